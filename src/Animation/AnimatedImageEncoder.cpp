@@ -0,0 +1,601 @@
+#include "AnimatedImageEncoder.h"
+
+#include <QCoreApplication>
+#include <QList>
+
+#ifndef Q_OS_WASM
+#include <QQueue>
+#include <QThread>
+#include <QtConcurrent>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <optional>
+
+namespace {
+QString trAnimatedImage(const char* text) {
+    return QCoreApplication::translate("AnimatedImageEncoder", text);
+}
+
+void appendLe16(QByteArray& out, int value) {
+    out.append(char(value & 0xFF));
+    out.append(char((value >> 8) & 0xFF));
+}
+
+void appendBe16(QByteArray& out, quint32 value) {
+    out.append(char((value >> 8) & 0xFF));
+    out.append(char(value & 0xFF));
+}
+
+void appendBe32(QByteArray& out, quint32 value) {
+    out.append(char((value >> 24) & 0xFF));
+    out.append(char((value >> 16) & 0xFF));
+    out.append(char((value >> 8) & 0xFF));
+    out.append(char(value & 0xFF));
+}
+
+// --- GIF ---------------------------------------------------------------------
+
+constexpr int kColorBins = 1 << 15;   // 5 bits per channel
+constexpr int kMaxPaletteColors = 255;
+constexpr int kTransparentIndex = 255;
+constexpr int kLzwMinCodeSize = 8;
+constexpr int kLzwMaxCode = 4096;
+
+int colorBin(const uchar* rgba) {
+    return ((rgba[0] >> 3) << 10) | ((rgba[1] >> 3) << 5) | (rgba[2] >> 3);
+}
+
+int binChannel(int bin, int axis) {
+    return (bin >> (10 - axis * 5)) & 31;
+}
+
+struct Histogram {
+    QVector<quint32> count = QVector<quint32>(kColorBins, 0);
+    QVector<quint64> sum[3] = {QVector<quint64>(kColorBins, 0), QVector<quint64>(kColorBins, 0),
+                               QVector<quint64>(kColorBins, 0)};
+
+    void add(const Histogram& other) {
+        for (int bin = 0; bin < kColorBins; ++bin) {
+            if (other.count[bin] == 0) continue;
+            count[bin] += other.count[bin];
+            for (int c = 0; c < 3; ++c) sum[c][bin] += other.sum[c][bin];
+        }
+    }
+};
+
+Histogram frameHistogram(const QImage& frame) {
+    Histogram histogram;
+    for (int y = 0; y < frame.height(); ++y) {
+        const uchar* pixel = frame.constScanLine(y);
+        for (int x = 0; x < frame.width(); ++x, pixel += 4) {
+            if (pixel[3] < AnimatedImageEncoder::kGifAlphaThreshold) continue;
+            const int bin = colorBin(pixel);
+            ++histogram.count[bin];
+            for (int c = 0; c < 3; ++c) histogram.sum[c][bin] += pixel[c];
+        }
+    }
+    return histogram;
+}
+
+struct Palette {
+    QVector<QRgb> colors;
+    QVector<uchar> indexOfBin = QVector<uchar>(kColorBins, 0);
+};
+
+// Median cut over the occupied bins. Every bin belongs to exactly one box, so mapping
+// a pixel is a table lookup instead of a nearest-colour search.
+Palette medianCut(const Histogram& histogram) {
+    struct Box {
+        QVector<int> bins;
+        quint64 population = 0;
+        int axis = 0;
+        int range = 0;
+    };
+    auto measure = [&histogram](Box& box) {
+        int lo[3] = {31, 31, 31};
+        int hi[3] = {0, 0, 0};
+        box.population = 0;
+        for (int bin : std::as_const(box.bins)) {
+            box.population += histogram.count[bin];
+            for (int c = 0; c < 3; ++c) {
+                lo[c] = qMin(lo[c], binChannel(bin, c));
+                hi[c] = qMax(hi[c], binChannel(bin, c));
+            }
+        }
+        box.axis = 0;
+        box.range = -1;
+        for (int c = 0; c < 3; ++c) {
+            if (hi[c] - lo[c] > box.range) {
+                box.range = hi[c] - lo[c];
+                box.axis = c;
+            }
+        }
+    };
+
+    QVector<Box> boxes(1);
+    for (int bin = 0; bin < kColorBins; ++bin) {
+        if (histogram.count[bin] > 0) boxes[0].bins.append(bin);
+    }
+    measure(boxes[0]);
+
+    while (boxes.size() < kMaxPaletteColors) {
+        // Split the box where the most pixels meet the widest spread of colour.
+        int target = -1;
+        quint64 bestScore = 0;
+        for (int i = 0; i < boxes.size(); ++i) {
+            if (boxes[i].bins.size() < 2) continue;
+            const quint64 score = boxes[i].population * quint64(boxes[i].range + 1);
+            if (score > bestScore) {
+                bestScore = score;
+                target = i;
+            }
+        }
+        if (target < 0) break;
+
+        Box& box = boxes[target];
+        const int axis = box.axis;
+        std::sort(box.bins.begin(), box.bins.end(), [axis](int a, int b) {
+            return binChannel(a, axis) < binChannel(b, axis);
+        });
+        quint64 below = 0;
+        qsizetype split = 1;
+        for (; split < box.bins.size() - 1; ++split) {
+            below += histogram.count[box.bins[split - 1]];
+            if (below * 2 >= box.population) break;
+        }
+        Box upper;
+        upper.bins = box.bins.mid(split);
+        box.bins.resize(split);
+        measure(box);
+        measure(upper);
+        boxes.append(upper);
+    }
+
+    Palette palette;
+    for (int i = 0; i < boxes.size(); ++i) {
+        quint64 population = 0;
+        quint64 sum[3] = {0, 0, 0};
+        for (int bin : std::as_const(boxes[i].bins)) {
+            population += histogram.count[bin];
+            for (int c = 0; c < 3; ++c) sum[c] += histogram.sum[c][bin];
+            palette.indexOfBin[bin] = uchar(i);
+        }
+        if (population == 0) {
+            palette.colors.append(qRgb(0, 0, 0));
+            continue;
+        }
+        palette.colors.append(qRgb(int(sum[0] / population), int(sum[1] / population),
+                                   int(sum[2] / population)));
+    }
+    return palette;
+}
+
+// Variable-width codes, packed least significant bit first.
+class BitWriter {
+public:
+    explicit BitWriter(QByteArray& out) : m_out(out) {}
+    void put(int code, int width) {
+        m_bits |= quint32(code) << m_count;
+        m_count += width;
+        while (m_count >= 8) {
+            m_out.append(char(m_bits & 0xFF));
+            m_bits >>= 8;
+            m_count -= 8;
+        }
+    }
+    void flush() {
+        if (m_count > 0) m_out.append(char(m_bits & 0xFF));
+        m_bits = 0;
+        m_count = 0;
+    }
+
+private:
+    QByteArray& m_out;
+    quint32 m_bits = 0;
+    int m_count = 0;
+};
+
+// GIF LZW. The string table is an open-addressed hash of (prefix code, next index).
+QByteArray lzwEncode(const QByteArray& indices) {
+    constexpr int kHashSize = 8191;  // prime, comfortably above the 4096 codes
+    constexpr int clearCode = 1 << kLzwMinCodeSize;
+    constexpr int endCode = clearCode + 1;
+    std::array<int, kHashSize> keys;
+    std::array<int, kHashSize> codes;
+
+    QByteArray out;
+    out.reserve(indices.size() / 2);
+    BitWriter writer(out);
+    int codeSize = kLzwMinCodeSize + 1;
+    int nextCode = endCode + 1;
+    auto reset = [&]() {
+        keys.fill(-1);
+        codeSize = kLzwMinCodeSize + 1;
+        nextCode = endCode + 1;
+    };
+    // Codes widen once the table holds one past the largest code of the current width,
+    // which is when the decoder, one code behind, widens too.
+    auto writeCode = [&](int code) {
+        writer.put(code, codeSize);
+        if (nextCode > (1 << codeSize) - 1 && codeSize < 12) ++codeSize;
+    };
+
+    reset();
+    writer.put(clearCode, codeSize);
+    const auto* data = reinterpret_cast<const uchar*>(indices.constData());
+    if (!indices.isEmpty()) {
+        int prefix = data[0];
+        for (qsizetype i = 1; i < indices.size(); ++i) {
+            const int next = data[i];
+            const int key = (prefix << 8) | next;
+            int slot = ((next << 12) ^ prefix) % kHashSize;
+            while (keys[slot] != -1 && keys[slot] != key) slot = (slot + 1) % kHashSize;
+            if (keys[slot] == key) {
+                prefix = codes[slot];
+                continue;
+            }
+            writeCode(prefix);
+            if (nextCode < kLzwMaxCode) {
+                keys[slot] = key;
+                codes[slot] = nextCode++;
+            } else {
+                writeCode(clearCode);
+                reset();
+            }
+            prefix = next;
+        }
+        writeCode(prefix);
+    }
+    writer.put(endCode, codeSize);
+    writer.flush();
+    return out;
+}
+
+QByteArray gifFrameData(const QImage& frame, const Palette& palette) {
+    QByteArray indices(qsizetype(frame.width()) * frame.height(), Qt::Uninitialized);
+    auto* index = reinterpret_cast<uchar*>(indices.data());
+    for (int y = 0; y < frame.height(); ++y) {
+        const uchar* pixel = frame.constScanLine(y);
+        for (int x = 0; x < frame.width(); ++x, pixel += 4) {
+            *index++ = pixel[3] < AnimatedImageEncoder::kGifAlphaThreshold
+                ? uchar(kTransparentIndex)
+                : palette.indexOfBin[colorBin(pixel)];
+        }
+    }
+    const QByteArray codes = lzwEncode(indices);
+    // Image data is a run of sub-blocks of at most 255 bytes, ended by an empty one.
+    QByteArray out;
+    out.reserve(codes.size() + codes.size() / 255 + 3);
+    out.append(char(kLzwMinCodeSize));
+    for (qsizetype offset = 0; offset < codes.size(); offset += 255) {
+        const qsizetype length = qMin<qsizetype>(255, codes.size() - offset);
+        out.append(char(length));
+        out.append(codes.constData() + offset, length);
+    }
+    out.append(char(0));
+    return out;
+}
+
+QByteArray gifFile(const Palette& palette, const QList<QByteArray>& images, const QSize& size, int fps) {
+    QByteArray out("GIF89a");
+    appendLe16(out, size.width());
+    appendLe16(out, size.height());
+    out.append(char(0xF7));  // 256-entry global colour table
+    out.append(char(kTransparentIndex));
+    out.append(char(0));
+    for (int i = 0; i < 256; ++i) {
+        const QRgb color = i < palette.colors.size() ? palette.colors[i] : qRgb(0, 0, 0);
+        out.append(char(qRed(color)));
+        out.append(char(qGreen(color)));
+        out.append(char(qBlue(color)));
+    }
+    // Loop forever.
+    out.append("\x21\xFF\x0BNETSCAPE2.0\x03\x01", 16);
+    appendLe16(out, 0);
+    out.append(char(0));
+
+    // Most viewers slow down delays under 2 centiseconds.
+    const int delay = qMax(2, qRound(100.0 / fps));
+    for (const QByteArray& image : images) {
+        // Graphic control: restore to background, so transparent pixels never show the
+        // previous frame.
+        out.append("\x21\xF9\x04", 3);
+        out.append(char((2 << 2) | 1));
+        appendLe16(out, delay);
+        out.append(char(kTransparentIndex));
+        out.append(char(0));
+        out.append(char(0x2C));
+        appendLe16(out, 0);
+        appendLe16(out, 0);
+        appendLe16(out, size.width());
+        appendLe16(out, size.height());
+        out.append(char(0));
+        out.append(image);
+    }
+    out.append(char(0x3B));
+    return out;
+}
+
+// --- APNG --------------------------------------------------------------------
+
+quint32 crc32(const char* data, qsizetype length, quint32 crc = 0xFFFFFFFFu) {
+    static const std::array<quint32, 256> table = [] {
+        std::array<quint32, 256> t{};
+        for (quint32 n = 0; n < 256; ++n) {
+            quint32 c = n;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[n] = c;
+        }
+        return t;
+    }();
+    for (qsizetype i = 0; i < length; ++i) {
+        crc = table[(crc ^ uchar(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+void appendChunk(QByteArray& out, const char* type, const QByteArray& data) {
+    appendBe32(out, quint32(data.size()));
+    const qsizetype start = out.size();
+    out.append(type, 4);
+    out.append(data);
+    appendBe32(out, crc32(out.constData() + start, out.size() - start) ^ 0xFFFFFFFFu);
+}
+
+int paeth(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) return a;
+    return pb <= pc ? b : c;
+}
+
+// Filters each row with whichever PNG filter gives the smallest sum of signed
+// residuals, the usual heuristic, then deflates the frame.
+QByteArray pngFrameData(const QImage& frame) {
+    constexpr int bpp = 4;
+    const int rowBytes = frame.width() * bpp;
+    QByteArray filtered;
+    filtered.reserve(qsizetype(rowBytes + 1) * frame.height());
+    QByteArray zeros(rowBytes, 0);
+    QByteArray candidate[5];
+    for (QByteArray& row : candidate) row.resize(rowBytes);
+    for (int y = 0; y < frame.height(); ++y) {
+        const uchar* row = frame.constScanLine(y);
+        const uchar* above = y > 0 ? frame.constScanLine(y - 1)
+                                   : reinterpret_cast<const uchar*>(zeros.constData());
+        for (int i = 0; i < rowBytes; ++i) {
+            const int a = i >= bpp ? row[i - bpp] : 0;
+            const int b = above[i];
+            const int c = i >= bpp ? above[i - bpp] : 0;
+            candidate[0][i] = char(row[i]);
+            candidate[1][i] = char(row[i] - a);
+            candidate[2][i] = char(row[i] - b);
+            candidate[3][i] = char(row[i] - ((a + b) >> 1));
+            candidate[4][i] = char(row[i] - paeth(a, b, c));
+        }
+        int best = 0;
+        qint64 bestCost = -1;
+        for (int f = 0; f < 5; ++f) {
+            qint64 cost = 0;
+            for (int i = 0; i < rowBytes; ++i) cost += std::abs(int(qint8(candidate[f][i])));
+            if (bestCost < 0 || cost < bestCost) {
+                bestCost = cost;
+                best = f;
+            }
+        }
+        filtered.append(char(best));
+        filtered.append(candidate[best]);
+    }
+    // qCompress prefixes the zlib stream with its uncompressed length.
+    return qCompress(filtered).mid(4);
+}
+
+QByteArray apngFile(const QList<QByteArray>& images, const QSize& size, int fps) {
+    QByteArray out("\x89PNG\r\n\x1A\n", 8);
+    QByteArray header;
+    appendBe32(header, quint32(size.width()));
+    appendBe32(header, quint32(size.height()));
+    header.append("\x08\x06\x00\x00\x00", 5);  // 8-bit RGBA, deflate, no interlace
+    appendChunk(out, "IHDR", header);
+    QByteArray control;
+    appendBe32(control, quint32(images.size()));
+    appendBe32(control, 0);  // loop forever
+    appendChunk(out, "acTL", control);
+
+    quint32 sequence = 0;
+    for (int i = 0; i < images.size(); ++i) {
+        QByteArray frameControl;
+        appendBe32(frameControl, sequence++);
+        appendBe32(frameControl, quint32(size.width()));
+        appendBe32(frameControl, quint32(size.height()));
+        appendBe32(frameControl, 0);
+        appendBe32(frameControl, 0);
+        appendBe16(frameControl, 1);
+        appendBe16(frameControl, quint32(fps));
+        frameControl.append(char(0));  // dispose: none
+        frameControl.append(char(0));  // blend: source replaces the whole canvas
+        appendChunk(out, "fcTL", frameControl);
+        // The first frame doubles as the default image viewers without APNG show.
+        if (i == 0) {
+            appendChunk(out, "IDAT", images[i]);
+        } else {
+            QByteArray frameData;
+            frameData.reserve(images[i].size() + 4);
+            appendBe32(frameData, sequence++);
+            frameData.append(images[i]);
+            appendChunk(out, "fdAT", frameData);
+        }
+    }
+    appendChunk(out, "IEND", QByteArray());
+    return out;
+}
+}  // namespace
+
+// Histograms are close to a megabyte each, so they are folded into one total as they
+// finish; encoded frames are kept until finish(), already compressed.
+struct AnimatedImageEncoder::State {
+    QSize size;
+    int paletteFrames = 0;
+    std::optional<Histogram> histogram;
+    std::optional<Palette> palette;
+    QList<QByteArray> frames;
+#ifndef Q_OS_WASM
+    int window = qMax(2, QThread::idealThreadCount());
+    QQueue<QFuture<Histogram>> pendingHistograms;
+    QQueue<QFuture<QByteArray>> pendingFrames;
+
+    ~State() {
+        // Queued GIF frames read the palette.
+        for (QFuture<Histogram>& future : pendingHistograms) future.waitForFinished();
+        for (QFuture<QByteArray>& future : pendingFrames) future.waitForFinished();
+    }
+#endif
+
+    void addHistogram(const Histogram& frameHistogram) {
+        if (histogram) {
+            histogram->add(frameHistogram);
+        } else {
+            histogram = frameHistogram;
+        }
+    }
+};
+
+AnimatedImageEncoder::AnimatedImageEncoder(Format format, int fps)
+    : m_format(format)
+    , m_fps(qBound(1, fps, 0xFFFF))
+    , m_state(std::make_unique<State>())
+{
+}
+
+AnimatedImageEncoder::~AnimatedImageEncoder() = default;
+
+bool AnimatedImageEncoder::needsPalettePass() const {
+    return m_format == Format::Gif;
+}
+
+bool AnimatedImageEncoder::prepare(const QImage& frame, QImage& rgba, QString& error) {
+    State& state = *m_state;
+    if (frame.isNull()) {
+        error = trAnimatedImage("A frame of the animation is empty.");
+        return false;
+    }
+    if (state.size.isEmpty()) {
+        if (m_format == Format::Gif && (frame.width() > 0xFFFF || frame.height() > 0xFFFF)) {
+            error = trAnimatedImage("GIF frames cannot be larger than 65535 pixels.");
+            return false;
+        }
+        state.size = frame.size();
+    } else if (frame.size() != state.size) {
+        error = trAnimatedImage("All frames must have the same size.");
+        return false;
+    }
+    rgba = frame.format() == QImage::Format_RGBA8888 ? frame : frame.convertToFormat(QImage::Format_RGBA8888);
+    return true;
+}
+
+bool AnimatedImageEncoder::addPaletteFrame(const QImage& frame, QString& error) {
+    State& state = *m_state;
+    if (state.palette) {
+        error = trAnimatedImage("Palette frames must come before the frames they colour.");
+        return false;
+    }
+    QImage rgba;
+    if (!prepare(frame, rgba, error)) return false;
+    ++state.paletteFrames;
+#ifdef Q_OS_WASM
+    state.addHistogram(frameHistogram(rgba));
+#else
+    if (state.pendingHistograms.size() >= state.window) {
+        state.addHistogram(state.pendingHistograms.dequeue().result());
+    }
+    state.pendingHistograms.enqueue(QtConcurrent::run(frameHistogram, rgba));
+#endif
+    return true;
+}
+
+bool AnimatedImageEncoder::addFrame(const QImage& frame, QString& error) {
+    State& state = *m_state;
+    if (m_format == Format::Gif && !state.palette) {
+        if (state.paletteFrames == 0) {
+            error = trAnimatedImage("GIF frames need a palette pass first.");
+            return false;
+        }
+#ifndef Q_OS_WASM
+        while (!state.pendingHistograms.isEmpty()) {
+            state.addHistogram(state.pendingHistograms.dequeue().result());
+        }
+#endif
+        state.palette = medianCut(*state.histogram);
+        state.histogram.reset();
+    }
+    QImage rgba;
+    if (!prepare(frame, rgba, error)) return false;
+#ifdef Q_OS_WASM
+    state.frames.append(m_format == Format::Gif ? gifFrameData(rgba, *state.palette) : pngFrameData(rgba));
+#else
+    if (state.pendingFrames.size() >= state.window) {
+        state.frames.append(state.pendingFrames.dequeue().result());
+    }
+    if (m_format == Format::Gif) {
+        const Palette* palette = &*state.palette;
+        state.pendingFrames.enqueue(QtConcurrent::run([rgba, palette]() { return gifFrameData(rgba, *palette); }));
+    } else {
+        state.pendingFrames.enqueue(QtConcurrent::run(pngFrameData, rgba));
+    }
+#endif
+    return true;
+}
+
+QByteArray AnimatedImageEncoder::finish(QString& error) {
+    State& state = *m_state;
+#ifndef Q_OS_WASM
+    while (!state.pendingFrames.isEmpty()) {
+        state.frames.append(state.pendingFrames.dequeue().result());
+    }
+#endif
+    if (state.frames.isEmpty()) {
+        error = trAnimatedImage("The animation has no frames.");
+        return {};
+    }
+    const QByteArray out = m_format == Format::Gif
+        ? gifFile(*state.palette, state.frames, state.size, m_fps)
+        : apngFile(state.frames, state.size, m_fps);
+    state.frames.clear();
+    return out;
+}
+
+bool AnimatedImageEncoder::formatForPath(const QString& path, Format& format) {
+    if (path.endsWith(QLatin1String(".gif"), Qt::CaseInsensitive)) {
+        format = Format::Gif;
+        return true;
+    }
+    if (path.endsWith(QLatin1String(".png"), Qt::CaseInsensitive)
+        || path.endsWith(QLatin1String(".apng"), Qt::CaseInsensitive)) {
+        format = Format::Apng;
+        return true;
+    }
+    return false;
+}
+
+QByteArray AnimatedImageEncoder::encode(const QVector<QImage>& frames, int fps, Format format,
+                                        QString& error) {
+    if (frames.isEmpty() || frames.first().isNull()) {
+        error = trAnimatedImage("The animation has no frames.");
+        return {};
+    }
+    AnimatedImageEncoder encoder(format, fps);
+    if (encoder.needsPalettePass()) {
+        for (const QImage& frame : frames) {
+            if (!encoder.addPaletteFrame(frame, error)) return {};
+        }
+    }
+    for (const QImage& frame : frames) {
+        if (!encoder.addFrame(frame, error)) return {};
+    }
+    return encoder.finish(error);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QString>
+#include <QVector>
+
+#include <memory>
+
+/**
+ * @class AnimatedImageEncoder
+ * @brief Writes looping GIF and APNG animations without external tools.
+ *
+ * Frames must all have the same size. GIF frames share one palette of up to 255
+ * colours, built by median cut over a 15-bit colour histogram of every frame, plus a
+ * transparent index for pixels with alpha below kGifAlphaThreshold. APNG keeps full
+ * RGBA. The per-frame work (histograms, palette mapping and LZW for GIF; filtering
+ * and deflate for APNG) runs on worker threads; only the final concatenation is serial.
+ *
+ * Frames are fed one at a time, so a caller can stream them and never hold the whole
+ * animation: only a few frames are in flight, and encoded frames are kept compressed.
+ * GIF needs the palette before any frame is encoded, so its frames are fed twice,
+ * first to addPaletteFrame() and then to addFrame().
+ */
+class AnimatedImageEncoder {
+public:
+    enum class Format { Gif, Apng };
+
+    // GIF has no partial transparency; pixels below this alpha become transparent.
+    static constexpr int kGifAlphaThreshold = 128;
+
+    AnimatedImageEncoder(Format format, int fps);
+    ~AnimatedImageEncoder();
+    AnimatedImageEncoder(const AnimatedImageEncoder&) = delete;
+    AnimatedImageEncoder& operator=(const AnimatedImageEncoder&) = delete;
+
+    /**
+     * @brief True when every frame must go through addPaletteFrame() before addFrame().
+     */
+    bool needsPalettePass() const;
+
+    /**
+     * @brief Adds a frame's colours to the GIF palette.
+     * @return bool False with error set for a frame of the wrong size.
+     */
+    bool addPaletteFrame(const QImage& frame, QString& error);
+
+    /**
+     * @brief Queues a frame for encoding, after the previous one.
+     * @return bool False with error set for a frame of the wrong size, or a GIF
+     * frame with no palette pass before it.
+     */
+    bool addFrame(const QImage& frame, QString& error);
+
+    /**
+     * @brief Waits for the queued frames and returns the file.
+     * @return QByteArray Empty on failure, with error set.
+     */
+    QByteArray finish(QString& error);
+
+    /**
+     * @brief Format written for @p path: ".gif", or ".png"/".apng".
+     * @return bool False for any other extension.
+     */
+    static bool formatForPath(const QString& path, Format& format);
+
+    /**
+     * @brief Encodes @p frames shown at @p fps, looping forever.
+     * @return QByteArray Empty on failure, with error set.
+     */
+    static QByteArray encode(const QVector<QImage>& frames, int fps, Format format, QString& error);
+
+private:
+    struct State;  // histograms, palette and frames in flight
+
+    // Converts to RGBA and checks the size against the first frame.
+    bool prepare(const QImage& frame, QImage& rgba, QString& error);
+
+    Format m_format;
+    int m_fps;
+    std::unique_ptr<State> m_state;
+};
@@ -1,5 +1,4 @@
 #include "AnimationCanvas.h"
-#include "AnimationPreviewService.h"
 #include <QScrollBar>
 #include <QApplication>
 #include "ViewUtils.h"
@@ -31,7 +30,8 @@ void AnimationCanvas::setSettings(const AppSettings& settings) {
     }
 }
 
-void AnimationCanvas::setPixmap(const QPixmap& pixmap) {
+void AnimationCanvas::setPixmap(const QPixmap& pixmap, const QPoint& pivotOrigin) {
+    m_pivotOrigin = pivotOrigin;
     m_pixmapItem->setPixmap(pixmap);
     m_scene->setSceneRect(m_pixmapItem->boundingRect());
     if (m_overlay->isVisible() && m_overlaySprite) {
@@ -39,8 +39,8 @@ void AnimationCanvas::setPixmap(const QPixmap& pixmap) {
         // Reposition after every composite update so the overlay stays aligned
         // even when the bounds change (e.g. after a pivot drag is committed).
         m_overlay->setPos(
-            AnimationPreviewService::cachedBoundsLeft() - m_overlaySprite->pivotX,
-            AnimationPreviewService::cachedBoundsTop()  - m_overlaySprite->pivotY);
+            m_pivotOrigin.x() - m_overlaySprite->pivotX,
+            m_pivotOrigin.y() - m_overlaySprite->pivotY);
         m_overlay->updateLayout();
     }
 }
@@ -63,8 +63,8 @@ void AnimationCanvas::setOverlaySprite(SpritePtr sprite) {
         // in the composite, so placing the overlay there makes item-local (pivotX, pivotY)
         // map to the correct scene position (maxLeft, maxTop).
         m_overlay->setPos(
-            AnimationPreviewService::cachedBoundsLeft() - sprite->pivotX,
-            AnimationPreviewService::cachedBoundsTop()  - sprite->pivotY);
+            m_pivotOrigin.x() - sprite->pivotX,
+            m_pivotOrigin.y() - sprite->pivotY);
     } else {
         m_overlay->setSprites({});
         m_overlay->setPos(0, 0);
@@ -79,8 +79,8 @@ void AnimationCanvas::setOverlayVisible(bool visible) {
         if (!sz.isNull())
             m_overlay->setSceneSize(sz);
         m_overlay->setPos(
-            AnimationPreviewService::cachedBoundsLeft() - m_overlaySprite->pivotX,
-            AnimationPreviewService::cachedBoundsTop()  - m_overlaySprite->pivotY);
+            m_pivotOrigin.x() - m_overlaySprite->pivotX,
+            m_pivotOrigin.y() - m_overlaySprite->pivotY);
         m_overlay->updateLayout();
     }
 }
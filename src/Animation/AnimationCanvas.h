@@ -17,8 +17,9 @@ public:
 
     /**
      * @brief Sets the pixmap to display.
+     * @param pivotOrigin Point of the pixmap where every frame's pivot lies.
      */
-    void setPixmap(const QPixmap& pixmap);
+    void setPixmap(const QPixmap& pixmap, const QPoint& pivotOrigin = QPoint());
 
     /**
      * @brief Centers the content in the view.
@@ -51,5 +52,6 @@ private:
     QGraphicsPixmapItem* m_pixmapItem;
     EditorOverlayItem*   m_overlay = nullptr;
     SpritePtr            m_overlaySprite;
+    QPoint               m_pivotOrigin;
     AppSettings          m_settings;
 };
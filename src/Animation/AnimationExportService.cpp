@@ -1,59 +1,37 @@
 #include "AnimationExportService.h"
-#include "MessageDialog.h"
+#include "AnimatedImageEncoder.h"
+#include "AnimationFrameStream.h"
 
 #include <QCoreApplication>
 #include <QFile>
 #include <QHash>
 #include <QFileDialog>
-#include <QImage>
 #include <QMessageBox>
-#include <QPainter>
-#include <QProcess>
+#include <QSaveFile>
 #include <QStandardPaths>
-#include <QTemporaryDir>
 
 namespace {
 QString trAnimationExport(const char* text) {
     return QCoreApplication::translate("AnimationExportService", text);
 }
+
+// Each video container gets a codec it accepts.
+QStringList videoCodecArguments(const QString& outPath) {
+    if (outPath.endsWith(".webm", Qt::CaseInsensitive))
+        return {"-c:v", "libvpx-vp9", "-pix_fmt", "yuva420p"};
+    if (outPath.endsWith(".ogv", Qt::CaseInsensitive))
+        return {"-c:v", "libtheora", "-pix_fmt", "yuv420p"};
+    // yuv420p needs even dimensions.
+    return {"-c:v", "libx264", "-pix_fmt", "yuv420p", "-vf", "pad=ceil(iw/2)*2:ceil(ih/2)*2"};
+}
 }
 
 QString AnimationExportService::chooseOutputPath(QWidget* parent) {
-    QString ffmpegExe = QStandardPaths::findExecutable("ffmpeg");
-    QString magickExe = QStandardPaths::findExecutable("magick");
-    if (magickExe.isEmpty()) {
-        magickExe = QStandardPaths::findExecutable("convert");
-    }
-
-    if (ffmpegExe.isEmpty() && magickExe.isEmpty()) {
-#if defined(Q_OS_WIN)
-        const QString hint = trAnimationExport(
-            "Install one of:\n"
-            "  \u2022 FFmpeg       \u2014 winget install ffmpeg\n"
-            "  \u2022 ImageMagick  \u2014 winget install ImageMagick");
-#elif defined(Q_OS_LINUX)
-        const QString hint = trAnimationExport(
-            "Install one of:\n"
-            "  \u2022 FFmpeg       \u2014 sudo apt install ffmpeg\n"
-            "  \u2022 ImageMagick  \u2014 sudo apt install imagemagick");
-#elif defined(Q_OS_MACOS)
-        const QString hint = trAnimationExport(
-            "Install one of:\n"
-            "  \u2022 FFmpeg       \u2014 brew install ffmpeg\n"
-            "  \u2022 ImageMagick  \u2014 brew install imagemagick");
-#else
-        const QString hint = trAnimationExport(
-            "Install FFmpeg or ImageMagick using your system package manager.");
-#endif
-        MessageDialog::warning(parent,
-            trAnimationExport("Missing Tools"),
-            trAnimationExport("Animation export requires ImageMagick or FFmpeg.\n\n") + hint);
-        return {};
-    }
-
+    // GIF and APNG are encoded in-process; only video needs FFmpeg.
     QStringList filters;
-    filters << trAnimationExport("GIF Image (*.gif)");
-    if (!ffmpegExe.isEmpty()) {
+    filters << trAnimationExport("GIF Image (*.gif)")
+            << trAnimationExport("APNG Image (*.png *.apng)");
+    if (!QStandardPaths::findExecutable("ffmpeg").isEmpty()) {
         filters << trAnimationExport("MP4 Video (*.mp4)")
                 << trAnimationExport("WebM Video (*.webm)")
                 << trAnimationExport("Ogg Video (*.ogv)")
@@ -87,34 +65,17 @@ bool AnimationExportService::exportAnimation(
         return false;
     }
 
-    QString converterExe = QStandardPaths::findExecutable("magick");
-    if (converterExe.isEmpty()) {
-        converterExe = QStandardPaths::findExecutable("convert");
-    }
-    QString ffmpegExe = QStandardPaths::findExecutable("ffmpeg");
-    bool isGif = outPath.endsWith(".gif", Qt::CaseInsensitive);
-    bool useMagick = isGif && !converterExe.isEmpty();
-    if (!useMagick && ffmpegExe.isEmpty()) {
-        if (!isGif) {
-            showError(trAnimationExport("FFmpeg Required"), trAnimationExport("FFmpeg is required for video export."));
-            return false;
-        }
-        if (converterExe.isEmpty()) {
-            showError(trAnimationExport("No Export Tool Found"),
-                      trAnimationExport("No suitable export tool found (FFmpeg or ImageMagick)."));
-            return false;
-        }
+    AnimatedImageEncoder::Format imageFormat = AnimatedImageEncoder::Format::Gif;
+    const bool isImage = AnimatedImageEncoder::formatForPath(outPath, imageFormat);
+    const QString ffmpegExe = isImage ? QString() : QStandardPaths::findExecutable("ffmpeg");
+    if (!isImage && ffmpegExe.isEmpty()) {
+        showError(trAnimationExport("FFmpeg Required"), trAnimationExport("FFmpeg is required for video export."));
+        return false;
     }
 
     setLoading(true);
     setStatus(trAnimationExport("Generating animation..."));
 
-    QTemporaryDir tempDir;
-    if (!tempDir.isValid()) {
-        setLoading(false);
-        return false;
-    }
-
     // Build O(1) pivot lookup to avoid O(N×M) nested search inside the frame loop.
     QHash<QString, SpritePtr> spriteMap;
     for (const auto& model : layoutModels) {
@@ -122,112 +83,71 @@ bool AnimationExportService::exportAnimation(
             spriteMap.insert(s->path, s);
     }
 
-    struct FrameData {
-        QString path;
-        int pivotX;
-        int pivotY;
-    };
-    QVector<FrameData> frameDataList;
-    int minX = 0, minY = 0, maxX = 0, maxY = 0;
-    bool first = true;
-
+    QVector<AnimationFrameStream::Frame> streamFrames;
+    streamFrames.reserve(frames.size());
     for (const QString& path : frames) {
-        int px = 0, py = 0;
-        QImage pm(path);
-        if (pm.isNull())
-            continue;
+        AnimationFrameStream::Frame frame;
+        frame.path = path;
         const auto it = spriteMap.constFind(path);
-        if (it != spriteMap.constEnd()) {
-            px = it.value()->pivotX;
-            py = it.value()->pivotY;
-        }
-        if (px == 0 && py == 0 && (pm.width() > 0 || pm.height() > 0)) {
-            px = pm.width() / 2;
-            py = pm.height() / 2;
-        }
-        frameDataList.append({path, px, py});
-        int l = -px;
-        int t = -py;
-        int r = pm.width() - px;
-        int b = pm.height() - py;
-        if (first) {
-            minX = l;
-            minY = t;
-            maxX = r;
-            maxY = b;
-            first = false;
-        } else {
-            minX = qMin(minX, l);
-            minY = qMin(minY, t);
-            maxX = qMax(maxX, r);
-            maxY = qMax(maxY, b);
-        }
-    }
-
-    if (frameDataList.isEmpty()) {
-        setLoading(false);
-        return false;
+        if (it != spriteMap.constEnd())
+            frame.pivot = QPoint(it.value()->pivotX, it.value()->pivotY);
+        streamFrames.append(frame);
     }
-
-    int canvasW = maxX - minX;
-    int canvasH = maxY - minY;
-    if (canvasW <= 0 || canvasH <= 0) {
+    AnimationFrameStream::Canvas canvas;
+    if (!AnimationFrameStream::measure(streamFrames, canvas)) {
         setLoading(false);
         return false;
     }
 
-    for (int i = 0; i < frameDataList.size(); ++i) {
-        const auto& fd = frameDataList[i];
-        QImage pm(fd.path);
-        QImage img(canvasW, canvasH, QImage::Format_ARGB32);
-        img.fill(Qt::transparent);
-        QPainter p(&img);
-        p.drawImage(-minX - fd.pivotX, -minY - fd.pivotY, pm);
-        p.end();
-        QString framePath = tempDir.filePath(QString("frame_%1.png").arg(i, 4, 10, QChar('0')));
-        if (!img.save(framePath)) {
-            setLoading(false);
-            return false;
+    QString error;
+    bool ok = false;
+    if (isImage) {
+        // Frames are handed to the encoder as they are composed, so only a few are held
+        // at a time. GIF needs its palette first, so its frames are composed twice.
+        AnimatedImageEncoder encoder(imageFormat, fps);
+        ok = !encoder.needsPalettePass()
+            || AnimationFrameStream::stream(streamFrames, canvas,
+                                            [&encoder](const QImage& image, QString& frameError) {
+                                                return encoder.addPaletteFrame(image, frameError);
+                                            },
+                                            error);
+        ok = ok && AnimationFrameStream::stream(streamFrames, canvas,
+                                                [&encoder](const QImage& image, QString& frameError) {
+                                                    return encoder.addFrame(image, frameError);
+                                                },
+                                                error);
+        QByteArray data;
+        if (ok) {
+            data = encoder.finish(error);
+            ok = !data.isEmpty();
+        }
+        if (ok) {
+            QSaveFile file(outPath);
+            ok = file.open(QIODevice::WriteOnly) && file.write(data) == data.size() && file.commit();
+            if (!ok) error = file.errorString();
         }
-    }
-
-#ifndef SPRAT_EMBEDDED_CLI
-    QProcess proc;
-    QStringList args;
-    if (useMagick) {
-        args << "-delay" << QString::number(100 / fps) << "-loop" << "0"
-             << tempDir.path() + "/frame_*.png" << outPath;
-        proc.start(converterExe, args);
-    } else if (!ffmpegExe.isEmpty()) {
-        args << "-y" << "-framerate" << QString::number(fps)
-             << "-i" << tempDir.path() + "/frame_%04d.png"
-             << "-c:v" << "libx264" << "-pix_fmt" << "yuv420p" << outPath;
-        proc.start(ffmpegExe, args);
     } else {
-        setLoading(false);
-        return false;
-    }
-    constexpr int kExportTimeoutMs = 5 * 60 * 1000; // 5 minutes
-    if (!proc.waitForFinished(kExportTimeoutMs)) {
-        proc.kill();
-        setStatus(trAnimationExport("Export timed out"));
-        showError(trAnimationExport("Export Failed"), trAnimationExport("Export process timed out after 5 minutes."));
-        setLoading(false);
-        return false;
-    }
-    bool ok = QFile::exists(outPath) && proc.exitStatus() == QProcess::NormalExit && proc.exitCode() == 0;
+#ifndef SPRAT_EMBEDDED_CLI
+        // Frames go to FFmpeg's stdin as raw RGBA, composed on worker threads.
+        const QString size = QStringLiteral("%1x%2").arg(canvas.size.width()).arg(canvas.size.height());
+        QStringList args;
+        args << "-y" << "-hide_banner" << "-loglevel" << "error"
+             << "-f" << "rawvideo" << "-pix_fmt" << "rgba" << "-s" << size
+             << "-framerate" << QString::number(fps) << "-i" << "-"
+             << videoCodecArguments(outPath) << outPath;
+        ok = AnimationFrameStream::pipe(streamFrames, canvas, ffmpegExe, args, error)
+            && QFile::exists(outPath);
 #else
-    Q_UNUSED(useMagick);
-    Q_UNUSED(converterExe);
-    Q_UNUSED(ffmpegExe);
-    bool ok = false;
     #ifdef Q_OS_WASM
-        showError(trAnimationExport("Not Supported"), trAnimationExport("Exporting to GIF/Video is not supported in the web version."));
+        showError(trAnimationExport("Not Supported"), trAnimationExport("Exporting to video is not supported in the web version."));
     #endif
 #endif
+    }
     if (!ok) {
         setStatus(trAnimationExport("Failed to generate animation"));
-        showError(trAnimationExport("Export Failed"), trAnimationExport("Exporting animation failed. Check console output for details."));
+        showError(trAnimationExport("Export Failed"), error.isEmpty()
+            ? trAnimationExport("Exporting animation failed. Check console output for details.")
+            : trAnimationExport("Exporting animation failed: %1").arg(error));
     }
     setLoading(false);
     return ok;
@@ -0,0 +1,176 @@
+#include "AnimationFrameStream.h"
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QPainter>
+
+#ifndef Q_OS_WASM
+#include <QFuture>
+#include <QProcess>
+#include <QQueue>
+#include <QThread>
+#include <QtConcurrent>
+#endif
+
+namespace {
+QString trFrameStream(const char* text) {
+    return QCoreApplication::translate("AnimationFrameStream", text);
+}
+
+#ifndef Q_OS_WASM
+constexpr int kStartTimeoutMs = 30 * 1000;
+// Per wait for the encoder to take more input, and for it to finish afterwards.
+constexpr int kEncoderTimeoutMs = 5 * 60 * 1000;
+#endif
+}  // namespace
+
+bool AnimationFrameStream::measure(QVector<Frame>& frames, Canvas& canvas) {
+    QVector<Frame> readable;
+    readable.reserve(frames.size());
+    int minX = 0, minY = 0, maxX = 0, maxY = 0;
+    for (Frame frame : std::as_const(frames)) {
+        QImageReader reader(frame.path);
+        QSize size = reader.size();
+        if (!size.isValid()) {
+            // Formats without a size in their header have to be decoded.
+            size = reader.read().size();
+        }
+        if (size.isEmpty()) continue;
+        frame.size = size;
+        if (frame.pivot.isNull()) {
+            frame.pivot = QPoint(size.width() / 2, size.height() / 2);
+        }
+        const int left = -frame.pivot.x();
+        const int top = -frame.pivot.y();
+        const int right = size.width() - frame.pivot.x();
+        const int bottom = size.height() - frame.pivot.y();
+        if (readable.isEmpty()) {
+            minX = left;
+            minY = top;
+            maxX = right;
+            maxY = bottom;
+        } else {
+            minX = qMin(minX, left);
+            minY = qMin(minY, top);
+            maxX = qMax(maxX, right);
+            maxY = qMax(maxY, bottom);
+        }
+        readable.append(frame);
+    }
+    frames = std::move(readable);
+    canvas.size = QSize(maxX - minX, maxY - minY);
+    canvas.origin = QPoint(-minX, -minY);
+    return !frames.isEmpty() && !canvas.size.isEmpty();
+}
+
+QImage AnimationFrameStream::compose(const Frame& frame, const Canvas& canvas) {
+    const QImage source(frame.path);
+    if (source.isNull() || canvas.size.isEmpty()) return {};
+    QImage image(canvas.size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.drawImage(canvas.origin - frame.pivot, source);
+    painter.end();
+    return image.convertToFormat(QImage::Format_RGBA8888);
+}
+
+bool AnimationFrameStream::stream(const QVector<Frame>& frames, const Canvas& canvas,
+                                  const std::function<bool(const QImage&, QString&)>& consume,
+                                  QString& error, int maxQueued) {
+    auto composeAt = [&frames, &canvas](int index) { return compose(frames[index], canvas); };
+#ifdef Q_OS_WASM
+    Q_UNUSED(maxQueued)
+    for (int i = 0; i < frames.size(); ++i) {
+        const QImage image = composeAt(i);
+        if (image.isNull()) {
+            error = trFrameStream("Could not read frame %1").arg(frames[i].path);
+            return false;
+        }
+        if (!consume(image, error)) return false;
+    }
+    return true;
+#else
+    const int window = maxQueued > 0 ? maxQueued : qMax(2, QThread::idealThreadCount() * 2);
+    QQueue<QFuture<QImage>> pending;
+    int next = 0;
+    auto refill = [&]() {
+        while (next < frames.size() && pending.size() < window) {
+            pending.enqueue(QtConcurrent::run(composeAt, next));
+            ++next;
+        }
+    };
+
+    refill();
+    bool ok = true;
+    for (int index = 0; ok && !pending.isEmpty(); ++index) {
+        const QImage image = pending.dequeue().result();
+        refill();
+        if (image.isNull()) {
+            error = trFrameStream("Could not read frame %1").arg(frames[index].path);
+            ok = false;
+        } else {
+            ok = consume(image, error);
+        }
+    }
+    // Frames still being composed reference the caller's data.
+    for (QFuture<QImage>& future : pending) future.waitForFinished();
+    return ok;
+#endif
+}
+
+bool AnimationFrameStream::pipe(const QVector<Frame>& frames, const Canvas& canvas,
+                                const QString& program, const QStringList& arguments,
+                                QString& error) {
+#ifdef Q_OS_WASM
+    Q_UNUSED(frames)
+    Q_UNUSED(canvas)
+    Q_UNUSED(arguments)
+    error = trFrameStream("%1 cannot be started in the web version.").arg(program);
+    return false;
+#else
+    const QString tool = QFileInfo(program).fileName();
+    QProcess process;
+    process.setStandardOutputFile(QProcess::nullDevice());
+    process.start(program, arguments);
+    if (!process.waitForStarted(kStartTimeoutMs)) {
+        error = trFrameStream("Could not start %1: %2").arg(tool, process.errorString());
+        return false;
+    }
+
+    const qint64 frameBytes = qint64(canvas.size.width()) * canvas.size.height() * kBytesPerPixel;
+    auto writeFrame = [&](const QImage& image, QString& writeError) {
+        // RGBA8888 rows are 4-byte aligned, so the buffer is already tightly packed.
+        process.write(reinterpret_cast<const char*>(image.constBits()), image.sizeInBytes());
+        // Keep at most one frame waiting in the pipe so composition follows the encoder.
+        while (process.bytesToWrite() > frameBytes) {
+            if (!process.waitForBytesWritten(kEncoderTimeoutMs)) {
+                writeError = trFrameStream("%1 stopped reading frames").arg(tool);
+                return false;
+            }
+        }
+        return true;
+    };
+    QString streamError;
+    const bool streamed = stream(frames, canvas, writeFrame, streamError);
+
+    process.closeWriteChannel();
+    if (!process.waitForFinished(kEncoderTimeoutMs)) {
+        process.kill();
+        process.waitForFinished();
+        error = trFrameStream("%1 did not finish within 5 minutes").arg(tool);
+        return false;
+    }
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        error = trFrameStream("%1 exited with code %2").arg(tool).arg(process.exitCode());
+        const QString details = QString::fromUtf8(process.readAllStandardError()).trimmed();
+        if (!details.isEmpty()) error += QStringLiteral(": ") + details;
+        return false;
+    }
+    if (!streamed) {
+        error = streamError;
+        return false;
+    }
+    return true;
+#endif
+}
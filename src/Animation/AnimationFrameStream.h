@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QImage>
+#include <QPoint>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+/**
+ * @class AnimationFrameStream
+ * @brief Composes animation frames on worker threads and hands them out in order.
+ *
+ * Every frame is drawn onto one shared canvas with its pivot on the canvas origin.
+ * Frames are composed ahead of the consumer, but only a bounded number at a time,
+ * so a long animation never holds all of its frames in memory. pipe() writes them
+ * as raw RGBA to an encoder's stdin, which avoids temporary image files entirely.
+ */
+class AnimationFrameStream {
+public:
+    static constexpr int kBytesPerPixel = 4;
+
+    struct Frame {
+        QString path;
+        QPoint pivot;  // in the frame's pixels; (0, 0) means the frame centre
+        QSize size;    // set by measure()
+    };
+
+    // Canvas every frame is drawn on; a frame's pivot lands on origin.
+    struct Canvas {
+        QSize size;
+        QPoint origin;
+    };
+
+    /**
+     * @brief Reads each frame's size from its header and sizes the canvas to fit
+     * all of them around their pivots. Frames that cannot be read are dropped.
+     * @return bool False when no frame is left or the canvas is empty.
+     */
+    static bool measure(QVector<Frame>& frames, Canvas& canvas);
+
+    /**
+     * @brief Decodes one frame and draws it on a transparent canvas.
+     * @return QImage Format_RGBA8888; null when the frame cannot be decoded.
+     */
+    static QImage compose(const Frame& frame, const Canvas& canvas);
+
+    /**
+     * @brief Composes every frame on worker threads, keeping at most @p maxQueued
+     * ahead of @p consume, and calls @p consume with them in order.
+     * @return bool False with error set when a frame fails or consume returns false.
+     */
+    static bool stream(const QVector<Frame>& frames, const Canvas& canvas,
+                       const std::function<bool(const QImage&, QString&)>& consume,
+                       QString& error, int maxQueued = 0);
+
+    /**
+     * @brief Starts @p program and writes every frame to its stdin as tightly packed
+     * RGBA rows, canvas.size.width() * canvas.size.height() * 4 bytes per frame.
+     * @return bool True when the program reads all frames and exits with code 0.
+     */
+    static bool pipe(const QVector<Frame>& frames, const Canvas& canvas,
+                     const QString& program, const QStringList& arguments, QString& error);
+};
@@ -2,13 +2,15 @@
 
 #include <QImageReader>
 #include <QPainter>
-#include <QPixmapCache>
+#include <QSet>
 #include <QTimer>
 #include <QCoreApplication>
 #include <QHash>
 #include <QtConcurrent>
 #include <QtGlobal>
 
+#include <utility>
+
 namespace {
 
 QString trAnimationPreview(const char* text) {
@@ -27,38 +29,28 @@ QHash<QString, SpritePtr> buildSpriteMap(const QVector<LayoutModel>& layoutModel
 }
 
 // ---------------------------------------------------------------------------
-// Sprite map cache — rebuilt only on invalidateSpriteMap()
+// Invalidation counters shared by every preview.  The caches they guard live
+// in each AnimationPreviewService instance.
 // ---------------------------------------------------------------------------
-quint64 g_spriteMapGeneration = 0;
-quint64 g_cachedSpriteMapGen  = ~quint64(0); // mismatched → first call builds it
-QHash<QString, SpritePtr> g_cachedSpriteMap;
+std::atomic<quint64> g_spriteMapGeneration{0};
+std::atomic<quint64> g_boundsGeneration{0};
 
-// ---------------------------------------------------------------------------
-// Bounds cache — the O(frames) pivot-aligned canvas-size computation.
-// Rebuilt only when the frames list changes or invalidateBounds() is called.
-// ---------------------------------------------------------------------------
-quint64 g_boundsGeneration = 0;
+constexpr int kMaxFrameSizes = 16384;
 
-struct BoundsCache {
-    int     selectedTimelineIndex = -2;  // -2 = never computed; compared O(1) instead of O(N) frame list
-    quint64 generation = ~quint64(0);
-    int     left = 0, right = 0, top = 0, bottom = 0;
-};
-BoundsCache g_boundsCache;
+} // namespace
 
 // ---------------------------------------------------------------------------
-// Frame size cache — shared between refresh() and calculateAnimationSize()
-// ---------------------------------------------------------------------------
-QHash<QString, QSize> g_frameSizeCache;
 
-// ---------------------------------------------------------------------------
-// Preload tracking — avoid re-preloading unchanged timelines
-// ---------------------------------------------------------------------------
-size_t g_preloadedTimelineHash = 0;
+AnimationPreviewService::AnimationPreviewService() = default;
 
-} // namespace
-
-// ---------------------------------------------------------------------------
+AnimationPreviewService::~AnimationPreviewService()
+{
+    // Both workers reference this instance; stop them before it goes away.
+    ++m_serial;
+    ++m_preloadSerial;
+    waitForPrefetch();
+    m_preload.waitForFinished();
+}
 
 void AnimationPreviewService::invalidateSpriteMap()
 {
@@ -71,8 +63,15 @@ void AnimationPreviewService::invalidateBounds()
     ++g_boundsGeneration;
 }
 
-int AnimationPreviewService::cachedBoundsLeft() { return g_boundsCache.left; }
-int AnimationPreviewService::cachedBoundsTop()  { return g_boundsCache.top;  }
+void AnimationPreviewService::waitForPrefetch()
+{
+    m_prefetch.waitForFinished();
+}
+
+bool AnimationPreviewService::isFrameReady(int frameIndex) const
+{
+    return isReady(frameIndex, m_serial.load());
+}
 
 void AnimationPreviewService::preloadTimeline(const QStringList& frames)
 {
@@ -83,87 +82,251 @@ void AnimationPreviewService::preloadTimeline(const QStringList& frames)
     for (const QString& f : frames)
         h ^= static_cast<size_t>(qHash(f)) + 0x9e3779b9u + (h << 6) + (h >> 2);
 
-    if (h == g_preloadedTimelineHash)
+    if (h == m_preloadedTimelineHash)
         return;
-    g_preloadedTimelineHash = h;
+    m_preloadedTimelineHash = h;
 
-    // Collect only the frames not already in the pixmap cache.
+    // A new timeline replaces the decoded images of the previous one.
+    const QSet<QString> wanted(frames.cbegin(), frames.cend());
     QStringList toLoad;
-    for (const QString& path : frames) {
-        QPixmap tmp;
-        if (!QPixmapCache::find(path, &tmp))
-            toLoad.append(path);
+    {
+        QMutexLocker lock(&m_mutex);
+        for (auto it = m_sources.begin(); it != m_sources.end();) {
+            if (wanted.contains(it.key()))
+                ++it;
+            else
+                it = m_sources.erase(it);
+        }
+        for (const QString& path : wanted) {
+            if (!m_sources.contains(path))
+                toLoad.append(path);
+        }
     }
     if (toLoad.isEmpty())
         return;
 
-    // Load QImages on a background thread (thread-safe disk I/O) and insert
-    // them into QPixmapCache on the main thread (QPixmap is not re-entrant).
-    // The returned QFuture is intentionally discarded — this is fire-and-forget.
-    auto preloadFuture = QtConcurrent::run([toLoad]() {
+    // An older preload stops after its current image.
+    const quint64 serial = ++m_preloadSerial;
+    m_preload.waitForFinished();
+    m_preload = QtConcurrent::run([this, toLoad, serial]() {
         for (const QString& path : toLoad) {
-            QImage img(path);
-            if (img.isNull())
-                continue;
-            QMetaObject::invokeMethod(qApp, [path, img]() {
-                // Double-check: another path may have been inserted since we checked.
-                QPixmap tmp;
-                if (!QPixmapCache::find(path, &tmp))
-                    QPixmapCache::insert(path, QPixmap::fromImage(img));
-            }, Qt::QueuedConnection);
+            if (m_preloadSerial.load() != serial)
+                return;
+            sourceImage(path);
         }
     });
-    Q_UNUSED(preloadFuture)
 }
 
 // ---------------------------------------------------------------------------
 
-// Recompute the pivot-aligned bounds for every frame in the timeline and
-// store the result in g_boundsCache.  Called only on cache miss.
-static void recomputeBounds(const QStringList& frames,
-                             const QHash<QString, SpritePtr>& spriteMap,
-                             int timelineIndex)
+const QHash<QString, SpritePtr>& AnimationPreviewService::spriteMap(
+    const QVector<LayoutModel>& layoutModels)
 {
-    if (g_frameSizeCache.size() > 16384) {
-        auto it = g_frameSizeCache.begin();
-        int toRemove = g_frameSizeCache.size() / 2;
-        while (toRemove-- > 0 && it != g_frameSizeCache.end()) {
-            it = g_frameSizeCache.erase(it);
-        }
+    const quint64 generation = g_spriteMapGeneration.load();
+    if (m_spriteMapGeneration != generation) {
+        m_spriteMap           = buildSpriteMap(layoutModels);
+        m_spriteMapGeneration = generation;
+        // Sprites may have been reloaded from disk.
+        m_frameSizes.clear();
+        m_preloadedTimelineHash = 0;
+        QMutexLocker lock(&m_mutex);
+        m_sources.clear();
     }
+    return m_spriteMap;
+}
 
-    int maxLeft = 0, maxRight = 0, maxTop = 0, maxBottom = 0;
+QSize AnimationPreviewService::frameSize(const QString& path)
+{
+    // Unreadable frames are cached too (as an invalid size) until the next sprite map
+    // rebuild, so they are not retried from disk on every tick.
+    const auto it = m_frameSizes.constFind(path);
+    if (it != m_frameSizes.constEnd())
+        return it.value();
+    QImageReader reader(path);
+    QSize size = reader.size();
+    if (!size.isValid()) {
+        // Formats without a size in their header have to be decoded.
+        size = reader.read().size();
+    }
+    if (m_frameSizes.size() >= kMaxFrameSizes)
+        m_frameSizes.clear();
+    m_frameSizes.insert(path, size);
+    return size;
+}
 
-    for (const QString& framePath : frames) {
-        QSize frameSize = g_frameSizeCache.value(framePath);
-        if (!frameSize.isValid()) {
-            frameSize = QImageReader(framePath).size();
-            if (frameSize.isValid())
-                g_frameSizeCache.insert(framePath, frameSize);
-        }
-        if (!frameSize.isValid())
+// Resolve every frame's pivot and the pivot-aligned bounds of the whole timeline.
+void AnimationPreviewService::buildScene(Scene& scene,
+                                         const QStringList& frames,
+                                         const QHash<QString, SpritePtr>& sprites)
+{
+    scene.frames = frames;
+    scene.pivots.resize(frames.size());
+
+    int maxLeft = 0, maxRight = 0, maxTop = 0, maxBottom = 0;
+    for (int i = 0; i < frames.size(); ++i) {
+        const QString& framePath = frames[i];
+        const QSize size = frameSize(framePath);
+        if (!size.isValid()) {
+            scene.pivots[i] = QPoint();
             continue;
+        }
 
-        int pivotX = frameSize.width()  / 2;
-        int pivotY = frameSize.height() / 2;
-        auto it = spriteMap.constFind(framePath);
-        if (it != spriteMap.constEnd()) {
-            pivotX = qBound(0, it.value()->pivotX, frameSize.width());
-            pivotY = qBound(0, it.value()->pivotY, frameSize.height());
+        int pivotX = size.width()  / 2;
+        int pivotY = size.height() / 2;
+        auto it = sprites.constFind(framePath);
+        if (it != sprites.constEnd()) {
+            pivotX = qBound(0, it.value()->pivotX, size.width());
+            pivotY = qBound(0, it.value()->pivotY, size.height());
         }
+        scene.pivots[i] = QPoint(pivotX, pivotY);
 
         maxLeft   = qMax(maxLeft,   pivotX);
-        maxRight  = qMax(maxRight,  frameSize.width()  - pivotX);
+        maxRight  = qMax(maxRight,  size.width()  - pivotX);
         maxTop    = qMax(maxTop,    pivotY);
-        maxBottom = qMax(maxBottom, frameSize.height() - pivotY);
+        maxBottom = qMax(maxBottom, size.height() - pivotY);
     }
 
-    g_boundsCache.selectedTimelineIndex = timelineIndex;
-    g_boundsCache.generation            = g_boundsGeneration;
-    g_boundsCache.left       = maxLeft;
-    g_boundsCache.right      = maxRight;
-    g_boundsCache.top        = maxTop;
-    g_boundsCache.bottom     = maxBottom;
+    scene.origin = QPoint(maxLeft, maxTop);
+    // Degenerate: no frame could be read.
+    scene.size = (maxLeft + maxRight > 0 && maxTop + maxBottom > 0)
+        ? QSize(maxLeft + maxRight, maxTop + maxBottom)
+        : QSize();
+}
+
+QImage AnimationPreviewService::sourceImage(const QString& path)
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        auto it = m_sources.constFind(path);
+        if (it != m_sources.constEnd())
+            return it.value();
+    }
+    // Decode outside the lock; the premultiplied format draws without conversion.
+    QImage image(path);
+    if (image.isNull())
+        return image;
+    image.convertTo(QImage::Format_ARGB32_Premultiplied);
+    QMutexLocker lock(&m_mutex);
+    m_sources.insert(path, image);
+    return image;
+}
+
+// Thread-safe: only reads the scene copy and the shared decoded-image cache.
+QImage AnimationPreviewService::compose(const Scene& scene, int index)
+{
+    const QImage source = sourceImage(scene.frames[index]);
+    if (source.isNull() || scene.size.isEmpty())
+        return QImage();
+
+    QImage canvas(scene.size, QImage::Format_ARGB32_Premultiplied);
+    canvas.fill(Qt::transparent);
+    QPainter p(&canvas);
+
+    auto draw = [&](const QImage& image, const QPoint& pivot) {
+        if (scene.hFlip || scene.vFlip) {
+            // Flip with the world transform instead of allocating a mirrored image.
+            // For scale s in axis X (s = ±1): the pixel at pivot.x() in image space must
+            // land at origin.x() on the canvas.
+            // With QTransform().translate(tx, ty).scale(sx, sy): point p' = sx·p + tx.
+            // Setting tx = origin.x() - sx·pivot.x() satisfies sx·pivot.x() + tx = origin.x(). ✓
+            const qreal sx = scene.hFlip ? -1.0 : 1.0;
+            const qreal sy = scene.vFlip ? -1.0 : 1.0;
+            p.save();
+            p.setWorldTransform(QTransform()
+                .translate(scene.origin.x() - sx * pivot.x(), scene.origin.y() - sy * pivot.y())
+                .scale(sx, sy));
+            p.drawImage(0, 0, image);
+            p.restore();
+        } else {
+            p.drawImage(scene.origin - pivot, image);
+        }
+    };
+
+    // Onion skin: draw adjacent frames as semi-transparent ghosts underneath.
+    if (scene.ghostOpacity > 0) {
+        p.setOpacity(scene.ghostOpacity / 100.0);
+        for (int gi : {index - 1, index + 1}) {
+            if (gi < 0 || gi >= scene.frames.size()) continue;
+            const QImage ghost = sourceImage(scene.frames[gi]);
+            if (!ghost.isNull())
+                draw(ghost, scene.pivots[gi]);
+        }
+        p.setOpacity(1.0);
+    }
+
+    draw(source, scene.pivots[index]);
+    p.end();
+    return canvas;
+}
+
+// ---------------------------------------------------------------------------
+// Frame ring
+// ---------------------------------------------------------------------------
+
+// How many frames index lies ahead of the playhead, wrapping at the loop end.
+int AnimationPreviewService::aheadOf(int index, int frameCount) const
+{
+    return (index - m_playhead.load() % frameCount + frameCount) % frameCount;
+}
+
+bool AnimationPreviewService::isReady(int index, quint64 serial) const
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_slots.isEmpty() || index < 0)
+        return false;
+    const Slot& slot = m_slots[index % m_slots.size()];
+    return slot.serial == serial && slot.index == index;
+}
+
+void AnimationPreviewService::store(int index, int frameCount, quint64 serial, const QImage& image)
+{
+    QMutexLocker lock(&m_mutex);
+    if (serial != m_serial.load() || m_slots.isEmpty())
+        return;
+    Slot& slot = m_slots[index % m_slots.size()];
+    // When the loop does not fit, frames past its end can share a slot with frames
+    // at its start; the one the playhead reaches first keeps it.
+    if (slot.serial == serial && slot.index >= 0 && slot.index != index
+            && aheadOf(slot.index, frameCount) < aheadOf(index, frameCount))
+        return;
+    slot.index  = index;
+    slot.serial = serial;
+    slot.image  = image;
+}
+
+// Compose the frames after the playhead on a worker, up to the ring's size.
+void AnimationPreviewService::prefetch()
+{
+    const int window = int(m_slots.size());
+    const int frameCount = int(m_scene.frames.size());
+    const quint64 serial = m_serial.load();
+    const int playhead = m_playhead.load();
+    if (window < 2)
+        return;
+    if (m_prefetch.isRunning()) {
+        if (m_prefetchSerial == serial)
+            return;
+        // A worker for an older scene stops after its current frame.
+        m_prefetch.waitForFinished();
+    } else if (m_prefetchSerial == serial && m_prefetchPlayhead == playhead) {
+        return;  // nothing has moved since the last pass
+    }
+    m_prefetchSerial   = serial;
+    m_prefetchPlayhead = playhead;
+
+    m_prefetch = QtConcurrent::run([this, scene = m_scene, serial, window, frameCount]() {
+        for (int step = 1; step < window; ++step) {
+            if (m_serial.load() != serial)
+                return;
+            // Follow the playhead so the worker stays ahead of it while it runs.
+            const int index = (m_playhead.load() + step) % frameCount;
+            if (isReady(index, serial))
+                continue;
+            const QImage image = compose(scene, index);
+            if (!image.isNull())
+                store(index, frameCount, serial, image);
+        }
+    });
 }
 
 // ---------------------------------------------------------------------------
@@ -194,8 +357,6 @@ QPixmap AnimationPreviewService::refresh(
 
     // Resolve effective frames (alias support)
     const QStringList* effectiveFrames = &selectedTimeline.frames;
-    bool hFlip = selectedTimeline.hFlip;
-    bool vFlip = selectedTimeline.vFlip;
 
     if (!selectedTimeline.aliasOf.isEmpty()) {
         for (const auto& tl : timelines) {
@@ -221,115 +382,72 @@ QPixmap AnimationPreviewService::refresh(
     if (frameIndex >= frames.size())
         frameIndex = 0;
 
-    // Sprite map — rebuild only after a layout change.
-    if (g_cachedSpriteMapGen != g_spriteMapGeneration) {
-        g_cachedSpriteMap    = buildSpriteMap(layoutModels);
-        g_cachedSpriteMapGen = g_spriteMapGeneration;
-    }
-    const QHash<QString, SpritePtr>& spriteMap = g_cachedSpriteMap;
-
-    const QString& path = frames[frameIndex];
-    SpritePtr currentSprite = spriteMap.value(path);
-
     statusText = QString("frame %1/%2")
                      .arg(frameIndex + 1)
                      .arg(frames.size());
 
-    QPixmap pix;
-    if (!QPixmapCache::find(path, &pix)) {
-        pix.load(path);
-        QPixmapCache::insert(path, pix);
-    }
-    if (pix.isNull())
-        return QPixmap();
-
-    // Bounds — O(frames) computation, cached until the selected timeline or pivots change.
-    // Comparing selectedTimelineIndex is O(1); changing frames within a timeline already
-    // increments g_boundsGeneration via invalidateBounds(), so the generation check covers it.
-    if (g_boundsCache.generation != g_boundsGeneration
-            || g_boundsCache.selectedTimelineIndex != selectedTimelineIndex)
-        recomputeBounds(frames, spriteMap, selectedTimelineIndex);
-
-    int maxLeftExtent   = g_boundsCache.left;
-    int maxRightExtent  = g_boundsCache.right;
-    int maxTopExtent    = g_boundsCache.top;
-    int maxBottomExtent = g_boundsCache.bottom;
-
-    // Degenerate fallback: all frames have unknown/zero size.
-    if (maxLeftExtent <= 0 && maxRightExtent <= 0 && maxTopExtent <= 0 && maxBottomExtent <= 0) {
-        int pivotX = currentSprite ? qBound(0, currentSprite->pivotX, pix.width())  : pix.width()  / 2;
-        int pivotY = currentSprite ? qBound(0, currentSprite->pivotY, pix.height()) : pix.height() / 2;
-        maxLeftExtent   = qMax(1, pivotX);
-        maxRightExtent  = qMax(1, pix.width()  - pivotX);
-        maxTopExtent    = qMax(1, pivotY);
-        maxBottomExtent = qMax(1, pix.height() - pivotY);
-    }
-
-    const int animationWidth  = qMax(1, maxLeftExtent + maxRightExtent);
-    const int animationHeight = qMax(1, maxTopExtent  + maxBottomExtent);
-
-    QPixmap canvas(animationWidth, animationHeight);
-    canvas.fill(Qt::transparent);
-
-    QPainter p(&canvas);
-
-    // Onion skin: draw adjacent frames as semi-transparent ghosts underneath.
-    if (onionSkin && onionOpacity > 0) {
-        const qreal ghostAlpha = onionOpacity / 100.0;
-        // Indices of adjacent frames to render as ghosts (prev and next).
-        const int ghostIndices[2] = { frameIndex - 1, frameIndex + 1 };
-        for (int gi : ghostIndices) {
-            if (gi < 0 || gi >= frames.size()) continue;
-            const QString& ghostPath = frames[gi];
-            QPixmap ghostPix;
-            if (!QPixmapCache::find(ghostPath, &ghostPix)) {
-                ghostPix.load(ghostPath);
-                if (!ghostPix.isNull())
-                    QPixmapCache::insert(ghostPath, ghostPix);
-            }
-            if (ghostPix.isNull()) continue;
-            SpritePtr ghostSprite = spriteMap.value(ghostPath);
-            int gx = ghostSprite ? qBound(0, ghostSprite->pivotX, ghostPix.width())  : ghostPix.width()  / 2;
-            int gy = ghostSprite ? qBound(0, ghostSprite->pivotY, ghostPix.height()) : ghostPix.height() / 2;
-            p.setOpacity(ghostAlpha);
-            if (hFlip || vFlip) {
-                // Use a world-transform flip instead of allocating a new QPixmap per frame.
-                // For scale s in axis X (s = ±1): the pixel at (gx, gy) in image space must land
-                // at (maxLeftExtent, maxTopExtent) on the canvas.
-                // With QTransform().translate(tx, ty).scale(sx, sy): point p' = sx·p + tx.
-                // Setting tx = maxLeftExtent - sx·gx satisfies sx·gx + tx = maxLeftExtent. ✓
-                const qreal sx = hFlip ? -1.0 : 1.0;
-                const qreal sy = vFlip ? -1.0 : 1.0;
-                p.save();
-                p.setWorldTransform(QTransform()
-                    .translate(maxLeftExtent - sx * gx, maxTopExtent - sy * gy)
-                    .scale(sx, sy));
-                p.drawPixmap(0, 0, ghostPix);
-                p.restore();
-            } else {
-                p.drawPixmap(maxLeftExtent - gx, maxTopExtent - gy, ghostPix);
+    // Scene — rebuilt only when the timeline, flips or onion skin changed, or when a
+    // pivot edit or layout rebuild bumped the bounds generation.
+    const quint64 boundsGeneration = g_boundsGeneration.load();
+    const int ghostOpacity = onionSkin ? qMax(0, onionOpacity) : 0;
+    if (m_boundsGeneration != boundsGeneration || frames != m_scene.frames
+            || selectedTimeline.hFlip != m_scene.hFlip || selectedTimeline.vFlip != m_scene.vFlip
+            || ghostOpacity != m_scene.ghostOpacity) {
+        m_boundsGeneration = boundsGeneration;
+        Scene scene;
+        buildScene(scene, frames, spriteMap(layoutModels));
+        scene.hFlip = selectedTimeline.hFlip;
+        scene.vFlip = selectedTimeline.vFlip;
+        scene.ghostOpacity = ghostOpacity;
+        scene.spriteMapGeneration = m_spriteMapGeneration;
+        if (!(scene == m_scene)) {
+            m_scene = scene;
+            ++m_serial;
+            // The whole loop when it fits the budget, else a window ahead of the playhead.
+            int capacity = 0;
+            if (!scene.size.isEmpty()) {
+                const qint64 frameBytes = qint64(scene.size.width()) * scene.size.height() * 4;
+                capacity = int(qMin<qint64>(frames.size(), qMax<qint64>(2, kRingBudgetBytes / frameBytes)));
             }
+            m_shown = QVector<Shown>(capacity);
+            QMutexLocker lock(&m_mutex);
+            m_slots = QVector<Slot>(capacity);
         }
-        p.setOpacity(1.0);
     }
+    if (m_scene.size.isEmpty())
+        return QPixmap();
 
-    int pivotX = currentSprite ? qBound(0, currentSprite->pivotX, pix.width())  : pix.width()  / 2;
-    int pivotY = currentSprite ? qBound(0, currentSprite->pivotY, pix.height()) : pix.height() / 2;
-    if (hFlip || vFlip) {
-        const qreal sx = hFlip ? -1.0 : 1.0;
-        const qreal sy = vFlip ? -1.0 : 1.0;
-        p.save();
-        p.setWorldTransform(QTransform()
-            .translate(maxLeftExtent - sx * pivotX, maxTopExtent - sy * pivotY)
-            .scale(sx, sy));
-        p.drawPixmap(0, 0, pix);
-        p.restore();
-    } else {
-        p.drawPixmap(maxLeftExtent - pivotX, maxTopExtent - pivotY, pix);
+    m_playhead = frameIndex;
+    const quint64 serial = m_serial.load();
+#ifndef Q_OS_WASM
+    prefetch();
+#endif
+
+    // Frames already shown are handed out as they are.
+    Shown& shown = m_shown[frameIndex % m_shown.size()];
+    if (shown.serial == serial && shown.index == frameIndex)
+        return shown.pixmap;
+
+    // Otherwise the composed image moves out of the ring into a pixmap; the slot stays
+    // marked as composed so the worker does not redo it.
+    QImage image;
+    {
+        QMutexLocker lock(&m_mutex);
+        Slot& slot = m_slots[frameIndex % m_slots.size()];
+        if (slot.serial == serial && slot.index == frameIndex)
+            image = std::exchange(slot.image, QImage());
     }
-    p.end();
-
-    return canvas;
+    if (image.isNull()) {
+        // First frame after a change, or a seek past what the worker has composed.
+        image = compose(m_scene, frameIndex);
+        if (image.isNull())
+            return QPixmap();
+        store(frameIndex, int(frames.size()), serial, QImage());
+    }
+    shown.index  = frameIndex;
+    shown.serial = serial;
+    shown.pixmap = QPixmap::fromImage(std::move(image));
+    return shown.pixmap;
 }
 
 // ---------------------------------------------------------------------------
@@ -361,19 +479,15 @@ QSize AnimationPreviewService::calculateAnimationSize(
         return QSize(280, 180);
     }
 
-    const QStringList& frames = *effectiveFramesCalc;
-
-    if (g_cachedSpriteMapGen != g_spriteMapGeneration) {
-        g_cachedSpriteMap    = buildSpriteMap(layoutModels);
-        g_cachedSpriteMapGen = g_spriteMapGeneration;
-    }
-
-    if (g_boundsCache.generation != g_boundsGeneration
-            || g_boundsCache.selectedTimelineIndex != selectedTimelineIndex)
-        recomputeBounds(frames, g_cachedSpriteMap, selectedTimelineIndex);
+    // The last refreshed scene has the same bounds when it shows these frames.
+    Scene scene;
+    if (m_boundsGeneration == g_boundsGeneration.load() && *effectiveFramesCalc == m_scene.frames)
+        scene = m_scene;
+    else
+        buildScene(scene, *effectiveFramesCalc, spriteMap(layoutModels));
 
-    const int animationWidth  = qMax(1, g_boundsCache.left  + g_boundsCache.right);
-    const int animationHeight = qMax(1, g_boundsCache.top   + g_boundsCache.bottom);
+    const int animationWidth  = qMax(1, scene.size.width());
+    const int animationHeight = qMax(1, scene.size.height());
 
     return QSize(qRound(animationWidth * zoom), qRound(animationHeight * zoom));
 }
@@ -1,17 +1,42 @@
 #pragma once
 
-#include <QVector>
+#include <QFuture>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
 #include <QPixmap>
+#include <QPoint>
+#include <QVector>
 #include "AnimationModels.h"
 #include "LayoutModels.h"
 
+#include <atomic>
+
 class QLabel;
 class QPushButton;
 class QTimer;
 
+/**
+ * @class AnimationPreviewService
+ * @brief Composes the frames of one animation preview.
+ *
+ * Each instance keeps its own caches and a ring of precomposed frames (pivot
+ * aligned, flipped and onion-skinned) that a worker fills ahead of the playhead,
+ * so playback normally just hands out a ready image. The ring holds the whole
+ * loop when it fits in kRingBudgetBytes. Any change to the frames, pivots, flips
+ * or onion skin drops the ring. Frames that have been shown are kept as pixmaps,
+ * so replaying the loop does no conversion at all.
+ */
 class AnimationPreviewService {
 public:
-    static QPixmap refresh(
+    // Memory the precomposed frames of one preview may use.
+    static constexpr qint64 kRingBudgetBytes = 64LL * 1024 * 1024;
+
+    AnimationPreviewService();
+    ~AnimationPreviewService();
+    Q_DISABLE_COPY(AnimationPreviewService)
+
+    QPixmap refresh(
         const QVector<AnimationTimeline>& timelines,
         int selectedTimelineIndex,
         int& frameIndex,
@@ -23,31 +48,105 @@ public:
         bool onionSkin = false,
         int onionOpacity = 30);
 
-    static QSize calculateAnimationSize(
+    QSize calculateAnimationSize(
         const QVector<AnimationTimeline>& timelines,
         int selectedTimelineIndex,
         const QVector<LayoutModel>& layoutModels,
         double zoom,
         int previewPadding);
 
-    // Preload all frames in the given list into QPixmapCache so the first
+    // Decode all frames in the given list on a worker thread so the first
     // playthrough has no per-frame disk reads.  Safe to call every tick —
     // a hash check makes it a no-op when the timeline has not changed.
-    static void preloadTimeline(const QStringList& frames);
+    void preloadTimeline(const QStringList& frames);
 
-    // Invalidate the cached sprite map so the next refresh() rebuilds it
-    // from the current layout models.  Call whenever layoutModels changes.
-    // Also invalidates the bounds cache.
+    // Invalidate the sprite map of every preview so the next refresh()
+    // rebuilds it from the current layout models.  Call whenever
+    // layoutModels changes.  Also drops decoded and precomposed frames.
     static void invalidateSpriteMap();
 
-    // Invalidate the cached canvas bounds so the next refresh() recomputes
-    // them.  Call whenever any sprite pivot changes.
+    // Invalidate the canvas bounds and precomposed frames of every preview
+    // so the next refresh() recomposes them.  Call whenever any sprite pivot
+    // changes.
     static void invalidateBounds();
 
     // Return the cached composite-canvas left/top extents (pixels from the
     // pivot alignment point to the left/top edge of the canvas).  Valid after
     // the most recent refresh() call.  Used to align the overlay item so that
     // its item-local coordinate system matches sprite-local coordinates.
-    static int cachedBoundsLeft();
-    static int cachedBoundsTop();
+    int cachedBoundsLeft() const { return m_scene.origin.x(); }
+    int cachedBoundsTop()  const { return m_scene.origin.y(); }
+
+    // True when frameIndex of the last refreshed timeline is precomposed.
+    bool isFrameReady(int frameIndex) const;
+
+    // Blocks until the worker filling the ring has stopped.
+    void waitForPrefetch();
+
+private:
+    // Everything a composed frame depends on.
+    struct Scene {
+        QStringList     frames;
+        QVector<QPoint> pivots;   // clamped to each frame; centre when the sprite is unknown
+        bool            hFlip = false;
+        bool            vFlip = false;
+        int             ghostOpacity = 0;  // percent; 0 = no onion skin
+        QPoint          origin;   // where every pivot lands
+        QSize           size;
+        quint64         spriteMapGeneration = 0;  // sprites may be reloaded under the same paths
+        bool operator==(const Scene& other) const = default;
+    };
+
+    // The image moves out once the frame is shown; index and serial stay so the
+    // worker does not compose it again.
+    struct Slot {
+        int     index = -1;
+        quint64 serial = 0;
+        QImage  image;
+    };
+
+    // Pixmap of a shown frame, indexed like m_slots. GUI thread only.
+    struct Shown {
+        int     index = -1;
+        quint64 serial = 0;
+        QPixmap pixmap;
+    };
+
+    const QHash<QString, SpritePtr>& spriteMap(const QVector<LayoutModel>& layoutModels);
+    QSize frameSize(const QString& path);
+    void buildScene(Scene& scene, const QStringList& frames, const QHash<QString, SpritePtr>& sprites);
+    QImage sourceImage(const QString& path);
+    QImage compose(const Scene& scene, int index);
+    int aheadOf(int index, int frameCount) const;
+    bool isReady(int index, quint64 serial) const;
+    void store(int index, int frameCount, quint64 serial, const QImage& image);
+    void prefetch();
+
+    // Sprite map — rebuilt only after invalidateSpriteMap().
+    quint64                   m_spriteMapGeneration = ~quint64(0);
+    QHash<QString, SpritePtr> m_spriteMap;
+
+    // Frame sizes read from image headers; invalid for frames that could not be read.
+    QHash<QString, QSize> m_frameSizes;
+
+    // Scene of the last refresh(); m_serial changes with it.
+    quint64                m_boundsGeneration = ~quint64(0);
+    Scene                  m_scene;
+    std::atomic<quint64>   m_serial{0};
+    std::atomic<int>       m_playhead{0};
+    quint64                m_prefetchSerial = 0;
+    int                    m_prefetchPlayhead = -1;
+
+    size_t                 m_preloadedTimelineHash = 0;
+    std::atomic<quint64>   m_preloadSerial{0};
+
+    // Guards m_sources and m_slots, which the workers share. Frame i lives in
+    // slot i % m_slots.size().
+    mutable QMutex          m_mutex;
+    QHash<QString, QImage>  m_sources;
+    QVector<Slot>           m_slots;
+    QFuture<void>           m_prefetch;
+    QFuture<void>           m_preload;
+
+    QVector<Shown>          m_shown;
 };
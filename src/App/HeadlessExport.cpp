@@ -0,0 +1,175 @@
+#include "HeadlessExport.h"
+#include "CliToolsConfig.h"
+#include "HeadlessExportService.h"
+#include "SpratProfilesConfig.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutex>
+#include <QProcess>
+#include <QTextStream>
+#include <QThread>
+
+#include <cstring>
+
+namespace {
+QString trHeadless(const char* text) {
+    return QCoreApplication::translate("HeadlessExport", text);
+}
+
+enum ExitCode { kExitOk = 0, kExitFailed = 1, kExitUsage = 2 };
+
+// Profile chains log from worker threads; each line is written whole.
+void printLine(const QString& line) {
+    static QMutex mutex;
+    QMutexLocker locker(&mutex);
+    QTextStream err(stderr);
+    err << line << Qt::endl;
+}
+
+bool runTool(const QString& tool, const QStringList& args, const QString& step,
+             const QByteArray* input, QByteArray* output) {
+    QProcess process;
+    process.setProcessChannelMode(QProcess::SeparateChannels);
+    process.start(tool, args);
+    if (input && !input->isEmpty()) {
+        process.write(*input);
+    }
+    process.closeWriteChannel();
+    if (!process.waitForFinished(-1)) {
+        printLine(trHeadless("%1: %2 did not finish").arg(step, QFileInfo(tool).fileName()));
+        return false;
+    }
+    if (output) *output = process.readAllStandardOutput();
+    const QString stderrText = QString::fromUtf8(process.readAllStandardError()).trimmed();
+    const bool ok = process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
+    if (!ok) {
+        printLine(trHeadless("%1: %2 exited with code %3").arg(step, QFileInfo(tool).fileName())
+                      .arg(process.exitCode()));
+    }
+    if (!stderrText.isEmpty()) {
+        printLine(QStringLiteral("  %1").arg(stderrText));
+    }
+    return ok;
+}
+
+void printLogEntry(const ExportLogEntry& entry) {
+    switch (entry.kind) {
+    case ExportLogEntry::Kind::FileWritten:
+        printLine(trHeadless("wrote %1").arg(entry.path));
+        break;
+    case ExportLogEntry::Kind::Unchanged:
+        printLine(trHeadless("unchanged %1").arg(entry.path));
+        break;
+    case ExportLogEntry::Kind::Info:
+        printLine(entry.path);
+        break;
+    case ExportLogEntry::Kind::Error:
+        printLine(trHeadless("error: %1").arg(entry.path));
+        break;
+    case ExportLogEntry::Kind::Timing: {
+        const QString step = entry.scope.isEmpty()
+            ? entry.path
+            : QStringLiteral("%1 (%2)").arg(entry.path, entry.scope);
+        printLine(trHeadless("%1: %2 ms").arg(step).arg(entry.wallMs));
+        break;
+    }
+    }
+}
+}  // namespace
+
+bool HeadlessExport::isRequested(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--export") == 0 || std::strncmp(argv[i], "--export=", 9) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int HeadlessExport::run(const QStringList& arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription(trHeadless("Exports a project without opening a window."));
+    parser.addHelpOption();
+    const QCommandLineOption exportOption(
+        QStringLiteral("export"), trHeadless("Project file, project folder or project zip to export."),
+        trHeadless("project"));
+    const QCommandLineOption profileOption(
+        QStringLiteral("profile"),
+        trHeadless("Profile to export; repeat or separate with commas. \"all\" exports every "
+                   "configured profile. Defaults to the project's selection."),
+        trHeadless("name"));
+    const QCommandLineOption outputOption(
+        QStringLiteral("output"),
+        trHeadless("Output folder, or a .zip file. Defaults to the project's export destination."),
+        trHeadless("path"));
+    const QCommandLineOption transformOption(
+        QStringLiteral("transform"),
+        trHeadless("Metadata format; repeat or separate with commas to write several from one "
+                   "pack. Defaults to the project's."),
+        trHeadless("name"));
+    const QCommandLineOption jobsOption(
+        QStringLiteral("jobs"), trHeadless("Profiles exported at once. Defaults to the core count."),
+        trHeadless("count"));
+    parser.addOptions({exportOption, profileOption, outputOption, transformOption, jobsOption});
+    if (!parser.parse(arguments)) {
+        printLine(parser.errorText());
+        return kExitUsage;
+    }
+    if (parser.isSet(QStringLiteral("help"))) {
+        printLine(parser.helpText());
+        return kExitOk;
+    }
+
+    HeadlessExportService::Request request;
+    request.projectPath = QFileInfo(parser.value(exportOption)).absoluteFilePath();
+    for (const QString& value : parser.values(profileOption)) {
+        for (const QString& name : value.split(u',', Qt::SkipEmptyParts)) {
+            request.profiles.append(name.trimmed());
+        }
+    }
+    if (parser.isSet(outputOption)) {
+        request.destination = QFileInfo(parser.value(outputOption)).absoluteFilePath();
+    }
+    for (const QString& value : parser.values(transformOption)) {
+        for (const QString& name : value.split(u',', Qt::SkipEmptyParts)) {
+            request.transforms.append(name.trimmed());
+        }
+    }
+    request.maxParallelProfiles = qMax(1, QThread::idealThreadCount());
+    if (parser.isSet(jobsOption)) {
+        bool ok = false;
+        request.maxParallelProfiles = parser.value(jobsOption).toInt(&ok);
+        if (!ok || request.maxParallelProfiles < 1) {
+            printLine(trHeadless("--jobs expects a positive number."));
+            return kExitUsage;
+        }
+    }
+
+    QString profilesError;
+    request.availableProfiles = SpratProfilesConfig::loadProfileDefinitions(&profilesError);
+    if (!profilesError.isEmpty()) {
+        printLine(trHeadless("Could not load profiles configuration: %1").arg(profilesError));
+        return kExitFailed;
+    }
+    request.cliPaths = CliToolsConfig::loadCliPaths();
+    const AppSettings settings = CliToolsConfig::loadAppSettings();
+    request.deduplicateMode = settings.deduplicateMode;
+    request.packInProcess = settings.packInProcess;
+
+    ProjectSaveService::SaveCallbacks callbacks;
+    callbacks.setStatus = [](const QString& status) { printLine(status); };
+    callbacks.runProcess = runTool;
+    callbacks.logEntry = printLogEntry;
+
+    QString destination;
+    QString error;
+    if (!HeadlessExportService::exportProject(request, callbacks, destination, error)) {
+        printLine(trHeadless("Export failed: %1").arg(error));
+        return kExitFailed;
+    }
+    printLine(trHeadless("Exported to %1").arg(destination));
+    return kExitOk;
+}
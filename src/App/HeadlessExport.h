@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QStringList>
+
+/**
+ * @class HeadlessExport
+ * @brief Command-line export mode: "sprat-gui --export project.spart.json [options]".
+ *
+ * Runs HeadlessExportService on the offscreen platform without creating MainWindow,
+ * prints progress to stderr and returns a process exit code.
+ */
+class HeadlessExport {
+public:
+    // True when the arguments ask for a headless export. Checked before any
+    // QGuiApplication exists, so it works on the raw argv.
+    static bool isRequested(int argc, char* argv[]);
+    // Parses the arguments and runs the export. 0 on success, 1 when the export
+    // fails, 2 for invalid arguments.
+    static int run(const QStringList& arguments);
+};
@@ -1,4 +1,5 @@
 #include "ExportCoordinator.h"
+#include "AtlasCompositor.h"
 #include "ILayoutContext.h"
 #include "LayoutOrchestrator.h"
 #include "LayoutCanvas.h"
@@ -7,9 +8,13 @@
 #include "LayoutParser.h"
 #include "ProjectSession.h"
 #include "ProjectSaveService.h"
+#include "SourceImageStore.h"
+#include "ExportTiming.h"
 #include "MessageDialog.h"
 #include "models.h"
 
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
@@ -19,29 +24,58 @@
 #include <QScrollBar>
 #include <QTemporaryFile>
 #include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
 #include <QTimer>
 #include <QtConcurrent>
 #include <QApplication>
 
+#include <atomic>
+
 #ifdef Q_OS_WASM
 #include <emscripten.h>
 #endif
 
-// Returns the output subdirectory for an atlas, automatically deriving one from the
-// atlas name when multiple atlases would otherwise all write to the same root directory.
-static QString effectiveOutputSubdir(const AtlasEntry& atlas, int rootExporterCount) {
-    if (!atlas.outputSubdir.isEmpty())
-        return atlas.outputSubdir;
-    if (rootExporterCount <= 1)
-        return {};
-    if (atlas.isNeutral)
-        return QStringLiteral("sprites");
-    const QString slug = atlas.name.trimmed().toLower().replace(QLatin1Char(' '), QLatin1Char('_'));
-    return slug.isEmpty() ? QStringLiteral("atlas") : slug;
+// Cache key for an export preview: the atlas, every profile setting the preview pack
+// uses, and the sprite set including each file's size and modification time, so an
+// edited image on disk is packed again.
+static QByteArray previewPackKey(int atlasIndex, const SpratProfile& profile,
+                                 const QString& scaleFilter, const QString& deduplicateMode,
+                                 const QString& layoutSourcePath, const QStringList& framePaths,
+                                 const QString& cachedLayout) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    auto add = [&hash](const QString& value) {
+        hash.addData(value.toUtf8());
+        hash.addData(QByteArrayView("\n", 1));
+    };
+    add(QString::number(atlasIndex));
+    add(profile.name.trimmed());
+    add(profile.preset.trimmed());
+    add(QString::number(profile.maxWidth));
+    add(QString::number(profile.maxHeight));
+    add(QString::number(profile.padding));
+    add(QString::number(profile.extrude));
+    add(QString::number(profile.scale, 'g', 17));
+    add(QString::number(profile.trimTransparent));
+    add(QString::number(profile.allowRotation));
+    add(QString::number(profile.multipack));
+    add(profile.sort.trimmed());
+    add(QString::number(profile.dilate));
+    add(scaleFilter);
+    add(deduplicateMode);
+    add(cachedLayout);
+    const QStringList inputs = framePaths.isEmpty() ? QStringList{layoutSourcePath} : framePaths;
+    for (const QString& path : inputs) {
+        const QFileInfo info(path);
+        add(path);
+        add(QString::number(info.size()));
+        add(QString::number(info.lastModified().toMSecsSinceEpoch()));
+    }
+    return hash.result();
 }
 
 ExportCoordinator::ExportCoordinator(const Config& cfg, QObject* parent)
-    : QObject(parent), m_cfg(cfg)
+    : QObject(parent), m_cfg(cfg), m_previewSources(std::make_shared<SourceImageStore>())
 {
     connect(&m_exportWatcher, &QFutureWatcherBase::finished,
             this, &ExportCoordinator::onExportWatcherFinished);
@@ -91,8 +125,7 @@ void ExportCoordinator::setExportPreviewAtlasIndex(int idx) {
 }
 
 void ExportCoordinator::invalidatePreviewCache() {
-    m_cachedPackedImage.clear();
-    m_cachedPackLayout.clear();
+    m_previewPackCache.clear();
 }
 
 bool ExportCoordinator::isExportRunning() const {
@@ -132,6 +165,7 @@ bool ExportCoordinator::runExport(SaveConfig config) {
     if (!config.outputPath.isEmpty()) {
         config.destination = config.outputPath;
     }
+    config.packInProcess = m_settings.packInProcess;
 
     if (m_layoutBinary.isEmpty() || m_packBinary.isEmpty()) {
         if (!m_cliReady) {
@@ -147,14 +181,13 @@ bool ExportCoordinator::runExport(SaveConfig config) {
         return false;
     }
 
-    // Stop any in-flight layout runner so it releases the tool mutex promptly.
+    // Stop any in-flight layout runner so it does not compete with the export.
     if (m_cfg.layoutOrchestrator) {
         m_cfg.layoutOrchestrator->stop();
     }
 
-    // If the export-workspace preview pack is still running it holds the tool mutex.
-    // Defer the export until it finishes rather than letting the export task block
-    // silently on the mutex.
+    // If the export-workspace preview pack is still running, defer the export until it
+    // finishes rather than having both compete for the packing tools.
     if (m_previewPackWatcher.isRunning()) {
         connect(&m_previewPackWatcher, &QFutureWatcher<PackPreviewResult>::finished,
                 this, [this, config]() { runExport(config); },
@@ -195,6 +228,13 @@ bool ExportCoordinator::runExport(SaveConfig config) {
     const QString spratPackBin = m_packBinary;
     const QString spratConvertBin = m_convertBinary;
     QJsonObject projectPayload = m_cfg.buildProjectPayload(config, true);
+    // Built once here and shared by every atlas and profile chain of the export.
+    const ExportStepTimer textTimer;
+    ExportMetadataText metadata = m_cfg.buildExportMetadata
+        ? m_cfg.buildExportMetadata(config)
+        : ExportMetadataText::fromPayload(projectPayload);
+    ExportLogEntry textTiming = textTimer.finish(QStringLiteral("text generation"), QString(),
+                                                 metadata.markers.size() + metadata.animations.size());
 
     auto saveTask = [this, config,
                      atlasSnapshot   = std::move(atlasSnapshot),
@@ -205,14 +245,17 @@ bool ExportCoordinator::runExport(SaveConfig config) {
                      deduplicateMode,
                      spratLayoutBin, spratPackBin, spratConvertBin,
                      projectPayload  = std::move(projectPayload),
+                     metadata        = std::move(metadata),
+                     textTiming,
                      setStatus, shouldCancel]() {
         ExportResult result;
+        const ExportStepTimer totalTimer;
 
         auto runToolBound = [this](const QString& tool, const QStringList& args, const QString& /*step*/, const QByteArray* input, QByteArray* output) {
             return m_cfg.runTool(tool, args, input, output, nullptr);
         };
 
-        QVector<ExportLogEntry> logEntries;
+        QVector<ExportLogEntry> logEntries{textTiming};
         auto logEntryFn = [&logEntries](const ExportLogEntry& e) { logEntries.append(e); };
 
         // Collect non-empty atlases for per-atlas export
@@ -223,6 +266,10 @@ bool ExportCoordinator::runExport(SaveConfig config) {
             }
         }
 
+        // Core budget shared by concurrently exported atlases and the profile chains
+        // inside each of them.
+        const int coreBudget = qMax(1, QThread::idealThreadCount());
+
         // Single-atlas (neutral-only) or empty project: use legacy path (backward compat)
         const bool multiAtlas = atlasesToExport.size() > 1
             || (!atlasesToExport.isEmpty() && !atlasesToExport.first().isNeutral);
@@ -238,10 +285,12 @@ bool ExportCoordinator::runExport(SaveConfig config) {
                 spratPackBin,
                 spratConvertBin,
                 projectPayload,
+                metadata,
                 result.savedDestination,
                 result.error,
                 deduplicateMode,
-                {nullptr, setStatus, shouldCancel, runToolBound, logEntryFn}
+                {nullptr, setStatus, shouldCancel, runToolBound, logEntryFn},
+                coreBudget
             );
         } else {
             // Multi-atlas: export each atlas to its own subdirectory
@@ -251,56 +300,110 @@ bool ExportCoordinator::runExport(SaveConfig config) {
             for (const auto& a : atlasesToExport)
                 if (a.outputSubdir.isEmpty()) ++rootExporterCount;
 
-            bool first = true;
+            struct AtlasJob {
+                const AtlasEntry* atlas = nullptr;
+                SaveConfig config;
+                QJsonObject payload;
+                ExportMetadataText metadata;
+                bool ok = false;
+                bool aborted = false;  // stopped early because another atlas failed
+                QString destination;
+                QString error;
+                QVector<ExportLogEntry> log;
+            };
+            QVector<AtlasJob> jobs;
             for (const auto& atlas : atlasesToExport) {
-                if (shouldCancel()) { result.canceled = true; break; }
-
-                SaveConfig atlasConfig = config;
-                // Apply per-atlas export overrides (empty = inherit global)
-                if (!atlas.exportConfig.profiles.isEmpty())
-                    atlasConfig.profiles = atlas.exportConfig.profiles;
-                if (!atlas.exportConfig.transform.isEmpty())
-                    atlasConfig.transform = atlas.exportConfig.transform;
-                if (!atlas.exportConfig.scaleFilter.isEmpty())
-                    atlasConfig.scaleFilter = atlas.exportConfig.scaleFilter;
-                // Nest this atlas inside each profile folder rather than at the top level.
-                // ProjectSaveService writes to <outputPath>/<profile>/<atlasSubdir>/.
-                atlasConfig.atlasSubdir = effectiveOutputSubdir(atlas, rootExporterCount);
-
+                AtlasJob job;
+                job.atlas = &atlas;
+                // Per-atlas overrides, nested inside each profile folder rather than at
+                // the top level.
+                job.config = ProjectSaveService::atlasConfig(config, atlas, rootExporterCount);
                 // Write project JSON only on first atlas call
-                const QJsonObject payload = first ? projectPayload : QJsonObject();
-                first = false;
-
-                setStatus(tr("Exporting '%1'...").arg(atlas.name));
+                if (jobs.isEmpty()) {
+                    job.payload = projectPayload;
+                    job.metadata = metadata;
+                } else {
+                    job.metadata = ExportMetadataText::fromPayload(job.payload);
+                }
+                jobs.append(job);
+            }
 
-                QString atlasDestination, atlasError;
-                const bool ok = ProjectSaveService::save(
-                    atlasConfig,
+            // Every atlas of a zip export rewrites the same archive, so those stay sequential.
+            const bool zipDestination = config.destination.endsWith(".zip", Qt::CaseInsensitive);
+            const int atlasThreads = zipDestination ? 1 : qMin(coreBudget, int(jobs.size()));
+            const int profileThreads = qMax(1, coreBudget / atlasThreads);
+
+            std::atomic_bool atlasFailed{false};
+            auto runJob = [&](AtlasJob& job) {
+                auto stopJob = [&]() { return atlasFailed.load() || shouldCancel(); };
+                auto logJobEntry = [&job](const ExportLogEntry& e) { job.log.append(e); };
+                setStatus(tr("Exporting '%1'...").arg(job.atlas->name));
+                job.ok = ProjectSaveService::save(
+                    job.config,
                     layoutSourcePath,
-                    atlas.spritePaths,
+                    job.atlas->spritePaths,
                     sourceFolder,
                     profiles,
                     QString(),
                     spratLayoutBin,
                     spratPackBin,
                     spratConvertBin,
-                    payload,
-                    atlasDestination,
-                    atlasError,
+                    job.payload,
+                    job.metadata,
+                    job.destination,
+                    job.error,
                     deduplicateMode,
-                    {nullptr, setStatus, shouldCancel, runToolBound, logEntryFn}
+                    {nullptr, setStatus, stopJob, runToolBound, logJobEntry},
+                    profileThreads
                 );
-                if (!ok) {
-                    result.success = false;
-                    result.error = atlasError;
-                    break;
+                if (!job.ok) {
+                    job.aborted = atlasFailed.exchange(true);
                 }
-                if (result.savedDestination.isEmpty()) {
-                    result.savedDestination = atlasDestination;
+            };
+
+#if defined(Q_OS_WASM) || defined(SPRAT_EMBEDDED_CLI)
+            Q_UNUSED(atlasThreads)
+            for (AtlasJob& job : jobs) runJob(job);
+#else
+            if (atlasThreads <= 1) {
+                for (AtlasJob& job : jobs) runJob(job);
+            } else {
+                // An atlas cleans its own profile folders, so an atlas whose folder holds
+                // or equals another one's (the root atlas writes dest/<profile> around
+                // the others' subfolders) finishes before the rest run in parallel.
+                auto holdsFolder = [](const QString& outer, const QString& inner) {
+                    return outer.isEmpty() || outer == inner || inner.startsWith(outer + '/');
+                };
+                QVector<int> parallelJobs;
+                for (int i = 0; i < jobs.size(); ++i) {
+                    bool holds = false;
+                    for (int j = 0; j < jobs.size() && !holds; ++j) {
+                        holds = j != i && holdsFolder(jobs[i].config.atlasSubdir,
+                                                      jobs[j].config.atlasSubdir);
+                    }
+                    if (holds) {
+                        runJob(jobs[i]);
+                    } else {
+                        parallelJobs.append(i);
+                    }
                 }
+                QThreadPool atlasPool;
+                atlasPool.setMaxThreadCount(atlasThreads);
+                QtConcurrent::blockingMap(&atlasPool, parallelJobs, [&](int i) { runJob(jobs[i]); });
             }
-            if (!result.canceled && result.error.isEmpty()) {
-                result.success = true;
+#endif
+
+            // Report in atlas order regardless of which task finished first.
+            result.success = true;
+            for (const AtlasJob& job : jobs) {
+                logEntries += job.log;
+                if (job.ok && result.savedDestination.isEmpty()) {
+                    result.savedDestination = job.destination;
+                }
+                if (!job.ok) {
+                    result.success = false;
+                    if (!job.aborted && result.error.isEmpty()) result.error = job.error;
+                }
             }
         }
 
@@ -312,6 +415,7 @@ bool ExportCoordinator::runExport(SaveConfig config) {
         const QString hookCmd = config.postExportCommand.trimmed();
 #ifndef Q_OS_WASM
         if (result.success && !hookCmd.isEmpty()) {
+            const ExportStepTimer hookTimer;
             QProcess proc;
             QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
             env.insert(QStringLiteral("SPRAT_EXPORT_PATH"), result.savedDestination);
@@ -333,11 +437,27 @@ bool ExportCoordinator::runExport(SaveConfig config) {
                 hookEntry.path = tr("Post-export hook completed: %1").arg(hookCmd);
             }
             logEntries.append(hookEntry);
+            logEntries.append(hookTimer.finish(QStringLiteral("post-export hook")));
         }
 #else
         Q_UNUSED(hookCmd)
 #endif
 
+        logEntries.append(totalTimer.finish(QStringLiteral("total")));
+#ifndef Q_OS_WASM
+        // WASM exports are downloaded and removed, so there is nothing to write next to.
+        if (result.success && !result.savedDestination.isEmpty()) {
+            QString reportError;
+            if (ExportTimingReport::write(logEntries, result.savedDestination, reportError)) {
+                logEntries.append({ExportLogEntry::Kind::Info,
+                    tr("Timing report written to %1").arg(ExportTimingReport::reportPath(result.savedDestination)), -1});
+            } else {
+                logEntries.append({ExportLogEntry::Kind::Error,
+                    tr("Could not write timing report: %1").arg(reportError), -1});
+            }
+        }
+#endif
+
         result.logEntries = std::move(logEntries);
         return result;
     };
@@ -412,8 +532,8 @@ void ExportCoordinator::handleExportResult(const ExportResult& result) {
 }
 
 void ExportCoordinator::refreshPreview(const QString& profileName, const QString& scaleFilter) {
+    // The preview cache is keyed by every pack input, so it stays valid across refreshes.
     cancelPreview();
-    invalidatePreviewCache();
     schedulePreviewPack(profileName, scaleFilter);
 }
 
@@ -460,11 +580,12 @@ void ExportCoordinator::doRunPreviewPack() {
     const QString deduplicateMode  = m_settings.deduplicateMode;
     const QVector<SpratProfile> profiles = m_cfg.layoutContext->configuredProfiles();
     const auto canceledPtr = m_previewPackCanceled;
-
-    const QByteArray cachedImage       = m_cachedPackedImage;
-    const QByteArray cachedPackLayout  = m_cachedPackLayout;
-    const QString    cachedSF          = m_cachedPackScaleFilter;
-    const int        cachedDilate      = m_cachedPackDilate;
+    // A task still finishing keeps the store it started with.
+    if (m_previewSources->totalBytes() > AppConstants::kPreviewSourceImageBytes) {
+        m_previewSources = std::make_shared<SourceImageStore>();
+    }
+    const auto previewSources = m_previewSources;
+    const int previewAtlasIndex = hasAtlasFilter ? m_exportPreviewAtlasIndex : -1;
 
     // Per-task cancellation flag for the queued layout-update callback.
     // Cancelling the old flag prevents a stale callback from a previous task
@@ -520,6 +641,19 @@ void ExportCoordinator::doRunPreviewPack() {
         }
         const double profileScale = qBound(0.01,
             effectiveProfile.scale > 0.0 ? effectiveProfile.scale : 1.0, 1.0);
+        constexpr double kTolerance = 1e-6;
+        const bool useCachedLayout = !cachedLayout.isEmpty()
+            && lastProfile == profileName
+            && std::abs(cachedLayoutScale - profileScale) < kTolerance
+            && cachedLayout.contains(QLatin1String("atlas "));
+
+        const QByteArray cacheKey = previewPackKey(previewAtlasIndex, effectiveProfile, scaleFilter,
+                                                   deduplicateMode, layoutSourcePath, framePaths,
+                                                   useCachedLayout ? cachedLayout : QString());
+        PreviewPackCache::Entry cached;
+        if (m_previewPackCache.find(cacheKey, cached)) {
+            return {cached.imageData, {}, cached.layoutModels, cached.image};
+        }
 
         // Write frame list to a temp file when needed
         QString layoutInputPath = layoutSourcePath;
@@ -527,7 +661,7 @@ void ExportCoordinator::doRunPreviewPack() {
         if (!framePaths.isEmpty()) {
             frameListFile.setFileTemplate(
                 QDir::temp().filePath("sprat-preview-frames-XXXXXX.txt"));
-            if (!frameListFile.open()) return {{}, tr("Could not create temporary frame list"), {}, {}, -1, {}};
+            if (!frameListFile.open()) return {{}, tr("Could not create temporary frame list"), {}};
             {
                 QTextStream out(&frameListFile);
                 for (const QString& p : framePaths) out << p << "\n";
@@ -542,11 +676,7 @@ void ExportCoordinator::doRunPreviewPack() {
 
         // Use cached layout when it matches the selected profile + scale
         QByteArray layoutData;
-        constexpr double kTolerance = 1e-6;
-        if (!cachedLayout.isEmpty()
-            && lastProfile == profileName
-            && std::abs(cachedLayoutScale - profileScale) < kTolerance
-            && cachedLayout.contains(QLatin1String("atlas "))) {
+        if (useCachedLayout) {
             layoutData = cachedLayout.toUtf8();
         } else {
             QStringList layoutArgs;
@@ -572,7 +702,7 @@ void ExportCoordinator::doRunPreviewPack() {
             QByteArray layoutStderr;
             if (!m_cfg.runTool(layoutBin, layoutArgs, nullptr, &layoutData, &layoutStderr)) {
                 const QString msg = QString::fromUtf8(layoutStderr).trimmed();
-                return {{}, msg.isEmpty() ? tr("Layout generation failed") : msg, {}, {}, -1, {}};
+                return {{}, msg.isEmpty() ? tr("Layout generation failed") : msg, {}};
             }
         }
 
@@ -581,12 +711,6 @@ void ExportCoordinator::doRunPreviewPack() {
         if (layoutData.isEmpty() || !layoutData.contains("atlas ")) return {};
 
         const int dilate = effectiveProfile.dilate;
-        if (!cachedImage.isEmpty()
-            && layoutData == cachedPackLayout
-            && scaleFilter == cachedSF
-            && dilate == cachedDilate) {
-            return {cachedImage, {}, {}, {}, -1, {}};  // cache hit — layout unchanged
-        }
 
         // Parse layout models and push them to the UI immediately so the placeholder
         // shows the correct sprite arrangement for this profile before sprat-pack finishes.
@@ -614,6 +738,21 @@ void ExportCoordinator::doRunPreviewPack() {
 
         if (canceledPtr->load()) return {};
 
+        // Single-page layouts are composed here from the decoded sources, so spratpack
+        // only runs for the real export. Dilation only recolors fully transparent
+        // pixels, so the preview looks the same without it; extruded and multipack
+        // profiles still go through spratpack.
+        if (previewModels.size() == 1 && effectiveProfile.extrude <= 0 && !effectiveProfile.multipack) {
+            QString composeError;
+            const QImage image = AtlasCompositor::composeTiled(
+                previewModels.first(), *previewSources, AtlasCompositor::scaleMode(scaleFilter),
+                AppConstants::kPreviewComposeTileSize, composeError, canceledPtr.get());
+            if (canceledPtr->load()) return {};
+            if (image.isNull()) return {{}, composeError, {}};
+            m_previewPackCache.insert(cacheKey, {{}, layoutData, previewModels, image});
+            return {{}, {}, previewModels, image};
+        }
+
         // Run spratpack with layout data as stdin
         QStringList packArgs;
         if (dilate > 0)
@@ -625,10 +764,13 @@ void ExportCoordinator::doRunPreviewPack() {
         QByteArray packStderr;
         if (!m_cfg.runTool(packBin, packArgs, &layoutData, &packOutput, &packStderr)) {
             const QString msg = QString::fromUtf8(packStderr).trimmed();
-            return {{}, msg.isEmpty() ? tr("Packing failed") : msg, {}, {}, -1, {}};
+            return {{}, msg.isEmpty() ? tr("Packing failed") : msg, {}};
         }
 
-        return {packOutput, {}, layoutData, scaleFilter, dilate, previewModels};
+        if (!canceledPtr->load() && !packOutput.isEmpty()) {
+            m_previewPackCache.insert(cacheKey, {packOutput, layoutData, previewModels});
+        }
+        return {packOutput, {}, previewModels};
     };
 
 #ifdef Q_OS_WASM
@@ -648,17 +790,12 @@ void ExportCoordinator::handlePackPreviewResult(const PackPreviewResult& result)
     if (!m_exportWorkspaceActive || m_previewPackCanceled->load()) return;
     if (!m_cfg.packedAtlasView) return;
 
-    // Update PNG cache when a real pack ran (non-empty layoutUsed means it wasn't a cache hit)
-    if (!result.imageData.isEmpty() && !result.layoutUsed.isEmpty()) {
-        m_cachedPackedImage     = result.imageData;
-        m_cachedPackLayout      = result.layoutUsed;
-        m_cachedPackScaleFilter = result.scaleFilterUsed;
-        m_cachedPackDilate      = result.dilateUsed;
-    }
     // Update layout model cache from the already-parsed result (avoids re-parsing here)
     if (!result.layoutModels.isEmpty()) {
         m_cachedPackModels        = result.layoutModels;
         m_cachedPackModelsProfile = m_previewPackProfile;
+        if (m_cfg.exportWorkspace)
+            m_cfg.exportWorkspace->setProfileLayoutModels(m_previewPackProfile, result.layoutModels);
     }
 
     // Capture layout canvas zoom/scroll before the swap so the packed atlas
@@ -678,7 +815,9 @@ void ExportCoordinator::handlePackPreviewResult(const PackPreviewResult& result)
     if (m_cfg.exportWorkspace && m_cfg.packedAtlasView)
         m_cfg.exportWorkspace->setViewport(m_cfg.packedAtlasView);
 
-    if (result.imageData.isEmpty()) {
+    if (!result.image.isNull()) {
+        m_cfg.packedAtlasView->setImage(result.image);
+    } else if (result.imageData.isEmpty()) {
         m_cfg.packedAtlasView->setError(
             result.errorMsg.isEmpty() ? tr("Preview generation failed") : result.errorMsg);
     } else {
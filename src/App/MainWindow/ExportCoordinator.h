@@ -4,12 +4,16 @@
 #include <QFutureWatcher>
 #include <QVector>
 #include <QByteArray>
+#include <QImage>
 #include <QJsonObject>
 #include <QString>
 #include <functional>
 #include <atomic>
 #include <memory>
 #include "models.h"
+#include "ExportMetadataText.h"
+#include "PreviewPackCache.h"
+#include "AppConstants.h"
 
 class QWidget;
 class ProjectSession;
@@ -18,6 +22,7 @@ class PackedAtlasView;
 class ExportWorkspace;
 class LayoutOrchestrator;
 class ILayoutContext;
+class SourceImageStore;
 
 /**
  * @class ExportCoordinator
@@ -40,10 +45,8 @@ public:
     struct PackPreviewResult {
         QByteArray           imageData;
         QString              errorMsg;
-        QByteArray           layoutUsed;
-        QString              scaleFilterUsed;
-        int                  dilateUsed = -1;
         QVector<LayoutModel> layoutModels;
+        QImage               image;  // set instead of imageData when composed in-process
     };
 
     struct Config {
@@ -60,6 +63,8 @@ public:
                            const QByteArray*, QByteArray*, QByteArray*)> runTool;
         // buildProjectPayload: wraps MainWindow::buildProjectPayload(config, session, portable)
         std::function<QJsonObject(const SaveConfig&, bool)> buildProjectPayload;
+        // buildExportMetadata: markers/animations text for spratconvert, from session data
+        std::function<ExportMetadataText(const SaveConfig&)> buildExportMetadata;
         // promoteSourceFolderAfterSave: post-export hook (stays in MainWindow)
         std::function<void(const QString&)> promoteSourceFolderAfterSave;
     };
@@ -118,10 +123,9 @@ private:
     std::atomic<bool>                  m_exportCanceled{false};
     QString                            m_previewPackProfile;
     QString                            m_previewPackScaleFilter;
-    QByteArray                         m_cachedPackedImage;
-    QByteArray                         m_cachedPackLayout;
-    QString                            m_cachedPackScaleFilter;
-    int                                m_cachedPackDilate = -1;
+    PreviewPackCache                   m_previewPackCache{AppConstants::kPreviewPackCacheBytes};
+    // Sources decoded for composed previews, reused across refreshes.
+    std::shared_ptr<SourceImageStore>  m_previewSources;
     std::shared_ptr<std::atomic<bool>> m_previewPackLayoutUpdateCanceled;
     QVector<LayoutModel>               m_cachedPackModels;
     QString                            m_cachedPackModelsProfile;
@@ -104,7 +104,9 @@ QVector<ExportDiffDialog::DiffEntry> ExportDiffDialog::buildEntries(
 
         const QString subdir = effectiveOutputSubdir(atlas, rootExporterCount);
         const QStringList profs = effectiveProfiles(atlas, config);
-        const QString transform = effectiveTransform(atlas, config);
+        QStringList transforms{effectiveTransform(atlas, config)};
+        transforms += config.extraTransforms;
+        transforms.removeDuplicates();
 
         for (const QString& profileName : profs) {
             // Structure: <outputPath>/<profileName>/<atlasSubdir>/
@@ -118,18 +120,23 @@ QVector<ExportDiffDialog::DiffEntry> ExportDiffDialog::buildEntries(
             const QString sheetPath = QDir(dir).filePath(QStringLiteral("spritesheet") + ext);
             entries.append({sheetPath, QFile::exists(sheetPath), false});
 
-            if (transform == QStringLiteral("raw")) {
-                for (const QString& name : {QStringLiteral("layout.txt"),
-                                             QStringLiteral("markers.txt"),
-                                             QStringLiteral("animations.txt")}) {
-                    const QString p = QDir(dir).filePath(name);
+            for (const QString& transform : std::as_const(transforms)) {
+                if (transform == QStringLiteral("raw")) {
+                    for (const QString& name : {QStringLiteral("layout.txt"),
+                                                 QStringLiteral("markers.txt"),
+                                                 QStringLiteral("animations.txt")}) {
+                        const QString p = QDir(dir).filePath(name);
+                        entries.append({p, QFile::exists(p), false});
+                    }
+                } else if (transform == QStringLiteral("binary")) {
+                    const QString p = QDir(dir).filePath(QStringLiteral("sprites.bin"));
                     entries.append({p, QFile::exists(p), false});
-                }
-            } else if (!transform.isEmpty() && transform != QStringLiteral("none")) {
-                const QString metaFile = transformOutputFilename(transform);
-                if (!metaFile.isEmpty()) {
-                    const QString metaPath = QDir(dir).filePath(metaFile);
-                    entries.append({metaPath, QFile::exists(metaPath), false});
+                } else if (!transform.isEmpty() && transform != QStringLiteral("none")) {
+                    const QString metaFile = transformOutputFilename(transform);
+                    if (!metaFile.isEmpty()) {
+                        const QString metaPath = QDir(dir).filePath(metaFile);
+                        entries.append({metaPath, QFile::exists(metaPath), false});
+                    }
                 }
             }
         }
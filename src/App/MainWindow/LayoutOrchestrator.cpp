@@ -69,6 +69,7 @@ void LayoutOrchestrator::resetDebounceTimer() {
 
 void LayoutOrchestrator::stopAndClearPending() {
     if (m_layoutRunner) m_layoutRunner->stop();
+    m_validatingCachedLayout = false;
     m_layoutRunPending = false;
     m_layoutRunPendingQuiet = false;
 }
@@ -457,6 +458,7 @@ void LayoutOrchestrator::onRunnerFinished(const LayoutResult& result) {
             }
             return;
         }
+        m_validatingCachedLayout = false;
 
         const QString combined = (result.error + "\n" + result.output).toLower();
 
@@ -540,21 +542,82 @@ void LayoutOrchestrator::onRunnerFinished(const LayoutResult& result) {
     m_retryWithoutTrimOnFailure = false;
 
     const QString layoutText = result.output;
+    if (m_validatingCachedLayout) {
+        m_validatingCachedLayout = false;
+        if (layoutText == m_cfg.session->cachedLayoutOutput) {
+            // The canvas already shows this layout; nothing to redraw.
+            qInfo() << "[Layout] Cached layout confirmed by spratlayout";
+            emit statusMessageChanged(QString(tr("Loaded %1 sprites in %2 atlas(es)"))
+                .arg(m_cfg.session->activeFramePaths.size())
+                .arg(m_cfg.session->activeAtlas().layoutModels.size()));
+            if (m_layoutRunPending) {
+                const bool q = m_layoutRunPendingQuiet;
+                m_layoutRunPending = false;
+                m_layoutRunPendingQuiet = false;
+                run(q);
+            }
+            return;
+        }
+        qInfo() << "[Layout] Cached layout is stale, applying fresh spratlayout output";
+    }
+    applyLayoutOutput(layoutText, parseLayoutOutput(layoutText));
+}
+
+// --- showCachedLayout ---
+
+bool LayoutOrchestrator::showCachedLayout() {
+    m_validatingCachedLayout = false;
+    const QString layoutText = m_cfg.session->cachedLayoutOutput;
+    if (layoutText.isEmpty() || !m_cfg.canvas) {
+        return false;
+    }
+    QVector<LayoutModel> models = parseLayoutOutput(layoutText);
+    int spriteCount = 0;
+    for (const auto& model : models) {
+        for (const auto& sprite : model.sprites) {
+            // Sprites moved or deleted since the save; let the packer build the layout.
+            if (!sprite || !QFileInfo::exists(sprite->path)) {
+                return false;
+            }
+            ++spriteCount;
+        }
+    }
+    if (spriteCount == 0) {
+        return false;
+    }
+
+    qInfo() << "[Layout] Showing cached layout," << spriteCount << "sprites";
+    m_validatingCachedLayout = true;
+    m_oldSpritePositions.clear();
+    m_oldSpritePackedRects.clear();
+    m_oldSpriteRotated.clear();
+    applyLayoutOutput(layoutText, std::move(models));
+    return true;
+}
+
+// --- applyLayoutOutput ---
+
+QVector<LayoutModel> LayoutOrchestrator::parseLayoutOutput(const QString& layoutText) const {
     QElapsedTimer parseTimer;
     parseTimer.start();
 
     const QString parserFolder = m_cfg.context ? m_cfg.context->layoutParserFolder() : QString();
-    QVector<LayoutModel> newModels = LayoutParser::parse(layoutText, parserFolder,
-                                                         m_cfg.session->currentFolder);
+    QVector<LayoutModel> models = LayoutParser::parse(layoutText, parserFolder,
+                                                      m_cfg.session->currentFolder);
     qInfo() << "[Layout] LayoutParser::parse done"
-            << "models=" << newModels.size()
+            << "models=" << models.size()
             << "ms=" << parseTimer.elapsed();
+    return models;
+}
+
+void LayoutOrchestrator::applyLayoutOutput(const QString& layoutText, QVector<LayoutModel> newModels) {
     if (newModels.isEmpty()) {
         newModels.append(LayoutModel());
     }
 
     m_cfg.session->cachedLayoutOutput = layoutText;
     m_cfg.session->cachedLayoutScale = newModels.first().scale;
+    m_cfg.session->touch();
 
     const bool forceCenter = m_centerPivotsOnNextLayout;
     m_centerPivotsOnNextLayout = false;
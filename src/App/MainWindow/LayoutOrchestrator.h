@@ -70,6 +70,10 @@ public:
     void stop();
     void resetDebounceTimer(); // Restarts debounce timer if it was running (called on user interaction)
     void stopAndClearPending(); // Stops the runner and clears any pending run
+    // Draws the session's cached layout output without running the packer. The next
+    // run validates it and only redraws when its output differs. Returns false when
+    // there is no usable cache (empty, or sprites missing on disk).
+    bool showCachedLayout();
 
     bool isDirty() const { return m_layoutDirty; }
     int  layoutGeneration() const { return m_layoutGeneration; }
@@ -105,6 +109,8 @@ private slots:
 
 private:
     LayoutRunConfig buildConfig() const;
+    QVector<LayoutModel> parseLayoutOutput(const QString& layoutText) const;
+    void applyLayoutOutput(const QString& layoutText, QVector<LayoutModel> newModels);
     void handleProfileFailure(const QString& failedProfile);
     void handleDimensionsError(const QString& failedProfile);
     bool isProfileEnabled(const QString& profile) const;
@@ -134,6 +140,7 @@ private:
     bool                        m_layoutFailureDialogShown   = false;
     QStringList                 m_profilesTriedForCurrentLoad;
     bool                        m_centerPivotsOnNextLayout   = false;
+    bool                        m_validatingCachedLayout     = false;
     QString                     m_currentProfile;
     QString                     m_currentResolution;
 
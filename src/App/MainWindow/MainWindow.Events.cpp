@@ -3,6 +3,7 @@
 #include "LayoutCanvas.h"
 #include "LayoutOrchestrator.h"
 #include "ImportPathSupport.h"
+#include "ProjectFileLoader.h"
 
 #include <QDir>
 #include <QDragEnterEvent>
@@ -94,9 +95,9 @@ bool MainWindow::tryHandleDroppedPath(const QString& path, DropAction action) {
     QFileInfo info(path);
     QPixmapCache::clear();
     if (info.isDir()) {
-        QDir dir(path);
-        if (dir.exists("project.spart.json")) {
-            loadProject(dir.filePath("project.spart.json"), action);
+        const QString projectFile = ProjectFileLoader::projectFileIn(path);
+        if (QFileInfo::exists(projectFile)) {
+            loadProject(projectFile, action);
         } else {
             loadFolder(path, action);
         }
@@ -389,6 +389,7 @@ void MainWindow::handleSingleImageLayout(const QString& imagePath, DropAction ac
 
     // Apply the model to the canvas
     m_session->activeAtlas().layoutModels = { singleImageModel };
+    m_session->payloadCache.markAllSpritesDirty();
     AnimationPreviewService::invalidateSpriteMap();
     ensureUniqueSpriteNames(m_session->activeAtlas().layoutModels, m_session->sourceFolder);
     auto* canvas = m_atlasWorkspace ? m_atlasWorkspace->canvas() : nullptr;
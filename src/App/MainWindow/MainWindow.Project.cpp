@@ -17,6 +17,8 @@
 #include "FrameAnimationWorkspace.h"
 
 #include "ArchiveExtractor.h"
+#include "AppConstants.h"
+#include "AutosaveJournal.h"
 #include "AutosaveProjectStore.h"
 #include "ImageDiscoveryService.h"
 #include "ImageFolderSelectionDialog.h"
@@ -193,6 +195,11 @@ void MainWindow::loadAutosavedProject() {
         m_statusLabel->setText(error);
         return;
     }
+    // Edits made after the snapshot live in the journal; bring the payload up to date.
+    const int replayed = AutosaveJournal::replay(m_autosaveJournal.path(), root);
+    if (replayed > 0) {
+        qInfo() << "[Autosave] Replayed" << replayed << "journal records";
+    }
     QJsonObject layoutOpts = root["layout_options"].toObject();
     int sourceResolutionWidth = 0;
     int sourceResolutionHeight = 0;
@@ -253,6 +260,8 @@ void MainWindow::loadAutosavedProject() {
         }
         updateFolderLabel(folder);
     }
+    // Draw the saved layout at once; the run below only validates it.
+    if (m_layoutOrchestrator) m_layoutOrchestrator->showCachedLayout();
     scheduleLayoutRebuild(true);
 }
 
@@ -272,9 +281,9 @@ void MainWindow::onLoadProject() {
     picker.exec();
 
     if (picker.clickedButton() == projectFileButton) {
-        const QString filter = tr("Project Files (project.spart.json *.json);;"
+        const QString filter = tr("Project Files (project.spart.json project.spart.cbor *.json *.cbor);;"
                                   "ZIP Projects (*.zip);;"
-                                  "All Supported Files (*.json *.zip)");
+                                  "All Supported Files (*.json *.cbor *.zip)");
         const QString file = QFileDialog::getOpenFileName(this, tr("Load Project File"), "", filter);
         if (!file.isEmpty()) {
             loadProject(file);
@@ -287,12 +296,12 @@ void MainWindow::onLoadProject() {
         if (folder.isEmpty()) {
             return;
         }
-        const QString projectFile = QDir(folder).filePath("project.spart.json");
+        const QString projectFile = ProjectFileLoader::projectFileIn(folder);
         if (!QFileInfo::exists(projectFile)) {
             MessageDialog::warning(
                 this,
                 tr("Load Failed"),
-                tr("The selected folder does not contain a project.spart.json file."));
+                tr("The selected folder does not contain a project.spart.json or project.spart.cbor file."));
             return;
         }
         loadProject(projectFile);
@@ -614,11 +623,18 @@ void MainWindow::onSaveClicked() {
     }
     const QString projectDir = QFileInfo(projectFilePath).absolutePath();
     QString error;
-    if (!ProjectSaveService::writeProjectJson(projectDir, buildProjectPayload(m_lastSaveConfig, m_session, true), error)) {
+    if (!ProjectSaveService::writeProjectFile(projectDir, buildProjectPayloadInput(m_lastSaveConfig, m_session, true),
+                                              m_settings.saveProjectAsCbor, error)) {
         m_statusLabel->setText(tr("Save failed: ") + error);
         MessageDialog::critical(this, tr("Save Failed"), error);
         return;
     }
+    // Switching the project encoding renames the file; follow it.
+    const QString savedFilePath = QDir(projectDir).filePath(ProjectFileLoader::projectFileName(m_settings.saveProjectAsCbor));
+    if (savedFilePath != projectFilePath) {
+        m_projectController->setProjectFilePath(savedFilePath);
+        addToRecentProjects(savedFilePath);
+    }
     if (m_lastSaveConfig.syncSprites) {
         syncNewSpritesToProjectFolder(projectDir);
     }
@@ -715,7 +731,7 @@ void MainWindow::onSaveAsClicked() {
         m_lastSaveConfig.syncSprites = cb->isChecked();
     }
 
-    const QString newProjectFilePath = QDir(projectDir).filePath("project.spart.json");
+    const QString newProjectFilePath = QDir(projectDir).filePath(ProjectFileLoader::projectFileName(m_settings.saveProjectAsCbor));
     if (m_projectController) m_projectController->setProjectFilePath(newProjectFilePath);
     m_lastSaveConfig.destination = projectDir;
 
@@ -727,7 +743,8 @@ void MainWindow::onSaveAsClicked() {
     setWindowTitle(tr("%1 — %2[*]").arg(folderName, projectDir));
 
     QString error;
-    if (!ProjectSaveService::writeProjectJson(projectDir, buildProjectPayload(m_lastSaveConfig, m_session, true), error)) {
+    if (!ProjectSaveService::writeProjectFile(projectDir, buildProjectPayloadInput(m_lastSaveConfig, m_session, true),
+                                              m_settings.saveProjectAsCbor, error)) {
         m_statusLabel->setText(tr("Save failed: ") + error);
         MessageDialog::critical(this, tr("Save Failed"), error);
         return;
@@ -826,6 +843,8 @@ void MainWindow::onExportWorkspaceRequested(SaveConfig config) {
         return;
 
     m_lastSaveConfig = config;
+    if (m_atlasWorkspace)
+        m_atlasWorkspace->spriteEditorPanel()->previewCanvas()->setMeshVertexBudget(config.meshVertexBudget);
     switchWorkspace(m_atlasWorkspace);
     updateUiState();  // enables Export action now that outputPath is set
     if (m_exportCoordinator) m_exportCoordinator->runExport(m_lastSaveConfig);
@@ -836,6 +855,10 @@ bool MainWindow::runExport(SaveConfig config) {
 }
 
 QJsonObject MainWindow::buildProjectPayload(SaveConfig config, ProjectSession* session, bool portable) {
+    return ProjectPayloadCodec::build(buildProjectPayloadInput(std::move(config), session, portable));
+}
+
+ProjectPayloadBuildInput MainWindow::buildProjectPayloadInput(SaveConfig config, ProjectSession* session, bool portable) {
     ProjectPayloadBuildInput input;
     input.currentFolder = session->currentFolder;
     input.sourceFolder = session->sourceFolder;
@@ -905,7 +928,8 @@ QJsonObject MainWindow::buildProjectPayload(SaveConfig config, ProjectSession* s
     input.portablePaths = portable;
     input.exportPresets   = m_exportPresets;
     input.markerTemplates = m_atlasWorkspace ? m_atlasWorkspace->markerRepository()->markerTemplates() : QVector<MarkerTemplate>{};
-    return ProjectPayloadCodec::build(input);
+    input.payloadCache = &session->payloadCache;
+    return input;
 }
 
 QString MainWindow::getAutosaveFilePath() const {
@@ -913,15 +937,160 @@ QString MainWindow::getAutosaveFilePath() const {
 }
 
 void MainWindow::autosaveProject() {
-    if (m_session->currentFolder.isEmpty() || m_isLoading) {
+    if (m_session->currentFolder.isEmpty() || m_isLoading || m_autosaveInFlight) {
+        return;
+    }
+    const quint64 generation = m_session->generation();
+    if (generation == m_autosaveGeneration && m_autosaveJournal.isOpen() && !m_autosaveSnapshotPending) {
+        return;
+    }
+
+    // Gather the input here (it reads widgets), then encode and write it off the GUI thread.
+    ProjectPayloadBuildInput input = buildProjectPayloadInput(m_lastSaveConfig, m_session, /*portable=*/true);
+    AutosaveProjectStore::detachSprites(input);
+    m_autosaveSnapshotPending = false;
+    m_autosaveInFlight = true;
+    m_autosaveInFlightGeneration = generation;
+    // Queued records are part of this snapshot; records queued from now on go to its journal.
+    m_autosaveJournal.clearPending();
+
+    const QString path = getAutosaveFilePath();
+#ifdef Q_OS_WASM
+    // QtConcurrent can be unreliable without pthreads/COOP+COEP; run synchronously
+    finishAutosave(AutosaveProjectStore::write(path, input));
+#else
+    m_autosaveWatcher.setFuture(QtConcurrent::run([path, input = std::move(input)]() {
+        return AutosaveProjectStore::write(path, input);
+    }));
+#endif
+}
+
+void MainWindow::finishAutosave(const AutosaveWriteResult& result) {
+    m_autosaveInFlight = false;
+    QString error = result.error;
+    if (!result.ok || !m_autosaveJournal.reset(result.writtenAt, error)) {
+        // The previous snapshot is intact but no longer matches the journal; snapshot again.
+        m_autosaveJournal.close();
+        m_autosaveSnapshotPending = true;
+        m_statusLabel->setText(error);
+        return;
+    }
+    m_autosaveGeneration = m_autosaveInFlightGeneration;
+    m_statusLabel->setText(tr("Autosaved project"));
+    if (m_autosaveJournal.pendingCount() > 0 && m_autosaveJournalTimer && !m_autosaveJournalTimer->isActive()) {
+        m_autosaveJournalTimer->start();
+    }
+}
+
+void MainWindow::recordAutosaveJournal(const QJsonObject& record) {
+    if (m_isLoading || m_isRestoringProject || m_session->currentFolder.isEmpty()) {
+        return;
+    }
+    m_session->touch();
+    m_autosaveJournal.record(record);
+    if (m_autosaveJournalTimer && !m_autosaveJournalTimer->isActive()) {
+        m_autosaveJournalTimer->start();
+    }
+}
+
+void MainWindow::requestAutosaveSnapshot() {
+    // Whatever changed was not journalled sprite by sprite; encode every sprite state again.
+    m_session->payloadCache.markAllSpritesDirty();
+    if (m_isLoading || m_isRestoringProject || m_session->currentFolder.isEmpty()) {
         return;
     }
+    m_session->touch();
+    m_autosaveSnapshotPending = true;
+    if (m_autosaveJournalTimer && !m_autosaveJournalTimer->isActive()) {
+        m_autosaveJournalTimer->start();
+    }
+}
+
+void MainWindow::journalUndoStep(int index) {
+    m_session->touch();
+    const int previous = m_lastJournaledUndoIndex;
+    m_lastJournaledUndoIndex = index;
+    if (!m_undoStack) {
+        return;
+    }
+    // Push and redo move the index forward, undo moves it back; a merge keeps it in place.
+    // setIndex() and clean-state jumps cross several commands at once, and each of them
+    // changed the project.
+    const int first = index == previous ? index - 1 : qMin(index, previous);
+    const int end = index == previous ? index : qMax(index, previous);
+    for (int i = first; i < end; ++i) {
+        journalUndoCommand(m_undoStack->command(i));
+    }
+}
+
+void MainWindow::journalUndoCommand(const QUndoCommand* command) {
+    if (!command) {
+        return;
+    }
+
+    const QDir currentDir(m_session->currentFolder);
+    const QVector<AnimationTimeline>* timelines = nullptr;
+    switch (command->id()) {
+    case 1001:
+        for (const SpritePtr& sprite : static_cast<const SetPivotCommand*>(command)->sprites()) {
+            if (!sprite) continue;
+            m_session->payloadCache.markSpriteDirty(sprite->path);
+            recordAutosaveJournal(AutosaveJournal::pivotRecord(
+                ProjectPayloadCodec::spriteStateKey(currentDir, sprite->path), sprite->pivotX, sprite->pivotY));
+        }
+        return;
+    case 1009:
+        for (const SpritePtr& sprite : static_cast<const SetMarkersCommand*>(command)->sprites()) {
+            if (!sprite) continue;
+            m_session->payloadCache.markSpriteDirty(sprite->path);
+            recordAutosaveJournal(AutosaveJournal::markersRecord(
+                ProjectPayloadCodec::spriteStateKey(currentDir, sprite->path),
+                ProjectPayloadCodec::buildSpriteState(*sprite).value("markers").toArray()));
+        }
+        return;
+    case 1002: timelines = static_cast<const TimelineFrameDropCommand*>(command)->timelines(); break;
+    case 1003: timelines = static_cast<const TimelineFrameMoveCommand*>(command)->timelines(); break;
+    case 1004: timelines = static_cast<const TimelineFrameRemoveCommand*>(command)->timelines(); break;
+    case 1005: timelines = static_cast<const TimelineFrameDuplicateCommand*>(command)->timelines(); break;
+    case 1006: timelines = static_cast<const TimelineAddCommand*>(command)->timelines(); break;
+    case 1007: timelines = static_cast<const TimelinesUpdateCommand*>(command)->timelines(); break;
+    case 1008: timelines = static_cast<const TimelineRemoveCommand*>(command)->timelines(); break;
+    case 1016: timelines = static_cast<const SetTimelineNameCommand*>(command)->timelines(); break;
+    case 1017: timelines = static_cast<const SetTimelineFpsCommand*>(command)->timelines(); break;
+    case 1022: timelines = static_cast<const SetTimelineFlipCommand*>(command)->timelines(); break;
+    default:
+        requestAutosaveSnapshot();
+        return;
+    }
+
+    for (const AtlasEntry& atlas : m_session->atlases) {
+        if (&atlas.timelines == timelines) {
+            m_session->payloadCache.markTimelinesDirty(atlas.id);
+            recordAutosaveJournal(AutosaveJournal::timelinesRecord(
+                atlas.id, ProjectPayloadCodec::buildTimelines(atlas.timelines)));
+            return;
+        }
+    }
+    requestAutosaveSnapshot();
+}
 
+void MainWindow::onAutosaveJournalTimer() {
+    if (m_autosaveInFlight) {
+        // The journal is rebound when the snapshot lands; flush after that.
+        m_autosaveJournalTimer->start();
+        return;
+    }
+    const bool snapshotDue = m_autosaveSnapshotPending || !m_autosaveJournal.isOpen()
+        || m_autosaveJournal.recordCount() + m_autosaveJournal.pendingCount()
+               >= AppConstants::kAutosaveJournalSnapshotRecords;
+    if (snapshotDue) {
+        autosaveProject();
+        return;
+    }
     QString error;
-    if (AutosaveProjectStore::save(getAutosaveFilePath(), buildProjectPayload(m_lastSaveConfig, m_session, /*portable=*/true), error)) {
-        m_statusLabel->setText(tr("Autosaved project"));
-    } else {
+    if (!m_autosaveJournal.flush(error)) {
         m_statusLabel->setText(error);
+        requestAutosaveSnapshot();
     }
 }
 
@@ -938,7 +1107,7 @@ void MainWindow::loadProject(const QString& path, DropAction action) {
 
     const QString lowerPath = path.toLower();
 
-    // ZIP files: try loading as a project first (checks for project.spart.json).
+    // ZIP files: try loading as a project first (checks for project.spart.cbor or .json).
     // If that fails, onProjectLoadFinished falls back to loadImagesFromZip.
     // Other archive formats and images are delegated directly.
     if (lowerPath.endsWith(".tar") || lowerPath.endsWith(".tar.gz") ||
@@ -1146,6 +1315,8 @@ void MainWindow::processProjectLoadResult(const ProjectController::ProjectLoadRe
                 }
                 updateFolderLabel(folder);
             }
+            // Draw the saved layout at once; the run below only validates it.
+            if (m_layoutOrchestrator) m_layoutOrchestrator->showCachedLayout();
             scheduleLayoutRebuild(true);
         }
     } else {
@@ -1513,6 +1684,8 @@ void MainWindow::applyProjectPayload() {
     m_lastSaveConfig = applied.saveConfig;
     if (m_atlasesManagementWorkspace)
         m_atlasesManagementWorkspace->setProfilesGlobal(m_lastSaveConfig.profilesGlobal);
+    if (m_atlasWorkspace)
+        m_atlasWorkspace->spriteEditorPanel()->previewCanvas()->setMeshVertexBudget(m_lastSaveConfig.meshVertexBudget);
     m_exportPresets   = applied.exportPresets;
     if (m_atlasWorkspace)
         m_atlasWorkspace->markerRepository()->setMarkerTemplates(applied.markerTemplates);
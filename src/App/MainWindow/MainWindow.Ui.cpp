@@ -16,6 +16,9 @@
 #include "AnimationCanvas.h"
 #include "CliToolsConfig.h"
 #include "AppConstants.h"
+#include "ProjectPayloadCodec.h"
+#include "AtlasPartitioner.h"
+#include "MessageDialog.h"
 #include <QDockWidget>
 
 #include <QAction>
@@ -48,6 +51,7 @@
 #include <QVBoxLayout>
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QImageReader>
 #include <QFontDatabase>
 #include <algorithm>
 #include <QPlainTextEdit>
@@ -60,6 +64,7 @@
 #include <QMessageBox>
 #include "NavigatorTreeWidget.h"
 #include "SpriteTreeUtils.h"
+#include <QHash>
 #include <QUuid>
 
 void MainWindow::setupUi() {
@@ -154,6 +159,7 @@ void MainWindow::setupUi() {
                     } else if (sessionAtlasIndex < m_session->atlases.size()) {
                         models = m_session->atlases[sessionAtlasIndex].layoutModels;
                     }
+                    m_exportWorkspace->setLayoutModels(models);
                     m_exportLayoutCanvas->setModels(models);
                     m_exportLayoutCanvas->setZoomManual(false);
                     m_exportLayoutCanvas->initialFit();
@@ -210,6 +216,7 @@ void MainWindow::setupUi() {
                 newAtlas.id   = QUuid::createUuid().toString(QUuid::WithoutBraces);
                 newAtlas.name = tr("Atlas %1").arg(m_session->atlases.size());
                 m_session->atlases.append(newAtlas);
+                requestAutosaveSnapshot();
                 emit m_session->atlasesChanged();
                 m_atlasesManagementWorkspace->setAtlases(
                     m_session->atlases, m_session->activeAtlasIndex);
@@ -220,6 +227,7 @@ void MainWindow::setupUi() {
                 m_session->atlases[index].name = newName;
                 m_session->atlases[index].outputSubdir =
                     newName.toLower().replace(QLatin1Char(' '), QLatin1Char('_'));
+                requestAutosaveSnapshot();
                 emit m_session->atlasesChanged();
                 m_atlasesManagementWorkspace->setAtlases(
                     m_session->atlases, m_session->activeAtlasIndex);
@@ -238,6 +246,7 @@ void MainWindow::setupUi() {
                 m_session->atlases.remove(index);
                 m_session->activeAtlasIndex = qBound(0, m_session->activeAtlasIndex,
                                                       m_session->atlases.size() - 1);
+                requestAutosaveSnapshot();
                 emit m_session->atlasesChanged();
                 m_atlasesManagementWorkspace->setAtlases(
                     m_session->atlases, m_session->activeAtlasIndex);
@@ -273,6 +282,7 @@ void MainWindow::setupUi() {
                 newAtlas.outputSubdir = groupName.toLower().replace(QLatin1Char(' '), QLatin1Char('_'));
                 m_session->atlases.append(newAtlas);
                 moveAtlasSprites(paths, srcIdx, m_session->atlases.size() - 1);
+                requestAutosaveSnapshot();
                 emit m_session->atlasesChanged();
                 m_atlasesManagementWorkspace->setAtlases(m_session->atlases, m_session->activeAtlasIndex);
             });
@@ -289,9 +299,12 @@ void MainWindow::setupUi() {
                     m_session->atlases.append(newAtlas);
                     moveAtlasSprites(paths, srcIdx, m_session->atlases.size() - 1);
                 }
+                requestAutosaveSnapshot();
                 emit m_session->atlasesChanged();
                 m_atlasesManagementWorkspace->setAtlases(m_session->atlases, m_session->activeAtlasIndex);
             });
+    connect(m_atlasesManagementWorkspace, &AtlasesManagementWorkspace::splitByAnimationsRequested,
+            this, &MainWindow::splitAtlasByAnimations);
     connect(m_atlasesManagementWorkspace, &AtlasesManagementWorkspace::atlasSelected,
             this, [this](int index) {
                 if (!m_session || index < 0 || index >= m_session->atlases.size()) return;
@@ -817,7 +830,7 @@ void MainWindow::setupToolbar() {
     m_loadProjectAction = fileMenu->addAction(
         style->standardIcon(QStyle::SP_DialogOpenButton), tr("Load..."));
     m_loadProjectAction->setToolTip(
-        tr("Load a project.spart.json file or a project folder containing that file"));
+        tr("Load a project.spart.json or project.spart.cbor file, or a project folder containing one"));
     connect(m_loadProjectAction, &QAction::triggered, this, &MainWindow::onLoadProject);
 
     m_loadAction = fileMenu->addAction(
@@ -870,12 +883,15 @@ void MainWindow::setupToolbar() {
         style->standardIcon(QStyle::SP_ArrowBack), tr("&Undo"));
     undoAction->setIcon(style->standardIcon(QStyle::SP_ArrowBack));
     undoAction->setShortcut(QKeySequence::Undo);
-    undoAction->setEnabled(m_undoStack->canUndo());
+    undoAction->setEnabled(UndoHistoryBudget::canUndo(m_undoStack));
     connect(undoAction, &QAction::triggered, this, [this]() {
         if (m_atlasWorkspace) m_atlasWorkspace->clearCoordinateOverride();
-        m_undoStack->undo();
+        UndoHistoryBudget::undo(m_undoStack);
+    });
+    // Steps released by the history budget stay on the stack but can no longer be undone.
+    connect(m_undoStack, &QUndoStack::indexChanged, undoAction, [this, undoAction](int) {
+        undoAction->setEnabled(UndoHistoryBudget::canUndo(m_undoStack));
     });
-    connect(m_undoStack, &QUndoStack::canUndoChanged, undoAction, &QAction::setEnabled);
 
     QAction* redoAction = editMenu->addAction(
         style->standardIcon(QStyle::SP_ArrowForward), tr("&Redo"));
@@ -1717,4 +1733,130 @@ void MainWindow::moveAtlasSprites(const QStringList& paths, int srcIdx, int tgtI
         }
         model.sprites = std::move(kept);
     }
+
+    if (srcIdx == excIdx || tgtIdx == excIdx) {
+        // Exclusion also edits sources and the frame list, which the journal does not track.
+        requestAutosaveSnapshot();
+    } else {
+        const QString spBase = m_session->sourceFolder.isEmpty() ? m_session->currentFolder : m_session->sourceFolder;
+        const QDir spBaseDir(spBase);
+        QStringList journalPaths;
+        for (const QString& norm : movedNorm) {
+            journalPaths.append(spBase.isEmpty() ? norm : ProjectPayloadCodec::portableSpritePath(spBaseDir, norm));
+        }
+        recordAutosaveJournal(AutosaveJournal::spritesMovedRecord(journalPaths, src.id, tgt.id));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Atlas partitioning by animation
+// ---------------------------------------------------------------------------
+
+void MainWindow::splitAtlasByAnimations(int atlasIndex)
+{
+    if (!m_session || atlasIndex < 0 || atlasIndex >= m_session->atlases.size()) return;
+    const AtlasEntry source = m_session->atlases[atlasIndex];
+
+    // Pages are sized like the selected profile's; unbounded profiles use the current pages.
+    SpratProfile profile;
+    const QString profileName = m_atlasesManagementWorkspace->selectedProfile();
+    for (const SpratProfile& p : configuredProfiles()) {
+        if (p.name.trimmed() == profileName) {
+            profile = p;
+            break;
+        }
+    }
+    QSize pageSize(profile.maxWidth, profile.maxHeight);
+    if (pageSize.width() <= 0 || pageSize.height() <= 0) {
+        pageSize = QSize();
+        for (const LayoutModel& model : source.layoutModels)
+            pageSize = pageSize.expandedTo(QSize(model.atlasWidth, model.atlasHeight));
+        if (pageSize.isEmpty()) pageSize = QSize(2048, 2048);
+    }
+
+    // Sizes are in the layout's atlas pixels, like the page size: placed sprites use
+    // their rect, and sprites the layout has not placed yet are read and scaled to match.
+    double layoutScale = source.layoutModels.isEmpty() ? 1.0 : source.layoutModels.first().scale;
+    if (layoutScale <= 0.0) layoutScale = 1.0;
+    QHash<QString, QPair<QSize, int>> placed;
+    for (int page = 0; page < source.layoutModels.size(); ++page) {
+        for (const SpritePtr& sprite : source.layoutModels[page].sprites)
+            placed.insert(QFileInfo(sprite->path).absoluteFilePath(), {sprite->rect.size(), page});
+    }
+    QVector<AtlasPartitioner::Sprite> sprites;
+    sprites.reserve(source.spritePaths.size());
+    for (const QString& path : source.spritePaths) {
+        const QString norm = QFileInfo(path).absoluteFilePath();
+        const auto it = placed.constFind(norm);
+        if (it != placed.cend()) {
+            sprites.append({norm, it->first, it->second});
+            continue;
+        }
+        QSize size = QImageReader(norm).size();
+        if (size.isValid())
+            size = QSize(qMax(1, qRound(size.width() * layoutScale)),
+                         qMax(1, qRound(size.height() * layoutScale)));
+        sprites.append({norm, size, -1});
+    }
+    QVector<AnimationTimeline> timelines = source.timelines;
+    for (AnimationTimeline& timeline : timelines) {
+        for (QString& frame : timeline.frames) frame = QFileInfo(frame).absoluteFilePath();
+    }
+
+    const AtlasPartitioner::Result result =
+        AtlasPartitioner::partition(sprites, timelines, pageSize, profile.padding);
+    const AtlasPartitioner::Assignment assignment = AtlasPartitioner::assignTimelines(result, timelines);
+    if (assignment.pages.size() <= 1) {
+        MessageDialog::information(this, tr("Split by animations"),
+            tr("All sprites of \"%1\" fit one %2x%3 page; there is nothing to split.")
+                .arg(source.name).arg(pageSize.width()).arg(pageSize.height()));
+        return;
+    }
+
+    QStringList report;
+    for (const AtlasPartitioner::TimelinePages& t : result.timelines) {
+        const QString before = t.pagesBefore > 0 ? QString::number(t.pagesBefore) : tr("not laid out");
+        report << tr("%1: %2 → %3").arg(t.name, before).arg(t.pagesAfter);
+    }
+    QString text = tr("Split \"%1\" into %2 atlases of up to %3x%4 so each animation stays on "
+                      "as few pages as possible?\n\nPages touched per animation:\n%5")
+        .arg(source.name).arg(assignment.pages.size()).arg(pageSize.width()).arg(pageSize.height())
+        .arg(report.join(QLatin1Char('\n')));
+    if (!assignment.spanningTimelines.isEmpty()) {
+        text += tr("\n\nThese animations do not fit one page and stay in \"%1\" with all their "
+                   "frames, so it may still need several pages:\n%2")
+            .arg(source.name, assignment.spanningTimelines.join(QLatin1Char('\n')));
+    }
+    if (MessageDialog::question(this, tr("Split by animations"), text,
+                                QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes) != QMessageBox::Yes)
+        return;
+
+    // The first page stays in the atlas; each other page becomes a new atlas, taking the
+    // timelines (and their aliases) whose frames all landed on it.
+    const bool sourceFolderIsTemp = m_projectController && m_projectController->isSourceFolderTemp();
+    const ProjectSession::SessionState before = m_session->captureState(sourceFolderIsTemp);
+    m_session->payloadCache.markTimelinesDirty(source.id);
+    QVector<AnimationTimeline> kept;
+    QVector<QVector<AnimationTimeline>> moved(assignment.pages.size());
+    for (int t = 0; t < source.timelines.size(); ++t) {
+        const int page = assignment.timelinePages.at(t);
+        (page == 0 ? kept : moved[page]).append(source.timelines.at(t));
+    }
+    m_session->atlases[atlasIndex].timelines = kept;
+    for (int page = 1; page < assignment.pages.size(); ++page) {
+        AtlasEntry newAtlas;
+        newAtlas.id           = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        newAtlas.name         = QStringLiteral("%1 %2").arg(source.name).arg(page + 1);
+        newAtlas.outputSubdir = newAtlas.name.toLower().replace(QLatin1Char(' '), QLatin1Char('_'));
+        newAtlas.exportConfig = source.exportConfig;
+        newAtlas.timelines    = moved[page];
+        m_session->atlases.append(newAtlas);
+        moveAtlasSprites(assignment.pages[page], atlasIndex, m_session->atlases.size() - 1);
+    }
+    m_undoStack->push(new SessionUndoCommand(this, m_session, tr("Split by animations"), before,
+                                             m_session->captureState(sourceFolderIsTemp), true));
+    requestAutosaveSnapshot();
+    emit m_session->atlasesChanged();
+    emit m_session->timelinesChanged();
+    m_atlasesManagementWorkspace->setAtlases(m_session->atlases, m_session->activeAtlasIndex);
 }
@@ -822,7 +822,7 @@ void MainWindow::syncLayoutToGif(const ProjectSource& src,
             bool ok = AnimationExportService::exportAnimation(
                 {tl}, 0, layoutModels, fps, outPath, cbs);
             if (!ok)
-                *errorOut = QStringLiteral("GIF export failed (ImageMagick required).");
+                *errorOut = QStringLiteral("GIF export failed.");
             return ok;
         }));
 }
@@ -876,6 +876,10 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
             this, [this](bool clean) { setWindowModified(!clean); });
     connect(m_undoStack, &QUndoStack::indexChanged,
             this, [this](int) { if (m_atlasWorkspace) m_atlasWorkspace->refreshSpriteEditor(); });
+    connect(m_undoStack, &QUndoStack::indexChanged, this, &MainWindow::journalUndoStep);
+    connect(m_undoStack, &QUndoStack::indexChanged, this, [this](int) {
+        m_undoBudget.update(m_undoStack);
+    });
 
     setupUi();
     setupKeyboardShortcuts();
@@ -1120,6 +1124,10 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
         cfg.buildProjectPayload = [this](const SaveConfig& config, bool portable) {
             return buildProjectPayload(config, m_session, portable);
         };
+        cfg.buildExportMetadata = [this](const SaveConfig& config) {
+            const ProjectPayloadBuildInput input = buildProjectPayloadInput(config, m_session, true);
+            return ExportMetadataText::build(input.currentFolder, input.layoutModels, input.timelines);
+        };
         cfg.promoteSourceFolderAfterSave = [this](const QString& dest) {
             promoteSourceFolderAfterSave(dest);
         };
@@ -1222,6 +1230,13 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     // Autosave setup
     m_autosaveTimer = new QTimer(this);
     connect(m_autosaveTimer, &QTimer::timeout, this, &MainWindow::onAutosaveTimer);
+    m_autosaveJournalTimer = new QTimer(this);
+    m_autosaveJournalTimer->setSingleShot(true);
+    m_autosaveJournalTimer->setInterval(AppConstants::kAutosaveJournalFlushMs);
+    connect(m_autosaveJournalTimer, &QTimer::timeout, this, &MainWindow::onAutosaveJournalTimer);
+    connect(&m_autosaveWatcher, &QFutureWatcher<AutosaveWriteResult>::finished, this, [this]() {
+        finishAutosave(m_autosaveWatcher.result());
+    });
 
 #ifndef Q_OS_WASM
     // One-time Choose default projects folder on very first launch
@@ -1369,6 +1384,10 @@ MainWindow::~MainWindow() {
 
     if (m_autosaveTimer)
         m_autosaveTimer->stop();
+    if (m_autosaveJournalTimer)
+        m_autosaveJournalTimer->stop();
+    // Let a running autosave commit; its input is a detached copy, not the session.
+    m_autosaveWatcher.waitForFinished();
 
     if (m_session && !m_session->frameListPath.isEmpty()) {
         QFile::remove(m_session->frameListPath);
@@ -2316,7 +2335,10 @@ bool MainWindow::runTool(const QString& tool, const QStringList& args, const QBy
         return false;
     }
 #endif
+#if defined(SPRAT_EMBEDDED_CLI) || defined(Q_OS_WASM)
+    // The embedded tools run in-process and share global state; one at a time.
     QMutexLocker locker(&m_toolMutex);
+#endif
     QElapsedTimer timer;
     timer.start();
 
@@ -3165,7 +3187,7 @@ void MainWindow::showSyncNotification(const QString& message) {
 void MainWindow::onUndo() {
     if (!m_undoStack) return;
     if (m_atlasWorkspace) m_atlasWorkspace->clearCoordinateOverride();
-    m_undoStack->undo();
+    UndoHistoryBudget::undo(m_undoStack);
     if (m_atlasWorkspace) m_atlasWorkspace->refreshSpriteEditor();
 }
 
@@ -3258,7 +3280,7 @@ void MainWindow::onQuickStart() {
         "<li>Add a timeline, then drag sprites from the canvas into it. Reorder frames by dragging.</li>"
         "<li>Set the FPS and use play/pause/step controls to preview the animation.</li>"
         "<li>Right-click the preview to export as GIF, MP4, WebM, or other formats "
-        "(requires FFmpeg or ImageMagick).</li>"
+        "(GIF and APNG are built in; video formats require FFmpeg).</li>"
         "<li>Use <i>Auto-create timelines</i> (right-click in the Navigator) to generate "
         "animations automatically from naming patterns such as <tt>Run_0</tt>, <tt>Run_1</tt>, &hellip;</li>"
         "</ul>"
@@ -3266,7 +3288,8 @@ void MainWindow::onQuickStart() {
         "<h3>6 &mdash; Save</h3>"
         "<p><i>File &rarr; Save</i> (Ctrl+S) saves the full project state &mdash; layout options, "
         "sprite names, pivots, markers, timelines &mdash; to a <tt>.json</tt> file or a <tt>.zip</tt> "
-        "archive. The app autosaves every 5 minutes and offers to restore on next launch.</p>"
+        "archive. The app journals edits within seconds, writes a full autosave every 5 minutes, "
+        "and offers to restore on next launch.</p>"
 
         "<h3>7 &mdash; Exportation Workspace</h3>"
         "<p>Open from the toolbar (or use the quick <i>Export</i> button to re-export to the last "
@@ -3412,6 +3435,8 @@ void MainWindow::refreshUiAfterUndo() {
     refreshTimelineList();
     refreshTimelineFrames();
     refreshAnimationTest();
+    if (m_atlasesManagementWorkspace && m_session)
+        m_atlasesManagementWorkspace->setAtlases(m_session->atlases, m_session->activeAtlasIndex);
     auto* canvas = m_atlasWorkspace ? m_atlasWorkspace->canvas() : nullptr;
     if (canvas) canvas->update();
     auto* previewCanvas = m_atlasWorkspace ? m_atlasWorkspace->spriteEditorPanel()->previewCanvas() : nullptr;
@@ -15,11 +15,14 @@
 #include <QUndoStack>
 
 #include "SourceFolderWatcher.h"
+#include "AppConstants.h"
 #include "ProjectSession.h"
 #include "SpratProfilesConfig.h"
 #include "models.h"
 #include "DropAction.h"
 #include "SettingsDialog.h"
+#include "AutosaveJournal.h"
+#include "AutosaveProjectStore.h"
 
 // Forward declarations for Qt classes
 class QComboBox;
@@ -68,6 +71,7 @@ class CliSetupController;
 class LayoutCanvas;
 class ExportWorkspace;
 class FrameAnimationWorkspace;
+struct ProjectPayloadBuildInput;
 #include "ILayoutContext.h"
 #include "IWorkspace.h"
 #include "AtlasWorkspace.h"
@@ -186,14 +190,45 @@ private slots:
 
     /**
      * @brief Handles autosave of the current project.
+     *
+     * Skips the write when the session generation has not moved since the last
+     * snapshot; otherwise encodes and writes a detached copy on a worker thread.
      */
     void autosaveProject();
 
+    /**
+     * @brief Binds the journal to the snapshot written by the background autosave.
+     */
+    void finishAutosave(const AutosaveWriteResult& result);
+
     /**
      * @brief Handles loading of an autosaved project.
      */
     void loadAutosavedProject();
 
+    /**
+     * @brief Queues an edit record for the autosave journal and schedules a flush.
+     */
+    void recordAutosaveJournal(const QJsonObject& record);
+
+    /**
+     * @brief Makes the next journal flush write a full snapshot instead.
+     *
+     * Used for edits the journal cannot express (sources, sprite removal, atlas creation).
+     */
+    void requestAutosaveSnapshot();
+
+    /**
+     * @brief Journals every undo command crossed by an undo stack index change.
+     */
+    void journalUndoStep(int index);
+    void journalUndoCommand(const QUndoCommand* command);
+
+    /**
+     * @brief Flushes queued journal records, or writes a snapshot when one is due.
+     */
+    void onAutosaveJournalTimer();
+
     /**
      * @brief Handles save action from the user (silent, uses last destination).
      */
@@ -282,6 +317,7 @@ private slots:
      * @return QJsonObject Project payload
      */
     QJsonObject buildProjectPayload(SaveConfig config, ProjectSession* session, bool portable = false);
+    ProjectPayloadBuildInput buildProjectPayloadInput(SaveConfig config, ProjectSession* session, bool portable = false);
 
     /**
      * @brief Handles autosave timer timeout.
@@ -674,6 +710,10 @@ private:
      *  Does NOT emit atlasesChanged() or update the UI. */
     void moveAtlasSprites(const QStringList& paths, int srcIdx, int tgtIdx);
 
+    /** Regroups atlas @p atlasIndex with AtlasPartitioner after showing its per-timeline
+     *  page report; every page past the first becomes a new atlas. */
+    void splitAtlasByAnimations(int atlasIndex);
+
     // Navigator context menu helpers
     QStringList collectDescendantSpritePaths(QTreeWidgetItem* item) const;
     QString folderPathForTreeItem(QTreeWidgetItem* item) const;
@@ -948,6 +988,7 @@ private:
 
     // === Undo/Redo & Recent Projects ===
     QUndoStack* m_undoStack = nullptr;
+    UndoHistoryBudget::Tracker m_undoBudget{AppConstants::kUndoHistoryBudgetBytes};
     QStringList m_recentProjects;
 
     // === Export Presets ===
@@ -976,6 +1017,14 @@ private:
     // Project controller — owns async watcher state, project-file path, and source-management helpers
     ProjectController* m_projectController = nullptr;
     QTimer* m_autosaveTimer = nullptr;
+    QTimer* m_autosaveJournalTimer = nullptr;
+    AutosaveJournal m_autosaveJournal;
+    bool m_autosaveSnapshotPending = false;
+    int m_lastJournaledUndoIndex = 0;
+    QFutureWatcher<AutosaveWriteResult> m_autosaveWatcher;
+    bool m_autosaveInFlight = false;          // Until finishAutosave() has rebound the journal
+    quint64 m_autosaveGeneration = 0;         // Session generation of the last snapshot written
+    quint64 m_autosaveInFlightGeneration = 0; // Session generation captured by the running autosave
     QTimer* m_resizeDebounceTimer = nullptr;
     QSize m_pendingResizeSize;
     QSize m_pendingResizeOldSize;
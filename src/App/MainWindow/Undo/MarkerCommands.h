@@ -3,11 +3,12 @@
 #include <QVector>
 #include <functional>
 #include "../../../Core/SpriteModels.h"
+#include "UndoMemory.h"
 
 // ---------------------------------------------------------------------------
 // (1009) SetMarkersCommand
 // ---------------------------------------------------------------------------
-class SetMarkersCommand : public QUndoCommand {
+class SetMarkersCommand : public QUndoCommand, public UndoMemoryCost {
 public:
     struct CoTarget {
         SpritePtr sprite;
@@ -62,6 +63,26 @@ public:
         return true;
     }
 
+    QVector<SpritePtr> sprites() const {
+        QVector<SpritePtr> out{m_sprite};
+        for (const auto& target : m_coTargets) out.append(target.sprite);
+        return out;
+    }
+
+    qsizetype memoryCost() const override {
+        qsizetype total = UndoMemory::bytes(m_oldPoints) + UndoMemory::bytes(m_newPoints);
+        for (const auto& target : m_coTargets) {
+            total += UndoMemory::bytes(target.oldPoints) + UndoMemory::bytes(target.newPoints);
+        }
+        return total;
+    }
+
+    void releaseMemory() override {
+        m_oldPoints.clear();
+        m_newPoints.clear();
+        m_coTargets.clear();
+    }
+
 private:
     SpritePtr m_sprite;
     QVector<NamedPoint> m_oldPoints;
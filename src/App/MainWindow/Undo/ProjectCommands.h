@@ -11,6 +11,7 @@
 #include <algorithm>
 #include "../../../Core/models.h"
 #include "TrashBin.h"
+#include "UndoMemory.h"
 
 // ---------------------------------------------------------------------------
 // (1011) CreateGroupCommand
@@ -194,7 +195,7 @@ private:
 // ---------------------------------------------------------------------------
 // (1024) RemoveSourceCommand
 // ---------------------------------------------------------------------------
-class RemoveSourceCommand : public QUndoCommand {
+class RemoveSourceCommand : public QUndoCommand, public UndoMemoryCost {
 public:
     RemoveSourceCommand(
         QVector<ProjectSource>* sources,
@@ -309,6 +310,17 @@ public:
 
     int id() const override { return 1024; }
 
+    qsizetype memoryCost() const override {
+        return UndoMemory::bytes(m_savedActivePaths) + UndoMemory::bytes(m_savedTimelines)
+             + UndoMemory::bytes(m_savedLayoutModels);
+    }
+
+    void releaseMemory() override {
+        m_savedActivePaths.clear();
+        m_savedTimelines.clear();
+        m_savedLayoutModels.clear();
+    }
+
 private:
     QVector<ProjectSource>* m_sources;
     QVector<SmartFolder>* m_smartFolders;
@@ -337,7 +349,7 @@ private:
 // ---------------------------------------------------------------------------
 // (1021) ExcludeSpriteCommand
 // ---------------------------------------------------------------------------
-class ExcludeSpriteCommand : public QUndoCommand {
+class ExcludeSpriteCommand : public QUndoCommand, public UndoMemoryCost {
 public:
     ExcludeSpriteCommand(QVector<SmartFolder>* smartFolders,
                           int folderIndex,
@@ -418,6 +430,17 @@ public:
 
     int id() const override { return 1021; }
 
+    qsizetype memoryCost() const override {
+        return UndoMemory::bytes(m_savedActivePaths) + UndoMemory::bytes(m_savedTimelines)
+             + UndoMemory::bytes(m_savedLayoutModels);
+    }
+
+    void releaseMemory() override {
+        m_savedActivePaths.clear();
+        m_savedTimelines.clear();
+        m_savedLayoutModels.clear();
+    }
+
 private:
     QVector<SmartFolder>* m_smartFolders;
     int m_folderIndex;
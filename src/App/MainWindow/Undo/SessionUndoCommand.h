@@ -1,6 +1,7 @@
 #pragma once
 #include <QUndoCommand>
 #include "../../../Project/ProjectSession.h"
+#include "UndoMemory.h"
 
 // Forward declaration of MainWindow or a generic UI refresher
 class IMainWindowUndoHost {
@@ -12,8 +13,11 @@ public:
 
 // ---------------------------------------------------------------------------
 // SessionUndoCommand — bulk session state update
+//
+// Fields of the after-state that did not change share the before-state's data, so a
+// step only pays for what it edited.
 // ---------------------------------------------------------------------------
-class SessionUndoCommand : public QUndoCommand {
+class SessionUndoCommand : public QUndoCommand, public UndoMemoryCost {
 public:
     SessionUndoCommand(IMainWindowUndoHost* host,
                        ProjectSession* session,
@@ -27,7 +31,9 @@ public:
         , m_before(before)
         , m_after(after)
         , m_skipFirstRedo(alreadyApplied)
-    {}
+    {
+        shareUnchanged(m_after, m_before);
+    }
 
     void undo() override {
         m_session->applyState(m_before);
@@ -45,7 +51,93 @@ public:
         m_host->refreshUiAfterUndo();
     }
 
+    qsizetype memoryCost() const override {
+        return stateCost(m_before, nullptr) + stateCost(m_after, &m_before);
+    }
+
+    void releaseMemory() override {
+        m_before = ProjectSession::SessionState();
+        m_after = ProjectSession::SessionState();
+    }
+
 private:
+    static bool sameLayout(const QVector<LayoutModel>& a, const QVector<LayoutModel>& b) {
+        if (a.size() != b.size()) return false;
+        for (int i = 0; i < a.size(); ++i) {
+            if (a[i].atlasWidth != b[i].atlasWidth || a[i].atlasHeight != b[i].atlasHeight
+                || a[i].scale != b[i].scale || a[i].sprites != b[i].sprites) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool sameTimelines(const QVector<AnimationTimeline>& a,
+                              const QVector<AnimationTimeline>& b) {
+        if (a.size() != b.size()) return false;
+        for (int i = 0; i < a.size(); ++i) {
+            if (a[i].name != b[i].name || a[i].fps != b[i].fps || a[i].frames != b[i].frames
+                || a[i].aliasOf != b[i].aliasOf || a[i].hFlip != b[i].hFlip
+                || a[i].vFlip != b[i].vFlip) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename T>
+    static void shareIfEqual(T& target, const T& source) {
+        if (target == source) target = source;
+    }
+
+    static void shareUnchanged(ProjectSession::SessionState& after,
+                               const ProjectSession::SessionState& before) {
+        shareIfEqual(after.cachedLayoutOutput, before.cachedLayoutOutput);
+        shareIfEqual(after.activeFramePaths, before.activeFramePaths);
+        shareIfEqual(after.selectedSpritePaths, before.selectedSpritePaths);
+        if (after.atlases.size() != before.atlases.size()) return;
+        for (int i = 0; i < after.atlases.size(); ++i) {
+            AtlasEntry& atlas = after.atlases[i];
+            const AtlasEntry& old = before.atlases.at(i);
+            if (atlas.id != old.id) continue;
+            shareIfEqual(atlas.spritePaths, old.spritePaths);
+            if (sameTimelines(atlas.timelines, old.timelines)) {
+                atlas.timelines = old.timelines;
+            }
+            if (sameLayout(atlas.layoutModels, old.layoutModels)) {
+                atlas.layoutModels = old.layoutModels;
+            }
+        }
+    }
+
+    // The before-state is charged in full; the after-state only where it does not
+    // share data with it.
+    template <typename T>
+    static qsizetype fieldCost(const T& field, const T* shareable) {
+        if (shareable && field.constData() == shareable->constData()) return 0;
+        return UndoMemory::bytes(field, UndoMemory::Count::All);
+    }
+
+    static qsizetype stateCost(const ProjectSession::SessionState& state,
+                               const ProjectSession::SessionState* shareable) {
+        qsizetype total = fieldCost(state.cachedLayoutOutput,
+                                    shareable ? &shareable->cachedLayoutOutput : nullptr)
+                        + fieldCost(state.activeFramePaths,
+                                    shareable ? &shareable->activeFramePaths : nullptr)
+                        + fieldCost(state.selectedSpritePaths,
+                                    shareable ? &shareable->selectedSpritePaths : nullptr);
+        for (int i = 0; i < state.atlases.size(); ++i) {
+            const AtlasEntry& atlas = state.atlases.at(i);
+            const AtlasEntry* old = shareable && i < shareable->atlases.size()
+                ? &shareable->atlases.at(i) : nullptr;
+            total += qsizetype(sizeof(AtlasEntry))
+                   + fieldCost(atlas.spritePaths, old ? &old->spritePaths : nullptr)
+                   + fieldCost(atlas.timelines, old ? &old->timelines : nullptr)
+                   + fieldCost(atlas.layoutModels, old ? &old->layoutModels : nullptr);
+        }
+        return total;
+    }
+
     IMainWindowUndoHost* m_host;
     ProjectSession* m_session;
     ProjectSession::SessionState m_before;
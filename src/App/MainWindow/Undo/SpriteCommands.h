@@ -12,6 +12,7 @@
 #include "../../../Core/AnimationModels.h"
 #include "../../../Core/LayoutModels.h"
 #include "../AnimationPreviewService.h"
+#include "UndoMemory.h"
 
 // ---------------------------------------------------------------------------
 // (1001) SetPivotCommand
@@ -81,6 +82,12 @@ public:
         return true;
     }
 
+    QVector<SpritePtr> sprites() const {
+        QVector<SpritePtr> out{m_sprite};
+        for (const auto& target : m_coTargets) out.append(target.sprite);
+        return out;
+    }
+
 private:
     SpritePtr m_sprite;
     int m_oldX, m_oldY, m_newX, m_newY;
@@ -248,7 +255,7 @@ private:
 // ---------------------------------------------------------------------------
 // (1013) RemoveSpritesCommand
 // ---------------------------------------------------------------------------
-class RemoveSpritesCommand : public QUndoCommand {
+class RemoveSpritesCommand : public QUndoCommand, public UndoMemoryCost {
 public:
     RemoveSpritesCommand(QStringList* activeFramePaths,
                           QVector<AnimationTimeline>* timelines,
@@ -323,6 +330,17 @@ public:
 
     int id() const override { return 1014; }
 
+    qsizetype memoryCost() const override {
+        return UndoMemory::bytes(m_savedActivePaths) + UndoMemory::bytes(m_savedTimelines)
+             + UndoMemory::bytes(m_savedLayoutModels);
+    }
+
+    void releaseMemory() override {
+        m_savedActivePaths.clear();
+        m_savedTimelines.clear();
+        m_savedLayoutModels.clear();
+    }
+
 private:
     QStringList* m_activeFramePaths;
     QVector<AnimationTimeline>* m_timelines;
@@ -341,7 +359,7 @@ private:
 // ---------------------------------------------------------------------------
 // (1028) RemoveFramesCommand
 // ---------------------------------------------------------------------------
-class RemoveFramesCommand : public QUndoCommand {
+class RemoveFramesCommand : public QUndoCommand, public UndoMemoryCost {
 public:
     RemoveFramesCommand(QStringList* activeFramePaths,
                          QVector<AnimationTimeline>* timelines,
@@ -416,6 +434,17 @@ public:
 
     int id() const override { return 1028; }
 
+    qsizetype memoryCost() const override {
+        return UndoMemory::bytes(m_savedActivePaths) + UndoMemory::bytes(m_savedTimelines)
+             + UndoMemory::bytes(m_savedLayoutModels);
+    }
+
+    void releaseMemory() override {
+        m_savedActivePaths.clear();
+        m_savedTimelines.clear();
+        m_savedLayoutModels.clear();
+    }
+
 private:
     QStringList* m_activeFramePaths;
     QVector<AnimationTimeline>* m_timelines;
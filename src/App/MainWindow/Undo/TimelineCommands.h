@@ -6,6 +6,7 @@
 #include <functional>
 #include <QApplication>
 #include "../../../Core/AnimationModels.h"
+#include "UndoMemory.h"
 
 // ---------------------------------------------------------------------------
 // (1002) TimelineFrameDropCommand
@@ -44,6 +45,7 @@ public:
     }
 
     int id() const override { return 1002; }
+    const QVector<AnimationTimeline>* timelines() const { return m_timelines; }
 
 private:
     QVector<AnimationTimeline>* m_timelines;
@@ -94,6 +96,7 @@ public:
     }
 
     int id() const override { return 1003; }
+    const QVector<AnimationTimeline>* timelines() const { return m_timelines; }
 
 private:
     QVector<AnimationTimeline>* m_timelines;
@@ -145,6 +148,7 @@ public:
     }
 
     int id() const override { return 1004; }
+    const QVector<AnimationTimeline>* timelines() const { return m_timelines; }
 
 private:
     QVector<AnimationTimeline>* m_timelines;
@@ -192,6 +196,7 @@ public:
     }
 
     int id() const override { return 1005; }
+    const QVector<AnimationTimeline>* timelines() const { return m_timelines; }
 
 private:
     QVector<AnimationTimeline>* m_timelines;
@@ -243,6 +248,7 @@ public:
     }
 
     int id() const override { return 1006; }
+    const QVector<AnimationTimeline>* timelines() const { return m_timelines; }
 
 private:
     QVector<AnimationTimeline>* m_timelines;
@@ -256,7 +262,7 @@ private:
 // ---------------------------------------------------------------------------
 // (1007) TimelinesUpdateCommand
 // ---------------------------------------------------------------------------
-class TimelinesUpdateCommand : public QUndoCommand {
+class TimelinesUpdateCommand : public QUndoCommand, public UndoMemoryCost {
 public:
     TimelinesUpdateCommand(QVector<AnimationTimeline>* timelines,
                           const QVector<AnimationTimeline>& oldState,
@@ -296,6 +302,16 @@ public:
     }
 
     int id() const override { return 1007; }
+    const QVector<AnimationTimeline>* timelines() const { return m_timelines; }
+
+    qsizetype memoryCost() const override {
+        return UndoMemory::bytes(m_oldState) + UndoMemory::bytes(m_newState);
+    }
+
+    void releaseMemory() override {
+        m_oldState.clear();
+        m_newState.clear();
+    }
 
 private:
     QVector<AnimationTimeline>* m_timelines;
@@ -349,6 +365,7 @@ public:
     }
 
     int id() const override { return 1008; }
+    const QVector<AnimationTimeline>* timelines() const { return m_timelines; }
 
 private:
     QVector<AnimationTimeline>* m_timelines;
@@ -389,6 +406,7 @@ public:
     }
 
     int id() const override { return 1016; }
+    const QVector<AnimationTimeline>* timelines() const { return m_timelines; }
 
     bool mergeWith(const QUndoCommand* other) override {
         const auto* o = static_cast<const SetTimelineNameCommand*>(other);
@@ -435,6 +453,7 @@ public:
     }
 
     int id() const override { return 1017; }
+    const QVector<AnimationTimeline>* timelines() const { return m_timelines; }
 
     bool mergeWith(const QUndoCommand* other) override {
         const auto* o = static_cast<const SetTimelineFpsCommand*>(other);
@@ -485,6 +504,7 @@ public:
     }
 
     int id() const override { return 1022; }
+    const QVector<AnimationTimeline>* timelines() const { return m_timelines; }
 
     bool mergeWith(const QUndoCommand* other) override {
         const auto* o = static_cast<const SetTimelineFlipCommand*>(other);
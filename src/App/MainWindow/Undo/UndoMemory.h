@@ -0,0 +1,216 @@
+#pragma once
+#include <QUndoCommand>
+#include <QUndoStack>
+#include <QStringList>
+#include <QVector>
+#include "../../../Core/AnimationModels.h"
+#include "../../../Core/LayoutModels.h"
+
+// ---------------------------------------------------------------------------
+// Undo history memory accounting
+//
+// Costs are approximate heap bytes a command keeps alive. By default implicitly
+// shared data that is still referenced elsewhere (the live session, a neighbouring
+// command) is not counted: keeping it in the history costs nothing extra. Sprites
+// are charged only when the history holds the last reference (e.g. removed ones).
+// ---------------------------------------------------------------------------
+namespace UndoMemory {
+
+// Flat charge for commands that hold only a few scalars and pointers.
+constexpr qsizetype kSmallCommandBytes = 128;
+
+enum class Count {
+    Owned,  // skip containers whose data is shared
+    All     // charge every container, e.g. snapshots that outlive the live state
+};
+
+template <typename Container>
+bool skip(const Container& c, Count count) {
+    return count == Count::Owned && !c.isDetached();
+}
+
+inline qsizetype bytes(const QString& s, Count count = Count::Owned) {
+    return skip(s, count) ? 0 : s.capacity() * qsizetype(sizeof(QChar));
+}
+
+inline qsizetype bytes(const QStringList& list, Count count = Count::Owned) {
+    if (skip(list, count)) return 0;
+    qsizetype total = list.capacity() * qsizetype(sizeof(QString));
+    for (const QString& s : list) total += bytes(s, count);
+    return total;
+}
+
+inline qsizetype bytes(const QVector<NamedPoint>& points, Count count = Count::Owned) {
+    if (skip(points, count)) return 0;
+    qsizetype total = points.capacity() * qsizetype(sizeof(NamedPoint));
+    for (const NamedPoint& p : points) {
+        total += bytes(p.name, count);
+        if (!skip(p.polygonPoints, count)) {
+            total += p.polygonPoints.capacity() * qsizetype(sizeof(QPoint));
+        }
+    }
+    return total;
+}
+
+inline qsizetype bytes(const QVector<AnimationTimeline>& timelines, Count count = Count::Owned) {
+    if (skip(timelines, count)) return 0;
+    qsizetype total = timelines.capacity() * qsizetype(sizeof(AnimationTimeline));
+    for (const AnimationTimeline& t : timelines) {
+        total += bytes(t.name, count) + bytes(t.frames, count) + bytes(t.aliasOf, count);
+    }
+    return total;
+}
+
+inline qsizetype bytes(const QVector<LayoutModel>& models, Count count = Count::Owned) {
+    if (skip(models, count)) return 0;
+    qsizetype total = models.capacity() * qsizetype(sizeof(LayoutModel));
+    for (const LayoutModel& model : models) {
+        if (skip(model.sprites, count)) continue;
+        total += model.sprites.capacity() * qsizetype(sizeof(SpritePtr));
+        for (const SpritePtr& sprite : model.sprites) {
+            if (sprite && sprite.use_count() == 1) {
+                total += qsizetype(sizeof(Sprite)) + bytes(sprite->path, Count::All)
+                       + bytes(sprite->name, Count::All) + bytes(sprite->aliases, Count::All)
+                       + bytes(sprite->points, Count::All);
+            }
+        }
+    }
+    return total;
+}
+
+} // namespace UndoMemory
+
+// Implemented by commands that hold sizeable snapshots.
+class UndoMemoryCost {
+public:
+    virtual ~UndoMemoryCost() = default;
+    virtual qsizetype memoryCost() const = 0;
+    // Frees the saved state once the command has been dropped from the history.
+    virtual void releaseMemory() = 0;
+};
+
+// ---------------------------------------------------------------------------
+// UndoHistoryBudget — keeps the undo side of a stack within a byte budget
+//
+// QUndoStack cannot remove its oldest commands, so steps over budget are released
+// in place and marked obsolete. Released steps always form the bottom of the stack;
+// undo() stops at them, and the stack's own undo limit drops them eventually.
+// ---------------------------------------------------------------------------
+namespace UndoHistoryBudget {
+
+inline qsizetype commandCost(const QUndoCommand* command) {
+    if (command->isObsolete()) return 0;
+    qsizetype total = 0;
+    if (const auto* costed = dynamic_cast<const UndoMemoryCost*>(command)) {
+        total = costed->memoryCost();
+    }
+    for (int i = 0; i < command->childCount(); ++i) {
+        total += commandCost(command->child(i));
+    }
+    return total + UndoMemory::kSmallCommandBytes;
+}
+
+inline qsizetype totalCost(const QUndoStack* stack) {
+    qsizetype total = 0;
+    for (int i = 0; i < stack->count(); ++i) total += commandCost(stack->command(i));
+    return total;
+}
+
+inline void releaseCommand(QUndoCommand* command) {
+    if (auto* costed = dynamic_cast<UndoMemoryCost*>(command)) costed->releaseMemory();
+    for (int i = 0; i < command->childCount(); ++i) {
+        releaseCommand(const_cast<QUndoCommand*>(command->child(i)));
+    }
+    command->setObsolete(true);
+}
+
+// Running cost of a stack's history. Each command is measured when it first shows
+// up, and the top one again after a merge, instead of walking the whole stack on
+// every index change.
+class Tracker {
+public:
+    explicit Tracker(qsizetype budgetBytes) : m_budgetBytes(budgetBytes) {}
+
+    qsizetype totalCost() const { return m_total; }
+
+    // Brings the cached costs in line with the stack, then releases the oldest undoable
+    // steps until the history fits the budget. The most recent step is always kept.
+    // Returns the number of steps released.
+    int update(QUndoStack* stack) {
+        sync(stack);
+        int released = 0;
+        int next = 0;
+        while (m_total > m_budgetBytes) {
+            while (next < stack->index() - 1 && stack->command(next)->isObsolete()) ++next;
+            if (next >= stack->index() - 1) break;
+            // QUndoStack owns its commands; command() only hands out const pointers.
+            releaseCommand(const_cast<QUndoCommand*>(stack->command(next)));
+            m_total -= m_costs[next];
+            m_costs[next] = 0;
+            // Dropping a step can leave data it shared with the next step owned by that
+            // step alone, so the neighbour is re-measured.
+            remeasure(stack, next + 1);
+            ++released;
+        }
+        return released;
+    }
+
+private:
+    void remeasure(const QUndoStack* stack, int i) {
+        const qsizetype cost = commandCost(stack->command(i));
+        m_total += cost - m_costs[i];
+        m_costs[i] = cost;
+    }
+
+    void sync(const QUndoStack* stack) {
+        // The undo limit deletes the oldest commands, clear() deletes all of them.
+        int dropped = 0;
+        while (dropped < m_commands.size()
+               && (stack->count() == 0 || m_commands[dropped] != stack->command(0))) {
+            m_total -= m_costs[dropped++];
+        }
+        m_commands.remove(0, dropped);
+        m_costs.remove(0, dropped);
+
+        // A push after undo deletes the undone commands.
+        int kept = 0;
+        while (kept < m_commands.size() && kept < stack->count() && m_commands[kept] == stack->command(kept)) {
+            ++kept;
+        }
+        for (int i = kept; i < m_commands.size(); ++i) m_total -= m_costs[i];
+        m_commands.resize(kept);
+        m_costs.resize(kept);
+
+        for (int i = kept; i < stack->count(); ++i) {
+            m_commands.append(stack->command(i));
+            m_costs.append(commandCost(stack->command(i)));
+            m_total += m_costs.last();
+        }
+        // A merge changes the top command in place.
+        if (kept > 0 && kept == stack->count() && stack->index() == stack->count()) {
+            remeasure(stack, kept - 1);
+        }
+    }
+
+    qsizetype m_budgetBytes = 0;
+    qsizetype m_total = 0;
+    QVector<const QUndoCommand*> m_commands;
+    QVector<qsizetype> m_costs;
+};
+
+// Measures the whole stack once and releases the oldest undoable steps until the
+// history fits the budget; see Tracker for repeated use on the same stack.
+inline int enforce(QUndoStack* stack, qsizetype budgetBytes) {
+    Tracker tracker(budgetBytes);
+    return tracker.update(stack);
+}
+
+inline bool canUndo(const QUndoStack* stack) {
+    return stack->canUndo() && !stack->command(stack->index() - 1)->isObsolete();
+}
+
+inline void undo(QUndoStack* stack) {
+    if (canUndo(stack)) stack->undo();
+}
+
+} // namespace UndoHistoryBudget
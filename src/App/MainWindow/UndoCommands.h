@@ -8,3 +8,4 @@
 #include "Undo/ViewCommands.h"
 #include "Undo/NavigatorCommands.h"
 #include "Undo/SessionUndoCommand.h"
+#include "Undo/UndoMemory.h"
@@ -358,6 +358,18 @@ void AtlasWorkspace::setupUi() {
         });
     }
 
+    {
+        auto* btn = m_spriteEditorPanel->showMeshBtn();
+        if (m_settings) btn->setChecked(m_settings->showMesh);
+        connect(btn, &QPushButton::toggled, this, [this](bool checked) {
+            if (m_settings) {
+                m_settings->showMesh = checked;
+                if (m_cliPaths) CliToolsConfig::saveAppSettings(*m_settings, *m_cliPaths);
+                m_spriteEditorPanel->previewCanvas()->setSettings(*m_settings);
+            }
+        });
+    }
+
     if (auto* btn = m_spriteEditorPanel->markerTemplatesBtn()) {
         auto* menu = new QMenu(btn);
         btn->setMenu(menu);
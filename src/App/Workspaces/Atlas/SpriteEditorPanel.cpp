@@ -86,6 +86,12 @@ SpriteEditorPanel::SpriteEditorPanel(QWidget* parent)
     m_showGridBtn->setAccessibleName(tr("Show grid"));
     viewportRow->addWidget(m_showGridBtn);
 
+    m_showMeshBtn = new QPushButton(QIcon(":/icons/polygon.svg"), tr("Mesh"), this);
+    m_showMeshBtn->setCheckable(true);
+    m_showMeshBtn->setToolTip(tr("Show the tight polygon mesh export traces around the visible pixels"));
+    m_showMeshBtn->setAccessibleName(tr("Show mesh"));
+    viewportRow->addWidget(m_showMeshBtn);
+
     viewportRow->addStretch();
     box->addLayout(viewportRow);
 
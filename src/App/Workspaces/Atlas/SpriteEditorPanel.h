@@ -33,6 +33,7 @@ public:
     QPushButton*    showTrimRectBtn()      const { return m_showTrimRectBtn; }
     QPushButton*    onionSkinBtn()         const { return m_onionSkinBtn; }
     QPushButton*    showGridBtn()          const { return m_showGridBtn; }
+    QPushButton*    showMeshBtn()          const { return m_showMeshBtn; }
     QComboBox*      handleCombo()          const { return m_handleCombo; }
     QDoubleSpinBox* pivotXSpin()           const { return m_pivotXSpin; }
     QDoubleSpinBox* pivotYSpin()           const { return m_pivotYSpin; }
@@ -51,6 +52,7 @@ private:
     QPushButton*    m_showTrimRectBtn      = nullptr;
     QPushButton*    m_onionSkinBtn         = nullptr;
     QPushButton*    m_showGridBtn          = nullptr;
+    QPushButton*    m_showMeshBtn          = nullptr;
     QComboBox*      m_handleCombo          = nullptr;
     QDoubleSpinBox* m_pivotXSpin           = nullptr;
     QDoubleSpinBox* m_pivotYSpin           = nullptr;
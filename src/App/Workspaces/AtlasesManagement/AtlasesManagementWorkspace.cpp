@@ -39,6 +39,7 @@
 #include <QTreeWidgetItemIterator>
 #include <QVBoxLayout>
 
+#include <algorithm>
 #include <functional>
 
 // ---------------------------------------------------------------------------
@@ -568,20 +569,32 @@ bool AtlasesManagementWorkspace::eventFilter(QObject* obj, QEvent* event) {
         const int srcRow      = m_contextMenuSourceAtlasRow;
         m_contextMenuSourceAtlasRow = -1;
 
-        // Only show when right-clicking a different atlas while checked sprites exist.
+        if (tgtRow < 0 || tgtRow >= m_atlases.size()) {
+            return QWidget::eventFilter(obj, event);
+        }
+        QMenu menu(this);
+        // Moving only applies when right-clicking a different atlas while checked sprites exist.
         const QStringList checked = m_navigator ? m_navigator->checkedPaths() : QStringList{};
-        if (tgtRow >= 0 && tgtRow < m_atlases.size()
-                && tgtRow != srcRow && srcRow >= 0
-                && !checked.isEmpty()) {
-            QMenu menu(this);
+        if (tgtRow != srcRow && srcRow >= 0 && !checked.isEmpty()) {
             menu.addAction(tr("Move checked sprites to \"%1\"").arg(m_atlases[tgtRow].name),
                            this, [this, checked, srcRow, tgtRow]() {
                 emit moveSpritesRequested(checked, srcRow, tgtRow);
             });
-            menu.exec(m_atlasList->viewport()->mapToGlobal(vpPos));
-            return true;
         }
-        return QWidget::eventFilter(obj, event);
+        const AtlasEntry& clicked = m_atlases[tgtRow];
+        const bool hasTimelines = std::any_of(clicked.timelines.cbegin(), clicked.timelines.cend(),
+            [](const AnimationTimeline& t) { return t.aliasOf.isEmpty() && t.frames.size() > 1; });
+        if (!clicked.isExcluded && hasTimelines) {
+            if (!menu.isEmpty()) menu.addSeparator();
+            menu.addAction(tr("Split by animations..."), this, [this, tgtRow]() {
+                emit splitByAnimationsRequested(tgtRow);
+            });
+        }
+        if (menu.isEmpty()) {
+            return QWidget::eventFilter(obj, event);
+        }
+        menu.exec(m_atlasList->viewport()->mapToGlobal(vpPos));
+        return true;
     }
     case QEvent::DragEnter: {
         auto* e = static_cast<QDragEnterEvent*>(event);
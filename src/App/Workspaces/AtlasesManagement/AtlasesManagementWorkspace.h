@@ -78,6 +78,8 @@ signals:
     void moveSpritesRequested(const QStringList& spritePaths, int sourceAtlasIndex, int targetAtlasIndex);
     void createAtlasFromGroupRequested(const QString& groupName, const QStringList& paths);
     void autoCreateAtlasesRequested(const QVector<QPair<QString, QStringList>>& groups);
+    /** Emitted to regroup an atlas's sprites so each timeline's frames share an atlas. */
+    void splitByAnimationsRequested(int atlasIndex);
 
     void selectedProfileChanged(const QString& profileName);
     void profileEnablementChanged(const QStringList& enabledProfiles);
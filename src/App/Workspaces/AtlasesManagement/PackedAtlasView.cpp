@@ -171,6 +171,14 @@ void PackedAtlasView::setImage(const QByteArray& pngData) {
     showPixmap(pixmap, QString());
 }
 
+void PackedAtlasView::setImage(const QImage& image) {
+    if (image.isNull()) {
+        setError(tr("Received empty image data"));
+        return;
+    }
+    showPixmap(QPixmap::fromImage(image), QString());
+}
+
 void PackedAtlasView::showPixmap(const QPixmap& pixmap, const QString& bannerText) {
     const QRectF imageRect(QPointF(0, 0), pixmap.size());
     m_bgRectItem->setRect(imageRect);
@@ -3,6 +3,7 @@
 #include "IAtlasViewport.h"
 #include "AppSettings.h"
 
+class QImage;
 class QLabel;
 class QGraphicsScene;
 class QGraphicsPixmapItem;
@@ -18,6 +19,7 @@ public:
     void setSettings(const AppSettings& settings);
     void setLoading();
     void setImage(const QByteArray& pngData);
+    void setImage(const QImage& image);
     void setError(const QString& message);
     void setIdle();
 
@@ -3,14 +3,18 @@
 #include "ZoomableGraphicsView.h"
 #include "CliToolsConfig.h"
 #include "MessageDialog.h"
+#include "TextureMemoryEstimator.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGridLayout>
 #include <QLabel>
 #include <QLineEdit>
+#include <QMenu>
 #include <QPushButton>
+#include <QCheckBox>
 #include <QComboBox>
 #include <QDoubleSpinBox>
+#include <QSpinBox>
 #include <QFileDialog>
 #include <QGroupBox>
 #include <QSplitter>
@@ -19,6 +23,7 @@
 #include <QDir>
 #include <QFile>
 #include <QTextStream>
+#include <QToolButton>
 #include <QTableWidget>
 #include <QTreeWidget>
 #include <QHeaderView>
@@ -59,6 +64,17 @@ QString extractJsonnetField(const QString& text, const QString& key) {
     return end >= 0 ? text.mid(start, end - start) : QString();
 }
 
+// Same pages holding the same sprite objects; a new layout run creates new sprites.
+bool sameLayout(const QVector<LayoutModel>& a, const QVector<LayoutModel>& b) {
+    if (a.size() != b.size()) return false;
+    for (int i = 0; i < a.size(); ++i) {
+        if (a[i].atlasWidth != b[i].atlasWidth || a[i].atlasHeight != b[i].atlasHeight
+            || a[i].scale != b[i].scale || a[i].sprites != b[i].sprites)
+            return false;
+    }
+    return true;
+}
+
 QIcon makeTransformIcon(const QString& iconRelPath, const QString& transformsDir) {
     if (iconRelPath.isEmpty() || transformsDir.isEmpty()) return {};
     const QString path = QDir(transformsDir).filePath(iconRelPath);
@@ -201,6 +217,7 @@ void ExportWorkspace::setupUi() {
             preset.name               = name.trimmed();
             preset.outputPath         = m_outputPathEdit ? m_outputPathEdit->text().trimmed() : QString();
             preset.transform          = m_transformCombo ? m_transformCombo->currentData().toString() : QString();
+            preset.extraTransforms    = getConfig().extraTransforms;
             preset.scaleFilter        = m_scaleFilterCombo ? m_scaleFilterCombo->currentData().toString() : QString();
             preset.postExportCommand  = m_postExportCommandEdit ? m_postExportCommandEdit->text() : QString();
             if (m_profileCombo && m_profileCombo->count() > 0) {
@@ -301,12 +318,24 @@ void ExportWorkspace::setupUi() {
     // Row 1: Format — combo spans cols 1–2 to reach the same right edge as Post-export command
     m_transformCombo = new QComboBox(exportGroup);
     m_transformCombo->addItem(tr("Raw (sprat-cli format)"), QStringLiteral("raw"));
+    m_transformCombo->addItem(tr("Binary (memory-mappable)"), QStringLiteral("binary"));
     // Transform list is populated lazily on first populate() call so the
     // constructor doesn't block waiting for a subprocess (queryTransformsDir).
     exportGrid->addWidget(new QLabel(tr("Format:"), exportGroup), 1, 0, Qt::AlignVCenter);
     exportGrid->addWidget(m_transformCombo, 1, 1, 1, 2);
 
-    // Row 2: Scale filter — same span as Format so both combos share the same width
+    // Row 2: Further formats written from the same pack; filled alongside the Format combo
+    m_extraTransformsButton = new QToolButton(exportGroup);
+    m_extraTransformsButton->setPopupMode(QToolButton::InstantPopup);
+    m_extraTransformsButton->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    m_extraTransformsButton->setMenu(new QMenu(m_extraTransformsButton));
+    m_extraTransformsButton->setToolTip(
+        tr("Further metadata formats converted from the same layout and spritesheet"));
+    updateExtraTransformsText();
+    exportGrid->addWidget(new QLabel(tr("Also write:"), exportGroup), 2, 0, Qt::AlignVCenter);
+    exportGrid->addWidget(m_extraTransformsButton, 2, 1, 1, 2);
+
+    // Row 3: Scale filter — same span as Format so both combos share the same width
     m_scaleFilterCombo = new QComboBox(exportGroup);
     m_scaleFilterCombo->addItem(tr("Nearest (default)"), QStringLiteral("nearest"));
     m_scaleFilterCombo->addItem(tr("Bilinear"),          QStringLiteral("bilinear"));
@@ -314,8 +343,19 @@ void ExportWorkspace::setupUi() {
     m_scaleFilterCombo->addItem(tr("Mitchell"),          QStringLiteral("mitchell"));
     connect(m_scaleFilterCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &ExportWorkspace::onAnyComboChanged);
-    exportGrid->addWidget(new QLabel(tr("Scale filter:"), exportGroup), 2, 0, Qt::AlignVCenter);
-    exportGrid->addWidget(m_scaleFilterCombo, 2, 1, 1, 2);
+    exportGrid->addWidget(new QLabel(tr("Scale filter:"), exportGroup), 3, 0, Qt::AlignVCenter);
+    exportGrid->addWidget(m_scaleFilterCombo, 3, 1, 1, 2);
+
+    // Row 4: Tight polygon mesh traced from each sprite's alpha, written as a marker
+    m_meshBudgetSpin = new QSpinBox(exportGroup);
+    m_meshBudgetSpin->setRange(0, 64);
+    m_meshBudgetSpin->setSpecialValueText(tr("Off"));
+    m_meshBudgetSpin->setSuffix(tr(" vertices"));
+    m_meshBudgetSpin->setToolTip(
+        tr("Writes a \"mesh\" polygon marker around each sprite's visible pixels, with at most\n"
+           "this many vertices. Drawing sprites as this polygon skips most transparent pixels."));
+    exportGrid->addWidget(new QLabel(tr("Tight mesh:"), exportGroup), 4, 0, Qt::AlignVCenter);
+    exportGrid->addWidget(m_meshBudgetSpin, 4, 1, 1, 2);
 
     exportLayout->addLayout(exportGrid);
 
@@ -363,6 +403,32 @@ void ExportWorkspace::setupUi() {
     buttonRow->addWidget(m_exportBtn);
     rightLayout->addLayout(buttonRow);
 
+    // Texture memory estimate, from the cached layout
+    m_memoryGroup = new QGroupBox(tr("Texture memory"), rightWidget);
+    auto* memoryLayout = new QVBoxLayout(m_memoryGroup);
+    memoryLayout->setContentsMargins(6, 6, 6, 6);
+    memoryLayout->setSpacing(4);
+
+    m_mipmapsCheck = new QCheckBox(tr("Include mipmaps"), m_memoryGroup);
+    m_mipmapsCheck->setToolTip(tr("Count the full mip chain of every page"));
+    connect(m_mipmapsCheck, &QCheckBox::toggled, this, &ExportWorkspace::updateMemoryEstimate);
+    memoryLayout->addWidget(m_mipmapsCheck);
+
+    m_memoryTree = new QTreeWidget(m_memoryGroup);
+    m_memoryTree->setColumnCount(3);
+    m_memoryTree->setHeaderLabels({tr("Profile"), tr("GPU memory"), tr("Transparent")});
+    m_memoryTree->header()->setStretchLastSection(false);
+    m_memoryTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_memoryTree->header()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+    m_memoryTree->header()->setSectionResizeMode(2, QHeaderView::ResizeToContents);
+    m_memoryTree->setSelectionMode(QAbstractItemView::NoSelection);
+    m_memoryTree->setFocusPolicy(Qt::NoFocus);
+    m_memoryTree->setMaximumHeight(160);
+    memoryLayout->addWidget(m_memoryTree);
+
+    m_memoryGroup->setVisible(false);
+    rightLayout->addWidget(m_memoryGroup);
+
     // Export log panel
     m_logGroup = new QGroupBox(tr("Last export"), rightWidget);
     auto* logLayout = new QVBoxLayout(m_logGroup);
@@ -510,7 +576,7 @@ void ExportWorkspace::populate(const QVector<SpratProfile>& profiles,
 
     // Populate transform combo on first visit (deferred from constructor to avoid
     // blocking the main thread at startup with a queryTransformsDir subprocess).
-    if (m_transformCombo->count() == 1) {
+    if (m_transformCombo->count() == 2) {
         const TransformsCache& cache = loadAvailableTransforms();
         if (!cache.transforms.isEmpty()) {
             for (const TransformInfo& t : cache.transforms)
@@ -521,6 +587,15 @@ void ExportWorkspace::populate(const QVector<SpratProfile>& profiles,
             m_transformCombo->addItem(QStringLiteral("xml"),  QStringLiteral("xml"));
             m_transformCombo->addItem(QStringLiteral("css"),  QStringLiteral("css"));
         }
+        QMenu* extraMenu = m_extraTransformsButton->menu();
+        for (int i = 0; i < m_transformCombo->count(); ++i) {
+            QAction* action = extraMenu->addAction(m_transformCombo->itemIcon(i),
+                                                   m_transformCombo->itemText(i));
+            action->setData(m_transformCombo->itemData(i));
+            action->setCheckable(true);
+            connect(action, &QAction::toggled, this, &ExportWorkspace::updateExtraTransformsText);
+            connect(action, &QAction::toggled, this, &ExportWorkspace::onAnyComboChanged);
+        }
     }
 
     // Restore transform
@@ -529,12 +604,24 @@ void ExportWorkspace::populate(const QVector<SpratProfile>& profiles,
         if (idx >= 0) m_transformCombo->setCurrentIndex(idx);
     }
 
+    // Restore extra formats without a preview refresh per action
+    for (QAction* action : m_extraTransformsButton->menu()->actions()) {
+        action->blockSignals(true);
+        action->setChecked(lastConfig.extraTransforms.contains(action->data().toString()));
+        action->blockSignals(false);
+    }
+    updateExtraTransformsText();
+
     // Restore scale filter
     if (!lastConfig.scaleFilter.isEmpty()) {
         const int idx = m_scaleFilterCombo->findData(lastConfig.scaleFilter);
         if (idx >= 0) m_scaleFilterCombo->setCurrentIndex(idx);
     }
 
+    // Restore mesh budget
+    if (m_meshBudgetSpin)
+        m_meshBudgetSpin->setValue(lastConfig.meshVertexBudget);
+
     // Restore post-export command
     if (m_postExportCommandEdit)
         m_postExportCommandEdit->setText(lastConfig.postExportCommand);
@@ -544,6 +631,9 @@ void ExportWorkspace::populate(const QVector<SpratProfile>& profiles,
         m_savePresetBtn->setEnabled(!m_outputPathEdit->text().trimmed().isEmpty());
 
     if (m_scaleFilterCombo) m_scaleFilterCombo->blockSignals(false);
+
+    // Profile settings may have changed since the estimate was last shown.
+    updateMemoryEstimate();
 }
 
 void ExportWorkspace::setAtlasNames(const QStringList& names, int activeSessionIndex,
@@ -720,6 +810,88 @@ void ExportWorkspace::updatePreviewProfileCombo(const QString& preferredProfile)
     m_profileCombo->blockSignals(false);
 }
 
+void ExportWorkspace::updateExtraTransformsText() {
+    QStringList names;
+    for (const QAction* action : m_extraTransformsButton->menu()->actions()) {
+        if (action->isChecked()) {
+            names.append(action->text());
+        }
+    }
+    m_extraTransformsButton->setText(names.isEmpty() ? tr("None") : names.join(QStringLiteral(", ")));
+}
+
+void ExportWorkspace::setLayoutModels(const QVector<LayoutModel>& models) {
+    const int atlasIndex = m_previewAtlasCombo ? m_previewAtlasCombo->currentData().toInt() : -1;
+    // Packed previews belong to one atlas and one layout of it; a new layout of the same
+    // atlas makes them stale too.
+    if (atlasIndex != m_layoutModelsAtlasIndex || !sameLayout(models, m_layoutModels)) {
+        m_profileLayoutModels.clear();
+        m_layoutModelsAtlasIndex = atlasIndex;
+    }
+    m_layoutModels = models;
+    updateMemoryEstimate();
+}
+
+void ExportWorkspace::setProfileLayoutModels(const QString& profileName,
+                                             const QVector<LayoutModel>& models) {
+    if (profileName.isEmpty() || models.isEmpty()) return;
+    m_profileLayoutModels.insert(profileName, models);
+    updateMemoryEstimate();
+}
+
+void ExportWorkspace::updateMemoryEstimate() {
+    if (!m_memoryTree || !m_memoryGroup) return;
+    m_memoryTree->clear();
+    const bool mipmaps = m_mipmapsCheck && m_mipmapsCheck->isChecked();
+    auto percent = [](double share) {
+        return QStringLiteral("%1%").arg(share * 100.0, 0, 'f', 0);
+    };
+
+    for (const SpratProfile& profile : std::as_const(m_allProfiles)) {
+        const QString name = profile.name.trimmed();
+        if (name.isEmpty()) continue;
+        // The profile's own packed layout when its preview ran, otherwise the current
+        // layout scaled from the scale it was laid out at.
+        const auto packed = m_profileLayoutModels.constFind(name);
+        const bool exact = packed != m_profileLayoutModels.cend();
+        const QVector<LayoutModel>& models = exact ? *packed : m_layoutModels;
+        if (models.isEmpty()) continue;
+        double scale = 1.0;
+        if (!exact) {
+            const double profileScale = qBound(0.01, profile.scale > 0.0 ? profile.scale : 1.0, 1.0);
+            const double layoutScale = models.first().scale > 0.0 ? models.first().scale : 1.0;
+            scale = profileScale / layoutScale;
+        }
+        const TextureMemoryEstimator::Estimate estimate =
+            TextureMemoryEstimator::estimate(models, profile.gpuCompress, mipmaps, scale);
+        if (estimate.pages.isEmpty()) continue;
+
+        const QString label = profile.label.trimmed().isEmpty() ? name : profile.label.trimmed();
+        auto* profileItem = new QTreeWidgetItem(m_memoryTree);
+        profileItem->setText(0, tr("%1 (%2)").arg(label,
+            TextureMemoryEstimator::formatName(profile.gpuCompress)));
+        profileItem->setText(1, formatFileSize(estimate.totalBytes));
+        profileItem->setText(2, percent(estimate.transparentShare));
+        if (!exact) {
+            profileItem->setToolTip(0, tr("Scaled from the current layout; open the profile's "
+                                          "preview for its packed pages"));
+        }
+        for (int i = 0; i < estimate.pages.size(); ++i) {
+            const TextureMemoryEstimator::Page& page = estimate.pages[i];
+            auto* pageItem = new QTreeWidgetItem(profileItem);
+            pageItem->setText(0, tr("Page %1: %2x%3").arg(i + 1)
+                                     .arg(page.size.width()).arg(page.size.height()));
+            pageItem->setText(1, formatFileSize(page.bytes));
+            pageItem->setText(2, percent(page.transparentShare));
+            if (page.bytes != page.baseBytes) {
+                pageItem->setToolTip(1, tr("%1 without mipmaps").arg(formatFileSize(page.baseBytes)));
+            }
+        }
+    }
+    m_memoryTree->expandAll();
+    m_memoryGroup->setVisible(m_memoryTree->topLevelItemCount() > 0);
+}
+
 void ExportWorkspace::onAnyComboChanged() {
     if (m_noPreviewLabel && !m_viewportWidget)
         m_noPreviewLabel->setText(tr("Generating preview\u2026"));
@@ -737,9 +909,20 @@ SaveConfig ExportWorkspace::getConfig() const {
     if (m_transformCombo) {
         config.transform = m_transformCombo->currentData().toString();
     }
+    if (m_extraTransformsButton) {
+        for (const QAction* action : m_extraTransformsButton->menu()->actions()) {
+            const QString transform = action->data().toString();
+            if (action->isChecked() && transform != config.transform) {
+                config.extraTransforms.append(transform);
+            }
+        }
+    }
     if (m_scaleFilterCombo) {
         config.scaleFilter = m_scaleFilterCombo->currentData().toString();
     }
+    if (m_meshBudgetSpin) {
+        config.meshVertexBudget = m_meshBudgetSpin->value();
+    }
     if (m_profileCombo && m_profileCombo->count() > 0) {
         const QString name = m_profileCombo->currentData().toString();
         if (!name.isEmpty()) config.profiles.append(name);
@@ -775,20 +958,32 @@ void ExportWorkspace::showExportLog(const QVector<ExportLogEntry>& entries,
 
     qint64 totalSize = 0;
     int    fileCount = 0;
+    int    unchangedCount = 0;
     bool   hasErrors = false;
+    // Step timings are listed after the files and messages, under their own heading.
+    QList<QTreeWidgetItem*> timingItems;
 
     for (const auto& e : entries) {
         auto* item = new QTreeWidgetItem();
         switch (e.kind) {
-        case ExportLogEntry::Kind::FileWritten: {
+        case ExportLogEntry::Kind::FileWritten:
+        case ExportLogEntry::Kind::Unchanged: {
             QString disp = e.path;
             if (!prefix.isEmpty() && disp.startsWith(prefix)) {
                 disp = disp.mid(prefix.length());
                 if (!disp.isEmpty() && (disp[0] == u'/' || disp[0] == u'\\'))
                     disp = disp.mid(1);
             }
-            item->setText(0, disp.isEmpty() ? e.path : disp);
+            if (disp.isEmpty()) disp = e.path;
             item->setText(1, formatFileSize(e.size));
+            if (e.kind == ExportLogEntry::Kind::Unchanged) {
+                // Left untouched on disk; listed so the output set stays complete.
+                item->setText(0, tr("%1 (unchanged)").arg(disp));
+                item->setForeground(0, QColor(110, 110, 110));
+                ++unchangedCount;
+                break;
+            }
+            item->setText(0, disp);
             if (e.size >= 0) totalSize += e.size;
             ++fileCount;
             break;
@@ -802,13 +997,34 @@ void ExportWorkspace::showExportLog(const QVector<ExportLogEntry>& entries,
             item->setText(0, e.path);
             item->setForeground(0, QColor(110, 110, 110));
             break;
+        case ExportLogEntry::Kind::Timing: {
+            const QString step = e.scope.isEmpty() ? e.path : tr("%1 (%2)").arg(e.path, e.scope);
+            item->setText(0, e.cpuMs >= 0
+                ? tr("%1: %2 ms wall, %3 ms CPU").arg(step).arg(e.wallMs).arg(e.cpuMs)
+                : tr("%1: %2 ms wall").arg(step).arg(e.wallMs));
+            item->setText(1, formatFileSize(e.size));
+            item->setForeground(0, QColor(110, 110, 110));
+            timingItems.append(item);
+            continue;
+        }
         }
         m_logTree->addTopLevelItem(item);
     }
+    if (!timingItems.isEmpty()) {
+        auto* heading = new QTreeWidgetItem({tr("Step timings")});
+        QFont font = heading->font(0);
+        font.setBold(true);
+        heading->setFont(0, font);
+        m_logTree->addTopLevelItem(heading);
+        m_logTree->addTopLevelItems(timingItems);
+    }
 
-    const QString title = hasErrors
+    QString title = hasErrors
         ? tr("Last export: errors — %1 file(s) written").arg(fileCount)
         : tr("Last export: %1 file(s), %2").arg(fileCount).arg(formatFileSize(totalSize));
+    if (unchangedCount > 0) {
+        title += tr(", %1 unchanged").arg(unchangedCount);
+    }
     m_logGroup->setTitle(title);
     m_logGroup->setVisible(true);
     if (m_logRevealBtn) m_logRevealBtn->setEnabled(!destination.isEmpty());
@@ -1,16 +1,20 @@
 #pragma once
 #include <QWidget>
+#include <QHash>
 #include <QList>
 #include <QPair>
 #include "models.h"
 #include "SpratProfilesConfig.h"
 #include "IWorkspace.h"
 
+class QCheckBox;
 class QLabel;
 class QLineEdit;
 class QComboBox;
 class QDoubleSpinBox;
+class QSpinBox;
 class QPushButton;
+class QToolButton;
 class QGroupBox;
 class QTableWidget;
 class QTreeWidget;
@@ -57,6 +61,13 @@ public:
     /** Populate the preset combo. */
     void setPresets(const QVector<ExportPreset>& presets);
 
+    /** Current layout of the preview atlas. Texture memory is estimated from it for
+     *  profiles without a packed preview, scaled to each profile's scale. */
+    void setLayoutModels(const QVector<LayoutModel>& models);
+    /** Layout packed for @p profileName's preview; replaces the scaled estimate for it
+     *  until the preview atlas changes. */
+    void setProfileLayoutModels(const QString& profileName, const QVector<LayoutModel>& models);
+
     QDoubleSpinBox* zoomSpin() const { return m_zoomSpin; }
 
     double savedZoom() const { return m_savedZoom; }
@@ -85,6 +96,8 @@ private:
     void onExportClicked();
     void setPreviewWidget(QWidget* preview);
     void clearPreviewWidget();
+    void updateExtraTransformsText();
+    void updateMemoryEstimate();
 
     QWidget*             m_previewPane         = nullptr;
     QLabel*              m_noPreviewLabel      = nullptr;  // shown when no viewport is set
@@ -92,7 +105,9 @@ private:
     QLineEdit*           m_outputPathEdit      = nullptr;
     QLineEdit*           m_postExportCommandEdit   = nullptr;
     QComboBox*           m_transformCombo          = nullptr;
+    QToolButton*         m_extraTransformsButton   = nullptr;  // menu of checkable formats
     QComboBox*           m_scaleFilterCombo        = nullptr;
+    QSpinBox*            m_meshBudgetSpin          = nullptr;  // 0: no meshes
     QComboBox*           m_profileCombo       = nullptr;
     QComboBox*           m_previewAtlasCombo  = nullptr;
     QDoubleSpinBox*      m_zoomSpin         = nullptr;
@@ -114,6 +129,14 @@ private:
 
     void updatePreviewProfileCombo(const QString& preferredProfile = {});
 
+    // Texture memory estimate per profile
+    QGroupBox*   m_memoryGroup  = nullptr;
+    QTreeWidget* m_memoryTree   = nullptr;
+    QCheckBox*   m_mipmapsCheck = nullptr;
+    QVector<LayoutModel> m_layoutModels;
+    QHash<QString, QVector<LayoutModel>> m_profileLayoutModels;  // packed previews, by profile
+    int m_layoutModelsAtlasIndex = -1;
+
     // Export log panel
     QGroupBox*   m_logGroup     = nullptr;
     QTreeWidget* m_logTree      = nullptr;
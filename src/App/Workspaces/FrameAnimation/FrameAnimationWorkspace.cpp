@@ -287,7 +287,7 @@ void FrameAnimationWorkspace::refreshAnimationTest()
                 }
             }
         }
-        AnimationPreviewService::preloadTimeline(*preloadFrames);
+        m_animPreview.preloadTimeline(*preloadFrames);
     }
 
     QString statusText;
@@ -295,7 +295,7 @@ void FrameAnimationWorkspace::refreshAnimationTest()
     bool playing = m_animPlaying;
     const bool onionSkin = m_animPanel->onionSkinButton() && m_animPanel->onionSkinButton()->isChecked();
     const int onionOpacity = m_settings ? m_settings->onionSkinOpacity : 0;
-    QPixmap pixmap = AnimationPreviewService::refresh(
+    QPixmap pixmap = m_animPreview.refresh(
         m_session->activeAtlas().timelines,
         m_session->selectedTimelineIndex,
         m_animFrameIndex,
@@ -335,7 +335,8 @@ void FrameAnimationWorkspace::refreshAnimationTest()
 
     auto* animCanvas = m_animPanel->animCanvas();
     if (animCanvas) {
-        animCanvas->setPixmap(pixmap);
+        animCanvas->setPixmap(pixmap, QPoint(m_animPreview.cachedBoundsLeft(),
+                                             m_animPreview.cachedBoundsTop()));
     }
 }
 
@@ -3,6 +3,7 @@
 #include <QFutureWatcher>
 #include <QPointF>
 #include <QWidget>
+#include "AnimationPreviewService.h"
 #include "AppSettings.h"
 #include "ProjectModels.h"
 #include "IWorkspace.h"
@@ -132,6 +133,7 @@ private:
     int           m_animFrameIndex = 0;
     bool          m_animPlaying    = false;
     QElapsedTimer m_animElapsed;
+    AnimationPreviewService m_animPreview;  // owns this preview's frame ring
 
     // ── Export state ─────────────────────────────────────────────────────────
     QFutureWatcher<bool> m_animExportWatcher;
@@ -1,5 +1,6 @@
 #include <QApplication>
 #include <QCoreApplication>
+#include <QGuiApplication>
 #include <QDir>
 #include <QLocale>
 #include <QTranslator>
@@ -12,6 +13,9 @@
 #include <QPainter>
 #include "MainWindow.h"
 #include "CliToolsConfig.h"
+#ifndef __EMSCRIPTEN__
+#include "HeadlessExport.h"
+#endif
 
 // Increases the gap between icon and text in QPushButton / QToolButton from Qt's
 // hardcoded 4 px to kIconTextSpacing.
@@ -100,6 +104,17 @@ extern "C" {
 #endif
 
 int main(int argc, char *argv[]) {
+#ifndef __EMSCRIPTEN__
+    // Batch export: no window, no display server needed.
+    if (HeadlessExport::isRequested(argc, argv)) {
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+        QGuiApplication app(argc, argv);
+        return HeadlessExport::run(app.arguments());
+    }
+#endif
+
     // Force a safe style to avoid crashes from unavailable styles like 'kvantum'
     // This must be done before QApplication is created
     qputenv("QT_STYLE_OVERRIDE", "Fusion");
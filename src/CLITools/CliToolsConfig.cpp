@@ -65,6 +65,8 @@ AppSettings CliToolsConfig::loadAppSettings() {
         QDir::homePath() + "/Sprat").toString();
     out.exportDefaultFormat       = settings.value("settings/export_default_format",       "none").toString();
     out.exportDefaultScaleFilter  = settings.value("settings/export_default_scale_filter", "nearest").toString();
+    out.saveProjectAsCbor         = settings.value("settings/save_project_as_cbor", out.saveProjectAsCbor).toBool();
+    out.packInProcess             = settings.value("settings/pack_in_process", out.packInProcess).toBool();
     out.coordUnit = settings.value("settings/coord_unit", 0).toInt() == 1
                   ? CoordUnit::Percent : CoordUnit::Pixels;
     out.showTrimRect = settings.value("settings/show_trim_rect", out.showTrimRect).toBool();
@@ -80,6 +82,7 @@ AppSettings CliToolsConfig::loadAppSettings() {
     out.spritePreviewDelay   = settings.value("settings/sprite_preview_delay",   out.spritePreviewDelay).toDouble();
     out.navigatorGroupSimilar = settings.value("settings/navigator_group_similar", out.navigatorGroupSimilar).toBool();
     out.showGrid        = settings.value("settings/show_grid",         out.showGrid).toBool();
+    out.showMesh        = settings.value("settings/show_mesh",         out.showMesh).toBool();
     out.gridCellWidth   = settings.value("settings/grid_cell_width",   out.gridCellWidth).toInt();
     out.gridCellHeight  = settings.value("settings/grid_cell_height",  out.gridCellHeight).toInt();
     out.gridOffsetX     = settings.value("settings/grid_offset_x",     out.gridOffsetX).toInt();
@@ -131,6 +134,8 @@ void CliToolsConfig::saveAppSettings(const AppSettings& settings, const CliPaths
     qsettings.setValue("settings/export_default_output_folder", settings.exportDefaultOutputFolder);
     qsettings.setValue("settings/export_default_format",       settings.exportDefaultFormat);
     qsettings.setValue("settings/export_default_scale_filter", settings.exportDefaultScaleFilter);
+    qsettings.setValue("settings/save_project_as_cbor",        settings.saveProjectAsCbor);
+    qsettings.setValue("settings/pack_in_process",             settings.packInProcess);
     qsettings.setValue("settings/coord_unit",
         settings.coordUnit == CoordUnit::Percent ? 1 : 0);
     qsettings.setValue("settings/show_trim_rect", settings.showTrimRect);
@@ -140,6 +145,7 @@ void CliToolsConfig::saveAppSettings(const AppSettings& settings, const CliPaths
     qsettings.setValue("settings/sprite_preview_delay",    settings.spritePreviewDelay);
     qsettings.setValue("settings/navigator_group_similar", settings.navigatorGroupSimilar);
     qsettings.setValue("settings/show_grid",        settings.showGrid);
+    qsettings.setValue("settings/show_mesh",        settings.showMesh);
     qsettings.setValue("settings/grid_cell_width",  settings.gridCellWidth);
     qsettings.setValue("settings/grid_cell_height", settings.gridCellHeight);
     qsettings.setValue("settings/grid_offset_x",    settings.gridOffsetX);
@@ -16,6 +16,9 @@ namespace AppConstants {
 /// Autosave interval: 5 minutes
 constexpr int kAutosaveIntervalMs = 300000;
 
+/// Autosave journal flush delay: edits are coalesced and appended this long after the first one
+constexpr int kAutosaveJournalFlushMs = 3000;
+
 /// Layout debounce interval: prevents excessive layout rebuilds on rapid changes
 constexpr int kLayoutDebounceMs = 2000;
 
@@ -42,7 +45,22 @@ constexpr int kCliStartupDelayMs = 1000;
 // ============================================================================
 
 /// Maximum number of undo/redo stack items
-constexpr int kUndoStackLimit = 50;
+constexpr int kUndoStackLimit = 1000;
+
+/// Approximate memory the undo history may keep alive before the oldest steps are dropped
+constexpr int kUndoHistoryBudgetBytes = 64 * 1024 * 1024;
+
+/// Export preview packs kept for switching between atlases and profiles without repacking
+constexpr int kPreviewPackCacheBytes = 128 * 1024 * 1024;
+
+/// Decoded source sprites kept for composing export previews; dropped past this size
+constexpr int kPreviewSourceImageBytes = 256 * 1024 * 1024;
+
+/// Edge of the square tiles export previews are composed in on worker threads
+constexpr int kPreviewComposeTileSize = 256;
+
+/// Journal records appended before autosave writes a fresh full snapshot
+constexpr int kAutosaveJournalSnapshotRecords = 500;
 
 /// Maximum number of recent projects to keep in menu
 constexpr int kRecentProjectsMax = 5;
@@ -37,10 +37,13 @@ struct AppSettings {
     QString exportDefaultOutputFolder;
     QString exportDefaultFormat = "none";
     QString exportDefaultScaleFilter = "nearest";
+    bool saveProjectAsCbor = false;
+    bool packInProcess = false;
     bool spritePreviewEnabled = true;
     double spritePreviewDelay = 0.4;
     bool navigatorGroupSimilar = true;
     bool showGrid = false;
+    bool showMesh = false;
     int gridCellWidth = 16;
     int gridCellHeight = 16;
     int gridOffsetX = 0;
@@ -211,10 +211,11 @@ bool ArchiveExtractor::readFileFromArchive(const QString& archivePath, const QSt
 
 #include <QDirIterator>
 
-bool ArchiveExtractor::createZip(const QString& sourceDir, const QString& destZipPath, QString& error) {
+namespace {
+struct archive* openZipForWriting(const QString& destZipPath, QString& error) {
     struct archive* a = archive_write_new();
     archive_write_set_format_zip(a);
-    
+
 #ifdef Q_OS_WIN
     int r = archive_write_open_filename_w(a, reinterpret_cast<const wchar_t*>(destZipPath.utf16()));
 #else
@@ -224,6 +225,49 @@ bool ArchiveExtractor::createZip(const QString& sourceDir, const QString& destZi
     if (r != ARCHIVE_OK) {
         error = QString("Could not open output archive: %1").arg(archive_error_string(a));
         archive_write_free(a);
+        return nullptr;
+    }
+    return a;
+}
+
+bool writeZipEntry(struct archive* a, const QString& relPath, const QByteArray& content, QString& error) {
+    struct archive_entry* entry = archive_entry_new();
+#ifdef Q_OS_WIN
+    archive_entry_copy_pathname_w(entry, reinterpret_cast<const wchar_t*>(relPath.utf16()));
+#else
+    archive_entry_set_pathname(entry, PATH_TO_UTF8(relPath));
+#endif
+    archive_entry_set_size(entry, content.size());
+    archive_entry_set_filetype(entry, AE_IFREG);
+    archive_entry_set_perm(entry, 0644);
+
+    if (archive_write_header(a, entry) != ARCHIVE_OK) {
+        error = QString("Header write error: %1").arg(archive_error_string(a));
+        archive_entry_free(entry);
+        return false;
+    }
+    archive_entry_free(entry);
+    if (!content.isEmpty()
+        && archive_write_data(a, content.constData(), static_cast<size_t>(content.size())) < 0) {
+        error = QString("Data write error: %1").arg(archive_error_string(a));
+        return false;
+    }
+    return true;
+}
+
+bool finishZip(struct archive* a, QString& error) {
+    const bool ok = archive_write_close(a) == ARCHIVE_OK;
+    if (!ok) {
+        error = QString("Could not finish output archive: %1").arg(archive_error_string(a));
+    }
+    archive_write_free(a);
+    return ok;
+}
+}  // namespace
+
+bool ArchiveExtractor::createZip(const QString& sourceDir, const QString& destZipPath, QString& error) {
+    struct archive* a = openZipForWriting(destZipPath, error);
+    if (!a) {
         return false;
     }
 
@@ -232,40 +276,36 @@ bool ArchiveExtractor::createZip(const QString& sourceDir, const QString& destZi
     while (it.hasNext()) {
         QString filePath = it.next();
         QString relPath = source.relativeFilePath(filePath);
-        
-        struct archive_entry* entry = archive_entry_new();
-#ifdef Q_OS_WIN
-        archive_entry_copy_pathname_w(entry, reinterpret_cast<const wchar_t*>(relPath.utf16()));
-#else
-        archive_entry_set_pathname(entry, PATH_TO_UTF8(relPath));
-#endif
-        
-        QFileInfo info(filePath);
-        archive_entry_set_size(entry, info.size());
-        archive_entry_set_filetype(entry, AE_IFREG);
-        archive_entry_set_perm(entry, 0644);
-        
-        if (archive_write_header(a, entry) != ARCHIVE_OK) {
-            error = QString("Header write error: %1").arg(archive_error_string(a));
-            archive_entry_free(entry);
-            archive_write_close(a);
-            archive_write_free(a);
-            return false;
-        }
 
+        QByteArray content;
         QFile file(filePath);
         if (file.open(QIODevice::ReadOnly)) {
-            QByteArray content = file.readAll();
-            archive_write_data(a, content.data(), static_cast<size_t>(content.size()));
+            content = file.readAll();
             file.close();
         }
-        
-        archive_entry_free(entry);
+        if (!writeZipEntry(a, relPath, content, error)) {
+            archive_write_close(a);
+            archive_write_free(a);
+            return false;
+        }
     }
 
-    archive_write_close(a);
-    archive_write_free(a);
-    return true;
+    return finishZip(a, error);
+}
+
+bool ArchiveExtractor::createZip(const QVector<ZipEntry>& entries, const QString& destZipPath, QString& error) {
+    struct archive* a = openZipForWriting(destZipPath, error);
+    if (!a) {
+        return false;
+    }
+    for (const ZipEntry& entry : entries) {
+        if (!writeZipEntry(a, entry.path, entry.data, error)) {
+            archive_write_close(a);
+            archive_write_free(a);
+            return false;
+        }
+    }
+    return finishZip(a, error);
 }
 
 QStringList ArchiveExtractor::listEntries(const QString& archivePath, QString& error) {
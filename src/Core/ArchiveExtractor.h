@@ -4,6 +4,7 @@
 #include <QStringList>
 #include <QByteArray>
 #include <QDir>
+#include <QVector>
 #include <atomic>
 
 /**
@@ -41,6 +42,23 @@ public:
      */
     static bool createZip(const QString& sourceDir, const QString& destZipPath, QString& error);
 
+    /**
+     * @brief A file stored in a ZIP archive built from memory.
+     */
+    struct ZipEntry {
+        QString path;      ///< Relative path inside the archive, '/'-separated.
+        QByteArray data;
+    };
+
+    /**
+     * @brief Creates a ZIP archive from in-memory entries, without a staging directory.
+     * @param entries Files to store, written in the given order.
+     * @param destZipPath Path to the destination ZIP file.
+     * @param error Output error message if creation fails.
+     * @return bool True if creation was successful.
+     */
+    static bool createZip(const QVector<ZipEntry>& entries, const QString& destZipPath, QString& error);
+
     /**
      * @brief Lists the file paths stored inside an archive.
      * @param archivePath Path to the archive file.
@@ -10,17 +10,34 @@ struct SaveConfig {
     QString destination;
     QString outputPath;
     QString transform;
+    // Further metadata formats written next to transform's output. Layout and pack run
+    // once per profile; each format only adds its own spratconvert pass.
+    QStringList extraTransforms;
+    // Maximum vertices of the tight "mesh" polygon marker traced from each sprite's
+    // alpha; 0 writes no meshes.
+    int meshVertexBudget = 0;
     QStringList profiles;
     bool profilesGlobal = true;
     QString scaleFilter;
     bool syncSprites = false;
     QString postExportCommand;
     QString atlasSubdir;
+    // Compose PNG spritesheets in-process from sources decoded once for all profiles,
+    // instead of one spratpack run per profile. An application setting, not saved
+    // with the project.
+    bool packInProcess = false;
 };
 
 struct ExportLogEntry {
-    enum class Kind { FileWritten, Info, Error };
+    // Unchanged: the output file already held the same bytes and was not rewritten.
+    enum class Kind { FileWritten, Info, Error, Timing, Unchanged };
     Kind    kind = Kind::FileWritten;
-    QString path;
-    qint64  size = -1;
+    QString path;         // Timing: step name, e.g. "spratpack"
+    qint64  size = -1;    // Timing: bytes the step read or produced
+    // Timing only: what the step worked on (profile output folder, atlas), wall time
+    // and CPU time of the thread that ran it. External tools run in their own
+    // process, so their work shows in wall time only.
+    QString scope;
+    qint64  wallMs = -1;
+    qint64  cpuMs  = -1;
 };
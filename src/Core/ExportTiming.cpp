@@ -0,0 +1,114 @@
+#include "ExportTiming.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#elif !defined(Q_OS_WASM)
+#include <time.h>
+#endif
+
+namespace {
+constexpr int kReportVersion = 1;
+const QString kReportSuffix = QStringLiteral(".timing.json");
+}  // namespace
+
+ExportStepTimer::ExportStepTimer()
+    : m_cpuStartMs(threadCpuMs())
+{
+    m_wall.start();
+}
+
+qint64 ExportStepTimer::wallMs() const {
+    return m_wall.elapsed();
+}
+
+qint64 ExportStepTimer::cpuMs() const {
+    if (m_cpuStartMs < 0) {
+        return -1;
+    }
+    return threadCpuMs() - m_cpuStartMs;
+}
+
+ExportLogEntry ExportStepTimer::finish(const QString& step, const QString& scope, qint64 bytes) const {
+    return entry(step, scope, wallMs(), cpuMs(), bytes);
+}
+
+ExportLogEntry ExportStepTimer::entry(const QString& step, const QString& scope,
+                                      qint64 wallMs, qint64 cpuMs, qint64 bytes) {
+    ExportLogEntry e;
+    e.kind = ExportLogEntry::Kind::Timing;
+    e.path = step;
+    e.size = bytes;
+    e.scope = scope;
+    e.wallMs = wallMs;
+    e.cpuMs = cpuMs;
+    return e;
+}
+
+qint64 ExportStepTimer::threadCpuMs() {
+#if defined(Q_OS_WIN)
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        return -1;
+    }
+    auto ticks = [](const FILETIME& t) {
+        return (qint64(t.dwHighDateTime) << 32) | qint64(t.dwLowDateTime);
+    };
+    return (ticks(kernel) + ticks(user)) / 10000;  // 100 ns units
+#elif defined(Q_OS_WASM)
+    return -1;
+#else
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return -1;
+    }
+    return qint64(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
+
+QString ExportTimingReport::reportPath(const QString& destination) {
+    // Never inside an output folder: an unchanged export must leave the folder untouched.
+    const QFileInfo info(QDir::cleanPath(destination));
+    if (destination.endsWith(QLatin1String(".zip"), Qt::CaseInsensitive)) {
+        return info.dir().filePath(info.completeBaseName() + kReportSuffix);
+    }
+    return info.dir().filePath(info.fileName() + kReportSuffix);
+}
+
+QByteArray ExportTimingReport::toJson(const QVector<ExportLogEntry>& entries, const QString& destination) {
+    QJsonArray steps;
+    for (const ExportLogEntry& e : entries) {
+        if (e.kind != ExportLogEntry::Kind::Timing) {
+            continue;
+        }
+        QJsonObject step;
+        step["step"] = e.path;
+        if (!e.scope.isEmpty()) step["scope"] = e.scope;
+        step["wall_ms"] = e.wallMs;
+        if (e.cpuMs >= 0) step["cpu_ms"] = e.cpuMs;
+        if (e.size >= 0) step["bytes"] = e.size;
+        steps.append(step);
+    }
+    QJsonObject root;
+    root["version"] = kReportVersion;
+    root["written_at"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+    root["destination"] = destination;
+    root["steps"] = steps;
+    return QJsonDocument(root).toJson();
+}
+
+bool ExportTimingReport::write(const QVector<ExportLogEntry>& entries, const QString& destination, QString& error) {
+    QSaveFile file(reportPath(destination));
+    if (!file.open(QIODevice::WriteOnly) || file.write(toJson(entries, destination)) < 0 || !file.commit()) {
+        error = file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+#include "ExportModels.h"
+
+/**
+ * @class ExportStepTimer
+ * @brief Measures one export step and turns it into a Timing log entry.
+ */
+class ExportStepTimer {
+public:
+    ExportStepTimer();
+
+    qint64 wallMs() const;
+    qint64 cpuMs() const;
+    ExportLogEntry finish(const QString& step, const QString& scope = QString(), qint64 bytes = -1) const;
+
+    static ExportLogEntry entry(const QString& step, const QString& scope,
+                                qint64 wallMs, qint64 cpuMs, qint64 bytes);
+    /**
+     * @brief CPU time used by the calling thread so far, or -1 where unavailable.
+     */
+    static qint64 threadCpuMs();
+
+private:
+    QElapsedTimer m_wall;
+    qint64 m_cpuStartMs = -1;
+};
+
+/**
+ * @class ExportTimingReport
+ * @brief Machine-readable copy of an export's Timing entries, written next to the output.
+ */
+class ExportTimingReport {
+public:
+    /**
+     * @brief Report path for an export destination: "<folder>.timing.json" beside an
+     * output folder, or "<name>.timing.json" beside a zip archive.
+     */
+    static QString reportPath(const QString& destination);
+    static QByteArray toJson(const QVector<ExportLogEntry>& entries, const QString& destination);
+    static bool write(const QVector<ExportLogEntry>& entries, const QString& destination, QString& error);
+};
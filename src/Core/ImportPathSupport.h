@@ -8,6 +8,7 @@ namespace ImportPathSupport {
 inline bool isSupportedLocalImportPath(const QString& path) {
     const QString lowerPath = path.toLower();
     return lowerPath.endsWith(".zip") || lowerPath.endsWith(".json") ||
+           lowerPath.endsWith(".cbor") ||
            lowerPath.endsWith(".tar") || lowerPath.endsWith(".tar.gz") ||
            lowerPath.endsWith(".tar.bz2") || lowerPath.endsWith(".tar.xz") ||
            lowerPath.endsWith(".png") || lowerPath.endsWith(".jpg") ||
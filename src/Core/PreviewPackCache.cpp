@@ -0,0 +1,73 @@
+#include "PreviewPackCache.h"
+
+#include <QMutexLocker>
+
+PreviewPackCache::PreviewPackCache(qsizetype maxBytes)
+    : m_maxBytes(maxBytes)
+{}
+
+bool PreviewPackCache::find(const QByteArray& key, Entry& entry) {
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_slots.constFind(key);
+    if (it == m_slots.constEnd()) {
+        return false;
+    }
+    entry = it->entry;
+    m_order.removeOne(key);
+    m_order.append(key);
+    return true;
+}
+
+void PreviewPackCache::insert(const QByteArray& key, Entry entry) {
+    const qsizetype bytes = entryBytes(entry);
+    QMutexLocker locker(&m_mutex);
+    if (const auto it = m_slots.constFind(key); it != m_slots.constEnd()) {
+        m_totalBytes -= it->bytes;
+        m_slots.erase(it);
+        m_order.removeOne(key);
+    }
+    if (bytes > m_maxBytes) {
+        return;
+    }
+    evictLocked(m_maxBytes - bytes);
+    m_slots.insert(key, Slot{std::move(entry), bytes});
+    m_order.append(key);
+    m_totalBytes += bytes;
+}
+
+void PreviewPackCache::clear() {
+    QMutexLocker locker(&m_mutex);
+    m_slots.clear();
+    m_order.clear();
+    m_totalBytes = 0;
+}
+
+int PreviewPackCache::count() const {
+    QMutexLocker locker(&m_mutex);
+    return int(m_slots.size());
+}
+
+qsizetype PreviewPackCache::totalBytes() const {
+    QMutexLocker locker(&m_mutex);
+    return m_totalBytes;
+}
+
+qsizetype PreviewPackCache::entryBytes(const Entry& entry) {
+    qsizetype total = entry.imageData.size() + entry.layoutData.size() + entry.image.sizeInBytes();
+    for (const LayoutModel& model : entry.layoutModels) {
+        for (const SpritePtr& sprite : model.sprites) {
+            if (sprite) {
+                total += qsizetype(sizeof(Sprite))
+                       + (sprite->path.size() + sprite->name.size()) * qsizetype(sizeof(QChar));
+            }
+        }
+    }
+    return total;
+}
+
+void PreviewPackCache::evictLocked(qsizetype maxBytes) {
+    while (m_totalBytes > maxBytes && !m_order.isEmpty()) {
+        const QByteArray oldest = m_order.takeFirst();
+        m_totalBytes -= m_slots.take(oldest).bytes;
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QVector>
+#include "LayoutModels.h"
+
+/**
+ * @class PreviewPackCache
+ * @brief Recently packed export previews, so switching back to an atlas or profile
+ * shows its spritesheet without running spratlayout and spratpack again.
+ *
+ * Entries are keyed by a hash of everything the pack depends on and evicted least
+ * recently used first once their total size exceeds the byte limit. Guarded by a
+ * mutex, since preview tasks look entries up on a worker thread.
+ */
+class PreviewPackCache {
+public:
+    struct Entry {
+        QByteArray imageData;
+        QByteArray layoutData;
+        QVector<LayoutModel> layoutModels;
+        QImage image;  // composed previews are kept decoded instead of as imageData
+    };
+
+    explicit PreviewPackCache(qsizetype maxBytes);
+
+    /**
+     * @brief Copies the entry stored under key and marks it most recently used.
+     * @return bool True if the key was cached.
+     */
+    bool find(const QByteArray& key, Entry& entry);
+
+    /**
+     * @brief Stores an entry, evicting older ones to stay within the byte limit.
+     * Entries larger than the limit on their own are not kept.
+     */
+    void insert(const QByteArray& key, Entry entry);
+
+    void clear();
+    int count() const;
+    qsizetype totalBytes() const;
+
+    /**
+     * @brief Approximate memory an entry keeps alive.
+     */
+    static qsizetype entryBytes(const Entry& entry);
+
+private:
+    struct Slot {
+        Entry entry;
+        qsizetype bytes = 0;
+    };
+    void evictLocked(qsizetype maxBytes);
+
+    mutable QMutex m_mutex;
+    const qsizetype m_maxBytes;
+    QHash<QByteArray, Slot> m_slots;
+    QList<QByteArray> m_order;  // least recently used first
+    qsizetype m_totalBytes = 0;
+};
@@ -66,6 +66,7 @@ struct ExportPreset {
     QString     name;
     QString     outputPath;
     QString     transform;
+    QStringList extraTransforms;
     QString     scaleFilter;
     QStringList profiles;
     QString     postExportCommand;
@@ -0,0 +1,46 @@
+#include "SourceImageStore.h"
+
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMutexLocker>
+
+QImage SourceImageStore::image(const QString& path) {
+    std::shared_ptr<Entry> entry;
+    {
+        QMutexLocker locker(&m_mutex);
+        std::shared_ptr<Entry>& slot = m_entries[path];
+        if (!slot) {
+            slot = std::make_shared<Entry>();
+        }
+        entry = slot;
+    }
+    QMutexLocker entryLocker(&entry->mutex);
+    const QFileInfo info(path);
+    const qint64 fileSize = info.exists() ? info.size() : -1;
+    const QDateTime modified = info.lastModified();
+    if (!entry->loaded || entry->fileSize != fileSize || entry->modified != modified) {
+        QImage decoded = QImageReader(path).read();
+        if (!decoded.isNull()) {
+            decoded = decoded.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        }
+        const qsizetype previousBytes = entry->image.sizeInBytes();
+        entry->image = decoded;
+        entry->fileSize = fileSize;
+        entry->modified = modified;
+        entry->loaded = true;
+        QMutexLocker locker(&m_mutex);
+        ++m_decodeCount;
+        m_totalBytes += decoded.sizeInBytes() - previousBytes;
+    }
+    return entry->image;
+}
+
+int SourceImageStore::decodeCount() const {
+    QMutexLocker locker(&m_mutex);
+    return m_decodeCount;
+}
+
+qsizetype SourceImageStore::totalBytes() const {
+    QMutexLocker locker(&m_mutex);
+    return m_totalBytes;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+
+#include <memory>
+
+/**
+ * @class SourceImageStore
+ * @brief Source sprites decoded once and shared by every profile of an export.
+ *
+ * Images are kept as ARGB32_Premultiplied. Each path is decoded by the first caller
+ * that asks for it; concurrent callers for the same path wait for that decode instead
+ * of reading the file again, while different paths decode in parallel. A file whose
+ * size or modification time changed since it was decoded is read again, so a store
+ * can outlive a single export (e.g. the Export workspace preview).
+ */
+class SourceImageStore {
+public:
+    /**
+     * @brief Decoded image for path, or a null image when it cannot be read.
+     */
+    QImage image(const QString& path);
+
+    // Number of file decodes so far, and the memory the decoded images hold.
+    int decodeCount() const;
+    qsizetype totalBytes() const;
+
+private:
+    struct Entry {
+        QMutex mutex;
+        bool loaded = false;
+        qint64 fileSize = -1;
+        QDateTime modified;
+        QImage image;
+    };
+
+    mutable QMutex m_mutex;
+    QHash<QString, std::shared_ptr<Entry>> m_entries;
+    int m_decodeCount = 0;
+    qsizetype m_totalBytes = 0;
+};
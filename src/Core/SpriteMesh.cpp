@@ -0,0 +1,241 @@
+#include "SpriteMesh.h"
+
+#include <QPointF>
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+// Twice the signed area of triangle (o, a, b); positive when o -> a -> b turns the
+// same way as the hull.
+qint64 cross(const QPoint& o, const QPoint& a, const QPoint& b) {
+    return qint64(a.x() - o.x()) * qint64(b.y() - o.y())
+         - qint64(a.y() - o.y()) * qint64(b.x() - o.x());
+}
+
+// Corners of the outermost pixels of every row; their hull covers every pixel.
+QVector<QPoint> rowCorners(const QImage& image, int alphaThreshold) {
+    QVector<QPoint> points;
+    for (int y = 0; y < image.height(); ++y) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+        int left = -1;
+        int right = -1;
+        for (int x = 0; x < image.width(); ++x) {
+            if (qAlpha(line[x]) > alphaThreshold) {
+                if (left < 0) left = x;
+                right = x;
+            }
+        }
+        if (left < 0) continue;
+        points << QPoint(left, y) << QPoint(left, y + 1)
+               << QPoint(right + 1, y) << QPoint(right + 1, y + 1);
+    }
+    return points;
+}
+
+// Andrew's monotone chain. Collinear points are dropped.
+QVector<QPoint> convexHull(QVector<QPoint> points) {
+    std::sort(points.begin(), points.end(), [](const QPoint& a, const QPoint& b) {
+        return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+    });
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    if (points.size() < 3) return {};
+    QVector<QPoint> hull(points.size() * 2);
+    qsizetype k = 0;
+    for (qsizetype i = 0; i < points.size(); ++i) {
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) --k;
+        hull[k++] = points[i];
+    }
+    const qsizetype lower = k + 1;
+    for (qsizetype i = points.size() - 2; i >= 0; --i) {
+        while (k >= lower && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) --k;
+        hull[k++] = points[i];
+    }
+    hull.resize(k - 1);
+    return hull;
+}
+
+void dropCollinear(QVector<QPoint>& polygon) {
+    bool changed = true;
+    while (changed && polygon.size() > 3) {
+        changed = false;
+        const qsizetype n = polygon.size();
+        for (qsizetype i = 0; i < n; ++i) {
+            if (cross(polygon[(i + n - 1) % n], polygon[i], polygon[(i + 1) % n]) == 0) {
+                polygon.remove(i);
+                changed = true;
+                break;
+            }
+        }
+    }
+}
+
+struct EdgeRemoval {
+    qsizetype edge = -1;  // edge (edge, edge + 1) is replaced by vertex
+    QPoint vertex;
+    qint64 addedArea2 = std::numeric_limits<qint64>::max();
+};
+
+// Cheapest edge to fold away: edge (b, c) is replaced by one integer point q where the
+// neighbouring edges a->b and c->d meet. q is accepted only if the polygon stays convex
+// and b and c stay inside it, so the result still covers every pixel. Intersections are
+// rarely integer, so a few grid points around each are tried.
+EdgeRemoval cheapestRemoval(const QVector<QPoint>& polygon, int reach) {
+    const qsizetype n = polygon.size();
+    EdgeRemoval best;
+    for (qsizetype i = 0; i < n; ++i) {
+        const QPoint& before = polygon[(i + n - 2) % n];
+        const QPoint& a = polygon[(i + n - 1) % n];
+        const QPoint& b = polygon[i];
+        const QPoint& c = polygon[(i + 1) % n];
+        const QPoint& d = polygon[(i + 2) % n];
+        const QPoint& after = polygon[(i + 3) % n];
+        // The lines only meet beyond (b, c) when they turn less than half a turn.
+        const double rx = b.x() - a.x();
+        const double ry = b.y() - a.y();
+        const double sx = d.x() - c.x();
+        const double sy = d.y() - c.y();
+        const double denom = rx * sy - ry * sx;
+        if (denom <= 0.0) continue;
+        const double t = ((c.x() - a.x()) * sy - (c.y() - a.y()) * sx) / denom;
+        const double px = a.x() + t * rx;
+        const double py = a.y() + t * ry;
+        if (std::abs(px) > reach || std::abs(py) > reach) continue;
+        const qint64 oldArea2 = cross(a, b, c) + cross(a, c, d);
+        const int x0 = int(std::floor(px));
+        const int y0 = int(std::floor(py));
+        for (int y = y0 - 1; y <= y0 + 2; ++y) {
+            for (int x = x0 - 1; x <= x0 + 2; ++x) {
+                const QPoint q(x, y);
+                if (cross(a, q, b) < 0 || cross(a, q, c) < 0
+                    || cross(q, d, b) < 0 || cross(q, d, c) < 0) {
+                    continue;
+                }
+                if (cross(before, a, q) < 0 || cross(a, q, d) <= 0 || cross(q, d, after) < 0) {
+                    continue;
+                }
+                const qint64 added = cross(a, q, d) - oldArea2;
+                if (added < best.addedArea2) {
+                    best.edge = i;
+                    best.vertex = q;
+                    best.addedArea2 = added;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+// Folded corners may poke out of the image, where the mesh would sample neighbouring
+// atlas sprites. Clips the polygon to the image, then snaps each cut point to the
+// corners of its pixel-grid cell so the hull of those still covers the clipped polygon.
+QVector<QPoint> clipToImage(const QVector<QPoint>& polygon, int width, int height) {
+    QVector<QPointF> points;
+    points.reserve(polygon.size());
+    for (const QPoint& p : polygon) points.append(QPointF(p));
+    for (int side = 0; side < 4; ++side) {
+        const bool alongX = side < 2;
+        const double limit = side == 0 ? 0.0 : side == 1 ? double(width) : side == 2 ? 0.0 : double(height);
+        const bool keepAbove = side == 0 || side == 2;
+        auto value = [alongX](const QPointF& p) { return alongX ? p.x() : p.y(); };
+        auto inside = [&](const QPointF& p) { return keepAbove ? value(p) >= limit : value(p) <= limit; };
+        QVector<QPointF> clipped;
+        for (qsizetype i = 0, n = points.size(); i < n; ++i) {
+            const QPointF& current = points[i];
+            const QPointF& next = points[(i + 1) % n];
+            if (inside(current)) clipped.append(current);
+            if (inside(current) != inside(next)) {
+                const double t = (limit - value(current)) / (value(next) - value(current));
+                QPointF cut = current + (next - current) * t;
+                if (alongX) cut.setX(limit); else cut.setY(limit);
+                clipped.append(cut);
+            }
+        }
+        points = std::move(clipped);
+    }
+    QVector<QPoint> snapped;
+    snapped.reserve(points.size() * 4);
+    for (const QPointF& p : points) {
+        const int x0 = qBound(0, int(std::floor(p.x())), width);
+        const int x1 = qBound(0, int(std::ceil(p.x())), width);
+        const int y0 = qBound(0, int(std::floor(p.y())), height);
+        const int y1 = qBound(0, int(std::ceil(p.y())), height);
+        snapped << QPoint(x0, y0) << QPoint(x1, y0) << QPoint(x0, y1) << QPoint(x1, y1);
+    }
+    return convexHull(snapped);
+}
+
+double area2(const QVector<QPoint>& polygon) {
+    qint64 sum = 0;
+    for (qsizetype i = 0, n = polygon.size(); i < n; ++i) {
+        const QPoint& p = polygon[i];
+        const QPoint& q = polygon[(i + 1) % n];
+        sum += qint64(p.x()) * q.y() - qint64(q.x()) * p.y();
+    }
+    return double(std::llabs(sum));
+}
+}  // namespace
+
+QPolygon SpriteMesh::trace(const QImage& image, int maxVertices, int alphaThreshold) {
+    if (image.isNull()) return {};
+    const QImage pixels = image.format() == QImage::Format_ARGB32
+            || image.format() == QImage::Format_ARGB32_Premultiplied
+        ? image
+        : image.convertToFormat(QImage::Format_ARGB32);
+    const QVector<QPoint> hull = convexHull(rowCorners(pixels, alphaThreshold));
+    if (hull.isEmpty()) return {};
+
+    // The trimmed rectangle always fits the budget; it is the answer whenever folding
+    // cannot get below the budget or ends up no smaller.
+    int left = pixels.width(), top = pixels.height(), right = 0, bottom = 0;
+    for (const QPoint& p : hull) {
+        left = qMin(left, p.x());
+        top = qMin(top, p.y());
+        right = qMax(right, p.x());
+        bottom = qMax(bottom, p.y());
+    }
+    const QVector<QPoint> box{QPoint(left, top), QPoint(right, top),
+                              QPoint(right, bottom), QPoint(left, bottom)};
+
+    // Fold edges until the polygon fits the budget once clipped back to the image.
+    // Clipping can add corners, so each miss folds one more edge.
+    const int budget = qMax(kMinVertices, maxVertices);
+    const int reach = 4 * qMax(pixels.width(), pixels.height());
+    QVector<QPoint> folded = hull;
+    QVector<QPoint> mesh = box;
+    for (int target = budget; target >= 3; --target) {
+        bool stuck = false;
+        while (folded.size() > target) {
+            const EdgeRemoval removal = cheapestRemoval(folded, reach);
+            if (removal.edge < 0) {
+                stuck = true;
+                break;
+            }
+            const qsizetype n = folded.size();
+            QVector<QPoint> reduced;
+            reduced.reserve(n - 1);
+            for (qsizetype i = 0; i < n; ++i) {
+                if (i == removal.edge) {
+                    reduced.append(removal.vertex);
+                } else if (i != (removal.edge + 1) % n) {
+                    reduced.append(folded[i]);
+                }
+            }
+            folded = std::move(reduced);
+            dropCollinear(folded);
+        }
+        if (stuck) break;
+        const QVector<QPoint> clipped = clipToImage(folded, pixels.width(), pixels.height());
+        if (clipped.size() <= budget) {
+            if (area2(clipped) < area2(box)) mesh = clipped;
+            break;
+        }
+    }
+    return QPolygon(mesh);
+}
+
+double SpriteMesh::area(const QPolygon& polygon) {
+    return area2(polygon) / 2.0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QImage>
+#include <QPolygon>
+
+/**
+ * @class SpriteMesh
+ * @brief Traces a sprite's alpha into a tight convex polygon for export.
+ *
+ * Drawing a sprite as this polygon instead of its rectangle skips most of the
+ * transparent pixels around the content. The outline is the convex hull of every
+ * pixel with alpha above the threshold, then simplified to the vertex budget by
+ * extending neighbouring edges, so it only ever grows and no opaque pixel falls
+ * outside it. Vertices are integer pixel-corner coordinates inside the image.
+ */
+class SpriteMesh {
+public:
+    // Budgets below this are raised to it; the trimmed rectangle always fits.
+    static constexpr int kMinVertices = 4;
+    // Budget the preview uses when the export has no mesh budget set.
+    static constexpr int kDefaultVertices = 8;
+
+    /**
+     * @brief Outline of the pixels with alpha above alphaThreshold, with at most
+     * maxVertices vertices. Empty when the image is fully transparent.
+     */
+    static QPolygon trace(const QImage& image, int maxVertices, int alphaThreshold = 0);
+
+    // Area enclosed by a simple polygon, in square pixels.
+    static double area(const QPolygon& polygon);
+};
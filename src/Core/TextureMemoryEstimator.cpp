@@ -0,0 +1,96 @@
+#include "TextureMemoryEstimator.h"
+
+#include <QCoreApplication>
+#include <QRect>
+
+#include <algorithm>
+
+namespace {
+QString trTextureMemory(const char* text) {
+    return QCoreApplication::translate("TextureMemoryEstimator", text);
+}
+
+// Bytes per 4x4 block, or 0 for uncompressed RGBA8.
+int blockBytes(const QString& gpuCompress) {
+    if (gpuCompress.compare(QLatin1String("dxt1"), Qt::CaseInsensitive) == 0) return 8;
+    if (gpuCompress.compare(QLatin1String("dxt5"), Qt::CaseInsensitive) == 0) return 16;
+    return 0;
+}
+
+// Area the sprites cover. Deduplicated sprites share a rect, so each rect counts once.
+qint64 coveredArea(const LayoutModel& model) {
+    QVector<QRect> rects;
+    rects.reserve(model.sprites.size());
+    for (const SpritePtr& sprite : model.sprites) {
+        if (sprite && !sprite->rect.isEmpty()) rects.append(sprite->rect);
+    }
+    std::sort(rects.begin(), rects.end(), [](const QRect& a, const QRect& b) {
+        if (a.x() != b.x()) return a.x() < b.x();
+        if (a.y() != b.y()) return a.y() < b.y();
+        if (a.width() != b.width()) return a.width() < b.width();
+        return a.height() < b.height();
+    });
+    rects.erase(std::unique(rects.begin(), rects.end()), rects.end());
+    qint64 area = 0;
+    for (const QRect& rect : std::as_const(rects)) {
+        area += qint64(rect.width()) * rect.height();
+    }
+    return area;
+}
+}  // namespace
+
+qint64 TextureMemoryEstimator::levelBytes(const QSize& size, const QString& gpuCompress) {
+    if (size.isEmpty()) return 0;
+    const int block = blockBytes(gpuCompress);
+    if (block == 0) return qint64(size.width()) * size.height() * 4;
+    return qint64((size.width() + 3) / 4) * ((size.height() + 3) / 4) * block;
+}
+
+qint64 TextureMemoryEstimator::textureBytes(const QSize& size, const QString& gpuCompress,
+                                            bool mipmaps) {
+    qint64 bytes = levelBytes(size, gpuCompress);
+    if (!mipmaps || size.isEmpty()) return bytes;
+    QSize level = size;
+    while (level.width() > 1 || level.height() > 1) {
+        level = QSize(qMax(1, level.width() / 2), qMax(1, level.height() / 2));
+        bytes += levelBytes(level, gpuCompress);
+    }
+    return bytes;
+}
+
+TextureMemoryEstimator::Estimate TextureMemoryEstimator::estimate(
+    const QVector<LayoutModel>& models, const QString& gpuCompress, bool mipmaps, double scale) {
+    Estimate result;
+    qint64 totalArea = 0;
+    double totalTransparent = 0.0;
+    for (const LayoutModel& model : models) {
+        if (model.atlasWidth <= 0 || model.atlasHeight <= 0) continue;
+        Page page;
+        page.size = QSize(qMax(1, qRound(model.atlasWidth * scale)),
+                          qMax(1, qRound(model.atlasHeight * scale)));
+        page.baseBytes = levelBytes(page.size, gpuCompress);
+        page.bytes = textureBytes(page.size, gpuCompress, mipmaps);
+        const double area = double(model.atlasWidth) * model.atlasHeight;
+        const double covered = qMin(area, double(coveredArea(model)));
+        page.transparentShare = 1.0 - covered / area;
+
+        const qint64 pageArea = qint64(page.size.width()) * page.size.height();
+        totalArea += pageArea;
+        totalTransparent += page.transparentShare * double(pageArea);
+        result.totalBytes += page.bytes;
+        result.pages.append(page);
+    }
+    if (totalArea > 0) result.transparentShare = totalTransparent / double(totalArea);
+    return result;
+}
+
+QString TextureMemoryEstimator::formatName(const QString& gpuCompress) {
+    switch (blockBytes(gpuCompress)) {
+    case 8:
+        return trTextureMemory("DXT1 (BC1)");
+    case 16:
+        return trTextureMemory("DXT5 (BC3)");
+    default:
+        return trTextureMemory("RGBA8");
+    }
+}
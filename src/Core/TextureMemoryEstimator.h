@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QSize>
+#include <QString>
+#include <QVector>
+#include "LayoutModels.h"
+
+/**
+ * @class TextureMemoryEstimator
+ * @brief Estimates the GPU memory a profile's atlas pages take once uploaded.
+ *
+ * Works from layout models alone, so it runs without packing. Pages upload as RGBA8
+ * unless the profile compresses to DXT1/DXT5, which store 8 or 16 bytes per 4x4
+ * block. The optional mip chain halves each level down to 1x1. Transparent area is
+ * the part of each page no sprite rect covers.
+ */
+class TextureMemoryEstimator {
+public:
+    struct Page {
+        QSize size;
+        qint64 baseBytes = 0;       // level 0 only
+        qint64 bytes = 0;           // level 0 plus the mip chain, if counted
+        double transparentShare = 0.0;
+    };
+
+    struct Estimate {
+        QVector<Page> pages;
+        qint64 totalBytes = 0;
+        double transparentShare = 0.0;  // over the area of all pages
+    };
+
+    /**
+     * @brief Bytes one texture level of @p size takes in the given compression
+     * ("", "dxt1" or "dxt5").
+     */
+    static qint64 levelBytes(const QSize& size, const QString& gpuCompress);
+
+    /**
+     * @brief Bytes a texture of @p size takes, with its full mip chain when @p mipmaps.
+     */
+    static qint64 textureBytes(const QSize& size, const QString& gpuCompress, bool mipmaps);
+
+    /**
+     * @brief Estimates every page in @p models. Page and sprite sizes are multiplied
+     * by @p scale, for models laid out at a different scale than the profile's.
+     */
+    static Estimate estimate(const QVector<LayoutModel>& models, const QString& gpuCompress,
+                             bool mipmaps, double scale = 1.0);
+
+    /**
+     * @brief Display name of the pixel format pages upload as.
+     */
+    static QString formatName(const QString& gpuCompress);
+};
@@ -0,0 +1,298 @@
+#include "AutosaveJournal.h"
+#include "AutosaveProjectStore.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSet>
+
+#ifdef Q_OS_WASM
+#include <emscripten.h>
+extern "C" { void sync_idbfs(); }
+#endif
+
+namespace {
+const QString kOpSnapshot = QStringLiteral("snapshot");
+const QString kOpPivot = QStringLiteral("pivot");
+const QString kOpMarkers = QStringLiteral("markers");
+const QString kOpSpritesMoved = QStringLiteral("sprites_moved");
+const QString kOpTimelines = QStringLiteral("timelines");
+
+QByteArray toLine(const QJsonObject& record) {
+    return QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n';
+}
+
+// Records that fully overwrite one entry; a newer pending one supersedes an older one.
+QString coalesceKey(const QJsonObject& record) {
+    const QString op = record.value("op").toString();
+    if (op == kOpPivot || op == kOpMarkers) {
+        return op + QLatin1Char(':') + record.value("key").toString();
+    }
+    if (op == kOpTimelines) {
+        return op + QLatin1Char(':') + record.value("atlas").toString();
+    }
+    return QString();
+}
+
+// Applies records to the sections of a snapshot. Sections are taken out of the root
+// first so edits do not copy the (potentially very large) sprite table per record.
+class JournalReplayer {
+public:
+    explicit JournalReplayer(QJsonObject& root)
+        : m_root(root)
+        , m_markersInfo(root.take("spritemarkers").toObject())
+        , m_sprites(m_markersInfo.take("sprites").toObject())
+        , m_atlases(root.take("atlases").toArray())
+        , m_animations(root.take("animations").toObject())
+        , m_hasAtlases(!m_atlases.isEmpty())
+        , m_activeAtlasIndex(root.value("active_atlas_index").toInt())
+    {}
+
+    void apply(const QJsonObject& record) {
+        const QString op = record.value("op").toString();
+        if (op == kOpPivot || op == kOpMarkers) {
+            const QString key = record.value("key").toString();
+            QJsonObject state = m_sprites.take(key).toObject();
+            if (op == kOpPivot) {
+                state["has_pivot"] = true;
+                state["pivot_x"] = record.value("x").toInt();
+                state["pivot_y"] = record.value("y").toInt();
+            } else {
+                state["markers"] = record.value("markers").toArray();
+            }
+            m_sprites.insert(key, state);
+        } else if (op == kOpSpritesMoved) {
+            QSet<QString> moved;
+            for (const auto& p : record.value("paths").toArray()) {
+                moved.insert(p.toString());
+            }
+            const QString fromId = record.value("from").toString();
+            const QString toId = record.value("to").toString();
+            for (int i = 0; i < m_atlases.size(); ++i) {
+                QJsonObject atlas = m_atlases.at(i).toObject();
+                const QString id = atlas.value("id").toString();
+                if (id != fromId && id != toId) {
+                    continue;
+                }
+                const QJsonArray paths = atlas.value("sprite_paths").toArray();
+                QJsonArray kept;
+                QSet<QString> present;
+                for (const auto& p : paths) {
+                    const QString path = p.toString();
+                    if (id == fromId && moved.contains(path)) {
+                        continue;
+                    }
+                    kept.append(path);
+                    present.insert(path);
+                }
+                if (id == toId && !atlas.value("is_excluded").toBool()) {
+                    for (const auto& p : record.value("paths").toArray()) {
+                        if (!present.contains(p.toString())) {
+                            kept.append(p);
+                        }
+                    }
+                }
+                atlas["sprite_paths"] = kept;
+                m_atlases.replace(i, atlas);
+            }
+        } else if (op == kOpTimelines) {
+            const QString atlasId = record.value("atlas").toString();
+            const QJsonArray timelines = record.value("timelines").toArray();
+            bool isActive = !m_hasAtlases;
+            for (int i = 0; i < m_atlases.size(); ++i) {
+                QJsonObject atlas = m_atlases.at(i).toObject();
+                if (atlas.value("id").toString() != atlasId) {
+                    continue;
+                }
+                atlas["timelines"] = timelines;
+                m_atlases.replace(i, atlas);
+                isActive = (i == m_activeAtlasIndex);
+                break;
+            }
+            if (isActive) {
+                m_animations["timelines"] = timelines;
+            }
+        }
+    }
+
+    void finish() {
+        m_markersInfo["sprites"] = m_sprites;
+        m_root["spritemarkers"] = m_markersInfo;
+        if (m_hasAtlases) {
+            m_root["atlases"] = m_atlases;
+        }
+        m_root["animations"] = m_animations;
+    }
+
+private:
+    QJsonObject& m_root;
+    QJsonObject m_markersInfo;
+    QJsonObject m_sprites;
+    QJsonArray m_atlases;
+    QJsonObject m_animations;
+    bool m_hasAtlases = false;
+    int m_activeAtlasIndex = 0;
+};
+
+}  // namespace
+
+QString AutosaveJournal::defaultPath() {
+    const QFileInfo snapshot(AutosaveProjectStore::defaultPath());
+    return snapshot.dir().filePath(snapshot.completeBaseName() + ".journal");
+}
+
+AutosaveJournal::AutosaveJournal(const QString& path)
+    : m_path(path)
+{}
+
+bool AutosaveJournal::reset(const QString& snapshotId, QString& error) {
+    m_recordCount = 0;
+    m_snapshotId.clear();
+
+    const QString parentDir = QFileInfo(m_path).path();
+    if (!parentDir.isEmpty() && !QDir(parentDir).exists() && !QDir().mkpath(parentDir)) {
+        error = "Could not create autosave directory.";
+        return false;
+    }
+    QFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = "Could not write autosave journal.";
+        return false;
+    }
+    QJsonObject header;
+    header["op"] = kOpSnapshot;
+    header["snapshot"] = snapshotId;
+    if (file.write(toLine(header)) < 0) {
+        error = "Could not write autosave journal.";
+        return false;
+    }
+    file.close();
+    m_snapshotId = snapshotId;
+    return true;
+}
+
+void AutosaveJournal::close() {
+    m_pending.clear();
+    m_recordCount = 0;
+    m_snapshotId.clear();
+}
+
+void AutosaveJournal::record(const QJsonObject& record) {
+    const QString key = coalesceKey(record);
+    if (!key.isEmpty()) {
+        for (QJsonObject& pending : m_pending) {
+            if (coalesceKey(pending) == key) {
+                pending = record;
+                return;
+            }
+        }
+    }
+    m_pending.append(record);
+}
+
+bool AutosaveJournal::flush(QString& error) {
+    if (m_pending.isEmpty()) {
+        return true;
+    }
+    if (!isOpen()) {
+        error = "Autosave journal has no snapshot.";
+        return false;
+    }
+    QByteArray data;
+    for (const QJsonObject& record : m_pending) {
+        data += toLine(record);
+    }
+    QFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        error = "Could not write autosave journal.";
+        return false;
+    }
+    if (file.write(data) < 0) {
+        error = "Could not write autosave journal.";
+        return false;
+    }
+    file.close();
+    m_recordCount += m_pending.size();
+    m_pending.clear();
+
+#ifdef Q_OS_WASM
+    sync_idbfs();
+#endif
+    return true;
+}
+
+QJsonObject AutosaveJournal::pivotRecord(const QString& spriteKey, int x, int y) {
+    QJsonObject record;
+    record["op"] = kOpPivot;
+    record["key"] = spriteKey;
+    record["x"] = x;
+    record["y"] = y;
+    return record;
+}
+
+QJsonObject AutosaveJournal::markersRecord(const QString& spriteKey, const QJsonArray& markers) {
+    QJsonObject record;
+    record["op"] = kOpMarkers;
+    record["key"] = spriteKey;
+    record["markers"] = markers;
+    return record;
+}
+
+QJsonObject AutosaveJournal::spritesMovedRecord(const QStringList& spritePaths,
+                                                const QString& fromAtlasId, const QString& toAtlasId) {
+    QJsonObject record;
+    record["op"] = kOpSpritesMoved;
+    record["paths"] = QJsonArray::fromStringList(spritePaths);
+    record["from"] = fromAtlasId;
+    record["to"] = toAtlasId;
+    return record;
+}
+
+QJsonObject AutosaveJournal::timelinesRecord(const QString& atlasId, const QJsonArray& timelines) {
+    QJsonObject record;
+    record["op"] = kOpTimelines;
+    record["atlas"] = atlasId;
+    record["timelines"] = timelines;
+    return record;
+}
+
+int AutosaveJournal::replay(const QString& path, QJsonObject& root) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    if (lines.isEmpty()) {
+        return 0;
+    }
+    const QJsonObject header = QJsonDocument::fromJson(lines.first()).object();
+    if (header.value("op").toString() != kOpSnapshot
+        || header.value("snapshot").toString() != root.value("written_at").toString()) {
+        // Written against another snapshot; its records are either stale or already included.
+        return 0;
+    }
+
+    JournalReplayer replayer(root);
+    int applied = 0;
+    for (int i = 1; i < lines.size(); ++i) {
+        if (lines.at(i).trimmed().isEmpty()) {
+            continue;
+        }
+        const QJsonDocument doc = QJsonDocument::fromJson(lines.at(i));
+        if (!doc.isObject()) {
+            // A torn final line from an interrupted write; everything before it is intact.
+            break;
+        }
+        replayer.apply(doc.object());
+        ++applied;
+    }
+    replayer.finish();
+    return applied;
+}
+
+void AutosaveJournal::applyRecord(QJsonObject& root, const QJsonObject& record) {
+    JournalReplayer replayer(root);
+    replayer.apply(record);
+    replayer.finish();
+}
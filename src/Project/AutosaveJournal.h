@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Append-only companion to the autosave snapshot. Small edit records are queued,
+// flushed as JSON lines, and replayed on top of the snapshot on recovery. The first
+// line names the snapshot (its "written_at" stamp) so a journal is never replayed on
+// a snapshot it was not written against.
+class AutosaveJournal {
+public:
+    static QString defaultPath();
+
+    explicit AutosaveJournal(const QString& path = defaultPath());
+
+    QString path() const { return m_path; }
+
+    // Truncates the journal and binds it to the snapshot that was just written. Pending
+    // records are kept: they were queued after the snapshot input was captured.
+    bool reset(const QString& snapshotId, QString& error);
+    // True once reset() bound the journal to a snapshot written by this session.
+    bool isOpen() const { return !m_snapshotId.isEmpty(); }
+    void close();
+
+    void record(const QJsonObject& record);
+    // Drops queued records once a snapshot that includes them has been captured.
+    void clearPending() { m_pending.clear(); }
+    bool flush(QString& error);
+    int pendingCount() const { return m_pending.size(); }
+    // Records written since the last reset, excluding pending ones.
+    int recordCount() const { return m_recordCount; }
+
+    static QJsonObject pivotRecord(const QString& spriteKey, int x, int y);
+    static QJsonObject markersRecord(const QString& spriteKey, const QJsonArray& markers);
+    static QJsonObject spritesMovedRecord(const QStringList& spritePaths,
+                                          const QString& fromAtlasId, const QString& toAtlasId);
+    static QJsonObject timelinesRecord(const QString& atlasId, const QJsonArray& timelines);
+
+    // Replays the journal at path onto the snapshot root; returns the number of records applied.
+    static int replay(const QString& path, QJsonObject& root);
+    static void applyRecord(QJsonObject& root, const QJsonObject& record);
+
+private:
+    QString m_path;
+    QString m_snapshotId;
+    QVector<QJsonObject> m_pending;
+    int m_recordCount = 0;
+};
@@ -1,9 +1,13 @@
 #include "AutosaveProjectStore.h"
+#include "ProjectPayloadCache.h"
+#include "ProjectPayloadCodec.h"
 
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
 #include <QJsonDocument>
+#include <QSaveFile>
 #include <QStandardPaths>
 
 QString AutosaveProjectStore::defaultPath() {
@@ -41,6 +45,10 @@ extern "C" { void sync_idbfs(); }
 #endif
 
 bool AutosaveProjectStore::save(const QString& path, const QJsonObject& root, QString& error) {
+    return saveData(path, QJsonDocument(root).toJson(), error);
+}
+
+bool AutosaveProjectStore::saveData(const QString& path, const QByteArray& data, QString& error) {
     const QFileInfo fileInfo(path);
     const QString parentDir = fileInfo.path();
     if (!parentDir.isEmpty()) {
@@ -51,19 +59,51 @@ bool AutosaveProjectStore::save(const QString& path, const QJsonObject& root, QS
         }
     }
 
-    QFile file(path);
+    // Written to a temporary file and renamed over the old snapshot on commit, so an
+    // interrupted write leaves the previous autosave intact.
+    QSaveFile file(path);
     if (!file.open(QIODevice::WriteOnly)) {
         error = "Autosave failed";
         return false;
     }
-    if (file.write(QJsonDocument(root).toJson()) < 0) {
+    if (file.write(data) < 0 || !file.commit()) {
         error = "Autosave failed";
         return false;
     }
-    file.close();
 
 #ifdef Q_OS_WASM
     sync_idbfs();
 #endif
     return true;
 }
+
+void AutosaveProjectStore::detachSprites(ProjectPayloadBuildInput& input) {
+    QHash<const Sprite*, SpritePtr> copies;
+    auto detach = [&copies](SpritePtr& sprite) {
+        if (!sprite) {
+            return;
+        }
+        SpritePtr& copy = copies[sprite.get()];
+        if (!copy) {
+            copy = std::make_shared<Sprite>(*sprite);
+        }
+        sprite = copy;
+    };
+    for (auto& model : input.layoutModels) {
+        for (auto& sprite : model.sprites) {
+            detach(sprite);
+        }
+    }
+    detach(input.selectedSprite);
+    // Edits marked after the copy must still reach the cache from the live sprites.
+    if (input.payloadCache) {
+        input.payloadCacheMarks = input.payloadCache->markSerial();
+    }
+}
+
+AutosaveWriteResult AutosaveProjectStore::write(const QString& path, const ProjectPayloadBuildInput& input) {
+    AutosaveWriteResult result;
+    const QByteArray data = ProjectPayloadCodec::toJson(input, &result.writtenAt);
+    result.ok = saveData(path, data, result.error);
+    return result;
+}
@@ -1,11 +1,27 @@
 #pragma once
 
+#include <QByteArray>
 #include <QJsonObject>
 #include <QString>
 
+struct ProjectPayloadBuildInput;
+
+struct AutosaveWriteResult {
+    bool ok = false;
+    QString writtenAt;  // "written_at" stamp of the snapshot; binds the autosave journal
+    QString error;
+};
+
 class AutosaveProjectStore {
 public:
     static QString defaultPath();
     static bool save(const QString& path, const QJsonObject& root, QString& error);
+    // Writes already-encoded snapshot text; save() encodes the root and calls this.
+    static bool saveData(const QString& path, const QByteArray& data, QString& error);
     static bool load(const QString& path, QJsonObject& root, QString& error);
+    // Replaces the sprites the input shares with the session by private copies, so the
+    // input can be encoded on a worker thread while the GUI keeps editing.
+    static void detachSprites(ProjectPayloadBuildInput& input);
+    // Builds the payload from a detached input and saves it; safe to run off the GUI thread.
+    static AutosaveWriteResult write(const QString& path, const ProjectPayloadBuildInput& input);
 };
@@ -0,0 +1,222 @@
+#include "BinaryMetadataExport.h"
+#include "ProjectPayloadCodec.h"
+
+#include <QDir>
+#include <QHash>
+#include <QList>
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+using namespace BinaryMetadataFormat;
+
+// Text between the first quote at or after from and the quote that follows it.
+QString quoted(const QByteArray& line, qsizetype from = 0) {
+    const qsizetype open = line.indexOf('"', from);
+    const qsizetype close = line.indexOf('"', open + 1);
+    if (open < 0 || close < 0) {
+        return QString();
+    }
+    return QString::fromUtf8(line.mid(open + 1, close - open - 1));
+}
+
+struct TextAnimation {
+    QString name;
+    quint32 fps = 0;
+    QString aliasOf;
+    quint32 flags = 0;
+    QStringList frames;
+};
+
+// Pivot markers keyed by the sprite path as written in the markers text.
+QHash<QString, QPoint> parsePivots(const QByteArray& markers) {
+    QHash<QString, QPoint> pivots;
+    QString currentPath;
+    for (const QByteArray& rawLine : markers.split('\n')) {
+        const QByteArray line = rawLine.trimmed();
+        if (line.startsWith("path ")) {
+            currentPath = quoted(line);
+        } else if (line.startsWith("- marker \"pivot\" point ")) {
+            const QList<QByteArray> coords = line.mid(line.lastIndexOf(' ') + 1).split(',');
+            if (coords.size() == 2 && !currentPath.isEmpty()) {
+                pivots.insert(currentPath, QPoint(coords[0].toInt(), coords[1].toInt()));
+            }
+        }
+    }
+    return pivots;
+}
+
+QVector<TextAnimation> parseAnimations(const QByteArray& animations) {
+    QVector<TextAnimation> out;
+    for (const QByteArray& rawLine : animations.split('\n')) {
+        const QByteArray line = rawLine.trimmed();
+        if (line.startsWith("animation ")) {
+            TextAnimation animation;
+            animation.name = quoted(line);
+            animation.fps = line.mid(line.lastIndexOf(' ') + 1).toUInt();
+            out.append(animation);
+        } else if (out.isEmpty()) {
+            continue;
+        } else if (line.startsWith("- frame ")) {
+            out.last().frames.append(quoted(line));
+        } else if (line.startsWith("alias ")) {
+            out.last().aliasOf = quoted(line);
+            const qsizetype flip = line.lastIndexOf(" flip ");
+            if (flip > line.lastIndexOf('"')) {
+                const QByteArray axes = line.mid(flip + 6);
+                if (axes.contains('h')) out.last().flags |= AnimationFlipH;
+                if (axes.contains('v')) out.last().flags |= AnimationFlipV;
+            }
+        }
+    }
+    return out;
+}
+
+class StringTable {
+public:
+    StringTable() { m_data.append('\0'); }
+
+    quint32 add(const QString& text) {
+        if (text.isEmpty()) {
+            return 0;
+        }
+        const auto it = m_offsets.constFind(text);
+        if (it != m_offsets.constEnd()) {
+            return *it;
+        }
+        const quint32 offset = quint32(m_data.size());
+        m_data.append(text.toUtf8());
+        m_data.append('\0');
+        m_offsets.insert(text, offset);
+        return offset;
+    }
+
+    const QByteArray& data() const { return m_data; }
+
+private:
+    QByteArray m_data;
+    QHash<QString, quint32> m_offsets;
+};
+
+template <typename Record>
+void appendRecord(QByteArray& out, const Record& record) {
+    out.append(reinterpret_cast<const char*>(&record), qsizetype(sizeof(Record)));
+}
+
+void alignTo4(QByteArray& out) {
+    while (out.size() % 4 != 0) {
+        out.append('\0');
+    }
+}
+}  // namespace
+
+QByteArray BinaryMetadataExport::build(const QVector<LayoutModel>& models,
+                                       const ExportMetadataText& metadata,
+                                       const QString& sourceFolder) {
+    const QDir sourceDir(sourceFolder);
+    const QHash<QString, QPoint> pivots = parsePivots(metadata.markers);
+    StringTable strings;
+
+    // Sprites are looked up by absolute path, then by the path relative to the project
+    // folder, which is how markers and portable timelines refer to them.
+    QHash<QString, quint32> spriteIndex;
+    QByteArray spriteRecords;
+    quint32 spriteCount = 0;
+    for (int page = 0; page < models.size(); ++page) {
+        for (const SpritePtr& sprite : models[page].sprites) {
+            if (!sprite) {
+                continue;
+            }
+            const QString absolutePath = QDir::cleanPath(sprite->path);
+            const QString relativePath = sourceDir.relativeFilePath(absolutePath);
+            // Same key as the markers text; a bare file name could match another folder's sprite.
+            const QPoint pivot = pivots.value(ProjectPayloadCodec::spriteStateKey(sourceDir, absolutePath),
+                                              QPoint(sprite->pivotX, sprite->pivotY));
+            SpriteRecord record;
+            std::memset(static_cast<void*>(&record), 0, sizeof(record));
+            record.nameOffset = strings.add(sprite->name);
+            record.pathOffset = strings.add(relativePath);
+            record.page = quint16(page);
+            record.flags = quint16((sprite->rotated ? SpriteRotated : 0)
+                                   | (sprite->trimmed ? SpriteTrimmed : 0));
+            record.x = sprite->rect.x();
+            record.y = sprite->rect.y();
+            record.width = sprite->rect.width();
+            record.height = sprite->rect.height();
+            if (sprite->trimmed) {
+                record.trimLeft = sprite->trimRect.x();
+                record.trimTop = sprite->trimRect.y();
+                record.trimRight = sprite->trimRect.width();
+                record.trimBottom = sprite->trimRect.height();
+            }
+            record.pivotX = pivot.x();
+            record.pivotY = pivot.y();
+            appendRecord(spriteRecords, record);
+            spriteIndex.insert(absolutePath, spriteCount);
+            spriteIndex.insert(relativePath, spriteCount);
+            ++spriteCount;
+        }
+    }
+
+    QByteArray animationRecords;
+    QByteArray frameRecords;
+    quint32 frameCount = 0;
+    const QVector<TextAnimation> animations = parseAnimations(metadata.animations);
+    for (const TextAnimation& animation : animations) {
+        AnimationRecord record;
+        std::memset(static_cast<void*>(&record), 0, sizeof(record));
+        record.nameOffset = strings.add(animation.name);
+        record.fps = animation.fps;
+        record.firstFrame = frameCount;
+        record.aliasOfOffset = animation.aliasOf.isEmpty() ? kNoString : strings.add(animation.aliasOf);
+        record.flags = animation.flags;
+        quint32 frames = 0;
+        for (const QString& frame : animation.frames) {
+            const QString key = QDir::isRelativePath(frame) ? sourceDir.absoluteFilePath(frame) : frame;
+            const quint32_le index = spriteIndex.value(QDir::cleanPath(key), kMissingSprite);
+            frameRecords.append(reinterpret_cast<const char*>(&index), qsizetype(sizeof(index)));
+            ++frames;
+        }
+        record.frameCount = frames;
+        frameCount += frames;
+        appendRecord(animationRecords, record);
+    }
+
+    Header header;
+    std::memset(static_cast<void*>(&header), 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.headerSize = quint16(sizeof(Header));
+    header.pageCount = quint32(models.size());
+    header.pageOffset = quint32(sizeof(Header));
+    if (!models.isEmpty()) {
+        header.scaleMilli = quint32(std::lround(models.first().scale * 1000.0));
+    }
+    QByteArray pageRecords;
+    for (const LayoutModel& model : models) {
+        PageRecord page;
+        page.width = quint32(qMax(0, model.atlasWidth));
+        page.height = quint32(qMax(0, model.atlasHeight));
+        appendRecord(pageRecords, page);
+    }
+    header.spriteCount = spriteCount;
+    header.spriteOffset = header.pageOffset + quint32(pageRecords.size());
+    header.animationCount = quint32(animations.size());
+    header.animationOffset = header.spriteOffset + quint32(spriteRecords.size());
+    header.frameCount = frameCount;
+    header.frameOffset = header.animationOffset + quint32(animationRecords.size());
+    header.stringTableSize = quint32(strings.data().size());
+    header.stringTableOffset = header.frameOffset + quint32(frameRecords.size());
+
+    QByteArray out;
+    out.reserve(qsizetype(header.stringTableOffset + header.stringTableSize) + 3);
+    appendRecord(out, header);
+    out.append(pageRecords);
+    out.append(spriteRecords);
+    out.append(animationRecords);
+    out.append(frameRecords);
+    out.append(strings.data());
+    alignTo4(out);
+    return out;
+}
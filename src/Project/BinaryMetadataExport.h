@@ -0,0 +1,104 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <QtEndian>
+#include "ExportMetadataText.h"
+#include "models.h"
+
+/**
+ * Layout of the "binary" export format (sprites.bin): one flat little-endian file a
+ * runtime can memory-map and read in place. Every section starts on a 4-byte boundary
+ * and is located through the header; strings are NUL-terminated UTF-8 inside the string
+ * table, referenced by byte offset (offset 0 is the empty string).
+ *
+ *   Header | PageRecord[pageCount] | SpriteRecord[spriteCount] | AnimationRecord[animationCount]
+ *          | quint32 frames[frameCount] | string table
+ *
+ * A frame is a sprite index, or kMissingSprite when the timeline names a sprite the
+ * layout does not contain.
+ */
+namespace BinaryMetadataFormat {
+
+constexpr char kMagic[4] = {'S', 'P', 'R', 'B'};
+constexpr quint16 kVersion = 2;
+constexpr quint32 kNoString = 0xFFFFFFFFu;
+constexpr quint32 kMissingSprite = 0xFFFFFFFFu;  // frame whose sprite is not in the layout
+
+enum SpriteFlags : quint16 {
+    SpriteRotated = 1 << 0,  // stored a quarter turn clockwise in the atlas
+    SpriteTrimmed = 1 << 1,
+};
+
+enum AnimationFlags : quint32 {
+    AnimationFlipH = 1 << 0,
+    AnimationFlipV = 1 << 1,
+};
+
+struct Header {
+    char magic[4];
+    quint16_le version;
+    quint16_le headerSize;
+    quint32_le pageCount;        // atlas pages; sprites reference them by index
+    quint32_le pageOffset;
+    quint32_le scaleMilli;       // layout scale x 1000
+    quint32_le spriteCount;
+    quint32_le spriteOffset;
+    quint32_le animationCount;
+    quint32_le animationOffset;
+    quint32_le frameCount;
+    quint32_le frameOffset;
+    quint32_le stringTableSize;
+    quint32_le stringTableOffset;
+};
+
+struct PageRecord {
+    quint32_le width;
+    quint32_le height;
+};
+
+struct SpriteRecord {
+    quint32_le nameOffset;
+    quint32_le pathOffset;       // source path relative to the project folder
+    quint16_le page;
+    quint16_le flags;            // SpriteFlags
+    qint32_le x, y, width, height;                   // rect in the atlas page
+    qint32_le trimLeft, trimTop, trimRight, trimBottom;  // source pixels trimmed away
+    qint32_le pivotX, pivotY;    // source pixels
+};
+
+struct AnimationRecord {
+    quint32_le nameOffset;
+    quint32_le fps;
+    quint32_le firstFrame;       // index into the frames array of sprite indices
+    quint32_le frameCount;       // 0 for aliases
+    quint32_le aliasOfOffset;    // kNoString unless this animation replays another
+    quint32_le flags;            // AnimationFlags
+};
+
+static_assert(sizeof(Header) == 52, "binary metadata header layout");
+static_assert(sizeof(PageRecord) == 8, "binary metadata page layout");
+static_assert(sizeof(SpriteRecord) == 52, "binary metadata sprite layout");
+static_assert(sizeof(AnimationRecord) == 24, "binary metadata animation layout");
+
+}  // namespace BinaryMetadataFormat
+
+/**
+ * @class BinaryMetadataExport
+ * @brief Writes the "binary" export format from a profile's layout and the shared
+ * markers and animations text.
+ */
+class BinaryMetadataExport {
+public:
+    static QString fileName() { return QStringLiteral("sprites.bin"); }
+
+    /**
+     * @brief Builds the file. Sprites keep layout order; pivots come from the "pivot"
+     * markers and animation frames are resolved to sprite indices. Frames that match no
+     * sprite in the layout keep their place as kMissingSprite, so frame numbers match the
+     * text export.
+     */
+    static QByteArray build(const QVector<LayoutModel>& models, const ExportMetadataText& metadata,
+                            const QString& sourceFolder);
+};
@@ -0,0 +1,302 @@
+#include "ExportMetadataText.h"
+#include "MarkerUtils.h"
+#include "ProjectPayloadCodec.h"
+#include "SourceImageStore.h"
+#include "SpriteMesh.h"
+
+#include <QDir>
+#include <QJsonArray>
+#include <QMap>
+#include <QtConcurrent>
+
+namespace {
+constexpr int kDefaultAnimationFps = 8;
+
+void appendQuoted(QByteArray& out, const QString& text) {
+    out += '"';
+    out += text.toUtf8();
+    out += '"';
+}
+
+void appendCoords(QByteArray& out, int a, int b) {
+    out += ' ';
+    out += QByteArray::number(a);
+    out += ',';
+    out += QByteArray::number(b);
+}
+
+void appendSpriteHeader(QByteArray& out, const QString& key) {
+    out += "path ";
+    appendQuoted(out, key);
+    out += '\n';
+}
+
+void appendMarkerHeader(QByteArray& out, const QString& name, const QString& kind) {
+    out += "- marker ";
+    appendQuoted(out, name);
+    out += ' ';
+    out += kind.toUtf8();
+}
+
+void appendPivot(QByteArray& out, int x, int y) {
+    out += "- marker \"pivot\" point";
+    appendCoords(out, x, y);
+    out += '\n';
+}
+
+void appendAliases(QByteArray& out, const QString& canonicalName, const QStringList& aliases) {
+    if (canonicalName.isEmpty()) {
+        return;
+    }
+    for (const QString& a : aliases) {
+        const QString alias = a.trimmed();
+        if (alias.isEmpty()) {
+            continue;
+        }
+        out += "alias ";
+        appendQuoted(out, alias);
+        out += ' ';
+        appendQuoted(out, canonicalName);
+        out += '\n';
+    }
+}
+
+void appendAnimationHeader(QByteArray& out, int animationFps) {
+    out += "fps ";
+    out += QByteArray::number(animationFps);
+    out += "\n\n";
+}
+
+void appendAnimation(QByteArray& out, const QString& name, int fps, const QString& aliasOf,
+                     bool hFlip, bool vFlip, const QStringList& frames) {
+    out += "animation ";
+    appendQuoted(out, name);
+    out += ' ';
+    out += QByteArray::number(fps > 0 ? fps : kDefaultAnimationFps);
+    out += '\n';
+    if (!aliasOf.isEmpty()) {
+        out += "alias ";
+        appendQuoted(out, aliasOf);
+        if (hFlip || vFlip) {
+            out += " flip ";
+            if (hFlip) out += 'h';
+            if (vFlip) out += 'v';
+        }
+        out += '\n';
+    } else {
+        for (const QString& frame : frames) {
+            out += "- frame ";
+            appendQuoted(out, frame);
+            out += '\n';
+        }
+    }
+    out += '\n';
+}
+}  // namespace
+
+ExportMetadataText ExportMetadataText::build(const QString& currentFolder,
+                                             const QVector<LayoutModel>& layoutModels,
+                                             const QVector<AnimationTimeline>& timelines) {
+    // Same key and order as the payload's sprite table; a later sprite with the same
+    // key replaces an earlier one there too.
+    const QDir currentDir(currentFolder);
+    QMap<QString, const Sprite*> sprites;
+    for (const LayoutModel& model : layoutModels) {
+        for (const SpritePtr& sprite : model.sprites) {
+            if (sprite) {
+                sprites.insert(ProjectPayloadCodec::spriteStateKey(currentDir, sprite->path), sprite.get());
+            }
+        }
+    }
+
+    ExportMetadataText text;
+    for (auto it = sprites.constBegin(); it != sprites.constEnd(); ++it) {
+        const Sprite& sprite = *it.value();
+        appendSpriteHeader(text.markers, it.key());
+        bool hasPivotMarker = false;
+        for (const NamedPoint& p : sprite.points) {
+            const QString name = normalizeMarkerName(p.name);
+            appendMarkerHeader(text.markers, name, markerKindToString(p.kind));
+            switch (p.kind) {
+            case MarkerKind::Point:
+                appendCoords(text.markers, p.x, p.y);
+                break;
+            case MarkerKind::Circle:
+                appendCoords(text.markers, p.x, p.y);
+                text.markers += ' ';
+                text.markers += QByteArray::number(p.radius);
+                break;
+            case MarkerKind::Rectangle:
+                appendCoords(text.markers, p.x, p.y);
+                appendCoords(text.markers, p.w, p.h);
+                break;
+            case MarkerKind::Polygon:
+                for (const QPoint& pt : p.polygonPoints) {
+                    appendCoords(text.markers, pt.x(), pt.y());
+                }
+                break;
+            }
+            text.markers += '\n';
+            hasPivotMarker = hasPivotMarker || name == QLatin1String("pivot");
+        }
+        if (!hasPivotMarker) {
+            appendPivot(text.markers, sprite.pivotX, sprite.pivotY);
+        }
+        text.markers += '\n';
+    }
+    for (const Sprite* sprite : std::as_const(sprites)) {
+        appendAliases(text.markers, sprite->name, sprite->aliases);
+    }
+
+    const int animationFps = timelines.isEmpty() ? kDefaultAnimationFps : timelines.first().fps;
+    appendAnimationHeader(text.animations, animationFps);
+    for (const AnimationTimeline& t : timelines) {
+        appendAnimation(text.animations, t.name, t.fps, t.aliasOf, t.hFlip, t.vFlip, t.frames);
+    }
+    return text;
+}
+
+ExportMetadataText ExportMetadataText::fromPayload(const QJsonObject& projectPayload) {
+    ExportMetadataText text;
+    const QJsonObject spritesState = projectPayload["spritemarkers"].toObject()["sprites"].toObject();
+    for (auto it = spritesState.begin(); it != spritesState.end(); ++it) {
+        const QJsonObject spriteState = it.value().toObject();
+        appendSpriteHeader(text.markers, it.key());
+        bool hasPivotMarker = false;
+        for (const auto& markerVal : spriteState["markers"].toArray()) {
+            const QJsonObject markerObj = markerVal.toObject();
+            const QString markerName = normalizeMarkerName(markerObj["name"].toString());
+            QString markerKindStr = markerObj["kind"].toString();
+            if (markerKindStr.isEmpty()) {
+                markerKindStr = markerObj["type"].toString();
+            }
+            if (markerKindStr.isEmpty()) {
+                markerKindStr = "point";
+            }
+            appendMarkerHeader(text.markers, markerName, markerKindStr);
+
+            if (markerKindStr == "point") {
+                appendCoords(text.markers, markerObj["x"].toInt(), markerObj["y"].toInt());
+            } else if (markerKindStr == "circle") {
+                appendCoords(text.markers, markerObj["x"].toInt(), markerObj["y"].toInt());
+                text.markers += ' ';
+                text.markers += QByteArray::number(markerObj["radius"].toInt());
+            } else if (markerKindStr == "rectangle") {
+                appendCoords(text.markers, markerObj["x"].toInt(), markerObj["y"].toInt());
+                appendCoords(text.markers, markerObj["w"].toInt(), markerObj["h"].toInt());
+            } else if (markerKindStr == "polygon") {
+                QJsonArray vertices = markerObj["vertices"].toArray();
+                if (vertices.isEmpty()) {
+                    vertices = markerObj["polygon_points"].toArray(); // Legacy fallback
+                }
+                for (const auto& vVal : vertices) {
+                    if (vVal.isArray()) {
+                        const QJsonArray vArr = vVal.toArray();
+                        if (vArr.size() >= 2) {
+                            appendCoords(text.markers, vArr[0].toInt(), vArr[1].toInt());
+                        }
+                    } else {
+                        const QJsonObject vObj = vVal.toObject();
+                        appendCoords(text.markers, vObj["x"].toInt(), vObj["y"].toInt());
+                    }
+                }
+            }
+            text.markers += '\n';
+            hasPivotMarker = hasPivotMarker || markerName == QLatin1String("pivot");
+        }
+        if (!hasPivotMarker) {
+            appendPivot(text.markers, spriteState["pivot_x"].toInt(), spriteState["pivot_y"].toInt());
+        }
+        text.markers += '\n';
+    }
+
+    // Top-level alias directives for each sprite that has aliases.
+    for (auto it = spritesState.begin(); it != spritesState.end(); ++it) {
+        const QJsonObject spriteState = it.value().toObject();
+        QStringList aliases;
+        for (const auto& a : spriteState["aliases"].toArray()) {
+            aliases.append(a.toString());
+        }
+        appendAliases(text.markers, spriteState["name"].toString(), aliases);
+    }
+
+    const QJsonObject animInfo = projectPayload["animations"].toObject();
+    const int animationFps = animInfo["animation_fps"].toInt(kDefaultAnimationFps);
+    appendAnimationHeader(text.animations, animationFps);
+    for (const auto& timelineVal : animInfo["timelines"].toArray()) {
+        const QJsonObject timeline = timelineVal.toObject();
+        QStringList frames;
+        for (const auto& fVal : timeline["frames"].toArray()) {
+            frames.append(fVal.toString());
+        }
+        appendAnimation(text.animations, timeline["name"].toString(),
+                        timeline["fps"].toInt(animationFps), timeline["alias_of"].toString(),
+                        timeline["h_flip"].toBool(), timeline["v_flip"].toBool(), frames);
+    }
+    return text;
+}
+
+int ExportMetadataText::appendMeshes(const QString& currentFolder, int vertexBudget,
+                                     SourceImageStore& images) {
+    // Each sprite block is its path line, its marker lines and a blank line; the mesh
+    // goes last in the block.
+    const QList<QByteArray> lines = markers.split('\n');
+    QStringList paths;
+    QVector<qsizetype> blockEnds;
+    const QDir currentDir(currentFolder);
+    QString key;
+    bool hasMesh = false;
+    for (qsizetype i = 0; i < lines.size(); ++i) {
+        const QByteArray& line = lines.at(i);
+        if (line.startsWith("path \"") && line.endsWith('"')) {
+            key = QString::fromUtf8(line.mid(6, line.size() - 7));
+            hasMesh = false;
+        } else if (key.isEmpty()) {
+            continue;
+        } else if (line.startsWith("- marker \"mesh\" ")) {
+            hasMesh = true;
+        } else if (line.isEmpty()) {
+            if (!hasMesh) {
+                paths.append(currentDir.absoluteFilePath(key));
+                blockEnds.append(i);
+            }
+            key.clear();
+        }
+    }
+
+    auto traceMesh = [&images, vertexBudget](const QString& path) {
+        return SpriteMesh::trace(images.image(path), vertexBudget);
+    };
+#ifdef Q_OS_WASM
+    QList<QPolygon> meshes;
+    for (const QString& path : paths) {
+        meshes.append(traceMesh(path));
+    }
+#else
+    const QList<QPolygon> meshes = QtConcurrent::blockingMapped<QList<QPolygon>>(paths, traceMesh);
+#endif
+
+    QByteArray out;
+    out.reserve(markers.size() + paths.size() * 64);
+    int added = 0;
+    qsizetype nextBlock = 0;
+    for (qsizetype i = 0; i < lines.size(); ++i) {
+        if (nextBlock < blockEnds.size() && blockEnds.at(nextBlock) == i) {
+            const QPolygon& mesh = meshes.at(nextBlock++);
+            if (!mesh.isEmpty()) {
+                appendMarkerHeader(out, QStringLiteral("mesh"), QStringLiteral("polygon"));
+                for (const QPoint& pt : mesh) {
+                    appendCoords(out, pt.x(), pt.y());
+                }
+                out += '\n';
+                ++added;
+            }
+        }
+        out += lines.at(i);
+        if (i + 1 < lines.size()) {
+            out += '\n';
+        }
+    }
+    markers = out;
+    return added;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+#include "models.h"
+
+class SourceImageStore;
+
+// Markers and animations text passed to spratconvert and written by the raw transform.
+// It depends only on the session, not on the profile, so an export builds it once and
+// every profile chain shares the same buffers.
+struct ExportMetadataText {
+    QByteArray markers;
+    QByteArray animations;
+
+    // Builds the text straight from session data. Sprites are keyed and ordered as in the
+    // project payload, so the output matches fromPayload() on the same session.
+    static ExportMetadataText build(const QString& currentFolder,
+                                    const QVector<LayoutModel>& layoutModels,
+                                    const QVector<AnimationTimeline>& timelines);
+    // Builds the text from the "spritemarkers" and "animations" payload sections.
+    static ExportMetadataText fromPayload(const QJsonObject& projectPayload);
+
+    // Adds a "mesh" polygon marker, traced by SpriteMesh with at most vertexBudget
+    // vertices, to every sprite that has none. Sprite keys are resolved against
+    // currentFolder and decoded through images. Returns the number of meshes added.
+    int appendMeshes(const QString& currentFolder, int vertexBudget, SourceImageStore& images);
+};
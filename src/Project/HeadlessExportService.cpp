@@ -0,0 +1,188 @@
+#include "HeadlessExportService.h"
+#include "ArchiveExtractor.h"
+#include "ProjectFileLoader.h"
+#include "ProjectPayloadCodec.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QTemporaryDir>
+
+#include <algorithm>
+
+namespace {
+QString trHeadlessExport(const char* text) {
+    return QCoreApplication::translate("HeadlessExportService", text);
+}
+
+// Where the project's layout input lives, resolved like the GUI does on load.
+struct LayoutSource {
+    QString folder;
+    QStringList framePaths;  // set for frame-list projects
+};
+
+LayoutSource resolveLayoutSource(const QJsonObject& root, const QString& projectDir) {
+    const QJsonObject layoutInfo = root["layout"].toObject();
+    const int projectVersion = root["version"].toInt(1);
+    LayoutSource source;
+    source.folder = layoutInfo["folder"].toString();
+    // Version 2+ stores folders relative to the project; fall back to the project root
+    // when the stored subfolder was never created.
+    if (projectVersion >= 2 || QDir::isRelativePath(source.folder)) {
+        const QString resolved = QDir(projectDir).filePath(source.folder);
+        source.folder = QDir(resolved).exists() ? resolved : projectDir;
+    }
+    if (layoutInfo["source_mode"].toString() == QLatin1String("list")) {
+        for (const auto& frameVal : layoutInfo["frame_paths"].toArray()) {
+            QString framePath = frameVal.toString().trimmed();
+            if (framePath.isEmpty()) {
+                continue;
+            }
+            if (projectVersion >= 2 || QDir::isRelativePath(framePath)) {
+                framePath = QDir(source.folder).filePath(framePath);
+            }
+            source.framePaths.append(framePath);
+        }
+    }
+    source.folder = QDir(source.folder).absolutePath();
+    return source;
+}
+
+bool resolveProfiles(const QStringList& requested, const QVector<SpratProfile>& available,
+                     QStringList& profiles, QString& error) {
+    if (requested.isEmpty()) {
+        return true;
+    }
+    profiles.clear();
+    for (const QString& name : requested) {
+        if (name.compare(QLatin1String("all"), Qt::CaseInsensitive) == 0) {
+            for (const SpratProfile& profile : available) {
+                const QString trimmed = profile.name.trimmed();
+                if (!trimmed.isEmpty() && !profiles.contains(trimmed)) {
+                    profiles.append(trimmed);
+                }
+            }
+            continue;
+        }
+        const bool known = std::any_of(available.begin(), available.end(),
+                                       [&name](const SpratProfile& p) { return p.name.trimmed() == name; });
+        if (!known) {
+            error = trHeadlessExport("Unknown profile '%1'.").arg(name);
+            return false;
+        }
+        if (!profiles.contains(name)) {
+            profiles.append(name);
+        }
+    }
+    return true;
+}
+}  // namespace
+
+bool HeadlessExportService::exportProject(const Request& request,
+                                          ProjectSaveService::SaveCallbacks callbacks,
+                                          QString& savedDestination,
+                                          QString& error) {
+    QString projectPath = request.projectPath;
+    if (QFileInfo(projectPath).isDir()) {
+        projectPath = ProjectFileLoader::projectFileIn(projectPath);
+    }
+    QJsonObject root;
+    if (!ProjectFileLoader::load(projectPath, root, error)) {
+        error = trHeadlessExport("Could not load project '%1': %2").arg(projectPath, error);
+        return false;
+    }
+
+    // Zip projects with embedded sprites are unpacked so their sprites exist on disk.
+    QString projectDir = QFileInfo(projectPath).absolutePath();
+    QTemporaryDir extractDir;
+    if (projectPath.endsWith(".zip", Qt::CaseInsensitive) && root["version"].toInt(1) >= 2) {
+        if (!extractDir.isValid()) {
+            error = trHeadlessExport("Could not create temporary directory for ZIP extraction.");
+            return false;
+        }
+        if (!ArchiveExtractor::extractToDirectory(projectPath, extractDir.path(), error)) {
+            return false;
+        }
+        projectDir = extractDir.path();
+    }
+
+    const LayoutSource source = resolveLayoutSource(root, projectDir);
+    QVector<LayoutModel> noModels;
+    const ProjectPayloadApplyResult project =
+        ProjectPayloadCodec::applyToLayout(root, source.folder, noModels);
+
+    SaveConfig config = project.saveConfig;
+    if (!request.destination.isEmpty()) {
+        config.destination = request.destination;
+    } else if (!config.destination.isEmpty() && QDir::isRelativePath(config.destination)) {
+        config.destination = QDir(projectDir).filePath(config.destination);
+    }
+    if (config.destination.isEmpty()) {
+        error = trHeadlessExport("The project has no export destination.");
+        return false;
+    }
+    if (!request.transforms.isEmpty()) {
+        config.transform = request.transforms.first();
+        config.extraTransforms = request.transforms.mid(1);
+    }
+    config.packInProcess = request.packInProcess;
+    if (!resolveProfiles(request.profiles, request.availableProfiles, config.profiles, error)) {
+        return false;
+    }
+
+    CliPaths cli = request.cliPaths;
+    if (cli.layoutBinary.isEmpty()) cli.layoutBinary = project.cliPaths.layoutBinary;
+    if (cli.packBinary.isEmpty()) cli.packBinary = project.cliPaths.packBinary;
+    if (cli.convertBinary.isEmpty()) cli.convertBinary = project.cliPaths.convertBinary;
+    if (cli.layoutBinary.isEmpty() || cli.packBinary.isEmpty()) {
+        error = trHeadlessExport("Missing spratlayout or spratpack binaries.");
+        return false;
+    }
+
+    QVector<AtlasEntry> atlases;
+    for (const AtlasEntry& atlas : project.atlases) {
+        if (!atlas.spritePaths.isEmpty()) {
+            atlases.append(atlas);
+        }
+    }
+    const bool multiAtlas = atlases.size() > 1
+        || (!atlases.isEmpty() && !atlases.first().isNeutral);
+    if (!multiAtlas) {
+        return ProjectSaveService::save(config, source.folder, source.framePaths, source.folder,
+                                        request.availableProfiles, QString(), cli.layoutBinary,
+                                        cli.packBinary, cli.convertBinary, root, savedDestination,
+                                        error, request.deduplicateMode, callbacks,
+                                        request.maxParallelProfiles);
+    }
+
+    // Same layout as an export from the GUI: one folder per atlas inside each profile
+    // folder, and only the first atlas gets the project payload (and with it the markers
+    // and animations text).
+    int rootExporterCount = 0;
+    for (const AtlasEntry& atlas : atlases) {
+        if (atlas.outputSubdir.isEmpty()) ++rootExporterCount;
+    }
+    // Atlases run one after another; each one already runs its profiles in parallel.
+    for (int i = 0; i < atlases.size(); ++i) {
+        const AtlasEntry& atlas = atlases.at(i);
+        if (callbacks.setStatus) {
+            callbacks.setStatus(trHeadlessExport("Exporting '%1'...").arg(atlas.name));
+        }
+        QString destination;
+        if (!ProjectSaveService::save(ProjectSaveService::atlasConfig(config, atlas, rootExporterCount),
+                                      source.folder, atlas.spritePaths, source.folder,
+                                      request.availableProfiles, QString(), cli.layoutBinary,
+                                      cli.packBinary, cli.convertBinary,
+                                      i == 0 ? root : QJsonObject(), destination, error,
+                                      request.deduplicateMode, callbacks,
+                                      request.maxParallelProfiles)) {
+            error = trHeadlessExport("Atlas '%1': %2").arg(atlas.name, error);
+            return false;
+        }
+        if (savedDestination.isEmpty()) {
+            savedDestination = destination;
+        }
+    }
+    return true;
+}
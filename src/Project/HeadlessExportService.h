@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "CliPaths.h"
+#include "ProjectSaveService.h"
+#include "SpratProfilesConfig.h"
+
+/**
+ * @class HeadlessExportService
+ * @brief Exports a saved project without a session or window.
+ *
+ * Resolves the layout source, atlases and export settings the way the GUI does when
+ * it opens the project, then runs ProjectSaveService for every atlas. Used by the
+ * "--export" command-line mode.
+ */
+class HeadlessExportService {
+public:
+    struct Request {
+        QString projectPath;              // project.spart.json, its folder, or a project zip
+        QStringList profiles;             // empty: the project's selection; "all": every profile
+        QString destination;              // empty: the project's export destination
+        QStringList transforms;           // empty: the project's formats; written from one pack
+        QVector<SpratProfile> availableProfiles;
+        CliPaths cliPaths;                // empty binaries fall back to the project's paths
+        QString deduplicateMode = "exact";
+        bool packInProcess = false;       // see SaveConfig::packInProcess
+        int maxParallelProfiles = 1;
+    };
+
+    static bool exportProject(const Request& request,
+                              ProjectSaveService::SaveCallbacks callbacks,
+                              QString& savedDestination,
+                              QString& error);
+};
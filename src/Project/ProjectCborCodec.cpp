@@ -0,0 +1,287 @@
+#include "ProjectCborCodec.h"
+#include "ProjectPayloadCache.h"
+#include "ProjectPayloadCodec.h"
+
+#include <QBuffer>
+#include <QCborStreamReader>
+#include <QCborStreamWriter>
+#include <QCoreApplication>
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonValue>
+
+namespace {
+QString trProjectCborCodec(const char* text) {
+    return QCoreApplication::translate("ProjectCborCodec", text);
+}
+
+// Nesting limit for decoding; project payloads are at most a handful of levels deep.
+constexpr int kMaxNestingDepth = 256;
+
+void writeString(QCborStreamWriter& writer, const QString& text) {
+    writer.append(QStringView(text));
+}
+
+void writeValue(QCborStreamWriter& writer, const QJsonValue& value);
+
+void writeObject(QCborStreamWriter& writer, const QJsonObject& object) {
+    writer.startMap(object.size());
+    for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+        writeString(writer, it.key());
+        writeValue(writer, it.value());
+    }
+    writer.endMap();
+}
+
+void writeArray(QCborStreamWriter& writer, const QJsonArray& array) {
+    writer.startArray(array.size());
+    for (const QJsonValue& entry : array) {
+        writeValue(writer, entry);
+    }
+    writer.endArray();
+}
+
+void writeValue(QCborStreamWriter& writer, const QJsonValue& value) {
+    switch (value.type()) {
+    case QJsonValue::Bool:
+        writer.append(value.toBool());
+        break;
+    case QJsonValue::Double: {
+        // Integral numbers keep the integer encoding so they decode back as integers.
+        const double number = value.toDouble();
+        const qint64 integer = value.toInteger();
+        if (static_cast<double>(integer) == number) {
+            writer.append(integer);
+        } else {
+            writer.append(number);
+        }
+        break;
+    }
+    case QJsonValue::String:
+        writeString(writer, value.toString());
+        break;
+    case QJsonValue::Array:
+        writeArray(writer, value.toArray());
+        break;
+    case QJsonValue::Object:
+        writeObject(writer, value.toObject());
+        break;
+    case QJsonValue::Null:
+    case QJsonValue::Undefined:
+        writer.append(nullptr);
+        break;
+    }
+}
+
+// Sprite entries are written one at a time, so the (potentially very large) "sprites"
+// object is never built as a whole just to be encoded; with a payload cache its encoded
+// entries are copied to the device as they are. Duplicate keys keep JSON semantics on
+// decode: the last entry wins.
+void writeSpriteStates(QCborStreamWriter& writer, QIODevice& device, const ProjectPayloadBuildInput& input) {
+    writer.startMap();
+    if (input.payloadCache) {
+        // The writer passes every item straight to the device, so raw map entries can go
+        // in between; the indefinite-length map needs no item count.
+        device.write(input.payloadCache->spriteStatesCbor(input.currentFolder, input.layoutModels,
+                                                          input.payloadCacheMarks));
+        writer.endMap();
+        return;
+    }
+    const QDir currentDir(input.currentFolder);
+    for (const auto& model : input.layoutModels) {
+        for (const auto& sprite : model.sprites) {
+            writeString(writer, ProjectPayloadCodec::spriteStateKey(currentDir, sprite->path));
+            writeObject(writer, ProjectPayloadCodec::buildSpriteState(*sprite));
+        }
+    }
+    writer.endMap();
+}
+
+class CborJsonReader {
+public:
+    explicit CborJsonReader(QCborStreamReader& reader) : m_reader(reader) {}
+
+    bool failed() const { return m_failed || m_reader.lastError() != QCborError::NoError; }
+
+    QJsonValue readValue(int depth) {
+        if (depth > kMaxNestingDepth) {
+            m_failed = true;
+            return {};
+        }
+        while (m_reader.isTag()) {
+            if (!m_reader.next()) {
+                return {};
+            }
+        }
+        if (m_reader.isInteger()) {
+            const qint64 value = m_reader.toInteger();
+            m_reader.next();
+            return QJsonValue(value);
+        }
+        if (m_reader.isFloat16()) {
+            const double value = static_cast<float>(m_reader.toFloat16());
+            m_reader.next();
+            return QJsonValue(value);
+        }
+        if (m_reader.isFloat()) {
+            const double value = m_reader.toFloat();
+            m_reader.next();
+            return QJsonValue(value);
+        }
+        if (m_reader.isDouble()) {
+            const double value = m_reader.toDouble();
+            m_reader.next();
+            return QJsonValue(value);
+        }
+        if (m_reader.isBool()) {
+            const bool value = m_reader.toBool();
+            m_reader.next();
+            return QJsonValue(value);
+        }
+        if (m_reader.isNull() || m_reader.isUndefined()) {
+            m_reader.next();
+            return QJsonValue(QJsonValue::Null);
+        }
+        if (m_reader.isString()) {
+            return QJsonValue(readString());
+        }
+        if (m_reader.isArray()) {
+            return readArray(depth);
+        }
+        if (m_reader.isMap()) {
+            return readObject(depth);
+        }
+        // Byte strings and simple types have no JSON counterpart in the project schema.
+        m_failed = true;
+        return {};
+    }
+
+private:
+    QString readString() {
+        QString out;
+        auto chunk = m_reader.readString();
+        while (chunk.status == QCborStreamReader::Ok) {
+            out += chunk.data;
+            chunk = m_reader.readString();
+        }
+        if (chunk.status == QCborStreamReader::Error) {
+            m_failed = true;
+        }
+        return out;
+    }
+
+    QJsonArray readArray(int depth) {
+        QJsonArray array;
+        if (!m_reader.enterContainer()) {
+            m_failed = true;
+            return array;
+        }
+        while (!failed() && m_reader.hasNext()) {
+            array.append(readValue(depth + 1));
+        }
+        if (!failed()) {
+            m_reader.leaveContainer();
+        }
+        return array;
+    }
+
+    QJsonObject readObject(int depth) {
+        QJsonObject object;
+        if (!m_reader.enterContainer()) {
+            m_failed = true;
+            return object;
+        }
+        while (!failed() && m_reader.hasNext()) {
+            if (!m_reader.isString()) {
+                m_failed = true;
+                break;
+            }
+            const QString key = readString();
+            object.insert(key, readValue(depth + 1));
+        }
+        if (!failed()) {
+            m_reader.leaveContainer();
+        }
+        return object;
+    }
+
+    QCborStreamReader& m_reader;
+    bool m_failed = false;
+};
+
+}  // namespace
+
+bool ProjectCborCodec::isCbor(const QByteArray& data) {
+    // Self-describe CBOR tag 55799, written at the start of every encoded project.
+    return data.startsWith(QByteArrayLiteral("\xd9\xd9\xf7"));
+}
+
+QByteArray ProjectCborCodec::encode(const ProjectPayloadBuildInput& input) {
+    // Everything except the sprite table is small; build it through the JSON codec so
+    // both encodings always carry the same keys.
+    ProjectPayloadBuildInput headerInput = input;
+    headerInput.includeSpriteStates = false;
+    const QJsonObject root = ProjectPayloadCodec::build(headerInput);
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    QCborStreamWriter writer(&buffer);
+    writer.append(QCborKnownTags::Signature);
+    writer.startMap(root.size());
+    for (auto it = root.constBegin(); it != root.constEnd(); ++it) {
+        writeString(writer, it.key());
+        if (it.key() != QLatin1String("spritemarkers")) {
+            writeValue(writer, it.value());
+            continue;
+        }
+        const QJsonObject markersInfo = it.value().toObject();
+        writer.startMap(markersInfo.size());
+        for (auto mit = markersInfo.constBegin(); mit != markersInfo.constEnd(); ++mit) {
+            writeString(writer, mit.key());
+            if (mit.key() == QLatin1String("sprites")) {
+                writeSpriteStates(writer, buffer, input);
+            } else {
+                writeValue(writer, mit.value());
+            }
+        }
+        writer.endMap();
+    }
+    writer.endMap();
+    return data;
+}
+
+QByteArray ProjectCborCodec::encodeMapEntry(const QString& key, const QJsonObject& value) {
+    QByteArray data;
+    QCborStreamWriter writer(&data);
+    writeString(writer, key);
+    writeObject(writer, value);
+    return data;
+}
+
+QByteArray ProjectCborCodec::encode(const QJsonObject& payload) {
+    QByteArray data;
+    QCborStreamWriter writer(&data);
+    writer.append(QCborKnownTags::Signature);
+    writeObject(writer, payload);
+    return data;
+}
+
+bool ProjectCborCodec::decode(const QByteArray& data, QJsonObject& root, QString& error) {
+    QCborStreamReader reader(data);
+    CborJsonReader decoder(reader);
+    const QJsonValue value = decoder.readValue(0);
+    if (decoder.failed()) {
+        const QCborError cborError = reader.lastError();
+        error = cborError != QCborError::NoError
+            ? trProjectCborCodec("Invalid CBOR data: %1").arg(cborError.toString())
+            : trProjectCborCodec("Invalid CBOR data.");
+        return false;
+    }
+    if (!value.isObject()) {
+        error = trProjectCborCodec("Invalid CBOR data.");
+        return false;
+    }
+    root = value.toObject();
+    return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+
+struct ProjectPayloadBuildInput;
+
+/**
+ * @class ProjectCborCodec
+ * @brief Binary (CBOR) encoding of the schema_version 4 project payload.
+ *
+ * The CBOR document mirrors the JSON payload key for key, so decoding yields
+ * the same QJsonObject that ProjectPayloadCodec::applyToLayout consumes.
+ * Encoding from a build input streams the sprite table, which dominates large
+ * projects; decoding reads the document with QCborStreamReader straight into
+ * that object, without building an intermediate QCborValue tree.
+ *
+ * Binary projects are saved as project.spart.cbor, never under the .json name,
+ * so tools reading project.spart.json keep seeing JSON.
+ */
+class ProjectCborCodec {
+public:
+    /**
+     * @brief Returns true when the data starts with the CBOR self-describe tag.
+     */
+    static bool isCbor(const QByteArray& data);
+
+    /**
+     * @brief Encodes the payload for the build input as CBOR.
+     *
+     * Only the small header goes through ProjectPayloadCodec::build; sprite states
+     * are written entry by entry from the payload cache or the layout models.
+     */
+    static QByteArray encode(const ProjectPayloadBuildInput& input);
+
+    /**
+     * @brief Encodes an already-built JSON payload as CBOR.
+     */
+    static QByteArray encode(const QJsonObject& payload);
+
+    /**
+     * @brief Encodes one key/value pair of a map, for writers that splice map entries.
+     */
+    static QByteArray encodeMapEntry(const QString& key, const QJsonObject& value);
+
+    /**
+     * @brief Decodes a CBOR project document into its JSON payload form.
+     *
+     * @param data Encoded document
+     * @param root Receives the decoded payload
+     * @param error Receives the error message if decoding fails
+     * @return bool True if the data was decoded successfully
+     */
+    static bool decode(const QByteArray& data, QJsonObject& root, QString& error);
+};
@@ -1,7 +1,9 @@
 #include "ProjectFileLoader.h"
 #include "ArchiveExtractor.h"
+#include "ProjectCborCodec.h"
 
 #include <QCoreApplication>
+#include <QDir>
 #include <QFile>
 #include <QFileInfo>
 #include <QJsonDocument>
@@ -15,7 +17,9 @@ QString trProjectFileLoader(const char* text) {
 bool ProjectFileLoader::load(const QString& path, QJsonObject& root, QString& error) {
     QByteArray jsonData;
     if (path.endsWith(".zip", Qt::CaseInsensitive)) {
-        if (!ArchiveExtractor::readFileFromArchive(path, "project.spart.json", jsonData, error, true)) {
+        QString cborError;
+        if (!ArchiveExtractor::readFileFromArchive(path, projectFileName(true), jsonData, cborError, true)
+            && !ArchiveExtractor::readFileFromArchive(path, projectFileName(false), jsonData, error, true)) {
             return false;
         }
     } else {
@@ -32,6 +36,10 @@ bool ProjectFileLoader::load(const QString& path, QJsonObject& root, QString& er
         jsonData = file.readAll();
     }
 
+    if (ProjectCborCodec::isCbor(jsonData)) {
+        return ProjectCborCodec::decode(jsonData, root, error);
+    }
+
     QJsonDocument doc = QJsonDocument::fromJson(jsonData);
     if (doc.isNull() || !doc.isObject()) {
         error = trProjectFileLoader("Invalid JSON data.");
@@ -40,3 +48,13 @@ bool ProjectFileLoader::load(const QString& path, QJsonObject& root, QString& er
     root = doc.object();
     return true;
 }
+
+QString ProjectFileLoader::projectFileName(bool binary) {
+    return binary ? QStringLiteral("project.spart.cbor") : QStringLiteral("project.spart.json");
+}
+
+QString ProjectFileLoader::projectFileIn(const QString& folder) {
+    const QDir dir(folder);
+    const QString binaryPath = dir.filePath(projectFileName(true));
+    return QFileInfo::exists(binaryPath) ? binaryPath : dir.filePath(projectFileName(false));
+}
@@ -8,7 +8,7 @@
  * @brief Static class for loading project files.
  * 
  * This class provides static methods for loading project files
- * in JSON format, handling file I/O and JSON parsing.
+ * in JSON or CBOR format, handling file I/O and parsing.
  */
 class ProjectFileLoader {
 public:
@@ -17,6 +17,8 @@ public:
      * 
      * This method reads a project file from the specified path,
      * parses the JSON content, and returns the parsed data.
+     * Files written in the binary CBOR format are detected by their
+     * signature and decoded into the same JSON payload.
      * 
      * @param path Path to the project file
      * @param root Reference to store the parsed JSON object
@@ -24,4 +26,24 @@ public:
      * @return bool True if file was loaded successfully, false otherwise
      */
     static bool load(const QString& path, QJsonObject& root, QString& error);
+
+    /**
+     * @brief Name a project file is saved under.
+     *
+     * Binary projects use their own extension so that tools which read
+     * project.spart.json as text never receive CBOR.
+     *
+     * @param binary True for the CBOR encoding
+     * @return QString "project.spart.cbor" or "project.spart.json"
+     */
+    static QString projectFileName(bool binary);
+
+    /**
+     * @brief Returns the project file inside a folder.
+     *
+     * @param folder Project folder
+     * @return QString Path of project.spart.cbor when it exists, otherwise of
+     *         project.spart.json (which may not exist either)
+     */
+    static QString projectFileIn(const QString& folder);
 };
@@ -0,0 +1,217 @@
+#include "ProjectPayloadCache.h"
+#include "ProjectCborCodec.h"
+#include "ProjectPayloadCodec.h"
+
+#include <QDir>
+#include <QJsonDocument>
+#include <QMutexLocker>
+
+#include <utility>
+
+namespace {
+bool sameTimeline(const AnimationTimeline& a, const AnimationTimeline& b) {
+    return a.fps == b.fps && a.hFlip == b.hFlip && a.vFlip == b.vFlip && a.name == b.name
+        && a.aliasOf == b.aliasOf && a.frames == b.frames;
+}
+
+// "spritemarkers.sprites" sits two levels below the root; its entries are written one
+// level deeper.
+const QByteArray kSpriteEntryIndent(8, ' ');
+
+// One "key": {...} member as QJsonDocument::Indented writes it inside the sprite table.
+// Raw newlines only occur between tokens, so shifting every line is safe.
+QByteArray indentedSpriteEntry(const QString& key, const QJsonObject& state) {
+    const QByteArray doc = QJsonDocument(QJsonObject{{key, state}}).toJson(QJsonDocument::Indented);
+    // Drop the enclosing "{\n" and "\n}\n" of the single-member document.
+    QByteArray member = doc.mid(2, doc.size() - 5);
+    member.replace('\n', "\n" + kSpriteEntryIndent);
+    return kSpriteEntryIndent + member;
+}
+}  // namespace
+
+void ProjectPayloadCache::markSpriteDirty(const QString& spritePath) {
+    QMutexLocker locker(&m_mutex);
+    m_dirtySprites.insert(spritePath, ++m_markSerial);
+}
+
+void ProjectPayloadCache::markAllSpritesDirty() {
+    QMutexLocker locker(&m_mutex);
+    m_allSpritesDirty = ++m_markSerial;
+}
+
+void ProjectPayloadCache::markTimelinesDirty(const QString& atlasId) {
+    QMutexLocker locker(&m_mutex);
+    m_dirtyTimelines.insert(atlasId);
+}
+
+void ProjectPayloadCache::clear() {
+    QMutexLocker locker(&m_mutex);
+    m_spritesFolder.clear();
+    m_spriteKeys.clear();
+    m_sprites.clear();
+    m_spriteStates = QJsonObject();
+    m_dirtySprites.clear();
+    m_allSpritesDirty = 0;
+    m_timelines.clear();
+    m_dirtyTimelines.clear();
+    m_lastEncodedSpriteCount = 0;
+}
+
+quint64 ProjectPayloadCache::markSerial() const {
+    QMutexLocker locker(&m_mutex);
+    return m_markSerial;
+}
+
+void ProjectPayloadCache::syncSprites(const QString& currentFolder, const QVector<LayoutModel>& layoutModels,
+                                      quint64 marksUpTo) {
+    if (currentFolder != m_spritesFolder) {
+        // Keys are relative to the folder, so none of them carry over.
+        m_spriteKeys.clear();
+        m_sprites.clear();
+        m_spriteStates = QJsonObject();
+        m_spritesFolder = currentFolder;
+    }
+
+    // Only paths are looked up here; states are encoded for new paths and dirty marks.
+    const QDir currentDir(currentFolder);
+    const bool anyDirty = m_allSpritesDirty != 0 || !m_dirtySprites.isEmpty();
+    int spriteCount = 0;
+    int encoded = 0;
+    for (const auto& model : layoutModels) {
+        for (const auto& s : model.sprites) {
+            ++spriteCount;
+            auto key = m_spriteKeys.find(s->path);
+            if (key == m_spriteKeys.end()) {
+                key = m_spriteKeys.insert(s->path, ProjectPayloadCodec::spriteStateKey(currentDir, s->path));
+            } else if (!anyDirty || (m_allSpritesDirty == 0 && !m_dirtySprites.contains(s->path))) {
+                continue;
+            }
+            SpriteEntry& entry = m_sprites[*key];
+            entry.state = ProjectPayloadCodec::buildSpriteState(*s);
+            entry.json.clear();
+            entry.cbor.clear();
+            m_spriteStates.insert(*key, entry.state);
+            ++encoded;
+        }
+    }
+    // Marks newer than the caller's sprites stay, so the live state is encoded next time.
+    if (m_allSpritesDirty <= marksUpTo) {
+        m_allSpritesDirty = 0;
+    }
+    for (auto it = m_dirtySprites.begin(); it != m_dirtySprites.end();) {
+        if (it.value() <= marksUpTo) {
+            it = m_dirtySprites.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_lastEncodedSpriteCount = encoded;
+
+    if (m_spriteKeys.size() != spriteCount) {
+        // Sprites left the layout (or a path appears in several models); drop stale entries.
+        QSet<QString> present;
+        present.reserve(spriteCount);
+        for (const auto& model : layoutModels) {
+            for (const auto& s : model.sprites) {
+                present.insert(s->path);
+            }
+        }
+        for (auto it = m_spriteKeys.begin(); it != m_spriteKeys.end();) {
+            if (present.contains(it.key())) {
+                ++it;
+                continue;
+            }
+            m_sprites.remove(it.value());
+            m_spriteStates.remove(it.value());
+            it = m_spriteKeys.erase(it);
+        }
+    }
+}
+
+QJsonObject ProjectPayloadCache::spriteStates(const QString& currentFolder,
+                                              const QVector<LayoutModel>& layoutModels,
+                                              quint64 marksUpTo) {
+    QMutexLocker locker(&m_mutex);
+    syncSprites(currentFolder, layoutModels, marksUpTo);
+    return m_spriteStates;
+}
+
+QByteArray ProjectPayloadCache::spriteStatesJson(const QString& currentFolder,
+                                                 const QVector<LayoutModel>& layoutModels,
+                                                 quint64 marksUpTo) {
+    QMutexLocker locker(&m_mutex);
+    syncSprites(currentFolder, layoutModels, marksUpTo);
+    if (m_sprites.isEmpty()) {
+        return "{\n" + kSpriteEntryIndent + "}";
+    }
+    qsizetype size = 0;
+    for (auto it = m_sprites.begin(); it != m_sprites.end(); ++it) {
+        if (it->json.isEmpty()) {
+            it->json = indentedSpriteEntry(it.key(), it->state);
+        }
+        size += it->json.size() + 2;
+    }
+    QByteArray json;
+    json.reserve(size + kSpriteEntryIndent.size() + 3);
+    json += "{\n";
+    for (auto it = m_sprites.cbegin(); it != m_sprites.cend(); ++it) {
+        if (it != m_sprites.cbegin()) {
+            json += ",\n";
+        }
+        json += it->json;
+    }
+    json += "\n" + kSpriteEntryIndent + "}";
+    return json;
+}
+
+QByteArray ProjectPayloadCache::spriteStatesCbor(const QString& currentFolder,
+                                                 const QVector<LayoutModel>& layoutModels,
+                                                 quint64 marksUpTo) {
+    QMutexLocker locker(&m_mutex);
+    syncSprites(currentFolder, layoutModels, marksUpTo);
+    qsizetype size = 0;
+    for (auto it = m_sprites.begin(); it != m_sprites.end(); ++it) {
+        if (it->cbor.isEmpty()) {
+            it->cbor = ProjectCborCodec::encodeMapEntry(it.key(), it->state);
+        }
+        size += it->cbor.size();
+    }
+    QByteArray cbor;
+    cbor.reserve(size);
+    for (const SpriteEntry& entry : std::as_const(m_sprites)) {
+        cbor += entry.cbor;
+    }
+    return cbor;
+}
+
+QJsonArray ProjectPayloadCache::timelines(const QString& atlasId, const QVector<AnimationTimeline>& timelines) {
+    QMutexLocker locker(&m_mutex);
+    TimelineEntry& entry = m_timelines[atlasId];
+    const bool dirty = m_dirtyTimelines.remove(atlasId);
+
+    bool changed = dirty || entry.timelines.size() != timelines.size();
+    QVector<QJsonObject> encoded;
+    encoded.reserve(timelines.size());
+    for (int i = 0; i < timelines.size(); ++i) {
+        if (!dirty && i < entry.timelines.size() && sameTimeline(entry.timelines.at(i), timelines.at(i))) {
+            encoded.append(entry.encoded.at(i));
+        } else {
+            encoded.append(ProjectPayloadCodec::buildTimeline(timelines.at(i)));
+            changed = true;
+        }
+    }
+    if (changed) {
+        entry.timelines = timelines;
+        entry.encoded = encoded;
+        entry.array = QJsonArray();
+        for (const QJsonObject& tObj : encoded) {
+            entry.array.append(tObj);
+        }
+    }
+    return entry.array;
+}
+
+int ProjectPayloadCache::lastEncodedSpriteCount() const {
+    QMutexLocker locker(&m_mutex);
+    return m_lastEncodedSpriteCount;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QVector>
+#include "models.h"
+
+#include <limits>
+
+/**
+ * @class ProjectPayloadCache
+ * @brief Encoded payload fragments kept between saves, so a save after a small
+ * edit only re-encodes the sprites and timelines that changed.
+ *
+ * Sprite states are re-encoded only when marked dirty, or when their path is new
+ * to the cache; every edit that changes a sprite's name, aliases, pivot or markers
+ * must mark it (markAllSpritesDirty() when the edit is not known). Each entry also
+ * keeps its JSON and CBOR bytes, so writers splice unchanged entries instead of
+ * serialising them again. Guarded by a mutex, since the autosave worker and the
+ * GUI thread may build payloads at the same time.
+ *
+ * The autosave worker encodes sprites copied earlier on the GUI thread; it passes
+ * the markSerial() taken with the copy, so marks made after it stay set and those
+ * sprites are encoded again from the live state.
+ */
+class ProjectPayloadCache {
+public:
+    void markSpriteDirty(const QString& spritePath);
+    void markAllSpritesDirty();
+    void markTimelinesDirty(const QString& atlasId);
+    void clear();
+
+    /**
+     * @brief Serial of the latest dirty mark; requests pass it to consume marks up to it.
+     */
+    quint64 markSerial() const;
+
+    static constexpr quint64 kAllMarks = std::numeric_limits<quint64>::max();
+
+    /**
+     * @brief Returns the "spritemarkers.sprites" section for the given models.
+     */
+    QJsonObject spriteStates(const QString& currentFolder, const QVector<LayoutModel>& layoutModels,
+                             quint64 marksUpTo = kAllMarks);
+
+    /**
+     * @brief Returns the "spritemarkers.sprites" object as QJsonDocument::Indented
+     * writes it at its depth in the payload, from the cached entry bytes.
+     */
+    QByteArray spriteStatesJson(const QString& currentFolder, const QVector<LayoutModel>& layoutModels,
+                                quint64 marksUpTo = kAllMarks);
+
+    /**
+     * @brief Returns the key/value pairs of the "spritemarkers.sprites" map, CBOR
+     * encoded and concatenated, for a writer that opens and closes the map itself.
+     */
+    QByteArray spriteStatesCbor(const QString& currentFolder, const QVector<LayoutModel>& layoutModels,
+                                quint64 marksUpTo = kAllMarks);
+
+    /**
+     * @brief Returns the timeline array stored for an atlas.
+     */
+    QJsonArray timelines(const QString& atlasId, const QVector<AnimationTimeline>& timelines);
+
+    /**
+     * @brief Number of sprite states encoded by the last sprite section request.
+     */
+    int lastEncodedSpriteCount() const;
+
+private:
+    struct SpriteEntry {
+        QJsonObject state;
+        QByteArray json;  // Filled on first use, cleared when the state is re-encoded
+        QByteArray cbor;
+    };
+    struct TimelineEntry {
+        QVector<AnimationTimeline> timelines;
+        QVector<QJsonObject> encoded;
+        QJsonArray array;
+    };
+
+    // Brings the entries in line with the models; called with the mutex held.
+    void syncSprites(const QString& currentFolder, const QVector<LayoutModel>& layoutModels, quint64 marksUpTo);
+
+    mutable QMutex m_mutex;
+    QString m_spritesFolder;
+    QHash<QString, QString> m_spriteKeys;     // Sprite path -> state key
+    QMap<QString, SpriteEntry> m_sprites;     // State key -> entry, in payload key order
+    QJsonObject m_spriteStates;
+    QHash<QString, quint64> m_dirtySprites;   // Sprite path -> serial of its latest mark
+    quint64 m_allSpritesDirty = 0;            // Serial of the latest markAllSpritesDirty(), 0 if none
+    quint64 m_markSerial = 0;
+    QHash<QString, TimelineEntry> m_timelines;
+    QSet<QString> m_dirtyTimelines;
+    int m_lastEncodedSpriteCount = 0;
+};
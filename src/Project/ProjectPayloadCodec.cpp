@@ -1,4 +1,5 @@
 #include "ProjectPayloadCodec.h"
+#include "ProjectPayloadCache.h"
 #include "MarkerUtils.h"
 #include "ResolutionUtils.h"
 
@@ -6,8 +7,12 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QJsonArray>
+#include <QJsonDocument>
 #include <QColor>
+#include <QHash>
+#include <QSet>
 #include <QUuid>
+#include <QtConcurrent>
 
 namespace {
 QJsonArray toJsonArray(const QVector<int>& values) {
@@ -28,6 +33,165 @@ QVector<int> fromJsonArray(const QJsonValue& value) {
     return out;
 }
 
+// Sprites per parallel work item when applying a project to a layout.
+constexpr int kApplyChunkSize = 512;
+
+// Runs fn(begin, end) over [0, count) in chunks on the global thread pool.
+template <typename Fn>
+void forEachChunk(int count, Fn fn) {
+#ifdef Q_OS_WASM
+    // QtConcurrent can be unreliable without pthreads/COOP+COEP; run synchronously
+    fn(0, count);
+#else
+    QVector<QPair<int, int>> chunks;
+    chunks.reserve(count / kApplyChunkSize + 1);
+    for (int begin = 0; begin < count; begin += kApplyChunkSize) {
+        chunks.append({begin, qMin(begin + kApplyChunkSize, count)});
+    }
+    QtConcurrent::blockingMap(chunks, [&fn](const QPair<int, int>& chunk) {
+        fn(chunk.first, chunk.second);
+    });
+#endif
+}
+
+// One "spritemarkers.sprites" entry, decoded from JSON ahead of the sprite pass.
+struct SpriteStateEntry {
+    bool hasName = false;
+    QString name;
+    QStringList aliases;
+    bool hasPivot = false;
+    int pivotX = 0;
+    int pivotY = 0;
+    bool hasMarkers = false;
+    QVector<NamedPoint> points;
+};
+
+SpriteStateEntry decodeSpriteState(const QJsonObject& state) {
+    SpriteStateEntry entry;
+    if (state.contains("name")) {
+        entry.hasName = true;
+        entry.name = state["name"].toString();
+    }
+    const QJsonArray aliasesArr = state["aliases"].toArray();
+    entry.aliases.reserve(aliasesArr.size());
+    for (const auto& a : aliasesArr)
+        entry.aliases.append(a.toString());
+    // Only apply stored pivot if the project was saved with the has_pivot flag.
+    // Older projects (no flag, or pivot_y=0 from partial centering) are ignored
+    // so LayoutParser's correctly-centered values are used instead.
+    if (state["has_pivot"].toBool() && state.contains("pivot_x") && state.contains("pivot_y")) {
+        entry.hasPivot = true;
+        entry.pivotX = state["pivot_x"].toInt();
+        entry.pivotY = state["pivot_y"].toInt();
+    }
+    if (!state.contains("markers")) {
+        return entry;
+    }
+    entry.hasMarkers = true;
+    const QJsonArray markersArr = state["markers"].toArray();
+    entry.points.reserve(markersArr.size());
+    for (const auto& mVal : markersArr) {
+        QJsonObject mObj = mVal.toObject();
+        NamedPoint p;
+        p.name = normalizeMarkerName(mObj["name"].toString());
+        p.x = mObj["x"].toInt();
+        p.y = mObj["y"].toInt();
+        QString kind = mObj["kind"].toString();
+        if (kind.isEmpty()) {
+            kind = mObj["type"].toString();
+        }
+        p.kind = markerKindFromString(kind);
+        p.radius = mObj["radius"].toInt(8);
+        p.w = mObj["w"].toInt(16);
+        p.h = mObj["h"].toInt(16);
+        if (mObj.contains("polygon_points")) {
+            QJsonArray polyArr = mObj["polygon_points"].toArray();
+            p.polygonPoints.reserve(polyArr.size());
+            for (const auto& ptVal : polyArr) {
+                QJsonArray ptPair = ptVal.toArray();
+                if (ptPair.size() == 2) {
+                    p.polygonPoints.append(QPoint(ptPair[0].toInt(), ptPair[1].toInt()));
+                }
+            }
+        } else if (mObj.contains("vertices")) {
+            QJsonArray verticesArr = mObj["vertices"].toArray();
+            p.polygonPoints.reserve(verticesArr.size());
+            for (const auto& vertexVal : verticesArr) {
+                QJsonObject vertex = vertexVal.toObject();
+                if (vertex.contains("x") && vertex.contains("y")) {
+                    p.polygonPoints.append(QPoint(vertex["x"].toInt(), vertex["y"].toInt()));
+                }
+            }
+        }
+        entry.points.append(p);
+    }
+    return entry;
+}
+
+QHash<QString, SpriteStateEntry> decodeSpriteStates(const QJsonObject& spritesState) {
+    QStringList keys;
+    QVector<QJsonObject> states;
+    keys.reserve(spritesState.size());
+    states.reserve(spritesState.size());
+    for (auto it = spritesState.constBegin(); it != spritesState.constEnd(); ++it) {
+        keys.append(it.key());
+        states.append(it.value().toObject());
+    }
+    QVector<SpriteStateEntry> entries(states.size());
+    forEachChunk(states.size(), [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            entries[i] = decodeSpriteState(states[i]);
+        }
+    });
+
+    QHash<QString, SpriteStateEntry> out;
+    out.reserve(keys.size());
+    for (int i = 0; i < keys.size(); ++i) {
+        out.insert(keys[i], std::move(entries[i]));
+    }
+    return out;
+}
+
+void applySpriteState(const SpriteStateEntry& entry, Sprite& sprite) {
+    if (entry.hasName) {
+        sprite.name = entry.name;
+    }
+    sprite.aliases = entry.aliases;
+    if (entry.hasPivot) {
+        sprite.pivotX = entry.pivotX;
+        sprite.pivotY = entry.pivotY;
+    }
+    if (entry.hasMarkers) {
+        sprite.points = entry.points;
+    }
+}
+
+// Same key as QDir(folder).relativeFilePath(path), without the per-call path
+// normalisation for the common case of a clean absolute path inside the folder.
+class SpriteKeyResolver {
+public:
+    explicit SpriteKeyResolver(const QString& folder) : m_dir(folder) {
+        if (QDir::isAbsolutePath(folder) && QDir::cleanPath(folder) == folder) {
+            m_prefix = folder.endsWith(QLatin1Char('/')) ? folder : folder + QLatin1Char('/');
+        }
+    }
+
+    QString key(const QString& path) const {
+        if (!m_prefix.isEmpty() && path.startsWith(m_prefix)) {
+            const QStringView rest = QStringView(path).mid(m_prefix.size());
+            if (!rest.isEmpty() && !rest.startsWith(QLatin1Char('.')) && !rest.contains(QLatin1String("/."))
+                && !rest.contains(QLatin1String("//"))) {
+                return rest.toString();
+            }
+        }
+        return m_dir.relativeFilePath(path);
+    }
+
+private:
+    QDir m_dir;
+    QString m_prefix;
+};
+
 bool isValidCliPath(const QString& path) {
     if (path.isEmpty()) {
         return true; // Empty path is allowed (use default)
@@ -43,6 +207,92 @@ bool isValidCliPath(const QString& path) {
 
 }  // namespace
 
+QJsonObject ProjectPayloadCodec::buildSpriteState(const Sprite& sprite) {
+    QJsonObject sObj;
+    sObj["name"] = sprite.name;
+    sObj["has_pivot"] = true;
+    sObj["pivot_x"] = sprite.pivotX;
+    sObj["pivot_y"] = sprite.pivotY;
+    QJsonArray markersArr;
+    for (const auto& p : sprite.points) {
+        QJsonObject mObj;
+        const QString kind = markerKindToString(p.kind);
+        mObj["name"] = normalizeMarkerName(p.name);
+        mObj["x"] = p.x;
+        mObj["y"] = p.y;
+        // Keep GUI field and include CLI-compatible field for spratconvert.
+        mObj["kind"] = kind;
+        mObj["type"] = kind;
+        mObj["radius"] = p.radius;
+        mObj["w"] = p.w;
+        mObj["h"] = p.h;
+        if (!p.polygonPoints.isEmpty()) {
+            QJsonArray polyArr;
+            QJsonArray verticesArr;
+            for (const auto& pt : p.polygonPoints) {
+                QJsonArray ptPair;
+                ptPair.append(pt.x());
+                ptPair.append(pt.y());
+                polyArr.append(ptPair);
+
+                QJsonObject vertex;
+                vertex["x"] = pt.x();
+                vertex["y"] = pt.y();
+                verticesArr.append(vertex);
+            }
+            // GUI legacy format.
+            mObj["polygon_points"] = polyArr;
+            // CLI format expected by spratconvert.
+            mObj["vertices"] = verticesArr;
+        }
+        markersArr.append(mObj);
+    }
+    sObj["markers"] = markersArr;
+
+    if (!sprite.aliases.isEmpty()) {
+        QJsonArray aliasArr;
+        for (const auto& a : sprite.aliases) aliasArr.append(a);
+        sObj["aliases"] = aliasArr;
+    }
+    return sObj;
+}
+
+QString ProjectPayloadCodec::spriteStateKey(const QDir& currentFolder, const QString& spritePath) {
+    QString key = currentFolder.relativeFilePath(spritePath);
+    if (key.isEmpty()) {
+        key = QFileInfo(spritePath).fileName();
+    }
+    return key;
+}
+
+QJsonArray ProjectPayloadCodec::buildTimelines(const QVector<AnimationTimeline>& timelines) {
+    QJsonArray timelinesArr;
+    for (const auto& t : timelines) {
+        timelinesArr.append(buildTimeline(t));
+    }
+    return timelinesArr;
+}
+
+QJsonObject ProjectPayloadCodec::buildTimeline(const AnimationTimeline& t) {
+    QJsonObject tObj;
+    tObj["name"] = t.name;
+    tObj["fps"] = t.fps;
+    QJsonArray framesArr;
+    for (const auto& f : t.frames) {
+        framesArr.append(f);
+    }
+    tObj["frames"] = framesArr;
+    if (!t.aliasOf.isEmpty()) tObj["alias_of"] = t.aliasOf;
+    if (t.hFlip) tObj["h_flip"] = true;
+    if (t.vFlip) tObj["v_flip"] = true;
+    return tObj;
+}
+
+QString ProjectPayloadCodec::portableSpritePath(const QDir& baseDir, const QString& spritePath) {
+    const QString rel = baseDir.relativeFilePath(spritePath);
+    return rel.startsWith("..") ? spritePath : rel;
+}
+
 QJsonObject ProjectPayloadCodec::build(const ProjectPayloadBuildInput& input) {
     QJsonObject root;
     root["schema_version"] = 4;
@@ -158,21 +408,10 @@ QJsonObject ProjectPayloadCodec::build(const ProjectPayloadBuildInput& input) {
     }
     animInfo["animation_frame_index"] = input.animationFrameIndex;
     animInfo["animation_playing"] = input.animationPlaying;
-    QJsonArray timelinesArr;
-    for (const auto& t : input.timelines) {
-        QJsonObject tObj;
-        tObj["name"] = t.name;
-        tObj["fps"] = t.fps;
-        QJsonArray framesArr;
-        for (const auto& f : t.frames) {
-            framesArr.append(f);
-        }
-        tObj["frames"] = framesArr;
-        if (!t.aliasOf.isEmpty()) tObj["alias_of"] = t.aliasOf;
-        if (t.hFlip) tObj["h_flip"] = true;
-        if (t.vFlip) tObj["v_flip"] = true;
-        timelinesArr.append(tObj);
-    }
+    const bool hasActiveAtlas = input.activeAtlasIndex >= 0 && input.activeAtlasIndex < input.atlases.size();
+    const QJsonArray timelinesArr = input.payloadCache && hasActiveAtlas
+        ? input.payloadCache->timelines(input.atlases.at(input.activeAtlasIndex).id, input.timelines)
+        : buildTimelines(input.timelines);
     if (!input.timelines.isEmpty()) {
         // Keep legacy field for older consumers that still expect one global fps.
         animInfo["animation_fps"] = input.timelines.first().fps;
@@ -210,8 +449,7 @@ QJsonObject ProjectPayloadCodec::build(const ProjectPayloadBuildInput& input) {
             if (!atlas.isExcluded) {
                 for (const QString& sp : atlas.spritePaths) {
                     if (input.portablePaths && !spBase.isEmpty()) {
-                        QString rel = spBaseDir.relativeFilePath(sp);
-                        spArr.append(rel.startsWith("..") ? sp : rel);
+                        spArr.append(portableSpritePath(spBaseDir, sp));
                     } else {
                         spArr.append(sp);
                     }
@@ -220,84 +458,29 @@ QJsonObject ProjectPayloadCodec::build(const ProjectPayloadBuildInput& input) {
             aObj["sprite_paths"] = spArr;
 
             // Timelines
-            QJsonArray atArr;
-            for (const auto& t : atlas.timelines) {
-                QJsonObject tObj;
-                tObj["name"] = t.name;
-                tObj["fps"]  = t.fps;
-                QJsonArray fArr;
-                for (const auto& f : t.frames) fArr.append(f);
-                tObj["frames"] = fArr;
-                if (!t.aliasOf.isEmpty()) tObj["alias_of"] = t.aliasOf;
-                if (t.hFlip) tObj["h_flip"] = true;
-                if (t.vFlip) tObj["v_flip"] = true;
-                atArr.append(tObj);
-            }
-            aObj["timelines"] = atArr;
+            aObj["timelines"] = input.payloadCache ? input.payloadCache->timelines(atlas.id, atlas.timelines)
+                                                   : buildTimelines(atlas.timelines);
             atlasesArr.append(aObj);
         }
         root["atlases"] = atlasesArr;
     }
 
     QJsonObject markersInfo;
-    QJsonObject spritesState;
-    for (const auto& model : input.layoutModels) {
-        for (const auto& s : model.sprites) {
-            QJsonObject sObj;
-            sObj["name"] = s->name;
-            sObj["has_pivot"] = true;
-            sObj["pivot_x"] = s->pivotX;
-            sObj["pivot_y"] = s->pivotY;
-            QJsonArray markersArr;
-            for (const auto& p : s->points) {
-                QJsonObject mObj;
-                const QString kind = markerKindToString(p.kind);
-                mObj["name"] = normalizeMarkerName(p.name);
-                mObj["x"] = p.x;
-                mObj["y"] = p.y;
-                // Keep GUI field and include CLI-compatible field for spratconvert.
-                mObj["kind"] = kind;
-                mObj["type"] = kind;
-                mObj["radius"] = p.radius;
-                mObj["w"] = p.w;
-                mObj["h"] = p.h;
-                if (!p.polygonPoints.isEmpty()) {
-                    QJsonArray polyArr;
-                    QJsonArray verticesArr;
-                    for (const auto& pt : p.polygonPoints) {
-                        QJsonArray ptPair;
-                        ptPair.append(pt.x());
-                        ptPair.append(pt.y());
-                        polyArr.append(ptPair);
-
-                        QJsonObject vertex;
-                        vertex["x"] = pt.x();
-                        vertex["y"] = pt.y();
-                        verticesArr.append(vertex);
-                    }
-                    // GUI legacy format.
-                    mObj["polygon_points"] = polyArr;
-                    // CLI format expected by spratconvert.
-                    mObj["vertices"] = verticesArr;
-                }
-                markersArr.append(mObj);
-            }
-            sObj["markers"] = markersArr;
-
-            if (!s->aliases.isEmpty()) {
-                QJsonArray aliasArr;
-                for (const auto& a : s->aliases) aliasArr.append(a);
-                sObj["aliases"] = aliasArr;
-            }
-
-            QString key = QDir(input.currentFolder).relativeFilePath(s->path);
-            if (key.isEmpty()) {
-                key = QFileInfo(s->path).fileName();
+    if (!input.includeSpriteStates) {
+        markersInfo["sprites"] = QJsonObject();
+    } else if (input.payloadCache) {
+        markersInfo["sprites"] = input.payloadCache->spriteStates(input.currentFolder, input.layoutModels,
+                                                                  input.payloadCacheMarks);
+    } else {
+        QJsonObject spritesState;
+        const QDir currentDir(input.currentFolder);
+        for (const auto& model : input.layoutModels) {
+            for (const auto& s : model.sprites) {
+                spritesState[spriteStateKey(currentDir, s->path)] = buildSpriteState(*s);
             }
-            spritesState[key] = sObj;
         }
+        markersInfo["sprites"] = spritesState;
     }
-    markersInfo["sprites"] = spritesState;
     if (input.selectedSprite) {
         markersInfo["selected_sprite_path"] = input.selectedSprite->path;
     }
@@ -345,6 +528,10 @@ QJsonObject ProjectPayloadCodec::build(const ProjectPayloadBuildInput& input) {
     saveOpts["destination"] = input.saveConfig.destination;
     saveOpts["output_path"] = input.saveConfig.outputPath;
     saveOpts["transform"] = input.saveConfig.transform;
+    if (!input.saveConfig.extraTransforms.isEmpty())
+        saveOpts["extra_transforms"] = QJsonArray::fromStringList(input.saveConfig.extraTransforms);
+    if (input.saveConfig.meshVertexBudget > 0)
+        saveOpts["mesh_vertex_budget"] = input.saveConfig.meshVertexBudget;
     QJsonArray profilesArr;
     for (const QString& profileName : input.saveConfig.profiles) {
         profilesArr.append(profileName);
@@ -362,6 +549,8 @@ QJsonObject ProjectPayloadCodec::build(const ProjectPayloadBuildInput& input) {
         po["name"]         = p.name;
         po["output_path"]  = p.outputPath;
         po["transform"]    = p.transform;
+        if (!p.extraTransforms.isEmpty())
+            po["extra_transforms"] = QJsonArray::fromStringList(p.extraTransforms);
         po["scale_filter"] = p.scaleFilter;
         if (!p.postExportCommand.isEmpty())
             po["post_export_command"] = p.postExportCommand;
@@ -401,6 +590,33 @@ QJsonObject ProjectPayloadCodec::build(const ProjectPayloadBuildInput& input) {
     return root;
 }
 
+QByteArray ProjectPayloadCodec::toJson(const ProjectPayloadBuildInput& input, QString* writtenAt) {
+    ProjectPayloadBuildInput headerInput = input;
+    headerInput.includeSpriteStates = !input.payloadCache;
+    const QJsonObject root = build(headerInput);
+    if (writtenAt) {
+        *writtenAt = root.value("written_at").toString();
+    }
+    QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+    if (!input.payloadCache) {
+        return json;
+    }
+
+    // The empty table as the indented writer lays it out under "spritemarkers". Raw
+    // newlines never occur inside strings, so this cannot match user text.
+    const QByteArray emptySprites = QByteArrayLiteral("\n        \"sprites\": {\n        }");
+    const qsizetype markersAt = json.indexOf("\n    \"spritemarkers\": {\n");
+    const qsizetype at = markersAt < 0 ? -1 : json.indexOf(emptySprites, markersAt);
+    if (at < 0) {
+        return QJsonDocument(build(input)).toJson(QJsonDocument::Indented);
+    }
+    const qsizetype valueAt = at + emptySprites.indexOf('{');
+    json.replace(valueAt, emptySprites.size() - (valueAt - at),
+                 input.payloadCache->spriteStatesJson(input.currentFolder, input.layoutModels,
+                                                      input.payloadCacheMarks));
+    return json;
+}
+
 ProjectPayloadApplyResult ProjectPayloadCodec::applyToLayout(const QJsonObject& root, const QString& currentFolder, QVector<LayoutModel>& layoutModels) {
     ProjectPayloadApplyResult out;
     if (!root.value(QStringLiteral("complete")).toBool()) {
@@ -408,73 +624,35 @@ ProjectPayloadApplyResult ProjectPayloadCodec::applyToLayout(const QJsonObject&
     }
 
     QJsonObject markersInfo = root["spritemarkers"].toObject();
-    QJsonObject spritesState = markersInfo["sprites"].toObject();
-    for (auto& model : layoutModels) {
-        for (auto& sprite : model.sprites) {
-            QString key = QDir(currentFolder).relativeFilePath(sprite->path);
-            if (!spritesState.contains(key)) {
-                key = QFileInfo(sprite->path).fileName();
-            }
-            if (!spritesState.contains(key)) {
-                continue;
-            }
-            QJsonObject state = spritesState[key].toObject();
-            if (state.contains("name")) {
-                sprite->name = state["name"].toString();
-            }
-            sprite->aliases.clear();
-            for (const auto& a : state["aliases"].toArray())
-                sprite->aliases.append(a.toString());
-            // Only apply stored pivot if the project was saved with the has_pivot flag.
-            // Older projects (no flag, or pivot_y=0 from partial centering) are ignored
-            // so LayoutParser's correctly-centered values are used instead.
-            if (state["has_pivot"].toBool() && state.contains("pivot_x") && state.contains("pivot_y")) {
-                sprite->pivotX = state["pivot_x"].toInt();
-                sprite->pivotY = state["pivot_y"].toInt();
-            }
-            if (!state.contains("markers")) {
-                continue;
-            }
-            sprite->points.clear();
-            QJsonArray markersArr = state["markers"].toArray();
-            sprite->points.reserve(markersArr.size());
-            for (const auto& mVal : markersArr) {
-                QJsonObject mObj = mVal.toObject();
-                NamedPoint p;
-                p.name = normalizeMarkerName(mObj["name"].toString());
-                p.x = mObj["x"].toInt();
-                p.y = mObj["y"].toInt();
-                QString kind = mObj["kind"].toString();
-                if (kind.isEmpty()) {
-                    kind = mObj["type"].toString();
-                }
-                p.kind = markerKindFromString(kind);
-                p.radius = mObj["radius"].toInt(8);
-                p.w = mObj["w"].toInt(16);
-                p.h = mObj["h"].toInt(16);
-                if (mObj.contains("polygon_points")) {
-                    QJsonArray polyArr = mObj["polygon_points"].toArray();
-                    p.polygonPoints.reserve(polyArr.size());
-                    for (const auto& ptVal : polyArr) {
-                        QJsonArray ptPair = ptVal.toArray();
-                        if (ptPair.size() == 2) {
-                            p.polygonPoints.append(QPoint(ptPair[0].toInt(), ptPair[1].toInt()));
-                        }
-                    }
-                } else if (mObj.contains("vertices")) {
-                    QJsonArray verticesArr = mObj["vertices"].toArray();
-                    p.polygonPoints.reserve(verticesArr.size());
-                    for (const auto& vertexVal : verticesArr) {
-                        QJsonObject vertex = vertexVal.toObject();
-                        if (vertex.contains("x") && vertex.contains("y")) {
-                            p.polygonPoints.append(QPoint(vertex["x"].toInt(), vertex["y"].toInt()));
-                        }
-                    }
+    const QHash<QString, SpriteStateEntry> spriteStates = decodeSpriteStates(markersInfo["sprites"].toObject());
+
+    // Sprites are independent of each other; collect each one once (models may share
+    // pointers) and apply their states in parallel chunks.
+    QVector<Sprite*> sprites;
+    {
+        QSet<const Sprite*> seen;
+        for (auto& model : layoutModels) {
+            for (auto& sprite : model.sprites) {
+                if (sprite && !seen.contains(sprite.get())) {
+                    seen.insert(sprite.get());
+                    sprites.append(sprite.get());
                 }
-                sprite->points.append(p);
             }
         }
     }
+    const SpriteKeyResolver resolver(currentFolder);
+    forEachChunk(sprites.size(), [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            Sprite* sprite = sprites[i];
+            auto it = spriteStates.constFind(resolver.key(sprite->path));
+            if (it == spriteStates.constEnd()) {
+                it = spriteStates.constFind(QFileInfo(sprite->path).fileName());
+            }
+            if (it != spriteStates.constEnd()) {
+                applySpriteState(*it, *sprite);
+            }
+        }
+    });
 
     QJsonObject animInfo = root["animations"].toObject();
     out.selectedTimelineIndex = animInfo["selected_timeline_index"].toInt(-1);
@@ -574,6 +752,10 @@ ProjectPayloadApplyResult ProjectPayloadCodec::applyToLayout(const QJsonObject&
     out.saveConfig.destination = saveOpts["destination"].toString();
     out.saveConfig.outputPath = saveOpts["output_path"].toString();
     out.saveConfig.transform = saveOpts["transform"].toString();
+    for (const auto& tVal : saveOpts["extra_transforms"].toArray()) {
+        out.saveConfig.extraTransforms.append(tVal.toString());
+    }
+    out.saveConfig.meshVertexBudget = qMax(0, saveOpts["mesh_vertex_budget"].toInt(0));
     QJsonArray profilesArr = saveOpts["profiles"].toArray();
     out.saveConfig.profiles.reserve(profilesArr.size());
     for (const auto& pVal : profilesArr) {
@@ -589,6 +771,8 @@ ProjectPayloadApplyResult ProjectPayloadCodec::applyToLayout(const QJsonObject&
         p.name               = po["name"].toString();
         p.outputPath         = po["output_path"].toString();
         p.transform          = po["transform"].toString();
+        for (const auto& tVal : po["extra_transforms"].toArray())
+            p.extraTransforms.append(tVal.toString());
         p.scaleFilter        = po["scale_filter"].toString();
         p.postExportCommand  = po["post_export_command"].toString();
         for (const auto& prv : po["profiles"].toArray())
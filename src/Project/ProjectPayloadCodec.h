@@ -1,8 +1,15 @@
 #pragma once
 
+#include <QByteArray>
+#include <QJsonArray>
 #include <QJsonObject>
 #include "models.h"
 
+#include <limits>
+
+class QDir;
+class ProjectPayloadCache;
+
 struct ProjectPayloadBuildInput {
     QString currentFolder;
     QString sourceFolder;          // Primary source folder for sprite files (used as base for relative paths)
@@ -43,6 +50,9 @@ struct ProjectPayloadBuildInput {
     QStringList orphanedSpritePaths; // Sprite paths recorded as orphaned (no backing file)
     QVector<ExportPreset> exportPresets;
     QVector<MarkerTemplate> markerTemplates;
+    ProjectPayloadCache* payloadCache = nullptr;  // Reuses encoded sprites/timelines when set
+    quint64 payloadCacheMarks = std::numeric_limits<quint64>::max();  // Cache marks made later stay set
+    bool includeSpriteStates = true;  // False leaves "spritemarkers.sprites" empty for encoders that stream it
 };
 
 struct ProjectPayloadApplyResult {
@@ -78,5 +88,16 @@ struct ProjectPayloadApplyResult {
 class ProjectPayloadCodec {
 public:
     static QJsonObject build(const ProjectPayloadBuildInput& input);
+    // Indented JSON text of build(input). With a payload cache the sprite table is spliced
+    // from the cached entry bytes instead of being serialised again.
+    static QByteArray toJson(const ProjectPayloadBuildInput& input, QString* writtenAt = nullptr);
     static ProjectPayloadApplyResult applyToLayout(const QJsonObject& root, const QString& currentFolder, QVector<LayoutModel>& layoutModels);
+    // Per-sprite entry of "spritemarkers.sprites" and the key it is stored under.
+    static QJsonObject buildSpriteState(const Sprite& sprite);
+    static QString spriteStateKey(const QDir& currentFolder, const QString& spritePath);
+    // Timeline array as stored in "animations" and in each atlas entry.
+    static QJsonArray buildTimelines(const QVector<AnimationTimeline>& timelines);
+    static QJsonObject buildTimeline(const AnimationTimeline& timeline);
+    // Atlas sprite path as stored by portable saves (relative to the sprite base when inside it).
+    static QString portableSpritePath(const QDir& baseDir, const QString& spritePath);
 };
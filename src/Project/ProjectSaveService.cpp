@@ -1,36 +1,281 @@
 #include "ProjectSaveService.h"
-#include "MarkerUtils.h"
 #include "ResolutionUtils.h"
 #include "ArchiveExtractor.h"
+#include "AtlasCompositor.h"
+#include "BinaryMetadataExport.h"
+#include "ExportTiming.h"
+#include "LayoutParser.h"
+#include "ProjectCborCodec.h"
+#include "ProjectFileLoader.h"
+#include "ProjectPayloadCodec.h"
+#include "SourceImageStore.h"
 
 #ifdef SPRAT_EMBEDDED_CLI
 #include "EmbeddedCli.h"
 #endif
 
 #include <QApplication>
+#include <QBuffer>
 #include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QDir>
+#include <QDirIterator>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QMessageBox>
 #include <QProcess>
+#include <QSet>
 #include <QStandardPaths>
 #include <QTemporaryDir>
 #include <QTemporaryFile>
 #include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrent>
 #include <QtGlobal>
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 namespace {
     QString trPS(const char* text) {
         return QCoreApplication::translate("ProjectSaveService", text);
     }
 
+    bool writeProjectData(const QString& projectFolder, const QByteArray& data, bool binary, QString& error) {
+        QDir dir(projectFolder);
+        if (!dir.exists()) {
+            if (!dir.mkpath(".")) {
+                error = trPS("Could not create project directory.");
+                return false;
+            }
+        }
+        const QString fileName = ProjectFileLoader::projectFileName(binary);
+        QFile projectFile(dir.filePath(fileName));
+        if (!projectFile.open(QIODevice::WriteOnly)) {
+            error = trPS("Could not write %1.").arg(fileName);
+            return false;
+        }
+        if (projectFile.write(data) < 0) {
+            error = trPS("Failed to write %1.").arg(fileName);
+            return false;
+        }
+        projectFile.close();
+        // A folder holds one project file; drop the other encoding so a stale copy is never loaded.
+        QFile::remove(dir.filePath(ProjectFileLoader::projectFileName(!binary)));
+        return true;
+    }
+
     bool isCompactPreset(const QString& preset) {
         const QString p = preset.trimmed().toLower();
         return p == "quality" || p == "small";
     }
+
+    // Written into each output folder; lists the folder's files and the hash of the
+    // inputs they were produced from, so an unchanged export can skip the folder.
+    const QString kManifestFileName = QStringLiteral(".sprat-manifest.json");
+    constexpr int kManifestVersion = 2;
+
+    // Sprite paths and file contents, in list order. Contents rather than timestamps so
+    // a fresh checkout of an unchanged project still matches.
+    QByteArray hashSpriteFiles(const QStringList& paths) {
+        auto hashFile = [](const QString& path) -> QByteArray {
+            QCryptographicHash hash(QCryptographicHash::Sha1);
+            QFile file(path);
+            if (file.open(QIODevice::ReadOnly)) {
+                hash.addData(&file);
+            }
+            return hash.result();
+        };
+#ifdef Q_OS_WASM
+        QList<QByteArray> digests;
+        for (const QString& path : paths) {
+            digests.append(hashFile(path));
+        }
+#else
+        const QList<QByteArray> digests = QtConcurrent::blockingMapped<QList<QByteArray>>(paths, hashFile);
+#endif
+        QCryptographicHash combined(QCryptographicHash::Sha1);
+        for (int i = 0; i < paths.size(); ++i) {
+            combined.addData(paths.at(i).toUtf8());
+            combined.addData(digests.at(i));
+        }
+        return combined.result();
+    }
+
+    void addField(QCryptographicHash& hash, const char* key, const QByteArray& value) {
+        hash.addData(QByteArray(key) + '=' + value + '\n');
+    }
+
+    void addField(QCryptographicHash& hash, const char* key, const QString& value) {
+        addField(hash, key, value.toUtf8());
+    }
+
+    void addProfile(QCryptographicHash& hash, const SpratProfile& profile) {
+        addField(hash, "profile", profile.name.trimmed());
+        addField(hash, "preset", profile.preset.trimmed());
+        addField(hash, "max_size", QString("%1x%2").arg(profile.maxWidth).arg(profile.maxHeight));
+        addField(hash, "target_resolution", QString("%1x%2:%3:%4")
+            .arg(profile.targetResolutionWidth).arg(profile.targetResolutionHeight)
+            .arg(profile.targetResolutionUseSource).arg(profile.resolutionReference.trimmed()));
+        addField(hash, "padding", QString::number(profile.padding));
+        addField(hash, "extrude", QString::number(profile.extrude));
+        addField(hash, "threads", QString::number(profile.threads));
+        addField(hash, "trim", QString::number(profile.trimTransparent));
+        addField(hash, "rotate", QString::number(profile.allowRotation));
+        addField(hash, "scale", QString::number(profile.scale, 'g', 17));
+        addField(hash, "multipack", QString::number(profile.multipack));
+        addField(hash, "sort", profile.sort.trimmed());
+        addField(hash, "gpu_compress", profile.gpuCompress);
+        addField(hash, "dilate", QString::number(profile.dilate));
+    }
+
+    // A rebuilt tool can change the output for identical inputs.
+    void addTool(QCryptographicHash& hash, const char* key, const QString& toolPath) {
+        const QFileInfo info(toolPath);
+        addField(hash, key, QString("%1:%2:%3").arg(toolPath).arg(info.size())
+            .arg(info.lastModified().toMSecsSinceEpoch()));
+    }
+
+    bool manifestMatches(const QString& dirPath, const QByteArray& inputHash) {
+        QFile file(QDir(dirPath).filePath(kManifestFileName));
+        if (!file.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+        const QJsonObject manifest = QJsonDocument::fromJson(file.readAll()).object();
+        if (manifest.value("version").toInt() != kManifestVersion
+            || manifest.value("input_hash").toString() != QString::fromLatin1(inputHash.toHex())) {
+            return false;
+        }
+        const QJsonArray outputs = manifest.value("outputs").toArray();
+        if (outputs.isEmpty()) {
+            return false;
+        }
+        const QDir dir(dirPath);
+        for (const QJsonValue& value : outputs) {
+            const QJsonObject output = value.toObject();
+            const QFileInfo info(dir.filePath(output.value("file").toString()));
+            if (!info.isFile() || info.size() != output.value("size").toInteger()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // True when the file at path already holds exactly data: same size, same SHA-1.
+    bool fileMatches(const QString& path, const QByteArray& data) {
+        const QFileInfo info(path);
+        if (!info.isFile() || info.size() != data.size()) {
+            return false;
+        }
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+        QCryptographicHash existing(QCryptographicHash::Sha1);
+        if (!existing.addData(&file)) {
+            return false;
+        }
+        return existing.result() == QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+    }
+
+    // Files below dirPath, relative to root. Subfolders with a manifest of their own
+    // hold another atlas's export and are skipped.
+    void collectOutputFiles(const QDir& root, const QString& dirPath, QSet<QString>& files) {
+        const QFileInfoList entries = QDir(dirPath).entryInfoList(
+            QDir::Files | QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot);
+        for (const QFileInfo& info : entries) {
+            if (info.isDir() && !info.isSymLink()) {
+                if (!QFileInfo::exists(QDir(info.filePath()).filePath(kManifestFileName))) {
+                    collectOutputFiles(root, info.filePath(), files);
+                }
+            } else if (info.isFile()) {
+                const QString relative = root.relativeFilePath(info.filePath());
+                if (relative != kManifestFileName) {
+                    files.insert(relative);
+                }
+            }
+        }
+    }
+
+    // Files the previous export into dirPath wrote, relative to it: the outputs its
+    // manifest lists, or everything outside nested atlas folders when there is no
+    // manifest of the current version.
+    QSet<QString> listOutputFiles(const QString& dirPath) {
+        QSet<QString> files;
+        QFile file(QDir(dirPath).filePath(kManifestFileName));
+        if (file.open(QIODevice::ReadOnly)) {
+            const QJsonObject manifest = QJsonDocument::fromJson(file.readAll()).object();
+            if (manifest.value("version").toInt() == kManifestVersion) {
+                for (const QJsonValue& value : manifest.value("outputs").toArray()) {
+                    const QString relative = QDir::cleanPath(value.toObject().value("file").toString());
+                    // Never reach outside the profile folder.
+                    if (!relative.isEmpty() && QDir::isRelativePath(relative)
+                        && relative != QLatin1String("..") && !relative.startsWith(QLatin1String("../"))) {
+                        files.insert(relative);
+                    }
+                }
+                return files;
+            }
+        }
+        collectOutputFiles(QDir(dirPath), dirPath, files);
+        return files;
+    }
+
+    // Records the files this export wrote (relative to dirPath). Nested atlas folders
+    // inside the profile folder are left to their own manifests. An identical manifest
+    // is left untouched, so a rebuild with the same outputs does not modify the folder.
+    void writeManifest(const QString& dirPath, const QByteArray& inputHash, const QStringList& files) {
+        const QDir dir(dirPath);
+        QJsonArray outputs;
+        for (const QString& relative : files) {
+            QJsonObject output;
+            output["file"] = relative;
+            output["size"] = QFileInfo(dir.filePath(relative)).size();
+            outputs.append(output);
+        }
+        QJsonObject manifest;
+        manifest["version"] = kManifestVersion;
+        manifest["input_hash"] = QString::fromLatin1(inputHash.toHex());
+        manifest["outputs"] = outputs;
+        const QString path = dir.filePath(kManifestFileName);
+        const QByteArray data = QJsonDocument(manifest).toJson();
+        if (fileMatches(path, data)) {
+            return;
+        }
+        QFile file(path);
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(data);
+        }
+    }
+}
+
+SaveConfig ProjectSaveService::atlasConfig(const SaveConfig& config, const AtlasEntry& atlas,
+                                           int rootExporterCount) {
+    SaveConfig out = config;
+    // Per-atlas export overrides (empty = inherit global)
+    if (!atlas.exportConfig.profiles.isEmpty())
+        out.profiles = atlas.exportConfig.profiles;
+    if (!atlas.exportConfig.transform.isEmpty())
+        out.transform = atlas.exportConfig.transform;
+    if (!atlas.exportConfig.scaleFilter.isEmpty())
+        out.scaleFilter = atlas.exportConfig.scaleFilter;
+    // Written to <outputPath>/<profile>/<atlasSubdir>/.
+    if (!atlas.outputSubdir.isEmpty()) {
+        out.atlasSubdir = atlas.outputSubdir;
+    } else if (rootExporterCount <= 1) {
+        out.atlasSubdir.clear();
+    } else if (atlas.isNeutral) {
+        out.atlasSubdir = QStringLiteral("sprites");
+    } else {
+        const QString slug = atlas.name.trimmed().toLower().replace(QLatin1Char(' '), QLatin1Char('_'));
+        out.atlasSubdir = slug.isEmpty() ? QStringLiteral("atlas") : slug;
+    }
+    return out;
 }
 
 bool ProjectSaveService::writeProjectJson(
@@ -38,24 +283,48 @@ bool ProjectSaveService::writeProjectJson(
     const QJsonObject& payload,
     QString& error
 ) {
-    QDir dir(projectFolder);
-    if (!dir.exists()) {
-        if (!dir.mkpath(".")) {
-            error = trPS("Could not create project directory.");
-            return false;
-        }
-    }
-    QFile projectFile(dir.filePath("project.spart.json"));
-    if (!projectFile.open(QIODevice::WriteOnly)) {
-        error = trPS("Could not write project.spart.json.");
-        return false;
-    }
-    if (projectFile.write(QJsonDocument(payload).toJson()) < 0) {
-        error = trPS("Failed to write project.spart.json.");
-        return false;
+    return writeProjectData(projectFolder, QJsonDocument(payload).toJson(), false, error);
+}
+
+bool ProjectSaveService::writeProjectFile(
+    const QString& projectFolder,
+    const ProjectPayloadBuildInput& input,
+    bool binary,
+    QString& error
+) {
+    const QByteArray data = binary
+        ? ProjectCborCodec::encode(input)
+        : ProjectPayloadCodec::toJson(input);
+    return writeProjectData(projectFolder, data, binary, error);
+}
+
+bool ProjectSaveService::save(
+    SaveConfig config,
+    const QString& layoutInputPath,
+    const QStringList& framePaths,
+    const QString& sourceFolder,
+    const QVector<SpratProfile>& availableProfiles,
+    const QString& selectedProfileName,
+    const QString& spratLayoutBin,
+    const QString& spratPackBin,
+    const QString& spratConvertBin,
+    const QJsonObject& projectPayload,
+    QString& savedDestination,
+    QString& error,
+    const QString& deduplicateMode,
+    SaveCallbacks callbacks,
+    int maxParallelProfiles
+) {
+    const ExportStepTimer textTimer;
+    const ExportMetadataText metadata = ExportMetadataText::fromPayload(projectPayload);
+    if (callbacks.logEntry) {
+        callbacks.logEntry(textTimer.finish(QStringLiteral("text generation"), QString(),
+                                            metadata.markers.size() + metadata.animations.size()));
     }
-    projectFile.close();
-    return true;
+    return save(std::move(config), layoutInputPath, framePaths, sourceFolder, availableProfiles,
+                selectedProfileName, spratLayoutBin, spratPackBin, spratConvertBin, projectPayload,
+                metadata, savedDestination, error, deduplicateMode, std::move(callbacks),
+                maxParallelProfiles);
 }
 
 bool ProjectSaveService::save(
@@ -69,10 +338,12 @@ bool ProjectSaveService::save(
     const QString& spratPackBin,
     const QString& spratConvertBin,
     const QJsonObject& projectPayload,
+    const ExportMetadataText& metadata,
     QString& savedDestination,
     QString& error,
     const QString& deduplicateMode,
-    SaveCallbacks callbacks
+    SaveCallbacks callbacks,
+    int maxParallelProfiles
 ) {
     Q_UNUSED(sourceFolder);
     const auto& setLoading     = callbacks.setLoading;
@@ -94,15 +365,10 @@ bool ProjectSaveService::save(
     // Never auto-convert a non-existent folder path to a zip.
     bool isZip = config.destination.endsWith(".zip", Qt::CaseInsensitive);
 
-    QTemporaryDir tempZipDir;
+    // Zip exports keep every output in memory and write the archive once at the end,
+    // so nothing is staged on disk for them.
     QString workingPath;
-    if (isZip) {
-        if (!tempZipDir.isValid()) {
-            error = trPS("Could not create temporary directory.");
-            return false;
-        }
-        workingPath = tempZipDir.path();
-    } else {
+    if (!isZip) {
         workingPath = config.destination;
         QDir d(workingPath);
         if (!d.exists()) {
@@ -110,23 +376,6 @@ bool ProjectSaveService::save(
         }
     }
 
-    // For folder exports, remove stale output directories first.
-    if (!isZip) {
-        const QDir wd(workingPath);
-        for (const QString& profileNameRaw : config.profiles) {
-            const QString profileName = profileNameRaw.trimmed();
-            if (profileName.isEmpty()) continue;
-            if (config.atlasSubdir.isEmpty()) {
-                // Single atlas: wipe the whole profile folder.
-                QDir(wd.filePath(profileName)).removeRecursively();
-            } else {
-                // Multi-atlas: only wipe this atlas's subfolder within the profile.
-                QDir(QDir(wd.filePath(profileName)).filePath(config.atlasSubdir))
-                    .removeRecursively();
-            }
-        }
-    }
-
     if (setLoading) setLoading(true);
     LoadingGuard loadingGuard{setLoading};
     if (setStatus) setStatus(trPS("Exporting..."));
@@ -148,7 +397,7 @@ bool ProjectSaveService::save(
     }
 
     QDir destDir(workingPath);
-    if (!destDir.exists()) {
+    if (!isZip && !destDir.exists()) {
         if (!destDir.mkpath(".")) {
             error = trPS("Could not create destination directory.");
             return false;
@@ -166,150 +415,13 @@ bool ProjectSaveService::save(
         sourceResolutionWidth,
         sourceResolutionHeight);
 
-    QJsonObject markersInfo = projectPayload["spritemarkers"].toObject();
-    QJsonObject spritesState = markersInfo["sprites"].toObject();
-    
-    QString markersContent;
-    QTextStream markersStream(&markersContent);
-
-    for (auto it = spritesState.begin(); it != spritesState.end(); ++it) {
-        QJsonObject spriteState = it.value().toObject();
-        QJsonArray markersArr = spriteState["markers"].toArray();
-        bool hasPivotMarker = false;
-        
-        QString spritePath = it.key();
-        markersStream << "path \"" << spritePath << "\"\n";
-
-        for (auto markerIt = markersArr.begin(); markerIt != markersArr.end(); ++markerIt) {
-            QJsonObject markerObj = markerIt->toObject();
-            const QString markerName = normalizeMarkerName(markerObj["name"].toString());
-            QString markerKindStr = markerObj["kind"].toString();
-            if (markerKindStr.isEmpty()) {
-                markerKindStr = markerObj["type"].toString();
-            }
-            if (markerKindStr.isEmpty()) {
-                markerKindStr = "point";
-            }
-            
-            markersStream << "- marker \"" << markerName << "\" " << markerKindStr;
-            
-            if (markerKindStr == "point") {
-                markersStream << " " << markerObj["x"].toInt() << "," << markerObj["y"].toInt();
-            } else if (markerKindStr == "circle") {
-                markersStream << " " << markerObj["x"].toInt() << "," << markerObj["y"].toInt() 
-                              << " " << markerObj["radius"].toInt();
-            } else if (markerKindStr == "rectangle") {
-                markersStream << " " << markerObj["x"].toInt() << "," << markerObj["y"].toInt() 
-                              << " " << markerObj["w"].toInt() << "," << markerObj["h"].toInt();
-            } else if (markerKindStr == "polygon") {
-                QJsonArray vertices = markerObj["vertices"].toArray();
-                if (vertices.isEmpty()) {
-                    vertices = markerObj["polygon_points"].toArray(); // Legacy fallback
-                }
-                for (const auto& vVal : vertices) {
-                    if (vVal.isArray()) {
-                        QJsonArray vArr = vVal.toArray();
-                        if (vArr.size() >= 2) {
-                            markersStream << " " << vArr[0].toInt() << "," << vArr[1].toInt();
-                        }
-                    } else {
-                        QJsonObject vObj = vVal.toObject();
-                        markersStream << " " << vObj["x"].toInt() << "," << vObj["y"].toInt();
-                    }
-                }
-            }
-            markersStream << "\n";
-
-            if (markerName == "pivot") {
-                hasPivotMarker = true;
-            }
-        }
-        
-        if (!hasPivotMarker) {
-            markersStream << "- marker \"pivot\" point "
-                          << spriteState["pivot_x"].toInt() << "," << spriteState["pivot_y"].toInt() << "\n";
-        }
-        markersStream << "\n";
-    }
-
-    // Emit top-level alias directives for each sprite that has aliases.
-    for (auto it = spritesState.begin(); it != spritesState.end(); ++it) {
-        const QJsonObject spriteState = it.value().toObject();
-        const QString canonicalName = spriteState["name"].toString();
-        if (canonicalName.isEmpty()) continue;
-        for (const auto& a : spriteState["aliases"].toArray()) {
-            const QString alias = a.toString().trimmed();
-            if (!alias.isEmpty())
-                markersStream << "alias \"" << alias << "\" \"" << canonicalName << "\"\n";
-        }
-    }
-
-    QJsonObject animInfo = projectPayload["animations"].toObject();
-    const int animationFps = animInfo["animation_fps"].toInt(8);
-    QJsonArray timelines = animInfo["timelines"].toArray();
-    
-    QString animContent;
-    QTextStream animStream(&animContent);
-    animStream << "fps " << animationFps << "\n\n";
-
-    for (int i = 0; i < timelines.size(); ++i) {
-        QJsonObject timeline = timelines[i].toObject();
-        int timelineFps = timeline["fps"].toInt(animationFps);
-        if (timelineFps <= 0) {
-            timelineFps = 8;
-        }
-        
-        animStream << "animation \"" << timeline["name"].toString() << "\" " << timelineFps << "\n";
-        const QString aliasOf = timeline["alias_of"].toString();
-        if (!aliasOf.isEmpty()) {
-            animStream << "alias \"" << aliasOf << "\"";
-            const bool hFlip = timeline["h_flip"].toBool();
-            const bool vFlip = timeline["v_flip"].toBool();
-            if (hFlip || vFlip) {
-                animStream << " flip ";
-                if (hFlip) animStream << "h";
-                if (vFlip) animStream << "v";
-            }
-            animStream << "\n";
-        } else {
-            QJsonArray frames = timeline["frames"].toArray();
-            for (const auto& fVal : frames) {
-                animStream << "- frame \"" << fVal.toString() << "\"\n";
-            }
-        }
-        animStream << "\n";
-    }
-
-    QTemporaryFile markersTemp;
-    markersTemp.setFileTemplate(QDir::temp().filePath("sprat-gui-markers-XXXXXX.txt"));
-    if (!markersTemp.open()) {
-        error = trPS("Could not create temporary markers file.");
-        return false;
-    }
-    if (markersTemp.write(markersContent.toUtf8()) < 0 || !markersTemp.flush()) {
-        error = trPS("Could not write temporary markers file.");
-        return false;
-    }
-    markersTemp.close();
-
-    QTemporaryFile animTemp;
-    animTemp.setFileTemplate(QDir::temp().filePath("sprat-gui-animations-XXXXXX.txt"));
-    if (!animTemp.open()) {
-        error = trPS("Could not create temporary animation file.");
-        return false;
-    }
-    if (animTemp.write(animContent.toUtf8()) < 0 || !animTemp.flush()) {
-        error = trPS("Could not write temporary animation file.");
-        return false;
-    }
-    animTemp.close();
-
     if (config.profiles.isEmpty()) {
         error = trPS("No output profiles selected.");
         return false;
     }
 
     updateStatus(trPS("Preparing layout input..."));
+    const ExportStepTimer discoveryTimer;
     if (checkCanceled()) {
         return false;
     }
@@ -331,7 +443,7 @@ bool ProjectSaveService::save(
         saveFrameList.close();
     }
 
-    auto runProcess = [&](const QString& tool, const QStringList& args, const QString& step, const QByteArray* inputData = nullptr, QByteArray* outputData = nullptr) -> bool {
+    auto runProcess = [&](QString& processError, const QString& tool, const QStringList& args, const QString& step, const QByteArray* inputData = nullptr, QByteArray* outputData = nullptr) -> bool {
 #ifdef SPRAT_EMBEDDED_CLI
         QString toolName = QFileInfo(tool).baseName();
         if (toolName.startsWith("sprat")) {
@@ -345,9 +457,9 @@ bool ProjectSaveService::save(
             if (embeddedResult.exitCode != 0) {
                 const QString stderrText = QString::fromUtf8(embeddedResult.stdErr).trimmed();
                 if (!stderrText.isEmpty()) {
-                    error = stderrText;
+                    processError = stderrText;
                 } else {
-                    error = trPS("Command failed: %1").arg(step);
+                    processError = trPS("Command failed: %1").arg(step);
                 }
                 return false;
             }
@@ -374,12 +486,110 @@ bool ProjectSaveService::save(
         return nullptr;
     };
 
-    constexpr double kScaleMatchTolerance = 1e-6;
+    // Folder exports skip any profile folder whose manifest records the same inputs.
+    // The hash below covers what every profile shares; each chain adds its own profile.
+    const bool incremental = !isZip && !framePaths.isEmpty();
+    QByteArray sharedInputHash;
+    if (incremental) {
+        updateStatus(trPS("Checking for changes..."));
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(QByteArray::number(kManifestVersion));
+        hash.addData(hashSpriteFiles(framePaths));
+        addField(hash, "markers", metadata.markers);
+        addField(hash, "animations", metadata.animations);
+        addField(hash, "transform", config.transform);
+        if (!config.extraTransforms.isEmpty()) {
+            addField(hash, "extra_transforms", config.extraTransforms.join(u','));
+        }
+        if (config.meshVertexBudget > 0) {
+            addField(hash, "mesh_vertex_budget", QString::number(config.meshVertexBudget));
+        }
+        addField(hash, "scale_filter", config.scaleFilter);
+        addField(hash, "atlas_subdir", config.atlasSubdir);
+        addField(hash, "deduplicate", deduplicateMode);
+        addField(hash, "pack_in_process", config.packInProcess ? QStringLiteral("1") : QString());
+        addField(hash, "source_resolution", layoutOptions["source_resolution"].toString());
+        addTool(hash, "spratlayout", spratLayoutBin);
+        addTool(hash, "spratpack", spratPackBin);
+        addTool(hash, "spratconvert", spratConvertBin);
+        sharedInputHash = hash.result();
+    }
+    if (callbacks.logEntry) {
+        callbacks.logEntry(discoveryTimer.finish(QStringLiteral("discovery"), QString(),
+                                                 framePaths.isEmpty() ? -1 : QFileInfo(layoutPathForSave).size()));
+    }
+
+    // Each profile is an independent layout -> pack -> write -> convert chain. Chains
+    // run concurrently up to maxParallelProfiles; their log entries are buffered and
+    // reported in profile order so output does not depend on scheduling.
+    struct ProfileChain {
+        QString name;
+        bool ok = false;
+        bool aborted = false;  // stopped early because another chain failed
+        QString error;
+        QVector<ExportLogEntry> log;
+        QVector<ArchiveExtractor::ZipEntry> zipEntries;
+    };
+    QVector<ProfileChain> chains;
     for (const QString& profileNameRaw : config.profiles) {
         const QString profileName = profileNameRaw.trimmed();
-        if (profileName.isEmpty()) {
-            continue;
+        if (!profileName.isEmpty()) {
+            chains.append(ProfileChain{profileName});
         }
+    }
+    std::atomic_bool chainFailed{false};
+
+    // In-process packing decodes each source once into this store; every profile then
+    // composes and scales its spritesheet from the decoded images.
+    SourceImageStore sourceImages;
+    std::atomic_int composedProfiles{0};
+    const QString layoutParserFolder = QFileInfo(layoutInputPath).isDir() ? layoutInputPath : sourceFolder;
+    const Qt::TransformationMode composeScaleMode = AtlasCompositor::scaleMode(config.scaleFilter);
+
+    // Tight meshes depend only on the sources, so they are traced once, from the same
+    // decoded images the compositor uses, and added to the markers every profile writes.
+    ExportMetadataText meshedMetadata;
+    if (config.meshVertexBudget > 0) {
+        updateStatus(trPS("Tracing sprite meshes..."));
+        const ExportStepTimer meshTimer;
+        meshedMetadata = metadata;
+        meshedMetadata.appendMeshes(sourceFolder, config.meshVertexBudget, sourceImages);
+        if (callbacks.logEntry) {
+            callbacks.logEntry(meshTimer.finish(QStringLiteral("mesh tracing"), QString(),
+                                                meshedMetadata.markers.size() - metadata.markers.size()));
+        }
+    }
+    const ExportMetadataText& exportText = config.meshVertexBudget > 0 ? meshedMetadata : metadata;
+
+    // Metadata formats to write: the primary transform, then any extra ones, each once.
+    // "raw" writes the sprat-cli text files as they are and "binary" the memory-mappable
+    // file built in-process; the rest go through spratconvert.
+    QStringList transforms;
+    for (const QString& name : QStringList{config.transform} + config.extraTransforms) {
+        const QString trimmed = name.trimmed();
+        if (!trimmed.isEmpty() && trimmed != QLatin1String("none") && !transforms.contains(trimmed)) {
+            transforms.append(trimmed);
+        }
+    }
+    QStringList convertTransforms = transforms;
+    convertTransforms.removeAll(QStringLiteral("raw"));
+    convertTransforms.removeAll(QStringLiteral("binary"));
+
+    constexpr double kScaleMatchTolerance = 1e-6;
+    auto exportProfile = [&](ProfileChain& chain) -> bool {
+        const QString& profileName = chain.name;
+        const QDir destDir(workingPath);  // own copy; chains may run on worker threads
+        auto checkCanceled = [&]() -> bool {
+            if (chainFailed.load()) {
+                chain.aborted = true;
+                return true;
+            }
+            if (shouldCancel && shouldCancel()) {
+                chain.error = trPS("Save canceled.");
+                return true;
+            }
+            return false;
+        };
         updateStatus(QString(trPS("Generating layout for profile '%1'...")).arg(profileName));
         if (checkCanceled()) {
             return false;
@@ -402,16 +612,93 @@ bool ProjectSaveService::save(
         //   <destination>/<profileName>/<atlasSubdir>/
         // Otherwise use the flat layout:
         //   <destination>/<profileName>/
-        const QString profileDirPath = config.atlasSubdir.isEmpty()
-            ? destDir.filePath(profileName)
-            : QDir(destDir.filePath(profileName)).filePath(config.atlasSubdir);
+        // Zip entries use the same layout relative to the archive root.
+        QString profileDirPath = config.atlasSubdir.isEmpty()
+            ? profileName
+            : profileName + u'/' + config.atlasSubdir;
+        // Timing entries name the profile output folder, which tells atlases apart too.
+        const QString timingScope = profileDirPath;
+        if (!isZip) {
+            profileDirPath = destDir.filePath(profileDirPath);
+        }
+        auto logTiming = [&](const ExportStepTimer& timer, const QString& step, qint64 bytes) {
+            if (callbacks.logEntry) {
+                chain.log.append(timer.finish(step, timingScope, bytes));
+            }
+        };
+
+        QByteArray inputHash;
+        if (incremental) {
+            QCryptographicHash hash(QCryptographicHash::Sha1);
+            hash.addData(sharedInputHash);
+            addProfile(hash, effectiveProfile);
+            // The layout saved with the project stands in for spratlayout on its own profile.
+            if (profileName == selectedProfileName) {
+                addField(hash, "cached_layout", cachedLayoutData);
+                addField(hash, "cached_layout_scale", QString::number(cachedLayoutScale, 'g', 17));
+            }
+            inputHash = hash.result();
+            if (manifestMatches(profileDirPath, inputHash)) {
+                if (callbacks.logEntry) {
+                    chain.log.append(ExportLogEntry{ExportLogEntry::Kind::Info,
+                        trPS("Profile '%1' unchanged; kept %2").arg(profileName, profileDirPath), -1});
+                }
+                return true;
+            }
+        }
+
+        // Existing output is replaced file by file: files whose bytes did not change are
+        // left alone (mtime included), and files the previous export wrote that this one
+        // no longer produces are removed at the end. The root atlas's profile folder also
+        // holds the other atlases' subfolders; the manifest keeps them out of its sweep.
         QDir profileDir(profileDirPath);
-        if (!profileDir.exists()) {
+        QSet<QString> staleFiles;
+        QStringList producedFiles;
+        if (!isZip) {
+            staleFiles = listOutputFiles(profileDirPath);
             if (!profileDir.mkpath(".")) {
-                error = QString(trPS("Could not create profile directory: %1")).arg(profileName);
+                chain.error = QString(trPS("Could not create profile directory: %1")).arg(profileName);
                 return false;
             }
         }
+        // Writes one output file, or queues it as a zip entry under the profile path.
+        // Write times add up into a single timing entry per profile.
+        qint64 writeWallMs = 0;
+        qint64 writeCpuMs = 0;
+        qint64 writeBytes = 0;
+        auto writeOutput = [&](const QString& fileName, const QByteArray& data) -> bool {
+            const ExportStepTimer writeTimer;
+            QString outputPath;
+            ExportLogEntry::Kind kind = ExportLogEntry::Kind::FileWritten;
+            if (isZip) {
+                outputPath = profileDirPath + u'/' + fileName;
+                chain.zipEntries.append({outputPath, data});
+            } else {
+                outputPath = profileDir.filePath(fileName);
+                staleFiles.remove(fileName);
+                if (!producedFiles.contains(fileName)) {
+                    producedFiles.append(fileName);
+                }
+                if (fileMatches(outputPath, data)) {
+                    kind = ExportLogEntry::Kind::Unchanged;
+                } else {
+                    QFile file(outputPath);
+                    if (!QDir().mkpath(QFileInfo(outputPath).path())
+                        || !file.open(QIODevice::WriteOnly) || file.write(data) < 0) {
+                        return false;
+                    }
+                    file.close();
+                }
+            }
+            writeWallMs += writeTimer.wallMs();
+            const qint64 cpuMs = writeTimer.cpuMs();
+            writeCpuMs = (cpuMs < 0 || writeCpuMs < 0) ? -1 : writeCpuMs + cpuMs;
+            writeBytes += data.size();
+            if (callbacks.logEntry) {
+                chain.log.append(ExportLogEntry{kind, outputPath, data.size()});
+            }
+            return true;
+        };
 
         QByteArray layoutData;
         bool usingCachedLayout = false;
@@ -476,25 +763,27 @@ bool ProjectSaveService::save(
                 layoutArgs << "--deduplicate" << deduplicateMode;
             }
 
+            const ExportStepTimer layoutTimer;
             bool layoutSuccess = false;
             while (!layoutSuccess) {
                 layoutData.clear();
-                if (!runProcess(spratLayoutBin, layoutArgs, QString(trPS("Layout generation failed for profile '%1'")).arg(profileName), nullptr, &layoutData)) {
+                if (!runProcess(chain.error, spratLayoutBin, layoutArgs, QString(trPS("Layout generation failed for profile '%1'")).arg(profileName), nullptr, &layoutData)) {
                     // Try without trim-transparent on failure
                     if (layoutArgs.contains("--trim-transparent")) {
                         layoutArgs.removeAll("--trim-transparent");
                         continue;
                     }
-                    error = QString(trPS("Layout generation failed for profile '%1'")).arg(profileName);
+                    chain.error = QString(trPS("Layout generation failed for profile '%1'")).arg(profileName);
                     return false;
                 }
                 layoutSuccess = true;
             }
+            logTiming(layoutTimer, QStringLiteral("spratlayout"), layoutData.size());
             if (checkCanceled()) {
                 return false;
             }
             if (!layoutData.contains("atlas ")) {
-                error = QString(trPS("Layout generation produced invalid output for profile '%1'.")).arg(profileName);
+                chain.error = QString(trPS("Layout generation produced invalid output for profile '%1'.")).arg(profileName);
                 return false;
             }
         }
@@ -505,6 +794,31 @@ bool ProjectSaveService::save(
             return false;
         }
 
+        // Single-atlas PNG profiles are composed in-process when enabled; anything that
+        // needs extrusion, dilation, GPU compression or several pages still goes to spratpack.
+        QVector<LayoutModel> composeModels;
+        if (config.packInProcess && AtlasCompositor::supports(effectiveProfile)) {
+            composeModels = LayoutParser::parse(QString::fromUtf8(layoutData), layoutParserFolder, sourceFolder);
+        }
+        if (composeModels.size() == 1) {
+            const ExportStepTimer composeTimer;
+            const QImage atlas = AtlasCompositor::compose(composeModels.first(), sourceImages,
+                                                          composeScaleMode, chain.error);
+            if (atlas.isNull()) {
+                chain.error = QString(trPS("Packing failed for profile '%1'")).arg(profileName)
+                    + QStringLiteral("\n\n") + chain.error;
+                return false;
+            }
+            QBuffer buffer(&imageData);
+            if (!buffer.open(QIODevice::WriteOnly)
+                || !atlas.convertToFormat(QImage::Format_ARGB32).save(&buffer, "PNG")) {
+                chain.error = QString(trPS("Could not encode spritesheet for profile '%1'.")).arg(profileName);
+                return false;
+            }
+            logTiming(composeTimer, QStringLiteral("compose"), imageData.size());
+            composedProfiles.fetch_add(1);
+        }
+
         QStringList packArgs;
         if (effectiveProfile.dilate > 0) {
             packArgs << "--dilate" << QString::number(effectiveProfile.dilate);
@@ -517,13 +831,17 @@ bool ProjectSaveService::save(
             packArgs << "--scale-filter" << config.scaleFilter;
         }
 
-        if (!runProcess(spratPackBin, packArgs, QString(trPS("Packing failed for profile '%1'")).arg(profileName), &layoutData, &imageData)) {
-            const QString packDetails = error;
-            error = QString(trPS("Packing failed for profile '%1'")).arg(profileName);
-            if (!packDetails.isEmpty()) {
-                error += QStringLiteral("\n\n") + packDetails;
+        if (imageData.isEmpty()) {
+            const ExportStepTimer packTimer;
+            if (!runProcess(chain.error, spratPackBin, packArgs, QString(trPS("Packing failed for profile '%1'")).arg(profileName), &layoutData, &imageData)) {
+                const QString packDetails = chain.error;
+                chain.error = QString(trPS("Packing failed for profile '%1'")).arg(profileName);
+                if (!packDetails.isEmpty()) {
+                    chain.error += QStringLiteral("\n\n") + packDetails;
+                }
+                return false;
             }
-            return false;
+            logTiming(packTimer, QStringLiteral("spratpack"), imageData.size());
         }
         const bool isMultipack = layoutData.contains("multipack true") || layoutData.count("atlas ") > 1;
         if (checkCanceled()) {
@@ -531,85 +849,207 @@ bool ProjectSaveService::save(
         }
 
         if (isMultipack && !imageData.startsWith("\x89PNG\r\n\x1a\n")) {
-            QFile imgFile(profileDir.filePath("spritesheet.tar"));
-            if (imgFile.open(QIODevice::WriteOnly)) {
-                imgFile.write(imageData);
-                imgFile.close();
-                if (callbacks.logEntry) {
-                    QFileInfo fi(imgFile.fileName());
-                    callbacks.logEntry({ExportLogEntry::Kind::FileWritten, imgFile.fileName(), fi.size()});
-                }
-            }
+            writeOutput(QStringLiteral("spritesheet.tar"), imageData);
         } else {
             const QString imageFileName = hasDds ? "spritesheet.dds" : "spritesheet.png";
-            QFile imgFile(profileDir.filePath(imageFileName));
-            if (!imgFile.open(QIODevice::WriteOnly) || imgFile.write(imageData) < 0) {
-                error = QString(trPS("Could not write spritesheet for profile '%1'.")).arg(profileName);
+            if (!writeOutput(imageFileName, imageData)) {
+                chain.error = QString(trPS("Could not write spritesheet for profile '%1'.")).arg(profileName);
                 return false;
             }
-            imgFile.close();
-            if (callbacks.logEntry) {
-                QFileInfo fi(imgFile.fileName());
-                callbacks.logEntry({ExportLogEntry::Kind::FileWritten, imgFile.fileName(), fi.size()});
-            }
         }
 
         // Save combined layout, markers and animations (absolute paths — for spratconvert)
         QByteArray combinedInput = layoutData;
         if (!combinedInput.endsWith('\n')) combinedInput.append('\n');
-        combinedInput.append(markersContent.toUtf8());
+        combinedInput.append(exportText.markers);
         if (!combinedInput.endsWith('\n')) combinedInput.append('\n');
-        combinedInput.append(animContent.toUtf8());
+        combinedInput.append(exportText.animations);
 
-        if (config.transform == QStringLiteral("raw")) {
+        if (transforms.contains(QStringLiteral("raw"))) {
             struct RawFile { QString name; QByteArray data; };
             const RawFile rawFiles[] = {
                 { QStringLiteral("layout.txt"),     layoutData              },
-                { QStringLiteral("markers.txt"),    markersContent.toUtf8() },
-                { QStringLiteral("animations.txt"), animContent.toUtf8()    },
+                { QStringLiteral("markers.txt"),    exportText.markers    },
+                { QStringLiteral("animations.txt"), exportText.animations },
             };
             for (const auto& rf : rawFiles) {
-                QFile f(profileDir.filePath(rf.name));
-                if (!f.open(QIODevice::WriteOnly) || f.write(rf.data) < 0) {
-                    error = QString(trPS("Could not write %1 for profile '%2'."))
+                if (!writeOutput(rf.name, rf.data)) {
+                    chain.error = QString(trPS("Could not write %1 for profile '%2'."))
                                 .arg(rf.name, profileName);
                     return false;
                 }
-                f.close();
-                if (callbacks.logEntry) {
-                    const QFileInfo fi(f.fileName());
-                    callbacks.logEntry({ExportLogEntry::Kind::FileWritten, f.fileName(), fi.size()});
-                }
             }
         }
 
-        if (config.transform != "none" && config.transform != "raw" && !spratConvertBin.isEmpty()) {
+        if (transforms.contains(QStringLiteral("binary"))) {
+            const ExportStepTimer binaryTimer;
+            const QVector<LayoutModel> binaryModels = composeModels.isEmpty()
+                ? LayoutParser::parse(QString::fromUtf8(layoutData), layoutParserFolder, sourceFolder)
+                : composeModels;
+            const QByteArray binary = BinaryMetadataExport::build(binaryModels, exportText, sourceFolder);
+            logTiming(binaryTimer, QStringLiteral("binary metadata"), binary.size());
+            if (!writeOutput(BinaryMetadataExport::fileName(), binary)) {
+                chain.error = QString(trPS("Could not write %1 for profile '%2'."))
+                                  .arg(BinaryMetadataExport::fileName(), profileName);
+                return false;
+            }
+        }
+
+        if (!convertTransforms.isEmpty() && !spratConvertBin.isEmpty()) {
             updateStatus(QString(trPS("Formatting output for profile '%1'...")).arg(profileName));
             if (checkCanceled()) {
                 return false;
             }
-            QStringList convArgs;
-            convArgs << "--transform" << config.transform;
-            convArgs << "--output-dir" << profileDir.absolutePath();
-
-            if (isMultipack) {
-                convArgs << "--atlas" << (hasDds ? "atlas_%d.dds" : "atlas_%d.png");
+            // Every format converts the same layout and spritesheet, so the spratconvert
+            // runs are independent and run side by side. Each writes to its own scratch
+            // directory; its files go through writeOutput from there, in format order.
+            struct Conversion {
+                QString transform;
+                std::unique_ptr<QTemporaryDir> dir;
+                bool ok = false;
+                QString error;
+                ExportLogEntry timing;
+            };
+            std::vector<Conversion> conversions;
+            for (const QString& transform : convertTransforms) {
+                conversions.push_back(Conversion{transform, std::make_unique<QTemporaryDir>()});
+            }
+            auto convert = [&](Conversion& conversion) {
+                if (!conversion.dir->isValid()) {
+                    conversion.error = trPS("Could not create temporary directory.");
+                    return;
+                }
+                QStringList convArgs;
+                convArgs << "--transform" << conversion.transform;
+                convArgs << "--output-dir" << conversion.dir->path();
+                if (isMultipack) {
+                    convArgs << "--atlas" << (hasDds ? "atlas_%d.dds" : "atlas_%d.png");
+                } else {
+                    convArgs << "--atlas" << (hasDds ? "spritesheet.dds" : "spritesheet.png");
+                }
+                const ExportStepTimer convertTimer;
+                QString processError;
+                if (!runProcess(processError, spratConvertBin, convArgs, QString(trPS("Format conversion failed for profile '%1'")).arg(profileName), &combinedInput, nullptr)) {
+                    conversion.error = QString(trPS("Format conversion failed for profile '%1'")).arg(profileName);
+                    return;
+                }
+                // Several formats get one timing row each, named after the format.
+                const QString scope = convertTransforms.size() > 1
+                    ? QStringLiteral("%1 (%2)").arg(timingScope, conversion.transform)
+                    : timingScope;
+                conversion.timing = convertTimer.finish(QStringLiteral("spratconvert"), scope,
+                                                        combinedInput.size());
+                conversion.ok = true;
+            };
+#if defined(Q_OS_WASM) || defined(SPRAT_EMBEDDED_CLI)
+            for (Conversion& conversion : conversions) {
+                convert(conversion);
+            }
+#else
+            if (conversions.size() > 1) {
+                QtConcurrent::blockingMap(conversions, convert);
             } else {
-                convArgs << "--atlas" << (hasDds ? "spritesheet.dds" : "spritesheet.png");
+                convert(conversions.front());
             }
-            
-            if (!runProcess(spratConvertBin, convArgs, QString(trPS("Format conversion failed for profile '%1'")).arg(profileName), &combinedInput, nullptr)) {
-                error = QString(trPS("Format conversion failed for profile '%1'")).arg(profileName);
-                return false;
+#endif
+            QHash<QString, QString> writtenBy;  // output file -> format that wrote it
+            for (const Conversion& conversion : conversions) {
+                if (!conversion.ok) {
+                    chain.error = conversion.error;
+                    return false;
+                }
+                if (callbacks.logEntry) {
+                    chain.log.append(conversion.timing);
+                }
+                const QString convertDirPath = conversion.dir->path();
+                const QDir convertRoot(convertDirPath);
+                QDirIterator it(convertDirPath, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+                while (it.hasNext()) {
+                    const QString filePath = it.next();
+                    const QString fileName = convertRoot.relativeFilePath(filePath);
+                    const QString otherTransform = writtenBy.value(fileName);
+                    if (!otherTransform.isEmpty()) {
+                        chain.error = QString(trPS("Formats '%1' and '%2' both write %3 for profile '%4'."))
+                                          .arg(otherTransform, conversion.transform, fileName, profileName);
+                        return false;
+                    }
+                    writtenBy.insert(fileName, conversion.transform);
+                    QFile file(filePath);
+                    if (!file.open(QIODevice::ReadOnly) || !writeOutput(fileName, file.readAll())) {
+                        chain.error = QString(trPS("Format conversion failed for profile '%1'")).arg(profileName);
+                        return false;
+                    }
+                }
+                if (callbacks.logEntry)
+                    chain.log.append(ExportLogEntry{ExportLogEntry::Kind::Info,
+                        QString(trPS("Format '%1' written to %2")).arg(conversion.transform,
+                                                                        isZip ? profileDirPath : profileDir.absolutePath()), -1});
             }
-            if (callbacks.logEntry)
-                callbacks.logEntry({ExportLogEntry::Kind::Info,
-                    QString(trPS("Format '%1' written to %2")).arg(config.transform,
-                                                                    profileDir.absolutePath()), -1});
             if (checkCanceled()) {
                 return false;
             }
         }
+        for (const QString& stale : std::as_const(staleFiles)) {
+            const QString stalePath = profileDir.filePath(stale);
+            QFile::remove(stalePath);
+            // Drops folders the removal emptied; rmdir leaves non-empty ones alone.
+            for (QString dir = QFileInfo(stale).path(); dir != QLatin1String(".");
+                 dir = QFileInfo(dir).path()) {
+                if (!profileDir.rmdir(dir)) break;
+            }
+        }
+        if (callbacks.logEntry) {
+            chain.log.append(ExportStepTimer::entry(QStringLiteral("file write"), timingScope,
+                                                    writeWallMs, writeCpuMs, writeBytes));
+        }
+        if (!isZip) {
+            // Also written without an input hash: the next sweep needs the file list.
+            writeManifest(profileDirPath, inputHash, producedFiles);
+        }
+        return true;
+    };
+    auto runChain = [&](ProfileChain& chain) {
+        chain.ok = exportProfile(chain);
+        if (!chain.ok && !chain.aborted) {
+            chainFailed.store(true);
+        }
+    };
+
+#if defined(Q_OS_WASM) || defined(SPRAT_EMBEDDED_CLI)
+    // Embedded tools share process-global state and WASM has no worker threads.
+    Q_UNUSED(maxParallelProfiles);
+    for (ProfileChain& chain : chains) {
+        runChain(chain);
+    }
+#else
+    if (maxParallelProfiles <= 1 || chains.size() <= 1) {
+        for (ProfileChain& chain : chains) {
+            runChain(chain);
+        }
+    } else {
+        QThreadPool pool;
+        pool.setMaxThreadCount(qMin(maxParallelProfiles, int(chains.size())));
+        QtConcurrent::blockingMap(&pool, chains, runChain);
+    }
+#endif
+
+    for (const ProfileChain& chain : chains) {
+        if (callbacks.logEntry) {
+            for (const ExportLogEntry& entry : chain.log) {
+                callbacks.logEntry(entry);
+            }
+        }
+    }
+    if (callbacks.logEntry && composedProfiles.load() > 0) {
+        callbacks.logEntry(ExportLogEntry{ExportLogEntry::Kind::Info,
+            trPS("Decoded %1 source image(s) once for %2 profile(s)")
+                .arg(sourceImages.decodeCount()).arg(composedProfiles.load()), -1});
+    }
+    for (const ProfileChain& chain : chains) {
+        if (!chain.ok && !chain.aborted) {
+            error = chain.error;
+            return false;
+        }
     }
 
     if (isZip) {
@@ -621,11 +1061,17 @@ bool ProjectSaveService::save(
         QDir().mkpath(QFileInfo(absDest).path());
         QFile::remove(absDest);
 
-        if (!ArchiveExtractor::createZip(workingPath, absDest, error)) {
+        QVector<ArchiveExtractor::ZipEntry> entries;
+        for (ProfileChain& chain : chains) {
+            entries += std::move(chain.zipEntries);
+        }
+        const ExportStepTimer zipTimer;
+        if (!ArchiveExtractor::createZip(entries, absDest, error)) {
             return false;
         }
         if (callbacks.logEntry) {
             QFileInfo fi(absDest);
+            callbacks.logEntry(zipTimer.finish(QStringLiteral("zip"), QString(), fi.size()));
             callbacks.logEntry({ExportLogEntry::Kind::FileWritten, absDest, fi.size()});
         }
     }
@@ -3,9 +3,13 @@
 #include <functional>
 #include <QJsonObject>
 #include <QStringList>
+#include "ExportMetadataText.h"
 #include "ExportModels.h"
+#include "ProjectModels.h"
 #include "SpratProfilesConfig.h"
 
+struct ProjectPayloadBuildInput;
+
 class ProjectSaveService {
 public:
     struct SaveCallbacks {
@@ -30,15 +34,54 @@ public:
         QString& savedDestination,
         QString& error,
         const QString& deduplicateMode = "none",
-        SaveCallbacks callbacks = {}
+        SaveCallbacks callbacks = {},
+        // Profiles export as independent chains; up to this many run at once.
+        int maxParallelProfiles = 1
+    );
+
+    // Same as above with the markers and animations text already built, e.g. from
+    // session data. The overload above derives it from projectPayload.
+    static bool save(
+        SaveConfig config,
+        const QString& layoutInputPath,
+        const QStringList& framePaths,
+        const QString& sourceFolder,
+        const QVector<SpratProfile>& availableProfiles,
+        const QString& selectedProfileName,
+        const QString& spratLayoutBin,
+        const QString& spratPackBin,
+        const QString& spratConvertBin,
+        const QJsonObject& projectPayload,
+        const ExportMetadataText& metadata,
+        QString& savedDestination,
+        QString& error,
+        const QString& deduplicateMode = "none",
+        SaveCallbacks callbacks = {},
+        int maxParallelProfiles = 1
     );
 
+    // Settings for one atlas of a multi-atlas export: the atlas overrides applied to
+    // config, nested in its own folder inside each profile folder. rootExporterCount is
+    // the number of exported atlases without an explicit output folder; when several
+    // would share the profile folder, each gets one derived from its name.
+    static SaveConfig atlasConfig(const SaveConfig& config, const AtlasEntry& atlas,
+                                  int rootExporterCount);
+
     static bool writeProjectJson(
         const QString& projectFolder,
         const QJsonObject& payload,
         QString& error
     );
 
+    // Writes the project file from the build input: indented JSON as project.spart.json,
+    // or CBOR as project.spart.cbor when binary is set. The other file, if any, is removed.
+    static bool writeProjectFile(
+        const QString& projectFolder,
+        const ProjectPayloadBuildInput& input,
+        bool binary,
+        QString& error
+    );
+
     static bool create(
         const QString& name,
         const QString& parentDir,
@@ -16,6 +16,12 @@ ProjectSession::ProjectSession(QObject* parent) : QObject(parent) {
     excl.name = tr("Excluded");
     excl.isExcluded = true;
     atlases.append(excl);
+
+    connect(this, &ProjectSession::changed, this, &ProjectSession::touch);
+    connect(this, &ProjectSession::layoutChanged, this, &ProjectSession::touch);
+    connect(this, &ProjectSession::timelinesChanged, this, &ProjectSession::touch);
+    connect(this, &ProjectSession::selectionChanged, this, &ProjectSession::touch);
+    connect(this, &ProjectSession::atlasesChanged, this, &ProjectSession::touch);
 }
 
 void ProjectSession::clear() {
@@ -52,6 +58,7 @@ void ProjectSession::clear() {
     selectedPointName.clear();
 
     pendingProjectPayload = QJsonObject();
+    payloadCache.clear();
     spriteIndex.clear();
 
     emit atlasesChanged();
@@ -110,6 +117,8 @@ int ProjectSession::neutralAtlasIndex() const {
 
 void ProjectSession::rebuildSpriteIndex() {
     spriteIndex.clear();
+    // Sprites may have been replaced by new objects with different states.
+    payloadCache.markAllSpritesDirty();
     // Collect all SpritePtr from layoutModels (have full rect data)
     for (const auto& atlas : atlases) {
         for (const auto& model : atlas.layoutModels) {
@@ -8,6 +8,7 @@
 #include <QJsonObject>
 #include <QUuid>
 #include "models.h"
+#include "ProjectPayloadCache.h"
 
 /**
  * @class ProjectSession
@@ -91,11 +92,18 @@ public:
 
     // --- Transient State ---
     QJsonObject pendingProjectPayload;
+    // Encoded sprite/timeline fragments from the last save; mark edited items dirty here.
+    ProjectPayloadCache payloadCache;
 
     void clear();
     bool isEmpty() const;
     void rebuildSpriteIndex();
 
+    // Edit counter, bumped by touch() and by every session signal. Autosave compares it
+    // with the generation of the last snapshot to skip writes when nothing changed.
+    quint64 generation() const { return m_generation; }
+    void touch() { ++m_generation; }
+
 signals:
     void changed();
     void layoutChanged();
@@ -103,4 +111,6 @@ signals:
     void selectionChanged();
     void atlasesChanged();
 
+private:
+    quint64 m_generation = 0;
 };
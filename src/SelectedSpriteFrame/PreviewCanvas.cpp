@@ -13,6 +13,7 @@
 #include <QApplication>
 #include <QPainter>
 #include <QtConcurrent>
+#include "SpriteMesh.h"
 #include "ViewUtils.h"
 
 namespace {
@@ -206,6 +207,41 @@ void PreviewCanvas::updateGridItem() {
     m_gridItem = grid;
 }
 
+void PreviewCanvas::updateMeshItem() {
+    if (m_meshItem) {
+        m_scene->removeItem(m_meshItem);
+        delete m_meshItem;
+        m_meshItem = nullptr;
+    }
+    if (!m_settings.showMesh || m_imageItems.isEmpty()) return;
+
+    const int budget = m_meshVertexBudget > 0 ? m_meshVertexBudget : SpriteMesh::kDefaultVertices;
+    const QPolygon mesh = SpriteMesh::trace(m_imageItems.first()->pixmap().toImage(), budget);
+    if (mesh.isEmpty()) return;
+
+    // Outline plus the fan triangulation a runtime would draw from the first vertex.
+    QPainterPath path;
+    path.addPolygon(QPolygonF(mesh));
+    path.closeSubpath();
+    for (int i = 2; i < mesh.size() - 1; ++i) {
+        path.moveTo(mesh.first());
+        path.lineTo(mesh.at(i));
+    }
+    QPen pen(QColor(0, 200, 255), 1);
+    pen.setCosmetic(true);
+    m_meshItem = new QGraphicsPathItem(path);
+    m_meshItem->setPen(pen);
+    m_meshItem->setBrush(QColor(0, 200, 255, 40));
+    m_meshItem->setZValue(0.45);  // above the trim rect, below the overlay
+    m_scene->addItem(m_meshItem);
+}
+
+void PreviewCanvas::setMeshVertexBudget(int budget) {
+    if (m_meshVertexBudget == budget) return;
+    m_meshVertexBudget = budget;
+    updateMeshItem();
+}
+
 void PreviewCanvas::setSprites(const QList<SpritePtr>& sprites) {
     // Cancel any in-flight trim-rect computation for the old sprite so it doesn't
     // waste CPU on a result we no longer need.  waitForFinished() is intentionally
@@ -279,6 +315,7 @@ void PreviewCanvas::setSprites(const QList<SpritePtr>& sprites) {
 
     updateTrimRectItem();
     updateGridItem();
+    updateMeshItem();
 }
 
 void PreviewCanvas::setZoom(double zoom) {
@@ -407,4 +444,5 @@ void PreviewCanvas::setSettings(const AppSettings& settings) {
 
     updateTrimRectItem();
     updateGridItem();
+    updateMeshItem();
 }
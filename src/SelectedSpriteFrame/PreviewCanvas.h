@@ -61,6 +61,12 @@ public:
      */
     void setGhostSprites(const QList<SpritePtr>& ghosts, QPoint activePivot = QPoint());
 
+    /**
+     * @brief Sets the vertex budget of the mesh overlay, normally the export's mesh
+     * budget. 0 falls back to SpriteMesh::kDefaultVertices.
+     */
+    void setMeshVertexBudget(int budget);
+
     EditorOverlayItem* overlay() const { return m_overlay; }
 
     /**
@@ -96,6 +102,7 @@ private:
     static QRect computeTrimRect(const QImage& img);
     void updateTrimRectItem();
     void updateGridItem();
+    void updateMeshItem();
 
     QGraphicsScene* m_scene;
     QList<QGraphicsPixmapItem*> m_imageItems;
@@ -104,6 +111,8 @@ private:
     QGraphicsRectItem* m_trimRectItem = nullptr;
     QGraphicsPathItem* m_trimDimItem = nullptr;
     QGraphicsItem*     m_gridItem = nullptr;
+    QGraphicsPathItem* m_meshItem = nullptr;
+    int m_meshVertexBudget = 0;
     EditorOverlayItem* m_overlay;
     QList<SpritePtr> m_sprites;
     AppSettings m_settings;
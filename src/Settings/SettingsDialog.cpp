@@ -338,6 +338,17 @@ void SettingsDialog::setupUi() {
     m_exportDefaultScaleFilterCombo->setToolTip(tr("Default scale filter for new exports"));
     exportationForm->addRow(tr("Default scale filter:"), m_exportDefaultScaleFilterCombo);
 
+    m_saveProjectAsCborCheck = new QCheckBox(tr("Save project files as binary (CBOR)"), this);
+    m_saveProjectAsCborCheck->setChecked(m_settings.saveProjectAsCbor);
+    m_saveProjectAsCborCheck->setToolTip(tr("Save the project as project.spart.cbor, a compact binary encoding that saves and loads faster on large projects. "
+                                          "The project.spart.json file is removed, so tools that read it will no longer find the project"));
+    exportationForm->addRow("", m_saveProjectAsCborCheck);
+
+    m_packInProcessCheck = new QCheckBox(tr("Pack PNG spritesheets in-process"), this);
+    m_packInProcessCheck->setChecked(m_settings.packInProcess);
+    m_packInProcessCheck->setToolTip(tr("Decode each source image once and compose every PNG profile from it instead of running spratpack per profile"));
+    exportationForm->addRow("", m_packInProcessCheck);
+
     contentLayout->addWidget(m_exportationGroup);
     m_exportationGroup->setVisible(m_initialSection == Section::Exportation);
 
@@ -486,6 +497,8 @@ void SettingsDialog::resetToDefaults() {
         int idx = m_exportDefaultScaleFilterCombo->findData(AppSettings().exportDefaultScaleFilter);
         if (idx >= 0) m_exportDefaultScaleFilterCombo->setCurrentIndex(idx);
     }
+    if (m_saveProjectAsCborCheck) m_saveProjectAsCborCheck->setChecked(AppSettings().saveProjectAsCbor);
+    if (m_packInProcessCheck) m_packInProcessCheck->setChecked(AppSettings().packInProcess);
 
     int deduplicateIndex = m_deduplicateModeCombo->findData(m_settings.deduplicateMode);
     if (deduplicateIndex >= 0) {
@@ -532,6 +545,8 @@ AppSettings SettingsDialog::getSettings() const {
     if (m_exportDefaultFolderEdit) s.exportDefaultOutputFolder = m_exportDefaultFolderEdit->text().trimmed();
     if (m_exportDefaultFormatCombo) s.exportDefaultFormat = m_exportDefaultFormatCombo->currentData().toString();
     if (m_exportDefaultScaleFilterCombo) s.exportDefaultScaleFilter = m_exportDefaultScaleFilterCombo->currentData().toString();
+    if (m_saveProjectAsCborCheck) s.saveProjectAsCbor = m_saveProjectAsCborCheck->isChecked();
+    if (m_packInProcessCheck) s.packInProcess = m_packInProcessCheck->isChecked();
     if (m_trimRectStyleCombo) s.trimRectStyle = (Qt::PenStyle)m_trimRectStyleCombo->currentData().toInt();
     if (m_gridCellWidthSpin)  s.gridCellWidth  = m_gridCellWidthSpin->value();
     if (m_gridCellHeightSpin) s.gridCellHeight = m_gridCellHeightSpin->value();
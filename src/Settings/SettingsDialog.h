@@ -108,4 +108,6 @@ private:
     QLineEdit* m_exportDefaultFolderEdit = nullptr;
     QComboBox* m_exportDefaultFormatCombo = nullptr;
     QComboBox* m_exportDefaultScaleFilterCombo = nullptr;
+    QCheckBox* m_saveProjectAsCborCheck = nullptr;
+    QCheckBox* m_packInProcessCheck = nullptr;
 };
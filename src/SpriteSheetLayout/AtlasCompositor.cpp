@@ -0,0 +1,184 @@
+#include "AtlasCompositor.h"
+#include "SourceImageStore.h"
+
+#include <QCoreApplication>
+#include <QPainter>
+#include <QTransform>
+#include <QtConcurrent>
+
+#include <cstring>
+
+namespace {
+QString trCompositor(const char* text) {
+    return QCoreApplication::translate("AtlasCompositor", text);
+}
+
+// The sprite as it appears in the atlas: trimmed, rotated and scaled to its rect.
+QImage placedImage(const Sprite& sprite, const QImage& source, Qt::TransformationMode scaleMode) {
+    QImage image = source;
+    if (sprite.trimmed) {
+        // trimRect holds the amounts trimmed from the left, top, right and bottom.
+        const int l = sprite.trimRect.x();
+        const int t = sprite.trimRect.y();
+        const int r = sprite.trimRect.width();
+        const int b = sprite.trimRect.height();
+        if (image.width() > l + r && image.height() > t + b) {
+            image = image.copy(l, t, image.width() - l - r, image.height() - t - b);
+        }
+    }
+    if (sprite.rotated) {
+        static const QTransform kRotation90 = []() {
+            QTransform t;
+            t.rotate(90);
+            return t;
+        }();
+        image = image.transformed(kRotation90);
+    }
+    const QSize targetSize = sprite.rect.size();
+    if (!targetSize.isEmpty() && image.size() != targetSize) {
+        image = image.scaled(targetSize, Qt::IgnoreAspectRatio, scaleMode);
+    }
+    return image;
+}
+
+QImage transparentAtlas(const LayoutModel& model, QString& error) {
+    if (model.atlasWidth <= 0 || model.atlasHeight <= 0) {
+        error = trCompositor("Layout has no atlas size.");
+        return QImage();
+    }
+    QImage atlas(model.atlasWidth, model.atlasHeight, QImage::Format_ARGB32_Premultiplied);
+    if (atlas.isNull()) {
+        error = trCompositor("Could not allocate a %1x%2 atlas.")
+                    .arg(model.atlasWidth).arg(model.atlasHeight);
+        return QImage();
+    }
+    atlas.fill(Qt::transparent);
+    return atlas;
+}
+
+template <typename Container, typename Function>
+void forEachParallel(Container& items, Function function) {
+#ifdef Q_OS_WASM
+    for (auto& item : items) {
+        function(item);
+    }
+#else
+    QtConcurrent::blockingMap(items, function);
+#endif
+}
+}  // namespace
+
+bool AtlasCompositor::supports(const SpratProfile& profile) {
+    return profile.gpuCompress.isEmpty() && profile.extrude <= 0 && profile.dilate <= 0
+        && !profile.multipack;
+}
+
+Qt::TransformationMode AtlasCompositor::scaleMode(const QString& scaleFilter) {
+    return (scaleFilter.isEmpty() || scaleFilter == QLatin1String("nearest"))
+        ? Qt::FastTransformation
+        : Qt::SmoothTransformation;
+}
+
+QImage AtlasCompositor::compose(const LayoutModel& model, SourceImageStore& store,
+                                Qt::TransformationMode scaleMode, QString& error) {
+    QImage atlas = transparentAtlas(model, error);
+    if (atlas.isNull()) {
+        return QImage();
+    }
+    QPainter painter(&atlas);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    for (const SpritePtr& sprite : model.sprites) {
+        if (!sprite || sprite->rect.isEmpty()) {
+            continue;
+        }
+        const QImage source = store.image(sprite->path);
+        if (source.isNull()) {
+            error = trCompositor("Could not read sprite '%1'.").arg(sprite->path);
+            return QImage();
+        }
+        painter.drawImage(sprite->rect.topLeft(), placedImage(*sprite, source, scaleMode));
+    }
+    painter.end();
+    return atlas;
+}
+
+QImage AtlasCompositor::composeTiled(const LayoutModel& model, SourceImageStore& store,
+                                     Qt::TransformationMode scaleMode, int tileSize,
+                                     QString& error, const std::atomic<bool>* canceled) {
+    auto isCanceled = [canceled]() { return canceled && canceled->load(); };
+    QImage atlas = transparentAtlas(model, error);
+    if (atlas.isNull()) {
+        return QImage();
+    }
+
+    struct Placement {
+        const Sprite* sprite = nullptr;
+        QImage image;
+        bool failed = false;
+    };
+    QVector<Placement> placements;
+    placements.reserve(model.sprites.size());
+    for (const SpritePtr& sprite : model.sprites) {
+        if (sprite && !sprite->rect.isEmpty()) {
+            placements.append(Placement{sprite.get()});
+        }
+    }
+    forEachParallel(placements, [&](Placement& placement) {
+        if (isCanceled()) {
+            return;
+        }
+        const QImage source = store.image(placement.sprite->path);
+        placement.failed = source.isNull();
+        if (!placement.failed) {
+            placement.image = placedImage(*placement.sprite, source, scaleMode);
+        }
+    });
+    if (isCanceled()) {
+        return QImage();
+    }
+    for (const Placement& placement : std::as_const(placements)) {
+        if (placement.failed) {
+            error = trCompositor("Could not read sprite '%1'.").arg(placement.sprite->path);
+            return QImage();
+        }
+    }
+
+    // Tiles never overlap, so each one is drawn on its own image and copied into its
+    // own rows of the atlas without locking. Sprites keep layout order within a tile.
+    tileSize = qMax(16, tileSize);
+    QVector<QRect> tiles;
+    for (int y = 0; y < atlas.height(); y += tileSize) {
+        for (int x = 0; x < atlas.width(); x += tileSize) {
+            tiles.append(QRect(x, y, qMin(tileSize, atlas.width() - x),
+                               qMin(tileSize, atlas.height() - y)));
+        }
+    }
+    uchar* const atlasBits = atlas.bits();
+    const qsizetype atlasStride = atlas.bytesPerLine();
+    constexpr int kBytesPerPixel = 4;
+    forEachParallel(tiles, [&](const QRect& tile) {
+        if (isCanceled()) {
+            return;
+        }
+        QImage tileImage(tile.size(), QImage::Format_ARGB32_Premultiplied);
+        tileImage.fill(Qt::transparent);
+        {
+            QPainter painter(&tileImage);
+            painter.setCompositionMode(QPainter::CompositionMode_Source);
+            painter.translate(-tile.topLeft());
+            for (const Placement& placement : placements) {
+                if (placement.sprite->rect.intersects(tile)) {
+                    painter.drawImage(placement.sprite->rect.topLeft(), placement.image);
+                }
+            }
+        }
+        for (int row = 0; row < tile.height(); ++row) {
+            std::memcpy(atlasBits + (tile.y() + row) * atlasStride + tile.x() * kBytesPerPixel,
+                        tileImage.constScanLine(row), size_t(tile.width()) * kBytesPerPixel);
+        }
+    });
+    if (isCanceled()) {
+        return QImage();
+    }
+    return atlas;
+}
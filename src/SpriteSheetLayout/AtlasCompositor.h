@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QImage>
+#include <QString>
+#include "LayoutModels.h"
+#include "SpratProfilesConfig.h"
+
+#include <atomic>
+
+class SourceImageStore;
+
+/**
+ * @class AtlasCompositor
+ * @brief Draws a parsed layout into a spritesheet image in-process, as spratpack would.
+ *
+ * Sprites come from a SourceImageStore, so several profiles composed from one store
+ * decode each source file once. Each sprite is cropped by its trim, rotated a quarter
+ * turn clockwise when marked rotated, and scaled to its atlas rect.
+ */
+class AtlasCompositor {
+public:
+    /**
+     * @brief True when the profile's output needs nothing beyond placing sprites:
+     * no GPU compression, extrusion, dilation or multipack archive.
+     */
+    static bool supports(const SpratProfile& profile);
+
+    /**
+     * @brief Scaling used for an export scale filter: nearest maps to FastTransformation,
+     * every smoothing filter to SmoothTransformation.
+     */
+    static Qt::TransformationMode scaleMode(const QString& scaleFilter);
+
+    /**
+     * @brief Composes a single-atlas layout onto a transparent image.
+     * @return QImage Null on failure, with error set.
+     */
+    static QImage compose(const LayoutModel& model, SourceImageStore& store,
+                          Qt::TransformationMode scaleMode, QString& error);
+
+    /**
+     * @brief Same result as compose(), built on worker threads: sprites are placed in
+     * parallel, then the atlas is drawn in tileSize squares that each own their pixels.
+     * @return QImage Null on failure with error set, or null with no error when canceled.
+     */
+    static QImage composeTiled(const LayoutModel& model, SourceImageStore& store,
+                               Qt::TransformationMode scaleMode, int tileSize, QString& error,
+                               const std::atomic<bool>* canceled = nullptr);
+};
@@ -0,0 +1,236 @@
+#include "AtlasPartitioner.h"
+
+#include <QHash>
+#include <QSet>
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+struct Page {
+    qint64 used = 0;
+    QVector<int> members;
+};
+
+int distinctPages(const QVector<int>& frames, const QVector<int>& pageOf) {
+    QSet<int> pages;
+    for (int sprite : frames) {
+        if (pageOf[sprite] >= 0) pages.insert(pageOf[sprite]);
+    }
+    return int(pages.size());
+}
+}  // namespace
+
+AtlasPartitioner::Result AtlasPartitioner::partition(const QVector<Sprite>& sprites,
+                                                     const QVector<AnimationTimeline>& timelines,
+                                                     const QSize& pageSize,
+                                                     int padding,
+                                                     double fillFactor) {
+    Result result;
+    if (sprites.isEmpty()) return result;
+
+    const qint64 capacity = qMax<qint64>(
+        1, qint64(double(pageSize.width()) * double(pageSize.height()) * fillFactor));
+    const int n = int(sprites.size());
+    QHash<QString, int> indexOf;
+    QVector<qint64> cost(n);
+    for (int i = 0; i < n; ++i) {
+        if (!indexOf.contains(sprites[i].path)) indexOf.insert(sprites[i].path, i);
+        cost[i] = qint64(qMax(0, sprites[i].size.width() + padding))
+                * qint64(qMax(0, sprites[i].size.height() + padding));
+    }
+
+    // Distinct known frames of each timeline. Aliases reuse another timeline's frames.
+    QVector<QVector<int>> frames(timelines.size());
+    QVector<qint64> timelineArea(timelines.size(), 0);
+    for (int t = 0; t < timelines.size(); ++t) {
+        if (!timelines[t].aliasOf.isEmpty()) continue;
+        QSet<int> seen;
+        for (const QString& frame : timelines[t].frames) {
+            const int sprite = indexOf.value(frame, -1);
+            if (sprite < 0 || seen.contains(sprite)) continue;
+            seen.insert(sprite);
+            frames[t].append(sprite);
+            timelineArea[t] += cost[sprite];
+        }
+    }
+    QVector<int> order(timelines.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&timelineArea](int a, int b) {
+        return timelineArea[a] > timelineArea[b];
+    });
+
+    QVector<int> pageOf(n, -1);
+    QVector<Page> pages;
+    auto place = [&](int sprite, int page) {
+        pageOf[sprite] = page;
+        pages[page].used += cost[sprite];
+        pages[page].members.append(sprite);
+    };
+    auto newPage = [&pages]() {
+        pages.append(Page());
+        return int(pages.size()) - 1;
+    };
+
+    for (int t : std::as_const(order)) {
+        QVector<int> pending;
+        qint64 need = 0;
+        QHash<int, int> held;
+        for (int sprite : std::as_const(frames[t])) {
+            if (pageOf[sprite] >= 0) {
+                ++held[pageOf[sprite]];
+            } else {
+                pending.append(sprite);
+                need += cost[sprite];
+            }
+        }
+        if (pending.isEmpty()) continue;
+
+        // Join the frames placed by an earlier timeline, else the tightest page that
+        // fits the whole timeline, else a page of its own.
+        int target = -1;
+        int targetHeld = 0;
+        for (auto it = held.cbegin(); it != held.cend(); ++it) {
+            if (pages[it.key()].used + need > capacity) continue;
+            if (it.value() > targetHeld || (it.value() == targetHeld && it.key() < target)) {
+                target = it.key();
+                targetHeld = it.value();
+            }
+        }
+        if (target < 0) {
+            qint64 tightest = capacity + 1;
+            for (int p = 0; p < pages.size(); ++p) {
+                const qint64 left = capacity - pages[p].used;
+                if (left >= need && left < tightest) {
+                    target = p;
+                    tightest = left;
+                }
+            }
+        }
+        if (target < 0 && need <= capacity) target = newPage();
+        if (target >= 0) {
+            for (int sprite : std::as_const(pending)) place(sprite, target);
+            continue;
+        }
+        // Larger than a page: fill whole pages in frame order so consecutive frames
+        // stay together and the timeline touches as few pages as possible.
+        int current = newPage();
+        for (int sprite : std::as_const(pending)) {
+            if (!pages[current].members.isEmpty() && pages[current].used + cost[sprite] > capacity) {
+                current = newPage();
+            }
+            place(sprite, current);
+        }
+    }
+
+    // Sprites outside every timeline fill the remaining space, largest first.
+    QVector<int> loose;
+    for (int i = 0; i < n; ++i) {
+        if (pageOf[i] < 0) loose.append(i);
+    }
+    std::stable_sort(loose.begin(), loose.end(), [&cost](int a, int b) { return cost[a] > cost[b]; });
+    for (int sprite : std::as_const(loose)) {
+        int target = -1;
+        for (int p = 0; p < pages.size() && target < 0; ++p) {
+            if (pages[p].used + cost[sprite] <= capacity) target = p;
+        }
+        place(sprite, target >= 0 ? target : newPage());
+    }
+
+    result.pages.reserve(pages.size());
+    for (Page& page : pages) {
+        std::sort(page.members.begin(), page.members.end());
+        QStringList paths;
+        paths.reserve(page.members.size());
+        for (int sprite : std::as_const(page.members)) paths.append(sprites[sprite].path);
+        result.pages.append(paths);
+    }
+
+    QVector<int> currentPage(n);
+    for (int i = 0; i < n; ++i) currentPage[i] = sprites[i].currentPage;
+    for (int t = 0; t < timelines.size(); ++t) {
+        if (frames[t].isEmpty()) continue;
+        TimelinePages report;
+        report.name = timelines[t].name;
+        report.pagesBefore = distinctPages(frames[t], currentPage);
+        report.pagesAfter = distinctPages(frames[t], pageOf);
+        result.timelines.append(report);
+    }
+    return result;
+}
+
+AtlasPartitioner::Assignment AtlasPartitioner::assignTimelines(const Result& result,
+                                                              const QVector<AnimationTimeline>& timelines) {
+    QHash<QString, int> pageOf;
+    for (int page = 0; page < result.pages.size(); ++page) {
+        for (const QString& path : result.pages[page]) pageOf.insert(path, page);
+    }
+
+    // Pulling a spanning timeline's frames to page 0 can split another timeline that
+    // shares one of them, so repeat until every timeline sits on one page. Frames only
+    // ever move to page 0, which bounds the loop.
+    Assignment assignment;
+    QSet<QString> spanning;
+    bool pulled = true;
+    while (pulled) {
+        pulled = false;
+        for (const AnimationTimeline& timeline : timelines) {
+            if (!timeline.aliasOf.isEmpty()) continue;
+            int page = -1;
+            bool spans = false;
+            for (const QString& frame : timeline.frames) {
+                const auto it = pageOf.constFind(frame);
+                if (it == pageOf.cend()) continue;
+                if (page < 0) page = *it;
+                spans = spans || *it != page;
+            }
+            if (!spans) continue;
+            if (!spanning.contains(timeline.name)) {
+                spanning.insert(timeline.name);
+                assignment.spanningTimelines.append(timeline.name);
+            }
+            for (const QString& frame : timeline.frames) {
+                const auto it = pageOf.find(frame);
+                if (it != pageOf.end() && *it != 0) {
+                    *it = 0;
+                    pulled = true;
+                }
+            }
+        }
+    }
+
+    // Renumber the pages that still hold sprites, keeping page 0 and the input order;
+    // page 0 lists its own sprites first, then those taken back from other pages.
+    QVector<int> renumbered(qMax<qsizetype>(1, result.pages.size()), -1);
+    renumbered[0] = 0;
+    assignment.pages.append(QStringList());
+    for (int page = 0; page < result.pages.size(); ++page) {
+        for (const QString& path : result.pages[page]) {
+            const int target = pageOf.value(path);
+            if (renumbered[target] < 0) {
+                renumbered[target] = int(assignment.pages.size());
+                assignment.pages.append(QStringList());
+            }
+            assignment.pages[renumbered[target]].append(path);
+        }
+    }
+    QHash<QString, int> ownerPage;
+    for (const AnimationTimeline& timeline : timelines) {
+        if (!timeline.aliasOf.isEmpty()) continue;
+        int page = 0;
+        for (const QString& frame : timeline.frames) {
+            const auto it = pageOf.constFind(frame);
+            if (it != pageOf.cend()) {
+                page = renumbered[*it];
+                break;
+            }
+        }
+        ownerPage.insert(timeline.name, page);
+    }
+    assignment.timelinePages.reserve(timelines.size());
+    for (const AnimationTimeline& timeline : timelines) {
+        assignment.timelinePages.append(
+            ownerPage.value(timeline.aliasOf.isEmpty() ? timeline.name : timeline.aliasOf, 0));
+    }
+    return assignment;
+}
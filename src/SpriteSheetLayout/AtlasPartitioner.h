@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "AnimationModels.h"
+
+/**
+ * @class AtlasPartitioner
+ * @brief Splits an atlas's sprites into pages so each timeline's frames share a page.
+ *
+ * The packer fills pages in its own order, so a walk cycle can end up spread over
+ * several textures and force a texture switch between frames. This groups sprites
+ * by timeline instead: timelines are placed largest first onto the page that already
+ * holds most of their frames, the best-fitting page, or a new page, and only a
+ * timeline larger than a page is split. Sprites no timeline uses fill the gaps.
+ * Pages are estimated by area, so real packing needs a little headroom.
+ */
+class AtlasPartitioner {
+public:
+    // Share of a page's area the estimate fills, leaving room for packing waste.
+    static constexpr double kDefaultFillFactor = 0.8;
+
+    struct Sprite {
+        QString path;
+        QSize size;            // packed size, before padding
+        int currentPage = -1;  // page the sprite is on now; -1 when not laid out
+    };
+
+    struct TimelinePages {
+        QString name;
+        int pagesBefore = 0;   // distinct current pages among the timeline's frames
+        int pagesAfter = 0;    // distinct pages after partitioning
+    };
+
+    struct Result {
+        QVector<QStringList> pages;           // sprite paths per page, in input order
+        QVector<TimelinePages> timelines;     // in input order; aliases are skipped
+    };
+
+    struct Assignment {
+        QVector<QStringList> pages;           // page 0 stays in the atlas; empty pages are dropped
+        QVector<int> timelinePages;           // page per input timeline; aliases follow their target
+        QStringList spanningTimelines;        // timelines kept on page 0 because they span pages
+    };
+
+    /**
+     * @brief Groups @p sprites into pages of @p pageSize.
+     *
+     * Timeline frames are matched against sprite paths; frames that are not one of
+     * @p sprites are ignored. A sprite used by several timelines goes with the
+     * largest of them.
+     */
+    static Result partition(const QVector<Sprite>& sprites,
+                            const QVector<AnimationTimeline>& timelines,
+                            const QSize& pageSize,
+                            int padding = 0,
+                            double fillFactor = kDefaultFillFactor);
+
+    /**
+     * @brief Decides which page each timeline moves to when pages become atlases.
+     *
+     * A timeline whose frames share one page moves with that page. A timeline spread
+     * over several pages stays on page 0 and takes its frames back there, so no
+     * timeline refers to sprites in two atlases; page 0 may then need more than one
+     * texture. Frames that are not on any page are ignored.
+     */
+    static Assignment assignTimelines(const Result& result, const QVector<AnimationTimeline>& timelines);
+};
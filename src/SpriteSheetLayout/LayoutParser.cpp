@@ -4,6 +4,7 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QImageReader>
+#include <QMutex>
 #include <QRegularExpression>
 #include <QHash>
 
@@ -13,9 +14,14 @@ QVector<LayoutModel> LayoutParser::parse(const QString& output, const QString& f
     double commonScale = 1.0;
     QString rootPath;
     QDir dir(folderPath);
+    // Shared by every caller; export profile chains parse layouts on worker threads.
     static QHash<QString, QSize> sourceSizeCache;
-    if (sourceSizeCache.size() > 16384) {
-        sourceSizeCache.clear();
+    static QMutex sourceSizeCacheMutex;
+    {
+        QMutexLocker locker(&sourceSizeCacheMutex);
+        if (sourceSizeCache.size() > 16384) {
+            sourceSizeCache.clear();
+        }
     }
     QRegularExpression spriteRe(R"raw(sprite\s+"((?:[^"\\]|\\.)*)"\s+(\d+),(\d+)\s+(\d+),(\d+)(?:\s+(\d+),(\d+)\s+(\d+),(\d+))?(?:\s+(rotated))?)raw");
     QRegularExpression rootRe(R"raw(root\s+"((?:[^"\\]|\\.)*)")raw");
@@ -105,10 +111,15 @@ QVector<LayoutModel> LayoutParser::parse(const QString& output, const QString& f
                 }
             }
 #else
-            QSize sourceSize = sourceSizeCache.value(s->path);
+            QSize sourceSize;
+            {
+                QMutexLocker locker(&sourceSizeCacheMutex);
+                sourceSize = sourceSizeCache.value(s->path);
+            }
             if (!sourceSize.isValid()) {
                 sourceSize = QImageReader(s->path).size();
                 if (sourceSize.isValid()) {
+                    QMutexLocker locker(&sourceSizeCacheMutex);
                     sourceSizeCache.insert(s->path, sourceSize);
                 }
             }
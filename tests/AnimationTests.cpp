@@ -49,7 +49,8 @@ void AnimationTests::testAnimationPreviewUsesTimelineBounds() {
     QString statusText;
     bool hasFrames = false;
 
-    QPixmap pixmap = AnimationPreviewService::refresh(
+    AnimationPreviewService preview;
+    QPixmap pixmap = preview.refresh(
         timelines,
         0,
         frameIndex,
@@ -64,6 +65,70 @@ void AnimationTests::testAnimationPreviewUsesTimelineBounds() {
     QVERIFY(pixmap.height() >= 120);
 }
 
+void AnimationTests::testAnimationPreviewPrecomposesFramesPerInstance() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QVector<AnimationTimeline> timelines(2);
+    timelines[0].name = "Walk";
+    const QList<QColor> colors = {Qt::red, Qt::green, Qt::blue, Qt::yellow};
+    for (int i = 0; i < colors.size(); ++i) {
+        const QString path = QDir(tempDir.path()).filePath(QString("walk_%1.png").arg(i));
+        QImage image(10, 10, QImage::Format_ARGB32);
+        image.fill(colors[i]);
+        QVERIFY(image.save(path));
+        timelines[0].frames.append(path);
+    }
+    timelines[1].name = "Banner";
+    const QString bannerPath = QDir(tempDir.path()).filePath("banner.png");
+    QVERIFY(saveSolidImage(bannerPath, 40, 20));
+    timelines[1].frames.append(bannerPath);
+
+    QTimer timer;
+    QString statusText;
+    bool hasFrames = false;
+    bool playing = true;
+    int walkFrame = 0;
+    AnimationPreviewService walk;
+    QPixmap pixmap = walk.refresh(timelines, 0, walkFrame, {}, statusText, hasFrames, playing, &timer);
+    QCOMPARE(pixmap.size(), QSize(10, 10));
+    QCOMPARE(walk.cachedBoundsLeft(), 5);
+
+    // The whole loop fits the ring, so the worker composes every frame after the playhead.
+    QTRY_VERIFY(walk.isFrameReady(1) && walk.isFrameReady(2) && walk.isFrameReady(3));
+    walkFrame = 2;
+    pixmap = walk.refresh(timelines, 0, walkFrame, {}, statusText, hasFrames, playing, &timer);
+    QCOMPARE(pixmap.toImage().pixelColor(5, 5), QColor(Qt::blue));
+    QCOMPARE(statusText, QString("frame 3/4"));
+
+    // A second preview keeps its own bounds and ring.
+    int bannerFrame = 0;
+    AnimationPreviewService banner;
+    pixmap = banner.refresh(timelines, 1, bannerFrame, {}, statusText, hasFrames, playing, &timer);
+    QCOMPARE(pixmap.size(), QSize(40, 20));
+    QCOMPARE(banner.cachedBoundsLeft(), 20);
+    QCOMPARE(walk.cachedBoundsLeft(), 5);
+    QVERIFY(walk.isFrameReady(1));
+    QVERIFY(!banner.isFrameReady(1));
+
+    // Flipping changes the scene, so frames are composed again.
+    timelines[0].hFlip = true;
+    walkFrame = 0;
+    pixmap = walk.refresh(timelines, 0, walkFrame, {}, statusText, hasFrames, playing, &timer);
+    QCOMPARE(pixmap.toImage().pixelColor(5, 5), QColor(Qt::red));
+    walk.waitForPrefetch();
+    QVERIFY(walk.isFrameReady(3));
+
+    // A sprite reloaded from disk keeps its path and size; the scene is the same
+    // otherwise, but the frames must not come from the old ring.
+    QImage reloaded(10, 10, QImage::Format_ARGB32);
+    reloaded.fill(Qt::magenta);
+    QVERIFY(reloaded.save(timelines[0].frames.first()));
+    AnimationPreviewService::invalidateSpriteMap();
+    pixmap = walk.refresh(timelines, 0, walkFrame, {}, statusText, hasFrames, playing, &timer);
+    QCOMPARE(pixmap.toImage().pixelColor(5, 5), QColor(Qt::magenta));
+}
+
 #include "TimelineGenerationService.h"
 
 void AnimationTests::testTimelineGenerationFromLayout() {
@@ -91,3 +156,230 @@ void AnimationTests::testTimelineGenerationFromLayout() {
     QCOMPARE(timelines[0].name, QString("Idle"));
     QCOMPARE(timelines[0].frames.size(), 2);
 }
+
+#include "AnimationFrameStream.h"
+#include <QStandardPaths>
+
+void AnimationTests::testAnimationFrameStreamPipesRawFrames() {
+    const QString shell = QStandardPaths::findExecutable("sh");
+    if (shell.isEmpty()) {
+        QSKIP("sh is required for the fake encoder.");
+    }
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto writeFrame = [&dir](const QString& name, int width, int height, const QColor& color) {
+        QImage image(width, height, QImage::Format_ARGB32);
+        image.fill(color);
+        return image.save(dir.filePath(name));
+    };
+    // Centred pivots put the three bars on one 8x8 canvas.
+    QVERIFY(writeFrame("square.png", 4, 4, Qt::red));
+    QVERIFY(writeFrame("wide.png", 8, 2, Qt::green));
+    QVERIFY(writeFrame("tall.png", 2, 8, Qt::blue));
+
+    QVector<AnimationFrameStream::Frame> frames;
+    for (const QString& name : {"square.png", "missing.png", "wide.png", "tall.png"}) {
+        AnimationFrameStream::Frame frame;
+        frame.path = dir.filePath(name);
+        frames.append(frame);
+    }
+    AnimationFrameStream::Canvas canvas;
+    QVERIFY(AnimationFrameStream::measure(frames, canvas));
+    QCOMPARE(frames.size(), 3);
+    QCOMPARE(canvas.size, QSize(8, 8));
+    QCOMPARE(canvas.origin, QPoint(4, 4));
+
+    // The fake encoder stores whatever arrives on stdin.
+    const QString rawPath = dir.filePath("frames.rgba");
+    QString error;
+    QVERIFY2(AnimationFrameStream::pipe(frames, canvas, shell,
+                                        {"-c", "cat > \"$0\"", rawPath}, error),
+             qPrintable(error));
+    QFile raw(rawPath);
+    QVERIFY(raw.open(QIODevice::ReadOnly));
+    const QByteArray bytes = raw.readAll();
+    const int frameBytes = 8 * 8 * AnimationFrameStream::kBytesPerPixel;
+    QCOMPARE(bytes.size(), frames.size() * frameBytes);
+
+    auto pixel = [&bytes, frameBytes](int frame, int x, int y) {
+        const auto* p = reinterpret_cast<const uchar*>(bytes.constData())
+            + frame * frameBytes + (y * 8 + x) * AnimationFrameStream::kBytesPerPixel;
+        return QColor(p[0], p[1], p[2], p[3]);
+    };
+    QCOMPARE(pixel(0, 0, 0).alpha(), 0);
+    QCOMPARE(pixel(0, 3, 3), QColor(Qt::red));
+    QCOMPARE(pixel(1, 0, 3), QColor(Qt::green));
+    QCOMPARE(pixel(1, 0, 0).alpha(), 0);
+    QCOMPARE(pixel(2, 3, 7), QColor(Qt::blue));
+
+    // A window of one frame still delivers every frame in order.
+    int delivered = 0;
+    QVERIFY(AnimationFrameStream::stream(frames, canvas,
+        [&delivered](const QImage& image, QString&) {
+            ++delivered;
+            return image.size() == QSize(8, 8) && image.format() == QImage::Format_RGBA8888;
+        }, error, 1));
+    QCOMPARE(delivered, 3);
+
+    // An encoder that fails is reported even after it read every frame.
+    error.clear();
+    QVERIFY(!AnimationFrameStream::pipe(frames, canvas, shell,
+                                        {"-c", "cat > /dev/null; echo broken >&2; exit 3"}, error));
+    QVERIFY(error.contains(QLatin1String("3")));
+    QVERIFY(error.contains(QLatin1String("broken")));
+}
+
+#include "AnimatedImageEncoder.h"
+#include <QBuffer>
+#include <QImageReader>
+#include <QtEndian>
+
+namespace {
+// Three solid frames, each with a transparent corner and a half-transparent pixel.
+QVector<QImage> solidEncoderFrames(const QList<QColor>& colors) {
+    QVector<QImage> frames;
+    for (const QColor& color : colors) {
+        QImage image(6, 5, QImage::Format_RGBA8888);
+        image.fill(color);
+        image.setPixelColor(0, 0, Qt::transparent);
+        image.setPixelColor(5, 4, QColor(255, 255, 255, 100));
+        frames.append(image);
+    }
+    return frames;
+}
+}  // namespace
+
+void AnimationTests::testAnimatedImageEncoderWritesGif() {
+    AnimatedImageEncoder::Format format = AnimatedImageEncoder::Format::Apng;
+    QVERIFY(AnimatedImageEncoder::formatForPath("walk.GIF", format));
+    QCOMPARE(format, AnimatedImageEncoder::Format::Gif);
+    QVERIFY(!AnimatedImageEncoder::formatForPath("walk.mp4", format));
+
+    const QList<QColor> colors = {Qt::red, Qt::green, Qt::blue};
+    const QVector<QImage> frames = solidEncoderFrames(colors);
+    QString error;
+    const QByteArray gif = AnimatedImageEncoder::encode(frames, 12, AnimatedImageEncoder::Format::Gif, error);
+    QVERIFY2(!gif.isEmpty(), qPrintable(error));
+    QVERIFY(gif.startsWith("GIF89a"));
+    QVERIFY(gif.contains("NETSCAPE2.0"));
+
+    // Streamed frames give the same file; the palette pass has to come first.
+    AnimatedImageEncoder streamed(AnimatedImageEncoder::Format::Gif, 12);
+    QVERIFY(streamed.needsPalettePass());
+    QVERIFY(!streamed.addFrame(frames[0], error));
+    QVERIFY(!error.isEmpty());
+    for (const QImage& frame : frames) QVERIFY2(streamed.addPaletteFrame(frame, error), qPrintable(error));
+    QVERIFY(!streamed.addPaletteFrame(QImage(7, 5, QImage::Format_RGBA8888), error));
+    for (const QImage& frame : frames) QVERIFY2(streamed.addFrame(frame, error), qPrintable(error));
+    QCOMPARE(streamed.finish(error), gif);
+
+    QVERIFY(AnimatedImageEncoder::encode({}, 12, AnimatedImageEncoder::Format::Gif, error).isEmpty());
+    QVERIFY(!error.isEmpty());
+
+    // Per-pixel noise over 200 colours, each alone in its palette bin so it survives
+    // exactly: LZW finds almost no repeats, fills its table and clears it many times.
+    QVector<QRgb> noiseColors;
+    for (int k = 0; k < 200; ++k) {
+        const int bin = (k * 163) % (1 << 15);
+        noiseColors.append(qRgb(((bin >> 10) & 31) << 3, ((bin >> 5) & 31) << 3, (bin & 31) << 3));
+    }
+    QVector<QImage> noise;
+    quint32 seed = 12345;
+    for (int f = 0; f < 2; ++f) {
+        QImage image(256, 256, QImage::Format_RGBA8888);
+        for (int y = 0; y < image.height(); ++y) {
+            for (int x = 0; x < image.width(); ++x) {
+                seed = seed * 1664525u + 1013904223u;
+                const quint32 pick = (seed >> 8) % 211;
+                image.setPixel(x, y, pick < 200 ? noiseColors[int(pick)] : qRgba(0, 0, 0, 0));
+            }
+        }
+        noise.append(image);
+    }
+    const QByteArray noisyGif = AnimatedImageEncoder::encode(noise, 10, AnimatedImageEncoder::Format::Gif, error);
+    QVERIFY2(!noisyGif.isEmpty(), qPrintable(error));
+
+    // Everything below decodes with Qt's reader.
+    if (!QImageReader::supportedImageFormats().contains("gif")) {
+        QSKIP("Qt was built without the GIF reader.");
+    }
+    QBuffer gifBuffer;
+    gifBuffer.setData(gif);
+    QVERIFY(gifBuffer.open(QIODevice::ReadOnly));
+    QImageReader reader(&gifBuffer, "gif");
+    QVERIFY(reader.supportsAnimation());
+    for (const QColor& color : colors) {
+        const QImage decoded = reader.read();
+        QVERIFY2(!decoded.isNull(), qPrintable(reader.errorString()));
+        QCOMPARE(decoded.size(), QSize(6, 5));
+        QCOMPARE(decoded.pixelColor(3, 2), color);
+        QCOMPARE(decoded.pixelColor(0, 0).alpha(), 0);
+        QCOMPARE(decoded.pixelColor(5, 4).alpha(), 0);
+        QCOMPARE(reader.nextImageDelay(), 80);
+    }
+    QVERIFY(reader.read().isNull());
+
+    QBuffer noisyBuffer;
+    noisyBuffer.setData(noisyGif);
+    QVERIFY(noisyBuffer.open(QIODevice::ReadOnly));
+    QImageReader noisyReader(&noisyBuffer, "gif");
+    for (const QImage& expected : std::as_const(noise)) {
+        const QImage decoded = noisyReader.read().convertToFormat(QImage::Format_ARGB32);
+        QVERIFY2(!decoded.isNull(), qPrintable(noisyReader.errorString()));
+        QCOMPARE(decoded.size(), expected.size());
+        for (int y = 0; y < expected.height(); ++y) {
+            for (int x = 0; x < expected.width(); ++x) {
+                const QRgb want = expected.pixel(x, y);
+                const QRgb got = decoded.pixel(x, y);
+                if (qAlpha(want) == 0) {
+                    QCOMPARE(qAlpha(got), 0);
+                } else if (got != want) {
+                    QFAIL(qPrintable(QStringLiteral("pixel %1,%2 is %3, expected %4")
+                                         .arg(x).arg(y).arg(got, 8, 16).arg(want, 8, 16)));
+                }
+            }
+        }
+    }
+    QVERIFY(noisyReader.read().isNull());
+}
+
+void AnimationTests::testAnimatedImageEncoderWritesApng() {
+    AnimatedImageEncoder::Format format = AnimatedImageEncoder::Format::Gif;
+    QVERIFY(AnimatedImageEncoder::formatForPath("walk.apng", format));
+    QCOMPARE(format, AnimatedImageEncoder::Format::Apng);
+
+    const QVector<QImage> frames = solidEncoderFrames({Qt::red, Qt::green, Qt::blue});
+    QString error;
+    const QByteArray apng = AnimatedImageEncoder::encode(frames, 12, AnimatedImageEncoder::Format::Apng, error);
+    QVERIFY2(!apng.isEmpty(), qPrintable(error));
+    // Viewers without APNG support show the first frame, losslessly.
+    QCOMPARE(QImage::fromData(apng, "PNG").convertToFormat(QImage::Format_RGBA8888), frames[0]);
+
+    // APNG has no palette, so frames are encoded as they arrive.
+    AnimatedImageEncoder streamed(AnimatedImageEncoder::Format::Apng, 12);
+    QVERIFY(!streamed.needsPalettePass());
+    for (const QImage& frame : frames) QVERIFY2(streamed.addFrame(frame, error), qPrintable(error));
+    QCOMPARE(streamed.finish(error), apng);
+
+    int frameControls = 0;
+    QList<QByteArray> frameData;
+    quint32 declaredFrames = 0;
+    for (qsizetype offset = 8; offset + 12 <= apng.size();) {
+        const quint32 length = qFromBigEndian<quint32>(apng.constData() + offset);
+        const QByteArray type = apng.mid(offset + 4, 4);
+        const QByteArray body = apng.mid(offset + 8, length);
+        if (type == "acTL") declaredFrames = qFromBigEndian<quint32>(body.constData());
+        if (type == "fcTL") ++frameControls;
+        if (type == "fdAT") frameData.append(body.mid(4));
+        offset += 12 + length;
+    }
+    QCOMPARE(declaredFrames, quint32(3));
+    QCOMPARE(frameControls, 3);
+    QCOMPARE(frameData.size(), 2);
+    // Each later frame inflates to one filter byte plus one RGBA row per line.
+    for (const QByteArray& data : std::as_const(frameData)) {
+        QByteArray prefixed(4, '\0');
+        qToBigEndian<quint32>(5 * (6 * 4 + 1), prefixed.data());
+        QCOMPARE(qUncompress(prefixed + data).size(), 5 * (6 * 4 + 1));
+    }
+}
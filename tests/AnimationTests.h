@@ -5,5 +5,9 @@ class AnimationTests : public QObject {
     Q_OBJECT
 private slots:
     void testAnimationPreviewUsesTimelineBounds();
+    void testAnimationPreviewPrecomposesFramesPerInstance();
     void testTimelineGenerationFromLayout();
+    void testAnimationFrameStreamPipesRawFrames();
+    void testAnimatedImageEncoderWritesGif();
+    void testAnimatedImageEncoderWritesApng();
 };
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QtGlobal>
+#include <cstring>
+#include "BinaryMetadataExport.h"
+
+// Reference reader for the "binary" export format, written the way a game runtime would
+// use it: the records are read in place from mapped memory, with bounds checks only.
+class BinaryMetadataReader {
+public:
+    using Header = BinaryMetadataFormat::Header;
+    using PageRecord = BinaryMetadataFormat::PageRecord;
+    using SpriteRecord = BinaryMetadataFormat::SpriteRecord;
+    using AnimationRecord = BinaryMetadataFormat::AnimationRecord;
+
+    bool open(const uchar* data, qint64 size) {
+        m_data = data;
+        m_size = size;
+        if (!data || size < qint64(sizeof(Header))) return false;
+        m_header = reinterpret_cast<const Header*>(data);
+        if (std::memcmp(m_header->magic, BinaryMetadataFormat::kMagic, 4) != 0) return false;
+        if (m_header->version != BinaryMetadataFormat::kVersion) return false;
+        return fits(m_header->pageOffset, qint64(m_header->pageCount) * qint64(sizeof(PageRecord)))
+            && fits(m_header->spriteOffset, qint64(m_header->spriteCount) * qint64(sizeof(SpriteRecord)))
+            && fits(m_header->animationOffset, qint64(m_header->animationCount) * qint64(sizeof(AnimationRecord)))
+            && fits(m_header->frameOffset, qint64(m_header->frameCount) * 4)
+            && fits(m_header->stringTableOffset, m_header->stringTableSize)
+            && m_header->stringTableSize > 0
+            && data[m_header->stringTableOffset + m_header->stringTableSize - 1] == '\0';
+    }
+
+    const Header& header() const { return *m_header; }
+
+    const PageRecord& page(quint32 index) const {
+        return reinterpret_cast<const PageRecord*>(m_data + m_header->pageOffset)[index];
+    }
+
+    const SpriteRecord& sprite(quint32 index) const {
+        return reinterpret_cast<const SpriteRecord*>(m_data + m_header->spriteOffset)[index];
+    }
+
+    const AnimationRecord& animation(quint32 index) const {
+        return reinterpret_cast<const AnimationRecord*>(m_data + m_header->animationOffset)[index];
+    }
+
+    quint32 frame(quint32 index) const {
+        return reinterpret_cast<const quint32_le*>(m_data + m_header->frameOffset)[index];
+    }
+
+    const char* string(quint32 offset) const {
+        if (offset >= m_header->stringTableSize) return nullptr;
+        return reinterpret_cast<const char*>(m_data + m_header->stringTableOffset + offset);
+    }
+
+private:
+    bool fits(quint32 offset, qint64 bytes) const {
+        return offset % 4 == 0 && qint64(offset) + bytes <= m_size;
+    }
+
+    const uchar* m_data = nullptr;
+    qint64 m_size = 0;
+    const Header* m_header = nullptr;
+};
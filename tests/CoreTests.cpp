@@ -41,3 +41,199 @@ void CoreTests::testResolutionUtils() {
 
     QCOMPARE(formatResolutionText(800, 600), QString("800x600"));
 }
+
+#include "PreviewPackCache.h"
+
+void CoreTests::testPreviewPackCacheEvictsLeastRecentlyUsed() {
+    auto entry = [](char fill) {
+        return PreviewPackCache::Entry{QByteArray(900, fill), QByteArray(100, fill), {}};
+    };
+    PreviewPackCache cache(3000);
+    cache.insert("desktop", entry('d'));
+    cache.insert("mobile", entry('m'));
+    cache.insert("tablet", entry('t'));
+    QCOMPARE(cache.count(), 3);
+    QCOMPARE(cache.totalBytes(), qsizetype(3000));
+
+    // Looking an entry up makes it the most recently used one.
+    PreviewPackCache::Entry found;
+    QVERIFY(cache.find("desktop", found));
+    QCOMPARE(found.imageData, QByteArray(900, 'd'));
+
+    cache.insert("tv", entry('v'));
+    QCOMPARE(cache.count(), 3);
+    QVERIFY(!cache.find("mobile", found));
+    QVERIFY(cache.find("desktop", found));
+    QVERIFY(cache.find("tablet", found));
+    QVERIFY(cache.find("tv", found));
+
+    // Replacing a key does not count it twice.
+    cache.insert("tv", entry('w'));
+    QCOMPARE(cache.totalBytes(), qsizetype(3000));
+    QVERIFY(cache.find("tv", found));
+    QCOMPARE(found.layoutData, QByteArray(100, 'w'));
+
+    // An entry over the whole limit is not kept and does not flush the others.
+    cache.insert("huge", PreviewPackCache::Entry{QByteArray(4000, 'h'), {}, {}});
+    QVERIFY(!cache.find("huge", found));
+    QCOMPARE(cache.count(), 3);
+
+    cache.clear();
+    QCOMPARE(cache.count(), 0);
+    QCOMPARE(cache.totalBytes(), qsizetype(0));
+}
+
+#include "SourceImageStore.h"
+
+#include <QDir>
+#include <QImage>
+#include <QTemporaryDir>
+#include <QtConcurrent>
+
+void CoreTests::testSourceImageStoreDecodesEachPathOnce() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString redPath = QDir(tempDir.path()).filePath("red.png");
+    const QString bluePath = QDir(tempDir.path()).filePath("blue.png");
+    QImage red(8, 8, QImage::Format_ARGB32);
+    red.fill(Qt::red);
+    QVERIFY(red.save(redPath));
+    QImage blue(4, 6, QImage::Format_ARGB32);
+    blue.fill(Qt::blue);
+    QVERIFY(blue.save(bluePath));
+
+    // Many concurrent requests for the same two files decode each of them once.
+    QStringList requests;
+    for (int i = 0; i < 64; ++i) {
+        requests << redPath << bluePath;
+    }
+    SourceImageStore store;
+    const QList<QSize> sizes = QtConcurrent::blockingMapped<QList<QSize>>(
+        requests, [&store](const QString& path) { return store.image(path).size(); });
+    for (int i = 0; i < sizes.size(); ++i) {
+        QCOMPARE(sizes.at(i), i % 2 == 0 ? QSize(8, 8) : QSize(4, 6));
+    }
+    QCOMPARE(store.decodeCount(), 2);
+    QCOMPARE(store.image(redPath).format(), QImage::Format_ARGB32_Premultiplied);
+    QCOMPARE(store.image(redPath).pixelColor(3, 3), QColor(Qt::red));
+    QCOMPARE(store.totalBytes(), qsizetype(8 * 8 * 4 + 4 * 6 * 4));
+
+    // Unreadable paths come back null and are not retried.
+    QVERIFY(store.image(QDir(tempDir.path()).filePath("missing.png")).isNull());
+    QVERIFY(store.image(QDir(tempDir.path()).filePath("missing.png")).isNull());
+    QCOMPARE(store.decodeCount(), 3);
+}
+
+#include "SpriteMesh.h"
+
+#include <QPolygonF>
+
+#include <cmath>
+
+void CoreTests::testSpriteMeshCoversOpaquePixelsWithinBudget() {
+    // A disc and a triangle inset in transparent margins; the mesh has to cover every
+    // opaque pixel while cutting away as much of the trimmed rectangle as the budget allows.
+    QImage disc(64, 64, QImage::Format_ARGB32);
+    disc.fill(Qt::transparent);
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            if ((x - 31.5) * (x - 31.5) + (y - 31.5) * (y - 31.5) <= 400.0) {
+                disc.setPixel(x, y, qRgba(255, 0, 0, 255));
+            }
+        }
+    }
+    QImage triangle(64, 64, QImage::Format_ARGB32);
+    triangle.fill(Qt::transparent);
+    for (int y = 8; y < 56; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            if (std::abs(x - 31.5) <= (y - 8) / 2.0) {
+                triangle.setPixel(x, y, qRgba(0, 255, 0, 128));
+            }
+        }
+    }
+
+    auto checkCovers = [](const QImage& image, const QPolygon& mesh, int budget) {
+        QVERIFY(!mesh.isEmpty());
+        QVERIFY(mesh.size() <= qMax(SpriteMesh::kMinVertices, budget));
+        const QRect bounds(0, 0, image.width() + 1, image.height() + 1);
+        for (const QPoint& p : mesh) {
+            QVERIFY(bounds.contains(p));
+        }
+        const QPolygonF outline(mesh);
+        for (int y = 0; y < image.height(); ++y) {
+            for (int x = 0; x < image.width(); ++x) {
+                if (qAlpha(image.pixel(x, y)) > 0) {
+                    QVERIFY2(outline.containsPoint(QPointF(x + 0.5, y + 0.5), Qt::WindingFill),
+                             qPrintable(QString("pixel %1,%2 outside the mesh").arg(x).arg(y)));
+                }
+            }
+        }
+    };
+
+    const QPolygon discMesh = SpriteMesh::trace(disc, 8);
+    checkCovers(disc, discMesh, 8);
+    QVERIFY(SpriteMesh::area(discMesh) < 0.9 * 40 * 40);
+    // More vertices hug the disc closer.
+    const QPolygon fineDiscMesh = SpriteMesh::trace(disc, 16);
+    checkCovers(disc, fineDiscMesh, 16);
+    QVERIFY(SpriteMesh::area(fineDiscMesh) < SpriteMesh::area(discMesh));
+
+    const QPolygon triangleMesh = SpriteMesh::trace(triangle, 6);
+    checkCovers(triangle, triangleMesh, 6);
+    QVERIFY(SpriteMesh::area(triangleMesh) < 0.6 * 48 * 48);
+
+    // Budgets below a quad are raised; the result still covers everything.
+    checkCovers(triangle, SpriteMesh::trace(triangle, 1), 1);
+
+    QImage empty(16, 16, QImage::Format_ARGB32);
+    empty.fill(Qt::transparent);
+    QVERIFY(SpriteMesh::trace(empty, 8).isEmpty());
+}
+
+#include "TextureMemoryEstimator.h"
+
+void CoreTests::testTextureMemoryEstimatorCountsFormatsMipsAndWaste() {
+    const QSize page(256, 256);
+    QCOMPARE(TextureMemoryEstimator::textureBytes(page, QString(), false), qint64(262144));
+    // 256x256 down to 1x1 is 87381 pixels.
+    QCOMPARE(TextureMemoryEstimator::textureBytes(page, QString(), true), qint64(87381 * 4));
+    QCOMPARE(TextureMemoryEstimator::textureBytes(page, QStringLiteral("dxt1"), false), qint64(32768));
+    // Levels below 4x4 still take a whole block: 5463 blocks over the chain.
+    QCOMPARE(TextureMemoryEstimator::textureBytes(page, QStringLiteral("dxt1"), true), qint64(5463 * 8));
+    QCOMPARE(TextureMemoryEstimator::textureBytes(page, QStringLiteral("dxt5"), true), qint64(5463 * 16));
+    QCOMPARE(TextureMemoryEstimator::levelBytes(QSize(30, 10), QStringLiteral("dxt1")), qint64(8 * 3 * 8));
+    QCOMPARE(TextureMemoryEstimator::textureBytes(QSize(4, 1), QString(), true), qint64(16 + 8 + 4));
+
+    auto sprite = [](const QRect& rect) {
+        auto s = std::make_shared<Sprite>();
+        s->rect = rect;
+        return s;
+    };
+    LayoutModel half;
+    half.atlasWidth = 100;
+    half.atlasHeight = 100;
+    // A deduplicated sprite shares its rect and is counted once.
+    half.sprites = {sprite(QRect(0, 0, 50, 50)), sprite(QRect(50, 0, 50, 50)),
+                    sprite(QRect(0, 0, 50, 50))};
+    LayoutModel full;
+    full.atlasWidth = 200;
+    full.atlasHeight = 100;
+    full.sprites = {sprite(QRect(0, 0, 200, 100))};
+    LayoutModel empty;
+
+    const TextureMemoryEstimator::Estimate estimate =
+        TextureMemoryEstimator::estimate({half, full, empty}, QString(), false);
+    QCOMPARE(estimate.pages.size(), 2);
+    QCOMPARE(estimate.pages[0].bytes, qint64(40000));
+    QCOMPARE(estimate.pages[0].transparentShare, 0.5);
+    QCOMPARE(estimate.pages[1].transparentShare, 0.0);
+    QCOMPARE(estimate.totalBytes, qint64(120000));
+    QVERIFY(std::abs(estimate.transparentShare - 1.0 / 6.0) < 1e-9);
+
+    // Models laid out at another scale are resized; the transparent share stays.
+    const TextureMemoryEstimator::Estimate scaled =
+        TextureMemoryEstimator::estimate({half, full}, QString(), false, 0.5);
+    QCOMPARE(scaled.pages[0].size, QSize(50, 50));
+    QCOMPARE(scaled.totalBytes, qint64(30000));
+    QVERIFY(std::abs(scaled.transparentShare - 1.0 / 6.0) < 1e-9);
+}
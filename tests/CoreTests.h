@@ -7,4 +7,8 @@ private slots:
     void testMarkerKindConversions();
     void testMarkerNameNormalization();
     void testResolutionUtils();
+    void testPreviewPackCacheEvictsLeastRecentlyUsed();
+    void testSourceImageStoreDecodesEachPathOnce();
+    void testSpriteMeshCoversOpaquePixelsWithinBudget();
+    void testTextureMemoryEstimatorCountsFormatsMipsAndWaste();
 };
@@ -60,3 +60,173 @@ void LayoutTests::testTimelineBuilderParsesSupportedPatterns() {
     const TimelineSeed* punch = findSeed("Punch");
     QVERIFY(punch != nullptr);
 }
+
+#include "AtlasCompositor.h"
+#include "SourceImageStore.h"
+
+#include <QImage>
+#include <QTemporaryDir>
+
+void LayoutTests::testAtlasCompositorTilesMatchSerialCompose() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QDir dir(tempDir.path());
+    // Gradients, so a sprite drawn in the wrong place or orientation changes pixels.
+    auto writeSprite = [&dir](const QString& name, int width, int height, int seed) {
+        QImage image(width, height, QImage::Format_ARGB32);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                image.setPixelColor(x, y, QColor((x * 7 + seed) % 256, (y * 11 + seed) % 256,
+                                                 (seed * 13) % 256, 128 + (x + y) % 128));
+            }
+        }
+        return image.save(dir.filePath(name));
+    };
+    QVERIFY(writeSprite("a.png", 40, 30, 1));
+    QVERIFY(writeSprite("b.png", 20, 50, 2));
+    QVERIFY(writeSprite("c.png", 36, 36, 3));
+
+    // Sprites straddle 16-pixel tile edges; b is rotated and c is trimmed and scaled.
+    const QString layout = QStringLiteral(
+        "atlas 100,70\n"
+        "sprite \"a.png\" 3,5 40,30\n"
+        "sprite \"b.png\" 45,2 50,20 rotated\n"
+        "sprite \"c.png\" 10,40 15,15 2,3 4,1\n");
+    const QVector<LayoutModel> models = LayoutParser::parse(layout, dir.path());
+    QCOMPARE(models.size(), 1);
+
+    SourceImageStore store;
+    QString error;
+    const QImage serial = AtlasCompositor::compose(models.first(), store, Qt::SmoothTransformation, error);
+    QVERIFY2(!serial.isNull(), qPrintable(error));
+    const QImage tiled = AtlasCompositor::composeTiled(models.first(), store, Qt::SmoothTransformation,
+                                                       16, error);
+    QVERIFY2(!tiled.isNull(), qPrintable(error));
+    QCOMPARE(tiled.size(), QSize(100, 70));
+    QCOMPARE(tiled, serial);
+    QCOMPARE(tiled.pixelColor(99, 69).alpha(), 0);
+    // Both passes share the store, so each source was decoded once.
+    QCOMPARE(store.decodeCount(), 3);
+
+    const std::atomic<bool> canceled{true};
+    error.clear();
+    QVERIFY(AtlasCompositor::composeTiled(models.first(), store, Qt::SmoothTransformation, 16, error,
+                                          &canceled).isNull());
+    QVERIFY(error.isEmpty());
+}
+
+#include "AtlasPartitioner.h"
+
+void LayoutTests::testAtlasPartitionerKeepsTimelinesOnOnePage() {
+    // 64x64 frames with 2px padding: twelve fit the 80% estimate of a 256x256 page.
+    const QSize pageSize(256, 256);
+    const int padding = 2;
+    QVector<AtlasPartitioner::Sprite> sprites;
+    QVector<AnimationTimeline> timelines;
+    auto framePath = [](const QString& timeline, int frame) {
+        return QStringLiteral("/sprites/%1_%2.png").arg(timeline).arg(frame, 3, 10, QLatin1Char('0'));
+    };
+
+    // Six 8-frame timelines laid out interleaved, as a name-sorted packer would, so
+    // each currently touches four pages.
+    const int timelineCount = 6;
+    const int frameCount = 8;
+    sprites.resize(timelineCount * frameCount);
+    for (int t = 0; t < timelineCount; ++t) {
+        AnimationTimeline timeline;
+        timeline.name = QStringLiteral("t%1").arg(t);
+        for (int f = 0; f < frameCount; ++f) {
+            const int position = f * timelineCount + t;
+            sprites[position] = {framePath(timeline.name, f), QSize(64, 64), position / 12};
+            timeline.frames.append(framePath(timeline.name, f));
+        }
+        timelines.append(timeline);
+    }
+    // A 20-frame timeline cannot fit one page and is split over two.
+    AnimationTimeline longTimeline;
+    longTimeline.name = QStringLiteral("long");
+    for (int f = 0; f < 20; ++f) {
+        const int position = int(sprites.size());
+        sprites.append({framePath(longTimeline.name, f), QSize(64, 64), position / 12});
+        longTimeline.frames.append(framePath(longTimeline.name, f));
+    }
+    timelines.append(longTimeline);
+    // Sprites no timeline uses fill the gap left on the long timeline's second page.
+    for (int i = 0; i < 10; ++i) {
+        sprites.append({QStringLiteral("/sprites/icon_%1.png").arg(i), QSize(32, 32), 6});
+    }
+
+    AnimationTimeline idle;
+    idle.name = QStringLiteral("idle");
+    idle.frames = timelines.first().frames.mid(0, 4);
+    timelines.append(idle);
+    AnimationTimeline alias;
+    alias.name = QStringLiteral("t0_left");
+    alias.aliasOf = QStringLiteral("t0");
+    alias.hFlip = true;
+    timelines.append(alias);
+    AnimationTimeline missing;
+    missing.name = QStringLiteral("missing");
+    missing.frames = {QStringLiteral("/sprites/gone.png")};
+    timelines.append(missing);
+
+    const AtlasPartitioner::Result result =
+        AtlasPartitioner::partition(sprites, timelines, pageSize, padding);
+
+    QCOMPARE(result.pages.size(), 8);
+    QHash<QString, int> pageOf;
+    for (int p = 0; p < result.pages.size(); ++p) {
+        for (const QString& path : result.pages[p]) {
+            QVERIFY2(!pageOf.contains(path), qPrintable(path));
+            pageOf.insert(path, p);
+        }
+    }
+    QCOMPARE(pageOf.size(), sprites.size());
+
+    // Aliases and timelines without known frames are not reported.
+    QCOMPARE(result.timelines.size(), timelineCount + 2);
+    for (int t = 0; t < timelineCount; ++t) {
+        const AtlasPartitioner::TimelinePages& report = result.timelines[t];
+        QCOMPARE(report.name, QStringLiteral("t%1").arg(t));
+        QCOMPARE(report.pagesBefore, 4);
+        QCOMPARE(report.pagesAfter, 1);
+    }
+    QCOMPARE(result.timelines[timelineCount].name, QStringLiteral("long"));
+    QCOMPARE(result.timelines[timelineCount].pagesBefore, 2);
+    QCOMPARE(result.timelines[timelineCount].pagesAfter, 2);
+    QCOMPARE(result.timelines[timelineCount + 1].name, QStringLiteral("idle"));
+    QCOMPARE(result.timelines[timelineCount + 1].pagesAfter, 1);
+    QCOMPARE(pageOf.value(QStringLiteral("/sprites/icon_0.png")),
+             pageOf.value(framePath(longTimeline.name, 19)));
+
+    // When pages become atlases, the long timeline stays on page 0 with all its frames;
+    // the icons that shared its second page still move out.
+    const AtlasPartitioner::Assignment assignment = AtlasPartitioner::assignTimelines(result, timelines);
+    QCOMPARE(assignment.spanningTimelines, QStringList{QStringLiteral("long")});
+    QCOMPARE(assignment.pages.size(), 8);
+    QCOMPARE(assignment.timelinePages.size(), timelines.size());
+    QHash<QString, int> atlasOf;
+    for (int p = 0; p < assignment.pages.size(); ++p) {
+        QVERIFY(!assignment.pages[p].isEmpty());
+        for (const QString& path : assignment.pages[p]) {
+            QVERIFY2(!atlasOf.contains(path), qPrintable(path));
+            atlasOf.insert(path, p);
+        }
+    }
+    QCOMPARE(atlasOf.size(), sprites.size());
+    QCOMPARE(assignment.timelinePages[timelineCount], 0);
+    for (const QString& frame : longTimeline.frames) {
+        QCOMPARE(atlasOf.value(frame), 0);
+    }
+    for (int t = 0; t < timelineCount; ++t) {
+        const int page = assignment.timelinePages[t];
+        QVERIFY(page > 0);
+        for (const QString& frame : timelines[t].frames) {
+            QCOMPARE(atlasOf.value(frame), page);
+        }
+    }
+    QCOMPARE(assignment.timelinePages[timelineCount + 1], assignment.timelinePages[0]);  // idle
+    QCOMPARE(assignment.timelinePages[timelineCount + 2], assignment.timelinePages[0]);  // t0_left
+    QCOMPARE(assignment.timelinePages[timelineCount + 3], 0);                            // missing
+    QVERIFY(atlasOf.value(QStringLiteral("/sprites/icon_0.png")) > 0);
+}
@@ -6,4 +6,6 @@ class LayoutTests : public QObject {
 private slots:
     void testLayoutParserHandlesEscapedQuotes();
     void testTimelineBuilderParsesSupportedPatterns();
+    void testAtlasCompositorTilesMatchSerialCompose();
+    void testAtlasPartitionerKeepsTimelinesOnOnePage();
 };
@@ -1,7 +1,40 @@
 #include "ProjectSessionTests.h"
 #include "ProjectSession.h"
+#include "AppConstants.h"
+#include "App/MainWindow/Undo/SessionUndoCommand.h"
+#include "App/MainWindow/Undo/SpriteCommands.h"
+#include "App/MainWindow/Undo/UndoMemory.h"
+#include <QUndoStack>
 #include <memory>
 
+namespace {
+LayoutModel makeLayoutModel(int spriteCount) {
+    LayoutModel model;
+    model.sprites.reserve(spriteCount);
+    for (int i = 0; i < spriteCount; ++i) {
+        auto sprite = std::make_shared<Sprite>();
+        sprite->path = QString("/tmp/project/sprites/sprite_%1.png").arg(i, 5, 10, QChar('0'));
+        sprite->name = QString("sprite_%1").arg(i);
+        model.sprites.append(sprite);
+    }
+    return model;
+}
+
+QStringList makeSpritePaths(int count) {
+    QStringList paths;
+    for (int i = 0; i < count; ++i) {
+        paths.append(QString("/tmp/project/sprites/sprite_%1.png").arg(i, 5, 10, QChar('0')));
+    }
+    return paths;
+}
+
+class NullUndoHost : public IMainWindowUndoHost {
+public:
+    void refreshUiAfterUndo() override {}
+    void setSourceFolderIsTemp(bool) override {}
+};
+}  // namespace
+
 void ProjectSessionTests::testInitialState() {
     ProjectSession session;
     QVERIFY(session.isEmpty());
@@ -33,3 +66,132 @@ void ProjectSessionTests::testMarkAsDirty() {
     
     QCOMPARE(spy.count(), 1);
 }
+
+void ProjectSessionTests::testGenerationCounter() {
+    ProjectSession session;
+    const quint64 initial = session.generation();
+
+    session.touch();
+    QCOMPARE(session.generation(), initial + 1);
+
+    emit session.timelinesChanged();
+    emit session.atlasesChanged();
+    QCOMPARE(session.generation(), initial + 3);
+
+    // Plain field writes are not tracked; callers touch() after edits the signals miss.
+    session.currentFolder = "/tmp/project";
+    QCOMPARE(session.generation(), initial + 3);
+}
+
+void ProjectSessionTests::testUndoHistoryBudget() {
+    const qsizetype budget = AppConstants::kUndoHistoryBudgetBytes;
+
+    // Pivot edits only reference live sprites: the history holds no copies of them.
+    LayoutModel model = makeLayoutModel(20000);
+    QUndoStack pivots;
+    pivots.setUndoLimit(AppConstants::kUndoStackLimit);
+    UndoHistoryBudget::Tracker pivotBudget(budget);
+    for (int i = 0; i < 1000; ++i) {
+        const SpritePtr sprite = model.sprites.at((i * 17) % model.sprites.size());
+        pivots.push(new SetPivotCommand(sprite, sprite->pivotX, sprite->pivotY, i, i));
+        pivotBudget.update(&pivots);
+    }
+    QCOMPARE(pivots.count(), 1000);
+    QCOMPARE(pivotBudget.totalCost(), UndoHistoryBudget::totalCost(&pivots));
+    QVERIFY(UndoHistoryBudget::canUndo(&pivots));
+    for (int i = 0; i < pivots.count(); ++i) {
+        const auto* command = static_cast<const SetPivotCommand*>(pivots.command(i));
+        QCOMPARE(command->sprites().first().get(), model.sprites.at((i * 17) % model.sprites.size()).get());
+    }
+    // Every edited sprite has one reference from the model and one from its command.
+    long extraReferences = 0;
+    for (const SpritePtr& sprite : model.sprites) {
+        extraReferences += sprite.use_count() - 1;
+    }
+    QCOMPARE(extraReferences, 1000L);
+
+    // Removals snapshot the whole layout; over budget the oldest snapshots are released.
+    const qsizetype smallBudget = 1024 * 1024;
+    QVector<LayoutModel> layout{makeLayoutModel(20000)};
+    QStringList activeFramePaths;
+    QVector<AnimationTimeline> timelines;
+    int selectedTimeline = -1;
+    QUndoStack removals;
+    UndoHistoryBudget::Tracker removalBudget(smallBudget);
+    for (int step = 0; step < 10; ++step) {
+        QStringList targets;
+        for (int i = 0; i < 1000; ++i) {
+            targets.append(layout.first().sprites.at(i)->path);
+        }
+        removals.push(new RemoveSpritesCommand(
+            &activeFramePaths, &timelines, &selectedTimeline, &layout, targets,
+            activeFramePaths, timelines, selectedTimeline, layout, {}, {}, {}));
+        removalBudget.update(&removals);
+        // The running total matches a fresh walk of the stack.
+        QCOMPARE(removalBudget.totalCost(), UndoHistoryBudget::totalCost(&removals));
+        QVERIFY(removalBudget.totalCost() <= smallBudget);
+    }
+    QCOMPARE(layout.first().sprites.size(), 10000);
+    QCOMPARE(removals.count(), 10);
+    QVERIFY(removals.command(0)->isObsolete());
+    QVERIFY(!removals.command(9)->isObsolete());
+
+    // Undo walks back through the kept steps and stops at the released ones.
+    int undone = 0;
+    while (UndoHistoryBudget::canUndo(&removals)) {
+        UndoHistoryBudget::undo(&removals);
+        ++undone;
+    }
+    QVERIFY(undone > 0);
+    QVERIFY(undone < 10);
+    QCOMPARE(layout.first().sprites.size(), 10000 + undone * 1000);
+
+    // Undoing into a released step is a no-op, and the stack stays usable afterwards.
+    const int releasedIndex = removals.index();
+    UndoHistoryBudget::undo(&removals);
+    QCOMPARE(removals.index(), releasedIndex);
+    QCOMPARE(layout.first().sprites.size(), 10000 + undone * 1000);
+    while (removals.canRedo()) {
+        removals.redo();
+    }
+    QCOMPARE(layout.first().sprites.size(), 10000);
+    QStringList targets;
+    for (int i = 0; i < 1000; ++i) {
+        targets.append(layout.first().sprites.at(i)->path);
+    }
+    removals.push(new RemoveSpritesCommand(
+        &activeFramePaths, &timelines, &selectedTimeline, &layout, targets,
+        activeFramePaths, timelines, selectedTimeline, layout, {}, {}, {}));
+    UndoHistoryBudget::enforce(&removals, smallBudget);
+    QCOMPARE(layout.first().sprites.size(), 9000);
+    QVERIFY(UndoHistoryBudget::canUndo(&removals));
+    UndoHistoryBudget::undo(&removals);
+    QCOMPARE(layout.first().sprites.size(), 10000);
+}
+
+void ProjectSessionTests::testSessionUndoSharesUnchangedState() {
+    ProjectSession session;
+    NullUndoHost host;
+
+    // Built separately so before and after start out as equal but unshared copies.
+    ProjectSession::SessionState before;
+    before.atlases.resize(1);
+    before.atlases[0].id = "main";
+    before.atlases[0].spritePaths = makeSpritePaths(20000);
+    before.cachedLayoutOutput = "layout v1";
+
+    ProjectSession::SessionState after;
+    after.atlases.resize(1);
+    after.atlases[0].id = "main";
+    after.atlases[0].spritePaths = makeSpritePaths(20000);
+    after.cachedLayoutOutput = "layout v2";
+
+    const qsizetype pathBytes = UndoMemory::bytes(before.atlases[0].spritePaths,
+                                                  UndoMemory::Count::All);
+    SessionUndoCommand command(&host, &session, "Edit", before, after, true);
+    QVERIFY(command.memoryCost() >= pathBytes);
+    QVERIFY(command.memoryCost() < pathBytes + pathBytes / 2);
+
+    command.releaseMemory();
+    QVERIFY(command.memoryCost() < 1024);
+}
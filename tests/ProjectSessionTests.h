@@ -7,4 +7,7 @@ private slots:
     void testInitialState();
     void testProjectLoading();
     void testMarkAsDirty();
+    void testGenerationCounter();
+    void testUndoHistoryBudget();
+    void testSessionUndoSharesUnchangedState();
 };
@@ -1,19 +1,104 @@
 #include "ProjectTests.h"
 #include "AnimatedImageImport.h"
+#include "ArchiveExtractor.h"
+#include "AutosaveJournal.h"
 #include "AutosaveProjectStore.h"
+#include "BinaryMetadataReader.h"
+#include "ExportMetadataText.h"
+#include "ExportTiming.h"
+#include "HeadlessExportService.h"
 #include "ImportPathSupport.h"
+#include "LayoutParser.h"
+#include "ProjectCborCodec.h"
 #include "ProjectFileLoader.h"
+#include "ProjectPayloadCache.h"
 #include "ProjectPayloadCodec.h"
+#include "ProjectSaveService.h"
+#include "SourceImageStore.h"
+#include "SpriteMesh.h"
 
 #include <QByteArray>
+#include <QDateTime>
+#include <QDeadlineTimer>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QImage>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QMap>
+#include <QMutex>
 #include <QProcess>
 #include <QStandardPaths>
 #include <QTemporaryDir>
+#include <QThread>
+#include <QThreadPool>
+
+#include <atomic>
+#include <cmath>
+
+namespace {
+// Builds a project with one timeline and a marker on every sprite; every tenth sprite
+// also carries a polygon.
+ProjectPayloadBuildInput makeProjectInput(int spriteCount) {
+    ProjectPayloadBuildInput input;
+    input.currentFolder = "/tmp/sample-project";
+    input.activeFramePaths.reserve(spriteCount);
+
+    LayoutModel model;
+    model.atlasWidth = 8192;
+    model.atlasHeight = 8192;
+    model.sprites.reserve(spriteCount);
+    AnimationTimeline timeline;
+    timeline.name = "walk";
+    timeline.fps = 12;
+    for (int i = 0; i < spriteCount; ++i) {
+        auto sprite = std::make_shared<Sprite>();
+        sprite->path = QString("/tmp/sample-project/frames/sprite_%1.png").arg(i, 5, 10, QChar('0'));
+        sprite->name = QString("frames/sprite_%1").arg(i, 5, 10, QChar('0'));
+        sprite->rect = QRect((i % 256) * 32, (i / 256) * 32, 32, 32);
+        sprite->pivotX = 16;
+        sprite->pivotY = 30;
+        NamedPoint hit;
+        hit.name = "hit";
+        hit.x = i % 32;
+        hit.y = 8;
+        sprite->points.append(hit);
+        if (i % 10 == 0) {
+            NamedPoint body;
+            body.name = "body";
+            body.kind = MarkerKind::Polygon;
+            body.polygonPoints = {QPoint(0, 0), QPoint(31, 0), QPoint(16, 31)};
+            sprite->points.append(body);
+        }
+        input.activeFramePaths.append(sprite->path);
+        if (i < 64) {
+            timeline.frames.append(sprite->path);
+        }
+        model.sprites.append(sprite);
+    }
+    input.layoutModels.append(model);
+    input.timelines.append(timeline);
+    input.layoutScale = 0.5;
+    input.layoutZoom = 1.25;
+    return input;
+}
+
+// Freshly parsed layout for the input's sprites: same paths, no project state applied.
+QVector<LayoutModel> makeUnappliedLayout(const ProjectPayloadBuildInput& input) {
+    QVector<LayoutModel> models = input.layoutModels;
+    for (auto& model : models) {
+        for (auto& sprite : model.sprites) {
+            auto fresh = std::make_shared<Sprite>();
+            fresh->path = sprite->path;
+            fresh->rect = sprite->rect;
+            sprite = fresh;
+        }
+    }
+    return models;
+}
+}  // namespace
 
 void ProjectTests::testProjectPayloadBuildStoresListSource() {
     ProjectPayloadBuildInput input;
@@ -33,6 +118,18 @@ void ProjectTests::testProjectPayloadBuildStoresListSource() {
     QCOMPARE(layout.value("source_mode").toString(), QString("list"));
     QCOMPARE(framePaths.size(), 2);
     QCOMPARE(framePaths.at(0).toString(), QString("/tmp/project/a/frame_0.png"));
+
+    // Export presets keep their extra formats.
+    ExportPreset preset;
+    preset.name = "web";
+    preset.transform = "json";
+    preset.extraTransforms = {"godot", "unity.json"};
+    input.exportPresets = {preset};
+    QVector<LayoutModel> models;
+    const ProjectPayloadApplyResult result =
+        ProjectPayloadCodec::applyToLayout(ProjectPayloadCodec::build(input), input.currentFolder, models);
+    QCOMPARE(result.exportPresets.size(), 1);
+    QCOMPARE(result.exportPresets.first().extraTransforms, preset.extraTransforms);
 }
 
 void ProjectTests::testProjectFileLoaderLoad() {
@@ -118,10 +215,41 @@ void ProjectTests::testAutosaveProjectStoreCreatesMissingParentDir() {
     QCOMPARE(loadedRoot.value("project").toString(), QString("autosave"));
 }
 
+void ProjectTests::testAutosaveProjectStoreWritesDetachedInput() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString autosavePath = QDir(tempDir.path()).filePath("gui_saved.json");
+
+    const ProjectPayloadBuildInput session = makeProjectInput(3);
+    ProjectPayloadBuildInput input = session;
+    AutosaveProjectStore::detachSprites(input);
+    const SpritePtr edited = session.layoutModels.first().sprites.first();
+    QVERIFY(input.layoutModels.first().sprites.first() != edited);
+
+    // Edits made after the input was captured must not leak into the snapshot.
+    edited->pivotX = 99;
+    const AutosaveWriteResult result = AutosaveProjectStore::write(autosavePath, input);
+    QVERIFY2(result.ok, qPrintable(result.error));
+    QVERIFY(!result.writtenAt.isEmpty());
+
+    QJsonObject loadedRoot;
+    QString error;
+    QVERIFY2(AutosaveProjectStore::load(autosavePath, loadedRoot, error), qPrintable(error));
+    QCOMPARE(loadedRoot.value("written_at").toString(), result.writtenAt);
+    const QString key = ProjectPayloadCodec::spriteStateKey(QDir(session.currentFolder), edited->path);
+    const QJsonObject state = loadedRoot.value("spritemarkers").toObject()
+        .value("sprites").toObject().value(key).toObject();
+    QCOMPARE(state.value("pivot_x").toInt(), 16);
+
+    // QSaveFile leaves only the committed snapshot behind.
+    QCOMPARE(QDir(tempDir.path()).entryList(QDir::Files), QStringList{"gui_saved.json"});
+}
+
 void ProjectTests::testMainWindowImportPathSupport() {
     QVERIFY(ImportPathSupport::isSupportedLocalImportPath("/tmp/sprites/archive.tar.gz"));
     QVERIFY(ImportPathSupport::isSupportedLocalImportPath("/tmp/sprites/archive.tar.bz2"));
     QVERIFY(ImportPathSupport::isSupportedLocalImportPath("/tmp/sprites/project archive.zip"));
+    QVERIFY(ImportPathSupport::isSupportedLocalImportPath("/tmp/sprites/project.spart.cbor"));
     QVERIFY(ImportPathSupport::isSupportedLocalImportPath("/tmp/sprites/sheet.png"));
     QVERIFY(!ImportPathSupport::isSupportedLocalImportPath("/tmp/sprites/readme.txt"));
 
@@ -155,3 +283,1327 @@ void ProjectTests::testAnimatedGifFrameExtraction() {
     QVERIFY(QFile::exists(framesDir.filePath("frame_0000.png")));
     QVERIFY(QFile::exists(framesDir.filePath("frame_0001.png")));
 }
+
+void ProjectTests::testProjectCborRoundTrip() {
+    const ProjectPayloadBuildInput input = makeProjectInput(20);
+
+    QJsonObject expected = ProjectPayloadCodec::build(input);
+    QByteArray encoded = ProjectCborCodec::encode(expected);
+    QVERIFY(ProjectCborCodec::isCbor(encoded));
+    QString error;
+    QJsonObject decoded;
+    QVERIFY2(ProjectCborCodec::decode(encoded, decoded, error), qPrintable(error));
+    QCOMPARE(decoded, expected);
+    expected.remove("written_at");
+
+    // Streaming the sprite table from the layout models or from the cache gives the same document.
+    encoded = ProjectCborCodec::encode(input);
+    QVERIFY2(ProjectCborCodec::decode(encoded, decoded, error), qPrintable(error));
+    decoded.remove("written_at");
+    QCOMPARE(decoded, expected);
+    ProjectPayloadCache cache;
+    ProjectPayloadBuildInput cachedInput = input;
+    cachedInput.payloadCache = &cache;
+    QVERIFY2(ProjectCborCodec::decode(ProjectCborCodec::encode(cachedInput), decoded, error), qPrintable(error));
+    decoded.remove("written_at");
+    QCOMPARE(decoded, expected);
+
+    // Binary projects get their own file name, and the JSON file of the other encoding is removed.
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QVERIFY2(ProjectSaveService::writeProjectFile(tempDir.path(), input, false, error), qPrintable(error));
+    QVERIFY2(ProjectSaveService::writeProjectFile(tempDir.path(), input, true, error), qPrintable(error));
+    const QString path = ProjectFileLoader::projectFileIn(tempDir.path());
+    QCOMPARE(QFileInfo(path).fileName(), QString("project.spart.cbor"));
+    QVERIFY(!QFile::exists(QDir(tempDir.path()).filePath("project.spart.json")));
+
+    // CBOR project files load through the regular loader.
+    QJsonObject loadedRoot;
+    QVERIFY2(ProjectFileLoader::load(path, loadedRoot, error), qPrintable(error));
+    loadedRoot.remove("written_at");
+    QCOMPARE(loadedRoot, expected);
+
+    QVector<LayoutModel> models;
+    LayoutModel model;
+    auto sprite = std::make_shared<Sprite>();
+    sprite->path = "/tmp/sample-project/frames/sprite_00010.png";
+    model.sprites.append(sprite);
+    models.append(model);
+    ProjectPayloadCodec::applyToLayout(loadedRoot, input.currentFolder, models);
+    QCOMPARE(sprite->pivotY, 30);
+    QCOMPARE(sprite->points.size(), 2);
+    QCOMPARE(sprite->points.at(1).polygonPoints.size(), 3);
+}
+
+void ProjectTests::testProjectCborIsSmallerThanJson() {
+    constexpr int kSpriteCount = 24;
+    const ProjectPayloadBuildInput input = makeProjectInput(kSpriteCount);
+
+    const QByteArray json = QJsonDocument(ProjectPayloadCodec::build(input)).toJson();
+    const QByteArray cbor = ProjectCborCodec::encode(input);
+    QJsonObject decoded;
+    QString error;
+    QVERIFY2(ProjectCborCodec::decode(cbor, decoded, error), qPrintable(error));
+
+    QCOMPARE(decoded.value("spritemarkers").toObject().value("sprites").toObject().size(), kSpriteCount);
+    QVERIFY(cbor.size() < json.size());
+}
+
+void ProjectTests::testProjectEncodingBenchmark_data() {
+    QTest::addColumn<bool>("binary");
+    QTest::newRow("json") << false;
+    QTest::newRow("cbor") << true;
+}
+
+void ProjectTests::testProjectEncodingBenchmark() {
+    QFETCH(bool, binary);
+    const ProjectPayloadBuildInput input = makeProjectInput(50000);
+
+    QByteArray data;
+    QBENCHMARK {
+        data = binary ? ProjectCborCodec::encode(input)
+                      : QJsonDocument(ProjectPayloadCodec::build(input)).toJson();
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void ProjectTests::testApplyToLayoutMatchesSingleThread() {
+    // Enough sprites for the apply pass to split into several chunks.
+    constexpr int kSpriteCount = 1200;
+    const ProjectPayloadBuildInput input = makeProjectInput(kSpriteCount);
+    const QJsonObject root = ProjectPayloadCodec::build(input);
+
+    QThreadPool* pool = QThreadPool::globalInstance();
+    const int defaultThreads = pool->maxThreadCount();
+    pool->setMaxThreadCount(1);
+    QVector<LayoutModel> singleModels = makeUnappliedLayout(input);
+    ProjectPayloadCodec::applyToLayout(root, input.currentFolder, singleModels);
+    pool->setMaxThreadCount(defaultThreads);
+
+    QVector<LayoutModel> models = makeUnappliedLayout(input);
+    ProjectPayloadCodec::applyToLayout(root, input.currentFolder, models);
+
+    const auto& expected = input.layoutModels.first().sprites;
+    const auto& single = singleModels.first().sprites;
+    const auto& parallel = models.first().sprites;
+    QCOMPARE(single.size(), kSpriteCount);
+    QCOMPARE(parallel.size(), kSpriteCount);
+    for (int i = 0; i < kSpriteCount; ++i) {
+        QCOMPARE(parallel.at(i)->name, single.at(i)->name);
+        QCOMPARE(parallel.at(i)->pivotX, single.at(i)->pivotX);
+        QCOMPARE(parallel.at(i)->pivotY, single.at(i)->pivotY);
+        QVERIFY(parallel.at(i)->points == single.at(i)->points);
+        QVERIFY(single.at(i)->points == expected.at(i)->points);
+    }
+}
+
+void ProjectTests::testApplyToLayoutBenchmark_data() {
+    QTest::addColumn<bool>("serial");
+    QTest::newRow("serial") << true;
+    QTest::newRow("chunked") << false;
+}
+
+void ProjectTests::testApplyToLayoutBenchmark() {
+    QFETCH(bool, serial);
+    const ProjectPayloadBuildInput input = makeProjectInput(50000);
+    const QJsonObject root = ProjectPayloadCodec::build(input);
+
+    // One worker thread runs the chunks one after another, like the serial pass did.
+    QThreadPool* pool = QThreadPool::globalInstance();
+    const int defaultThreads = pool->maxThreadCount();
+    if (serial) {
+        pool->setMaxThreadCount(1);
+    }
+    QVector<LayoutModel> models;
+    QBENCHMARK {
+        models = makeUnappliedLayout(input);
+        ProjectPayloadCodec::applyToLayout(root, input.currentFolder, models);
+    }
+    pool->setMaxThreadCount(defaultThreads);
+    QCOMPARE(models.first().sprites.last()->pivotY, 30);
+}
+
+void ProjectTests::testProjectPayloadCacheReencodesOnlyEdits() {
+    constexpr int kSpriteCount = 12;
+    ProjectPayloadBuildInput input = makeProjectInput(kSpriteCount);
+    AtlasEntry atlas;
+    atlas.id = "default";
+    atlas.isNeutral = true;
+    atlas.timelines = input.timelines;
+    input.atlases = {atlas};
+    ProjectPayloadCache cache;
+    input.payloadCache = &cache;
+
+    ProjectPayloadCodec::build(input);
+    QCOMPARE(cache.lastEncodedSpriteCount(), kSpriteCount);
+
+    // Only marked sprites are encoded again; an unmarked edit is not looked for.
+    input.layoutModels.first().sprites.at(7)->pivotX = 3;
+    ProjectPayloadCodec::build(input);
+    QCOMPARE(cache.lastEncodedSpriteCount(), 0);
+    cache.markSpriteDirty(input.layoutModels.first().sprites.at(7)->path);
+    QJsonObject incremental = ProjectPayloadCodec::build(input);
+    QCOMPARE(cache.lastEncodedSpriteCount(), 1);
+
+    ProjectPayloadBuildInput uncached = input;
+    uncached.payloadCache = nullptr;
+    QJsonObject expected = ProjectPayloadCodec::build(uncached);
+    incremental.remove("written_at");
+    expected.remove("written_at");
+    QCOMPARE(incremental, expected);
+
+    // Spliced entry bytes give the same files as encoding the whole payload.
+    auto withoutStamp = [](QByteArray json) {
+        const qsizetype at = json.indexOf("\"written_at\"");
+        return at < 0 ? json : json.remove(at, json.indexOf('\n', at) - at);
+    };
+    QCOMPARE(withoutStamp(ProjectPayloadCodec::toJson(input)),
+             withoutStamp(QJsonDocument(ProjectPayloadCodec::build(uncached)).toJson()));
+    QJsonObject decoded;
+    QString error;
+    QVERIFY2(ProjectCborCodec::decode(ProjectCborCodec::encode(input), decoded, error), qPrintable(error));
+    decoded.remove("written_at");
+    QCOMPARE(decoded, expected);
+    QCOMPARE(cache.lastEncodedSpriteCount(), 0);
+
+    // Timeline edits are picked up without a mark.
+    input.atlases[0].timelines[0].fps = 24;
+    input.timelines[0].fps = 24;
+    const QJsonObject edited = ProjectPayloadCodec::build(input);
+    QCOMPARE(edited.value("atlases").toArray().first().toObject().value("timelines").toArray()
+                 .first().toObject().value("fps").toInt(), 24);
+
+    // A mark made after the autosave copy survives the copy's build, so the live state follows.
+    ProjectPayloadBuildInput detached = input;
+    AutosaveProjectStore::detachSprites(detached);
+    const SpritePtr live = input.layoutModels.first().sprites.at(9);
+    live->pivotY = 5;
+    cache.markSpriteDirty(live->path);
+    ProjectPayloadCodec::build(detached);
+    const QJsonObject followed = ProjectPayloadCodec::build(input);
+    QCOMPARE(cache.lastEncodedSpriteCount(), 1);
+    const QString key = ProjectPayloadCodec::spriteStateKey(QDir(input.currentFolder), live->path);
+    QCOMPARE(followed.value("spritemarkers").toObject().value("sprites").toObject()
+                 .value(key).toObject().value("pivot_y").toInt(), 5);
+
+    // Sprites removed from the layout drop out of the section.
+    input.layoutModels.first().sprites.removeLast();
+    const QJsonObject shrunk = ProjectPayloadCodec::build(input);
+    QCOMPARE(shrunk.value("spritemarkers").toObject().value("sprites").toObject().size(), kSpriteCount - 1);
+}
+
+void ProjectTests::testProjectPayloadCacheEncodesOneEditOnLargeProject() {
+    constexpr int kSpriteCount = 20000;
+    ProjectPayloadBuildInput input = makeProjectInput(kSpriteCount);
+    ProjectPayloadCache cache;
+    input.payloadCache = &cache;
+    ProjectPayloadCodec::toJson(input);
+    QCOMPARE(cache.lastEncodedSpriteCount(), kSpriteCount);
+
+    const SpritePtr sprite = input.layoutModels.first().sprites.at(kSpriteCount / 2);
+    sprite->pivotX = 1;
+    cache.markSpriteDirty(sprite->path);
+    const QByteArray json = ProjectPayloadCodec::toJson(input);
+    QCOMPARE(cache.lastEncodedSpriteCount(), 1);
+    QVERIFY(json.contains("\"pivot_x\": 1,"));
+}
+
+void ProjectTests::testAutosaveJournalReplay() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    ProjectPayloadBuildInput input = makeProjectInput(4);
+    input.portablePaths = true;
+    AtlasEntry heroes;
+    heroes.id = "heroes";
+    heroes.name = "Heroes";
+    heroes.isNeutral = true;
+    heroes.spritePaths = input.activeFramePaths;
+    heroes.timelines = input.timelines;
+    AtlasEntry props;
+    props.id = "props";
+    props.name = "Props";
+    input.atlases = {heroes, props};
+    const QJsonObject snapshot = ProjectPayloadCodec::build(input);
+
+    const QString journalPath = QDir(tempDir.path()).filePath("gui_saved.journal");
+    AutosaveJournal journal(journalPath);
+    QString error;
+    QVERIFY(!journal.isOpen());
+    QVERIFY2(journal.reset(snapshot.value("written_at").toString(), error), qPrintable(error));
+
+    // The second pivot edit on the same sprite supersedes the first before flushing.
+    journal.record(AutosaveJournal::pivotRecord("frames/sprite_00001.png", 3, 4));
+    journal.record(AutosaveJournal::pivotRecord("frames/sprite_00001.png", 5, 6));
+    QCOMPARE(journal.pendingCount(), 1);
+    QJsonObject marker;
+    marker["name"] = "muzzle";
+    marker["x"] = 7;
+    marker["y"] = 8;
+    marker["kind"] = "point";
+    journal.record(AutosaveJournal::markersRecord("frames/sprite_00002.png", QJsonArray{marker}));
+    journal.record(AutosaveJournal::spritesMovedRecord({"frames/sprite_00003.png"}, "heroes", "props"));
+    AnimationTimeline idle;
+    idle.name = "idle";
+    idle.frames = QStringList{input.activeFramePaths.at(0)};
+    journal.record(AutosaveJournal::timelinesRecord("heroes", ProjectPayloadCodec::buildTimelines({idle})));
+    QVERIFY2(journal.flush(error), qPrintable(error));
+    QCOMPARE(journal.recordCount(), 4);
+
+    // A torn trailing line from an interrupted write is ignored.
+    QFile journalFile(journalPath);
+    QVERIFY(journalFile.open(QIODevice::Append));
+    journalFile.write("{\"op\":\"pivot\",\"key\":");
+    journalFile.close();
+
+    QJsonObject recovered = snapshot;
+    QCOMPARE(AutosaveJournal::replay(journalPath, recovered), 4);
+
+    QVector<LayoutModel> models;
+    LayoutModel model;
+    for (int i = 0; i < 4; ++i) {
+        auto sprite = std::make_shared<Sprite>();
+        sprite->path = input.activeFramePaths.at(i);
+        model.sprites.append(sprite);
+    }
+    models.append(model);
+    const ProjectPayloadApplyResult result = ProjectPayloadCodec::applyToLayout(recovered, input.currentFolder, models);
+    QCOMPARE(models[0].sprites[1]->pivotX, 5);
+    QCOMPARE(models[0].sprites[1]->pivotY, 6);
+    QCOMPARE(models[0].sprites[2]->points.size(), 1);
+    QCOMPARE(models[0].sprites[2]->points.first().name, QString("muzzle"));
+    QCOMPARE(result.timelines.size(), 1);
+    QCOMPARE(result.timelines.first().name, QString("idle"));
+
+    const QJsonArray atlases = recovered.value("atlases").toArray();
+    QCOMPARE(atlases.size(), 2);
+    QCOMPARE(atlases.at(0).toObject().value("sprite_paths").toArray().size(), 3);
+    QCOMPARE(atlases.at(1).toObject().value("sprite_paths").toArray().first().toString(),
+             QString("frames/sprite_00003.png"));
+
+    // A journal bound to another snapshot is never replayed.
+    QJsonObject otherSnapshot = snapshot;
+    otherSnapshot["written_at"] = "1970-01-01T00:00:00.000Z";
+    QCOMPARE(AutosaveJournal::replay(journalPath, otherSnapshot), 0);
+    QCOMPARE(otherSnapshot.value("spritemarkers"), snapshot.value("spritemarkers"));
+}
+
+void ProjectTests::testProjectSaveServiceRunsProfilesInParallel() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    // Stand-ins for spratlayout and spratpack that record how many of them run at once.
+    // Each call waits a little for a second one to start, so overlapping chains are seen
+    // even on a single core.
+    std::atomic_int running{0};
+    std::atomic_int peak{0};
+    auto fakeTools = [&running, &peak](const QString& tool, const QStringList&, const QString&,
+                                       const QByteArray*, QByteArray* output) {
+        const int now = ++running;
+        int seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+        }
+        const QDeadlineTimer deadline(2000);
+        while (peak.load() < 2 && !deadline.hasExpired()) {
+            QThread::msleep(1);
+        }
+        if (tool == QLatin1String("layout")) {
+            *output = "atlas 64,64\nsprite \"a.png\" 0,0 32,32\n";
+        } else {
+            *output = QByteArray("\x89PNG\r\n\x1a\n", 8) + QByteArray(64, '\0');
+        }
+        --running;
+        return true;
+    };
+
+    SaveConfig config;
+    config.destination = tempDir.path();
+    config.transform = "none";
+    const int profileCount = 6;
+    for (int i = 0; i < profileCount; ++i) {
+        config.profiles.append(QString("profile%1").arg(i));
+    }
+
+    QStringList written;
+    ProjectSaveService::SaveCallbacks callbacks;
+    callbacks.runProcess = fakeTools;
+    callbacks.logEntry = [&written](const ExportLogEntry& entry) {
+        if (entry.kind == ExportLogEntry::Kind::FileWritten) written.append(entry.path);
+    };
+
+    QString destination;
+    QString error;
+    constexpr int kMaxParallel = 3;
+    QVERIFY2(ProjectSaveService::save(config, QString(), {"/tmp/a.png"}, QString(), {}, QString(),
+                                      "layout", "pack", QString(), QJsonObject(),
+                                      destination, error, "none", callbacks, kMaxParallel),
+             qPrintable(error));
+
+    // Chains overlap, but never more of them than the save was allowed to run.
+    QVERIFY(peak.load() >= 2);
+    QVERIFY(peak.load() <= kMaxParallel);
+
+    // Log entries come back in profile order, not completion order.
+    QCOMPARE(written.size(), profileCount);
+    for (int i = 0; i < profileCount; ++i) {
+        QVERIFY(written.at(i).contains(QString("profile%1").arg(i)));
+        QVERIFY(QFile::exists(written.at(i)));
+    }
+
+    // A failing chain stops the save and reports its own profile.
+    QTemporaryDir failDir;
+    QVERIFY(failDir.isValid());
+    config.destination = failDir.path();
+    callbacks.runProcess = [fakeTools](const QString& tool, const QStringList& args,
+                                       const QString& step, const QByteArray* input,
+                                       QByteArray* output) {
+        if (tool == QLatin1String("pack") && step.contains(QLatin1String("profile3"))) {
+            return false;
+        }
+        return fakeTools(tool, args, step, input, output);
+    };
+    QVERIFY(!ProjectSaveService::save(config, QString(), {"/tmp/a.png"}, QString(), {}, QString(),
+                                      "layout", "pack", QString(), QJsonObject(),
+                                      destination, error, "none", callbacks, profileCount));
+    QVERIFY(error.contains(QLatin1String("profile3")));
+}
+
+void ProjectTests::testProjectSaveServiceSkipsUnchangedOutputs() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString spritePath = QDir(tempDir.path()).filePath("hero.png");
+    auto writeSprite = [&spritePath](const QByteArray& data) {
+        QFile file(spritePath);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(data);
+    };
+    writeSprite("first");
+
+    QAtomicInt toolCalls = 0;
+    ProjectSaveService::SaveCallbacks callbacks;
+    callbacks.runProcess = [&toolCalls](const QString& tool, const QStringList&, const QString&,
+                                        const QByteArray*, QByteArray* output) {
+        toolCalls.fetchAndAddRelaxed(1);
+        *output = tool == QLatin1String("layout")
+            ? QByteArray("atlas 64,64\n")
+            : QByteArray("\x89PNG\r\n\x1a\n", 8) + QByteArray(16, '\0');
+        return true;
+    };
+    QStringList infos;
+    callbacks.logEntry = [&infos](const ExportLogEntry& entry) {
+        if (entry.kind == ExportLogEntry::Kind::Info) infos.append(entry.path);
+    };
+
+    SaveConfig config;
+    config.destination = QDir(tempDir.path()).filePath("out");
+    config.transform = "none";
+    config.profiles = {"desktop", "mobile"};
+    QVector<SpratProfile> profiles(2);
+    profiles[0].name = "desktop";
+    profiles[1].name = "mobile";
+
+    auto save = [&]() {
+        QString destination;
+        QString error;
+        toolCalls.storeRelaxed(0);
+        infos.clear();
+        const bool ok = ProjectSaveService::save(config, QString(), {spritePath}, QString(),
+                                                 profiles, QString(), "layout", "pack", QString(),
+                                                 QJsonObject(), destination, error, "none",
+                                                 callbacks, 2);
+        if (!ok) qWarning() << error;
+        return ok;
+    };
+
+    QVERIFY(save());
+    QCOMPARE(toolCalls.loadRelaxed(), 4);
+    const QString desktopSheet = QDir(config.destination).filePath("desktop/spritesheet.png");
+    QVERIFY(QFile::exists(desktopSheet));
+    QVERIFY(QFile::exists(QDir(config.destination).filePath("desktop/.sprat-manifest.json")));
+
+    // Nothing changed: both profiles are kept as they are.
+    QVERIFY(save());
+    QCOMPARE(toolCalls.loadRelaxed(), 0);
+    QCOMPARE(infos.size(), 2);
+    QVERIFY(QFile::exists(desktopSheet));
+
+    // A profile setting only invalidates that profile.
+    profiles[1].padding = 2;
+    QVERIFY(save());
+    QCOMPARE(toolCalls.loadRelaxed(), 2);
+
+    // Sprite content invalidates every profile.
+    writeSprite("second");
+    QVERIFY(save());
+    QCOMPARE(toolCalls.loadRelaxed(), 4);
+
+    // A missing output is rebuilt even when the inputs match; the manifest that lists
+    // the same outputs again is not rewritten.
+    const QString desktopManifest = QDir(config.destination).filePath("desktop/.sprat-manifest.json");
+    const QDateTime manifestTime = QDateTime::currentDateTime().addDays(-1);
+    {
+        QFile manifest(desktopManifest);
+        QVERIFY(manifest.open(QIODevice::ReadWrite));
+        QVERIFY(manifest.setFileTime(manifestTime, QFileDevice::FileModificationTime));
+    }
+    QVERIFY(QFile::remove(desktopSheet));
+    QVERIFY(save());
+    QCOMPARE(toolCalls.loadRelaxed(), 2);
+    QVERIFY(QFile::exists(desktopSheet));
+    QCOMPARE(QFileInfo(desktopManifest).lastModified().toSecsSinceEpoch(), manifestTime.toSecsSinceEpoch());
+}
+
+void ProjectTests::testProjectSaveServiceKeepsNestedAtlasOutputs() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QDir temp(tempDir.path());
+    for (const QString& name : {QStringLiteral("hero.png"), QStringLiteral("button.png")}) {
+        QFile file(temp.filePath(name));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(name.toUtf8());
+    }
+
+    QAtomicInt toolCalls = 0;
+    ProjectSaveService::SaveCallbacks callbacks;
+    callbacks.runProcess = [&toolCalls](const QString& tool, const QStringList&, const QString& step,
+                                        const QByteArray*, QByteArray* output) {
+        toolCalls.fetchAndAddRelaxed(1);
+        *output = tool == QLatin1String("layout")
+            ? QByteArray("atlas 64,64\n")
+            : QByteArray("\x89PNG\r\n\x1a\n", 8) + step.toUtf8();
+        return true;
+    };
+
+    // The root atlas writes out/desktop, the "ui" atlas out/desktop/ui.
+    SaveConfig rootConfig;
+    rootConfig.destination = temp.filePath("out");
+    rootConfig.transform = "none";
+    rootConfig.profiles = {"desktop"};
+    SaveConfig uiConfig = rootConfig;
+    uiConfig.atlasSubdir = "ui";
+    QVector<SpratProfile> profiles(1);
+    profiles[0].name = "desktop";
+
+    auto save = [&](const SaveConfig& config, const QString& spritePath) {
+        QString destination;
+        QString error;
+        const bool ok = ProjectSaveService::save(config, QString(), {spritePath}, QString(),
+                                                 profiles, QString(), "layout", "pack", QString(),
+                                                 QJsonObject(), destination, error, "none",
+                                                 callbacks, 1);
+        if (!ok) qWarning() << error;
+        return ok;
+    };
+    auto exportBoth = [&]() {
+        toolCalls.storeRelaxed(0);
+        return save(rootConfig, temp.filePath("hero.png"))
+            && save(uiConfig, temp.filePath("button.png"));
+    };
+
+    const QDir desktop(temp.filePath("out/desktop"));
+    QVERIFY(exportBoth());
+    QCOMPARE(toolCalls.loadRelaxed(), 4);
+    QVERIFY(QFile::exists(desktop.filePath("spritesheet.png")));
+    QVERIFY(QFile::exists(desktop.filePath("ui/spritesheet.png")));
+    QVERIFY(QFile::exists(desktop.filePath("ui/.sprat-manifest.json")));
+
+    // The root manifest lists only the root atlas's own files.
+    QFile manifestFile(desktop.filePath(".sprat-manifest.json"));
+    QVERIFY(manifestFile.open(QIODevice::ReadOnly));
+    const QJsonArray outputs = QJsonDocument::fromJson(manifestFile.readAll()).object()
+        .value("outputs").toArray();
+    manifestFile.close();
+    QVERIFY(!outputs.isEmpty());
+    for (const QJsonValue& output : outputs) {
+        QVERIFY(!output.toObject().value("file").toString().startsWith(QLatin1String("ui/")));
+    }
+
+    // A second export into the same folder keeps both atlases and skips both.
+    QVERIFY(exportBoth());
+    QCOMPARE(toolCalls.loadRelaxed(), 0);
+    QVERIFY(QFile::exists(desktop.filePath("ui/spritesheet.png")));
+
+    // Without a root manifest the root sweep still leaves the ui folder alone, and its
+    // own leftovers go.
+    QVERIFY(QFile::remove(desktop.filePath(".sprat-manifest.json")));
+    QFile leftover(desktop.filePath("old.json"));
+    QVERIFY(leftover.open(QIODevice::WriteOnly));
+    leftover.close();
+    QVERIFY(exportBoth());
+    QCOMPARE(toolCalls.loadRelaxed(), 2);
+    QVERIFY(!QFile::exists(desktop.filePath("old.json")));
+    QVERIFY(QFile::exists(desktop.filePath("spritesheet.png")));
+    QVERIFY(QFile::exists(desktop.filePath("ui/spritesheet.png")));
+    QVERIFY(QFile::exists(desktop.filePath("ui/.sprat-manifest.json")));
+}
+
+void ProjectTests::testProjectSaveServiceWritesZipFromMemory() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    // Fake tools; the converter writes its output like spratconvert does.
+    ProjectSaveService::SaveCallbacks callbacks;
+    callbacks.runProcess = [](const QString& tool, const QStringList& args, const QString& step,
+                              const QByteArray*, QByteArray* output) {
+        if (tool == QLatin1String("layout")) {
+            *output = "atlas 64,64\nsprite \"a.png\" 0,0 32,32\n";
+        } else if (tool == QLatin1String("pack")) {
+            *output = QByteArray("\x89PNG\r\n\x1a\n", 8) + step.toUtf8();
+        } else {
+            const QDir outputDir(args.at(args.indexOf("--output-dir") + 1));
+            QFile file(outputDir.filePath("meta/atlas.json"));
+            if (!outputDir.mkpath("meta") || !file.open(QIODevice::WriteOnly)) {
+                return false;
+            }
+            file.write(step.toUtf8());
+        }
+        return true;
+    };
+    QStringList written;
+    callbacks.logEntry = [&written](const ExportLogEntry& entry) {
+        if (entry.kind == ExportLogEntry::Kind::FileWritten) written.append(entry.path);
+    };
+
+    SaveConfig config;
+    config.transform = "json";
+    config.atlasSubdir = "ui";
+    config.profiles = {"desktop", "mobile"};
+    auto save = [&](const QString& destination) {
+        config.destination = destination;
+        QString savedDestination;
+        QString error;
+        const bool ok = ProjectSaveService::save(config, QString(), {}, QString(), {}, QString(),
+                                                 "layout", "pack", "convert", QJsonObject(),
+                                                 savedDestination, error, "none", callbacks, 2);
+        if (!ok) qWarning() << error;
+        return ok;
+    };
+
+    // Reference: what a zip export used to contain, the folder output archived as a whole.
+    const QString folder = QDir(tempDir.path()).filePath("folder");
+    QVERIFY(save(folder));
+    const QString referenceZip = QDir(tempDir.path()).filePath("reference.zip");
+    QString error;
+    QVERIFY2(ArchiveExtractor::createZip(folder, referenceZip, error), qPrintable(error));
+
+    const QString zipPath = QDir(tempDir.path()).filePath("out/export.zip");
+    written.clear();
+    QVERIFY(save(zipPath));
+    QCOMPARE(written.size(), 5);
+    QCOMPARE(written.first(), QString("desktop/ui/spritesheet.png"));
+    QCOMPARE(written.last(), zipPath);
+
+    // No staging directory is left next to the archive.
+    QCOMPARE(QDir(QFileInfo(zipPath).path()).entryList(QDir::AllEntries | QDir::NoDotAndDotDot),
+             QStringList{"export.zip"});
+
+    QStringList expected = ArchiveExtractor::listEntries(referenceZip, error);
+    QStringList actual = ArchiveExtractor::listEntries(zipPath, error);
+    QVERIFY(error.isEmpty());
+    expected.sort();
+    actual.sort();
+    QCOMPARE(actual, expected);
+    QCOMPARE(actual.size(), 4);
+    for (const QString& entry : expected) {
+        QByteArray expectedData;
+        QByteArray actualData;
+        QVERIFY(ArchiveExtractor::readFileFromArchive(referenceZip, entry, expectedData, error, true));
+        QVERIFY(ArchiveExtractor::readFileFromArchive(zipPath, entry, actualData, error, true));
+        QCOMPARE(actualData, expectedData);
+    }
+}
+
+void ProjectTests::testExportMetadataTextMatchesPayload() {
+    // Every tenth sprite carries a polygon, so two of them do.
+    ProjectPayloadBuildInput input = makeProjectInput(12);
+    // One sprite with every marker kind, an explicit pivot marker and aliases.
+    auto sprite = input.layoutModels.first().sprites.first();
+    sprite->aliases = {"idle", "  ", "stand "};
+    NamedPoint circle;
+    circle.name = "range";
+    circle.kind = MarkerKind::Circle;
+    circle.radius = 12;
+    NamedPoint rect;
+    rect.name = "hurt";
+    rect.kind = MarkerKind::Rectangle;
+    rect.w = 10;
+    rect.h = 20;
+    NamedPoint pivot;
+    pivot.name = " Pivot ";
+    pivot.x = 3;
+    pivot.y = 4;
+    sprite->points.append(circle);
+    sprite->points.append(rect);
+    sprite->points.append(pivot);
+    AnimationTimeline mirrored;
+    mirrored.name = "walk_left";
+    mirrored.fps = 0;
+    mirrored.aliasOf = "walk";
+    mirrored.hFlip = true;
+    input.timelines.append(mirrored);
+
+    const ExportMetadataText typed =
+        ExportMetadataText::build(input.currentFolder, input.layoutModels, input.timelines);
+    const ExportMetadataText fromPayload =
+        ExportMetadataText::fromPayload(ProjectPayloadCodec::build(input));
+
+    QCOMPARE(typed.markers, fromPayload.markers);
+    QCOMPARE(typed.animations, fromPayload.animations);
+    QVERIFY(typed.markers.startsWith("path \"frames/sprite_00000.png\"\n- marker \"hit\" point 0,8\n"));
+    QVERIFY(typed.markers.contains("- marker \"range\" circle 0,0 12\n- marker \"hurt\" rectangle 0,0 10,20\n"
+                                   "- marker \"pivot\" point 3,4\n\n"));
+    QVERIFY(typed.markers.contains("- marker \"pivot\" point 16,30\n"));
+    QVERIFY(typed.markers.endsWith("alias \"idle\" \"frames/sprite_00000\"\n"
+                                   "alias \"stand\" \"frames/sprite_00000\"\n"));
+    QVERIFY(typed.animations.startsWith("fps 12\n\nanimation \"walk\" 12\n"));
+    QVERIFY(typed.animations.endsWith("animation \"walk_left\" 8\nalias \"walk\" flip h\n\n"));
+
+    // Without session data the payload fallback keeps the default frame rate.
+    QCOMPARE(ExportMetadataText::fromPayload(QJsonObject()).animations, QByteArray("fps 8\n\n"));
+    QCOMPARE(ExportMetadataText::build(QString(), {}, {}).animations, QByteArray("fps 8\n\n"));
+}
+
+void ProjectTests::testProjectSaveServiceReportsStepTimings() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    ProjectSaveService::SaveCallbacks callbacks;
+    callbacks.runProcess = [](const QString& tool, const QStringList&, const QString&,
+                              const QByteArray*, QByteArray* output) {
+        QThread::msleep(20);
+        if (tool == QLatin1String("layout")) {
+            *output = "atlas 64,64\nsprite \"a.png\" 0,0 32,32\n";
+        } else if (tool == QLatin1String("pack")) {
+            *output = QByteArray("\x89PNG\r\n\x1a\n", 8) + QByteArray(100, '\0');
+        }
+        return true;
+    };
+    QVector<ExportLogEntry> timings;
+    callbacks.logEntry = [&timings](const ExportLogEntry& entry) {
+        if (entry.kind == ExportLogEntry::Kind::Timing) timings.append(entry);
+    };
+
+    SaveConfig config;
+    config.transform = "json";
+    config.profiles = {"desktop"};
+    config.destination = QDir(tempDir.path()).filePath("out/export.zip");
+    QString destination;
+    QString error;
+    QVERIFY2(ProjectSaveService::save(config, QString(), {}, QString(), {}, QString(),
+                                      "layout", "pack", "convert", QJsonObject(),
+                                      destination, error, "none", callbacks),
+             qPrintable(error));
+
+    QStringList steps;
+    for (const ExportLogEntry& entry : timings) {
+        steps.append(entry.path);
+        QVERIFY(entry.wallMs >= 0);
+    }
+    QCOMPARE(steps, QStringList({"text generation", "discovery", "spratlayout", "spratpack",
+                                 "spratconvert", "file write", "zip"}));
+    const ExportLogEntry& pack = timings.at(3);
+    QCOMPARE(pack.scope, QString("desktop"));
+    QCOMPARE(pack.size, qint64(108));
+    QVERIFY(pack.wallMs >= 20);
+    QCOMPARE(timings.at(5).size, qint64(108));
+    QCOMPARE(timings.last().size, QFileInfo(config.destination).size());
+
+    // The report sits beside a zip archive or an output folder, never inside it.
+    QCOMPARE(ExportTimingReport::reportPath(config.destination),
+             QDir(tempDir.path()).filePath("out/export.timing.json"));
+    QCOMPARE(ExportTimingReport::reportPath(QDir(tempDir.path()).filePath("out/atlas")),
+             QDir(tempDir.path()).filePath("out/atlas.timing.json"));
+    QCOMPARE(ExportTimingReport::reportPath(QDir(tempDir.path()).filePath("out/atlas/")),
+             QDir(tempDir.path()).filePath("out/atlas.timing.json"));
+    QVERIFY2(ExportTimingReport::write(timings, config.destination, error), qPrintable(error));
+    QFile reportFile(ExportTimingReport::reportPath(config.destination));
+    QVERIFY(reportFile.open(QIODevice::ReadOnly));
+    const QJsonObject report = QJsonDocument::fromJson(reportFile.readAll()).object();
+    QCOMPARE(report["destination"].toString(), config.destination);
+    const QJsonArray reportSteps = report["steps"].toArray();
+    QCOMPARE(reportSteps.size(), timings.size());
+    const QJsonObject packStep = reportSteps.at(3).toObject();
+    QCOMPARE(packStep["step"].toString(), QString("spratpack"));
+    QCOMPARE(packStep["scope"].toString(), QString("desktop"));
+    QCOMPARE(packStep["bytes"].toInteger(), qint64(108));
+    QVERIFY(packStep["wall_ms"].toInteger() >= 20);
+}
+
+void ProjectTests::testHeadlessExportServiceExportsProjectAtlases() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QDir projectDir(tempDir.path());
+    QVERIFY(projectDir.mkpath("sprites"));
+    for (const QString& name : {QStringLiteral("hero.png"), QStringLiteral("enemy.png")}) {
+        QFile sprite(projectDir.filePath("sprites/" + name));
+        QVERIFY(sprite.open(QIODevice::WriteOnly));
+        sprite.write(name.toUtf8());
+    }
+
+    // A saved project with two atlases and an export destination next to it.
+    QJsonObject atlasHero{{"id", "a1"}, {"name", "Hero"}, {"sprite_paths", QJsonArray{"hero.png"}}};
+    QJsonObject atlasEnemy{{"id", "a2"}, {"name", "Enemy"}, {"sprite_paths", QJsonArray{"enemy.png"}}};
+    QJsonObject root{
+        {"version", 2},
+        {"schema_version", 4},
+        {"complete", true},
+        {"layout", QJsonObject{{"folder", "sprites"}}},
+        {"atlases", QJsonArray{atlasHero, atlasEnemy}},
+        {"save_options", QJsonObject{{"destination", "out"}, {"transform", "none"},
+                                     {"profiles", QJsonArray{"desktop"}}}},
+    };
+    QFile projectFile(projectDir.filePath("project.spart.json"));
+    QVERIFY(projectFile.open(QIODevice::WriteOnly));
+    projectFile.write(QJsonDocument(root).toJson());
+    projectFile.close();
+
+    QMutex callsMutex;
+    QStringList layoutInputs;
+    ProjectSaveService::SaveCallbacks callbacks;
+    callbacks.runProcess = [&](const QString& tool, const QStringList& args, const QString&,
+                               const QByteArray*, QByteArray* output) {
+        if (tool == QLatin1String("layout")) {
+            QFile frameList(args.first());
+            if (!frameList.open(QIODevice::ReadOnly)) return false;
+            QMutexLocker locker(&callsMutex);
+            layoutInputs.append(QString::fromUtf8(frameList.readAll()).trimmed());
+            *output = "atlas 64,64\nsprite \"a.png\" 0,0 32,32\n";
+        } else {
+            *output = QByteArray("\x89PNG\r\n\x1a\n", 8);
+        }
+        return true;
+    };
+
+    QVector<SpratProfile> profiles(2);
+    profiles[0].name = "desktop";
+    profiles[1].name = "mobile";
+    HeadlessExportService::Request request;
+    request.projectPath = projectDir.path();
+    request.availableProfiles = profiles;
+    request.cliPaths.layoutBinary = "layout";
+    request.cliPaths.packBinary = "pack";
+    request.deduplicateMode = "none";
+
+    // The project's own profile selection and destination.
+    QString destination;
+    QString error;
+    QVERIFY2(HeadlessExportService::exportProject(request, callbacks, destination, error),
+             qPrintable(error));
+    const QDir out(projectDir.filePath("out"));
+    QCOMPARE(QDir::cleanPath(destination), QDir::cleanPath(out.path()));
+    QVERIFY(QFile::exists(out.filePath("desktop/hero/spritesheet.png")));
+    QVERIFY(QFile::exists(out.filePath("desktop/enemy/spritesheet.png")));
+    QVERIFY(!out.exists("mobile"));
+    layoutInputs.sort();
+    QCOMPARE(layoutInputs, QStringList({projectDir.filePath("sprites/enemy.png"),
+                                        projectDir.filePath("sprites/hero.png")}));
+
+    // "all" exports every configured profile to the requested destination.
+    request.profiles = {"all"};
+    request.destination = projectDir.filePath("farm");
+    destination.clear();
+    QVERIFY2(HeadlessExportService::exportProject(request, callbacks, destination, error),
+             qPrintable(error));
+    QVERIFY(QFile::exists(projectDir.filePath("farm/mobile/enemy/spritesheet.png")));
+    QVERIFY(QFile::exists(projectDir.filePath("farm/desktop/hero/spritesheet.png")));
+
+    // An unknown profile fails before anything runs.
+    request.profiles = {"console"};
+    QVERIFY(!HeadlessExportService::exportProject(request, callbacks, destination, error));
+    QVERIFY(error.contains("console"));
+
+    request.projectPath = projectDir.filePath("missing.spart.json");
+    QVERIFY(!HeadlessExportService::exportProject(request, callbacks, destination, error));
+}
+
+void ProjectTests::testProjectSaveServiceLeavesUnchangedFilesAlone() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QByteArray packOutput = QByteArray("\x89PNG\r\n\x1a\n", 8) + "first";
+    ProjectSaveService::SaveCallbacks callbacks;
+    callbacks.runProcess = [&packOutput](const QString& tool, const QStringList& args, const QString&,
+                                         const QByteArray*, QByteArray* output) {
+        if (tool == QLatin1String("layout")) {
+            *output = "atlas 64,64\nsprite \"a.png\" 0,0 32,32\n";
+        } else if (tool == QLatin1String("pack")) {
+            *output = packOutput;
+        } else {
+            const QDir outputDir(args.at(args.indexOf("--output-dir") + 1));
+            QFile file(outputDir.filePath("meta/atlas.json"));
+            if (!outputDir.mkpath("meta") || !file.open(QIODevice::WriteOnly)) {
+                return false;
+            }
+            file.write("{}");
+        }
+        return true;
+    };
+    QMap<QString, ExportLogEntry::Kind> kinds;
+    callbacks.logEntry = [&kinds](const ExportLogEntry& entry) {
+        if (entry.kind == ExportLogEntry::Kind::FileWritten
+            || entry.kind == ExportLogEntry::Kind::Unchanged) {
+            kinds.insert(QFileInfo(entry.path).fileName(), entry.kind);
+        }
+    };
+
+    SaveConfig config;
+    config.destination = tempDir.path();
+    config.transform = "json";
+    config.profiles = {"desktop"};
+    auto save = [&]() {
+        kinds.clear();
+        QString destination;
+        QString error;
+        const bool ok = ProjectSaveService::save(config, QString(), {}, QString(), {}, QString(),
+                                                 "layout", "pack", "convert", QJsonObject(),
+                                                 destination, error, "none", callbacks);
+        if (!ok) qWarning() << error;
+        return ok;
+    };
+    const QDir profileDir(QDir(tempDir.path()).filePath("desktop"));
+    const QString sheetPath = profileDir.filePath("spritesheet.png");
+    const QString metaPath = profileDir.filePath("meta/atlas.json");
+    const QDateTime past = QDateTime::currentDateTimeUtc().addDays(-1);
+    auto backdate = [&past](const QString& path) {
+        QFile file(path);
+        return file.open(QIODevice::ReadWrite)
+            && file.setFileTime(past, QFileDevice::FileModificationTime);
+    };
+    auto modified = [](const QString& path) {
+        return QFileInfo(path).fileTime(QFileDevice::FileModificationTime).toUTC();
+    };
+
+    QVERIFY(save());
+    QVERIFY(kinds.value("spritesheet.png") == ExportLogEntry::Kind::FileWritten);
+    QVERIFY(kinds.value("atlas.json") == ExportLogEntry::Kind::FileWritten);
+    QVERIFY(backdate(sheetPath));
+    QVERIFY(backdate(metaPath));
+    const QDateTime sheetTime = modified(sheetPath);
+
+    // Same bytes: both files are reported unchanged and keep their modification time.
+    // Output the export no longer produces is removed.
+    QFile stale(profileDir.filePath("old/leftover.txt"));
+    QVERIFY(profileDir.mkpath("old"));
+    QVERIFY(stale.open(QIODevice::WriteOnly));
+    stale.close();
+    QVERIFY(save());
+    QVERIFY(kinds.value("spritesheet.png") == ExportLogEntry::Kind::Unchanged);
+    QVERIFY(kinds.value("atlas.json") == ExportLogEntry::Kind::Unchanged);
+    QCOMPARE(modified(sheetPath), sheetTime);
+    QCOMPARE(modified(metaPath), sheetTime);
+    QVERIFY(!QFile::exists(stale.fileName()));
+    QVERIFY(!profileDir.exists("old"));
+
+    // Same size, different content: only the spritesheet is rewritten.
+    packOutput = QByteArray("\x89PNG\r\n\x1a\n", 8) + "other";
+    QVERIFY(save());
+    QVERIFY(kinds.value("spritesheet.png") == ExportLogEntry::Kind::FileWritten);
+    QVERIFY(kinds.value("atlas.json") == ExportLogEntry::Kind::Unchanged);
+    QVERIFY(modified(sheetPath) > sheetTime);
+    QCOMPARE(modified(metaPath), sheetTime);
+    QFile sheet(sheetPath);
+    QVERIFY(sheet.open(QIODevice::ReadOnly));
+    QCOMPARE(sheet.readAll(), packOutput);
+}
+
+void ProjectTests::testProjectSaveServiceComposesProfilesFromSharedSources() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QDir sourceDir(tempDir.path());
+    QVERIFY(sourceDir.mkpath("sprites"));
+    const QString spritesPath = sourceDir.filePath("sprites");
+    QImage red(8, 8, QImage::Format_ARGB32);
+    red.fill(Qt::red);
+    QVERIFY(red.save(QDir(spritesPath).filePath("a.png")));
+    // Blue with a green top row, to tell which way a rotated sprite was turned.
+    QImage blue(4, 6, QImage::Format_ARGB32);
+    blue.fill(Qt::blue);
+    for (int x = 0; x < blue.width(); ++x) {
+        blue.setPixelColor(x, 0, Qt::green);
+    }
+    QVERIFY(blue.save(QDir(spritesPath).filePath("b.png")));
+
+    SpratProfile full;
+    full.name = "full";
+    SpratProfile half;
+    half.name = "half";
+    half.scale = 0.5;
+    SpratProfile rotated;
+    rotated.name = "rotated";
+    rotated.allowRotation = true;
+    const QVector<SpratProfile> profiles{full, half, rotated};
+
+    std::atomic_int packRuns{0};
+    ProjectSaveService::SaveCallbacks callbacks;
+    callbacks.runProcess = [&packRuns](const QString& tool, const QStringList& args, const QString&,
+                                       const QByteArray*, QByteArray* output) {
+        if (tool != QLatin1String("layout")) {
+            packRuns.fetch_add(1);
+            return false;
+        }
+        if (args.contains("--rotate")) {
+            *output = "atlas 14,8\nsprite \"a.png\" 0,0 8,8\nsprite \"b.png\" 8,0 6,4 rotated\n";
+        } else if (args.at(args.indexOf("--scale") + 1) == QLatin1String("0.5")) {
+            *output = "atlas 6,4\nscale 0.5\nsprite \"a.png\" 0,0 4,4\nsprite \"b.png\" 4,0 2,3\n";
+        } else {
+            *output = "atlas 12,8\nsprite \"a.png\" 0,0 8,8\nsprite \"b.png\" 8,0 4,6\n";
+        }
+        return true;
+    };
+    QMutex logMutex;
+    QStringList infos;
+    QStringList composeScopes;
+    callbacks.logEntry = [&](const ExportLogEntry& entry) {
+        QMutexLocker locker(&logMutex);
+        if (entry.kind == ExportLogEntry::Kind::Info) {
+            infos << entry.path;
+        } else if (entry.kind == ExportLogEntry::Kind::Timing && entry.path == QLatin1String("compose")) {
+            composeScopes << entry.scope;
+        }
+    };
+
+    SaveConfig config;
+    config.destination = sourceDir.filePath("out");
+    config.transform = "none";
+    config.profiles = {"full", "half", "rotated"};
+    config.packInProcess = true;
+    QString destination;
+    QString error;
+    QVERIFY2(ProjectSaveService::save(config, spritesPath, {}, spritesPath, profiles, QString(),
+                                      "layout", "pack", QString(), QJsonObject(), destination,
+                                      error, "none", callbacks, 3),
+             qPrintable(error));
+
+    // Three profiles, two sources: each file is decoded once and spratpack never runs.
+    QCOMPARE(packRuns.load(), 0);
+    QCOMPARE(composeScopes.size(), 3);
+    QVERIFY(infos.contains("Decoded 2 source image(s) once for 3 profile(s)"));
+
+    const QDir outDir(config.destination);
+    const QImage fullSheet(outDir.filePath("full/spritesheet.png"));
+    QCOMPARE(fullSheet.size(), QSize(12, 8));
+    QCOMPARE(fullSheet.pixelColor(4, 4), QColor(Qt::red));
+    QCOMPARE(fullSheet.pixelColor(9, 0), QColor(Qt::green));
+    QCOMPARE(fullSheet.pixelColor(9, 3), QColor(Qt::blue));
+    QCOMPARE(fullSheet.pixelColor(9, 7).alpha(), 0);
+
+    const QImage halfSheet(outDir.filePath("half/spritesheet.png"));
+    QCOMPARE(halfSheet.size(), QSize(6, 4));
+    QCOMPARE(halfSheet.pixelColor(1, 1), QColor(Qt::red));
+    QCOMPARE(halfSheet.pixelColor(5, 3).alpha(), 0);
+
+    // A quarter turn clockwise puts the green top row in the rightmost column.
+    const QImage rotatedSheet(outDir.filePath("rotated/spritesheet.png"));
+    QCOMPARE(rotatedSheet.size(), QSize(14, 8));
+    QCOMPARE(rotatedSheet.pixelColor(13, 2), QColor(Qt::green));
+    QCOMPARE(rotatedSheet.pixelColor(8, 2), QColor(Qt::blue));
+
+    // Profiles the compositor cannot produce still go to spratpack.
+    SpratProfile dds = full;
+    dds.name = "dds";
+    dds.gpuCompress = "dxt5";
+    config.profiles = {"dds"};
+    QVERIFY(!ProjectSaveService::save(config, spritesPath, {}, spritesPath, {dds}, QString(),
+                                      "layout", "pack", QString(), QJsonObject(), destination,
+                                      error, "none", callbacks));
+    QCOMPARE(packRuns.load(), 1);
+}
+
+void ProjectTests::testProjectSaveServiceConvertsSeveralTransformsFromOnePack() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    std::atomic_int layoutRuns{0};
+    std::atomic_int packRuns{0};
+    std::atomic_int convertRuns{0};
+    std::atomic_int convertsRunning{0};
+    std::atomic_int maxConvertsRunning{0};
+    ProjectSaveService::SaveCallbacks callbacks;
+    callbacks.runProcess = [&](const QString& tool, const QStringList& args, const QString&,
+                               const QByteArray*, QByteArray* output) {
+        if (tool == QLatin1String("layout")) {
+            layoutRuns.fetch_add(1);
+            *output = "atlas 64,64\nsprite \"a.png\" 0,0 32,32\n";
+            return true;
+        }
+        if (tool == QLatin1String("pack")) {
+            packRuns.fetch_add(1);
+            *output = QByteArray("\x89PNG\r\n\x1a\n", 8);
+            return true;
+        }
+        convertRuns.fetch_add(1);
+        const int running = convertsRunning.fetch_add(1) + 1;
+        int seen = maxConvertsRunning.load();
+        while (running > seen && !maxConvertsRunning.compare_exchange_weak(seen, running)) {}
+        QThread::msleep(150);
+        convertsRunning.fetch_sub(1);
+        // "dup" stands in for a format whose output name collides with json's.
+        QString transform = args.at(args.indexOf("--transform") + 1);
+        if (transform == QLatin1String("dup")) transform = "json";
+        QFile file(QDir(args.at(args.indexOf("--output-dir") + 1)).filePath(transform + ".json"));
+        return file.open(QIODevice::WriteOnly) && file.write("{}") == 2;
+    };
+    QStringList timingScopes;
+    callbacks.logEntry = [&timingScopes](const ExportLogEntry& entry) {
+        if (entry.kind == ExportLogEntry::Kind::Timing && entry.path == QLatin1String("spratconvert")) {
+            timingScopes << entry.scope;
+        }
+    };
+
+    SaveConfig config;
+    config.destination = tempDir.path();
+    config.transform = "json";
+    config.extraTransforms = {"godot", "raw", "json", "unity.json"};
+    config.profiles = {"desktop"};
+    QString destination;
+    QString error;
+    QVERIFY2(ProjectSaveService::save(config, QString(), {}, QString(), {}, QString(),
+                                      "layout", "pack", "convert", QJsonObject(), destination,
+                                      error, "none", callbacks),
+             qPrintable(error));
+
+    // One layout and one pack; each spratconvert format runs once, side by side.
+    QCOMPARE(layoutRuns.load(), 1);
+    QCOMPARE(packRuns.load(), 1);
+    QCOMPARE(convertRuns.load(), 3);
+    if (QThread::idealThreadCount() > 1) {
+        QVERIFY(maxConvertsRunning.load() > 1);
+    }
+    QCOMPARE(timingScopes, QStringList({"desktop (json)", "desktop (godot)", "desktop (unity.json)"}));
+    const QDir profileDir(QDir(tempDir.path()).filePath("desktop"));
+    for (const QString& name : {"spritesheet.png", "json.json", "godot.json", "unity.json.json",
+                                "layout.txt", "markers.txt", "animations.txt"}) {
+        QVERIFY2(profileDir.exists(name), qPrintable(name));
+    }
+
+    // Two formats writing the same file name fail instead of overwriting each other.
+    config.extraTransforms = {"dup"};
+    QVERIFY(!ProjectSaveService::save(config, QString(), {}, QString(), {}, QString(),
+                                      "layout", "pack", "convert", QJsonObject(), destination,
+                                      error, "none", callbacks));
+    QVERIFY(error.contains("both write json.json"));
+}
+
+void ProjectTests::testBinaryMetadataExportMatchesTextExport() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString folder = tempDir.path();
+    const QString layoutText =
+        "atlas 32,16\n"
+        "sprite \"a.png\" 0,0 8,8\n"
+        "sprite \"sub/b.png\" 8,0 6,4 1,2,3,4 rotated\n"
+        "sprite \"c.png\" 0,8 4,4 1,0,0,1\n";
+
+    // Pivots and timelines are edited in the session; the binary file must take them
+    // from the text export, not from the freshly parsed layout.
+    QVector<LayoutModel> session = LayoutParser::parse(layoutText, folder, folder);
+    QCOMPARE(session.size(), 1);
+    QCOMPARE(session[0].sprites.size(), 3);
+    session[0].sprites[0]->pivotX = 3;
+    session[0].sprites[0]->pivotY = 7;
+    NamedPoint pivot;
+    pivot.name = "pivot";
+    pivot.x = 1;
+    pivot.y = 2;
+    session[0].sprites[1]->points.append(pivot);
+    AnimationTimeline walk;
+    walk.name = "walk";
+    walk.fps = 12;
+    walk.frames = {QDir(folder).filePath("a.png"), "sub/b.png", "missing.png", "c.png"};
+    AnimationTimeline walkLeft;
+    walkLeft.name = "walk_left";
+    walkLeft.aliasOf = "walk";
+    walkLeft.hFlip = true;
+    const ExportMetadataText metadata = ExportMetadataText::build(folder, session, {walk, walkLeft});
+
+    const QVector<LayoutModel> exported = LayoutParser::parse(layoutText, folder, folder);
+    const QByteArray data = BinaryMetadataExport::build(exported, metadata, folder);
+    QCOMPARE(data.size() % 4, 0);
+
+    // Read it back the way a runtime would: map the file and use the records in place.
+    QFile file(QDir(folder).filePath(BinaryMetadataExport::fileName()));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QCOMPARE(file.write(data), data.size());
+    QVERIFY(file.flush());
+    const uchar* mapped = file.map(0, file.size());
+    QVERIFY(mapped);
+    BinaryMetadataReader reader;
+    QVERIFY(reader.open(mapped, file.size()));
+    QCOMPARE(quint32(reader.header().pageCount), 1u);
+    QCOMPARE(quint32(reader.page(0).width), 32u);
+    QCOMPARE(quint32(reader.page(0).height), 16u);
+    QCOMPARE(quint32(reader.header().scaleMilli), 1000u);
+    QCOMPARE(quint32(reader.header().spriteCount), 3u);
+
+    using namespace BinaryMetadataFormat;
+    const SpriteRecord& a = reader.sprite(0);
+    QCOMPARE(QString::fromUtf8(reader.string(a.nameOffset)), QString("a"));
+    QCOMPARE(QString::fromUtf8(reader.string(a.pathOffset)), QString("a.png"));
+    QCOMPARE(quint32(a.flags), 0u);
+    QCOMPARE(QRect(a.x, a.y, a.width, a.height), QRect(0, 0, 8, 8));
+    QCOMPARE(QPoint(a.pivotX, a.pivotY), QPoint(3, 7));
+
+    const SpriteRecord& b = reader.sprite(1);
+    QCOMPARE(QString::fromUtf8(reader.string(b.nameOffset)), QString("sub/b"));
+    QCOMPARE(QString::fromUtf8(reader.string(b.pathOffset)), QString("sub/b.png"));
+    QCOMPARE(quint32(b.flags), quint32(SpriteRotated | SpriteTrimmed));
+    QCOMPARE(QRect(b.x, b.y, b.width, b.height), QRect(8, 0, 6, 4));
+    QCOMPARE(QRect(b.trimLeft, b.trimTop, b.trimRight, b.trimBottom), QRect(1, 2, 3, 4));
+    QCOMPARE(QPoint(b.pivotX, b.pivotY), QPoint(1, 2));
+
+    const SpriteRecord& c = reader.sprite(2);
+    QCOMPARE(quint32(c.flags), quint32(SpriteTrimmed));
+    QCOMPARE(QRect(c.trimLeft, c.trimTop, c.trimRight, c.trimBottom), QRect(1, 0, 0, 1));
+    QCOMPARE(QPoint(c.pivotX, c.pivotY), QPoint(exported[0].sprites[2]->pivotX, exported[0].sprites[2]->pivotY));
+
+    // Frames become sprite indices; the frame with no sprite in the layout keeps its place.
+    QCOMPARE(quint32(reader.header().animationCount), 2u);
+    const AnimationRecord& walkRecord = reader.animation(0);
+    QCOMPARE(QString::fromUtf8(reader.string(walkRecord.nameOffset)), QString("walk"));
+    QCOMPARE(quint32(walkRecord.fps), 12u);
+    QCOMPARE(quint32(walkRecord.aliasOfOffset), kNoString);
+    QCOMPARE(quint32(walkRecord.frameCount), 4u);
+    QCOMPARE(reader.frame(walkRecord.firstFrame), 0u);
+    QCOMPARE(reader.frame(walkRecord.firstFrame + 1), 1u);
+    QCOMPARE(reader.frame(walkRecord.firstFrame + 2), kMissingSprite);
+    QCOMPARE(reader.frame(walkRecord.firstFrame + 3), 2u);
+    const AnimationRecord& leftRecord = reader.animation(1);
+    QCOMPARE(QString::fromUtf8(reader.string(leftRecord.nameOffset)), QString("walk_left"));
+    QCOMPARE(QString::fromUtf8(reader.string(leftRecord.aliasOfOffset)), QString("walk"));
+    QCOMPARE(quint32(leftRecord.flags), quint32(AnimationFlipH));
+    QCOMPARE(quint32(leftRecord.frameCount), 0u);
+    file.unmap(const_cast<uchar*>(mapped));
+    file.close();
+
+    // Multipack: every page records its own size.
+    QVector<LayoutModel> pages = exported;
+    LayoutModel secondPage;
+    secondPage.atlasWidth = 8;
+    secondPage.atlasHeight = 4;
+    pages.append(secondPage);
+    const QByteArray multipack = BinaryMetadataExport::build(pages, metadata, folder);
+    BinaryMetadataReader pagesReader;
+    QVERIFY(pagesReader.open(reinterpret_cast<const uchar*>(multipack.constData()), multipack.size()));
+    QCOMPARE(quint32(pagesReader.header().pageCount), 2u);
+    QCOMPARE(QSize(pagesReader.page(0).width, pagesReader.page(0).height), QSize(32, 16));
+    QCOMPARE(QSize(pagesReader.page(1).width, pagesReader.page(1).height), QSize(8, 4));
+
+    // A sprite with the same file name in another folder does not take a.png's pivot.
+    const QVector<LayoutModel> namesake =
+        LayoutParser::parse("atlas 8,8\nsprite \"other/a.png\" 0,0 8,8\n", folder, folder);
+    QCOMPARE(namesake.size(), 1);
+    const QByteArray namesakeData = BinaryMetadataExport::build(namesake, metadata, folder);
+    BinaryMetadataReader namesakeReader;
+    QVERIFY(namesakeReader.open(reinterpret_cast<const uchar*>(namesakeData.constData()), namesakeData.size()));
+    const SpriteRecord& otherA = namesakeReader.sprite(0);
+    QCOMPARE(QString::fromUtf8(namesakeReader.string(otherA.pathOffset)), QString("other/a.png"));
+    QCOMPARE(QPoint(otherA.pivotX, otherA.pivotY),
+             QPoint(namesake[0].sprites[0]->pivotX, namesake[0].sprites[0]->pivotY));
+
+    // As an extra transform the file is written next to the raw text, from the same layout.
+    ProjectSaveService::SaveCallbacks callbacks;
+    callbacks.runProcess = [&layoutText](const QString& tool, const QStringList&, const QString&,
+                                         const QByteArray*, QByteArray* output) {
+        *output = tool == QLatin1String("layout") ? layoutText.toUtf8()
+                                                  : QByteArray("\x89PNG\r\n\x1a\n", 8);
+        return true;
+    };
+    SaveConfig config;
+    config.destination = QDir(folder).filePath("out");
+    config.transform = "raw";
+    config.extraTransforms = {"binary"};
+    config.profiles = {"desktop"};
+    QString destination;
+    QString error;
+    QVERIFY2(ProjectSaveService::save(config, folder, {}, folder, {}, QString(), "layout", "pack",
+                                      QString(), QJsonObject(), destination, error, "none", callbacks),
+             qPrintable(error));
+    const QDir profileDir(QDir(config.destination).filePath("desktop"));
+    QVERIFY(profileDir.exists("layout.txt"));
+    QFile written(profileDir.filePath(BinaryMetadataExport::fileName()));
+    QVERIFY(written.open(QIODevice::ReadOnly));
+    const QByteArray writtenData = written.readAll();
+    BinaryMetadataReader writtenReader;
+    QVERIFY(writtenReader.open(reinterpret_cast<const uchar*>(writtenData.constData()), writtenData.size()));
+    QCOMPARE(quint32(writtenReader.header().spriteCount), 3u);
+}
+
+void ProjectTests::testProjectSaveServiceWritesSpriteMeshMarkers() {
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString folder = tempDir.path();
+    // A diamond in a 32x32 frame: a quad covers it with half the rectangle's area.
+    QImage diamond(32, 32, QImage::Format_ARGB32);
+    diamond.fill(Qt::transparent);
+    for (int y = 0; y < 32; ++y) {
+        for (int x = 0; x < 32; ++x) {
+            if (std::abs(x - 15.5) + std::abs(y - 15.5) <= 12.0) {
+                diamond.setPixel(x, y, qRgba(0, 0, 255, 255));
+            }
+        }
+    }
+    QVERIFY(diamond.save(QDir(folder).filePath("a.png")));
+    QVERIFY(diamond.save(QDir(folder).filePath("b.png")));
+
+    QVector<LayoutModel> session =
+        LayoutParser::parse("atlas 64,32\nsprite \"a.png\" 0,0 32,32\nsprite \"b.png\" 32,0 32,32\n",
+                            folder, folder);
+    QCOMPARE(session[0].sprites.size(), 2);
+    // A hand-made mesh marker is kept as it is.
+    NamedPoint handMade;
+    handMade.name = "mesh";
+    handMade.kind = MarkerKind::Polygon;
+    handMade.polygonPoints = {QPoint(0, 0), QPoint(32, 0), QPoint(16, 32)};
+    session[0].sprites[1]->points.append(handMade);
+    ExportMetadataText text = ExportMetadataText::build(folder, session, {});
+    const QByteArray before = text.markers;
+
+    SourceImageStore images;
+    QCOMPARE(text.appendMeshes(folder, 4, images), 1);
+    const QList<QByteArray> lines = text.markers.split('\n');
+    QByteArray meshLine;
+    for (const QByteArray& line : lines) {
+        if (line.startsWith("- marker \"mesh\" polygon ") && !line.endsWith("0,0 32,0 16,32")) {
+            QVERIFY(meshLine.isEmpty());
+            meshLine = line;
+        }
+    }
+    QVERIFY(!meshLine.isEmpty());
+    QPolygon mesh;
+    for (const QByteArray& coords : meshLine.mid(24).split(' ')) {
+        const QList<QByteArray> xy = coords.split(',');
+        QCOMPARE(xy.size(), 2);
+        mesh << QPoint(xy[0].toInt(), xy[1].toInt());
+    }
+    QVERIFY(mesh.size() <= 4);
+    QVERIFY(SpriteMesh::area(mesh) < 0.75 * 24 * 24);
+    // The mesh closes a.png's block; everything else is untouched.
+    const qsizetype meshAt = text.markers.indexOf(meshLine);
+    QVERIFY(meshAt > text.markers.indexOf("path \"a.png\""));
+    QVERIFY(meshAt < text.markers.indexOf("path \"b.png\""));
+    QCOMPARE(QByteArray(text.markers).remove(meshAt, meshLine.size() + 1), before);
+
+    // Exports with a mesh budget write the traced marker into markers.txt.
+    ProjectSaveService::SaveCallbacks callbacks;
+    callbacks.runProcess = [](const QString& tool, const QStringList&, const QString&,
+                              const QByteArray*, QByteArray* output) {
+        *output = tool == QLatin1String("layout")
+            ? QByteArray("atlas 64,32\nsprite \"a.png\" 0,0 32,32\nsprite \"b.png\" 32,0 32,32\n")
+            : QByteArray("\x89PNG\r\n\x1a\n", 8);
+        return true;
+    };
+    SaveConfig config;
+    config.destination = QDir(folder).filePath("out");
+    config.transform = "raw";
+    config.profiles = {"desktop"};
+    config.meshVertexBudget = 4;
+    QString destination;
+    QString error;
+    QVERIFY2(ProjectSaveService::save(config, folder, {}, folder, {}, QString(), "layout", "pack",
+                                      QString(), QJsonObject(), ExportMetadataText::build(folder, session, {}),
+                                      destination, error, "none", callbacks),
+             qPrintable(error));
+    QFile markers(QDir(config.destination).filePath("desktop/markers.txt"));
+    QVERIFY(markers.open(QIODevice::ReadOnly));
+    QVERIFY(markers.readAll().contains(meshLine));
+}
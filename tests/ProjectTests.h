@@ -8,6 +8,29 @@ private slots:
     void testProjectFileLoaderLoad();
     void testProjectFileLoaderLoadZip();
     void testAutosaveProjectStoreCreatesMissingParentDir();
+    void testAutosaveProjectStoreWritesDetachedInput();
     void testMainWindowImportPathSupport();
     void testAnimatedGifFrameExtraction();
+    void testProjectCborRoundTrip();
+    void testProjectCborIsSmallerThanJson();
+    void testProjectEncodingBenchmark_data();
+    void testProjectEncodingBenchmark();
+    void testApplyToLayoutMatchesSingleThread();
+    void testApplyToLayoutBenchmark_data();
+    void testApplyToLayoutBenchmark();
+    void testProjectPayloadCacheReencodesOnlyEdits();
+    void testProjectPayloadCacheEncodesOneEditOnLargeProject();
+    void testAutosaveJournalReplay();
+    void testProjectSaveServiceRunsProfilesInParallel();
+    void testProjectSaveServiceSkipsUnchangedOutputs();
+    void testProjectSaveServiceKeepsNestedAtlasOutputs();
+    void testProjectSaveServiceWritesZipFromMemory();
+    void testExportMetadataTextMatchesPayload();
+    void testProjectSaveServiceReportsStepTimings();
+    void testHeadlessExportServiceExportsProjectAtlases();
+    void testProjectSaveServiceLeavesUnchangedFilesAlone();
+    void testProjectSaveServiceComposesProfilesFromSharedSources();
+    void testProjectSaveServiceConvertsSeveralTransformsFromOnePack();
+    void testBinaryMetadataExportMatchesTextExport();
+    void testProjectSaveServiceWritesSpriteMeshMarkers();
 };